@@ -525,6 +525,9 @@ extern bfd_boolean bfd_cache_close
 
 extern bfd_boolean bfd_cache_close_all (void);
 
+extern void bfd_cache_get_stats
+  (unsigned long *, unsigned long *, int *);
+
 extern bfd_boolean bfd_record_phdr
   (bfd *, unsigned long, bfd_boolean, flagword, bfd_boolean, bfd_vma,
    bfd_boolean, bfd_boolean, unsigned int, struct bfd_section **);
@@ -1724,6 +1727,11 @@ bfd_boolean bfd_get_section_contents
 bfd_boolean bfd_malloc_and_get_section
    (bfd *abfd, asection *section, bfd_byte **buf);
 
+bfd_boolean bfd_map_section_contents
+   (bfd *abfd, asection *section, bfd_byte **buf, void **view);
+
+void bfd_unmap_section_contents (bfd_byte *buf, void *view);
+
 bfd_boolean bfd_copy_private_section_data
    (bfd *ibfd, asection *isec, bfd *obfd, asection *osec);
 
@@ -28,6 +28,10 @@
 #include "bfd.h"
 #include "libbfd.h"
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #ifndef S_IXUSR
 #define S_IXUSR 0100    /* Execute by owner.  */
 #endif
@@ -542,3 +546,107 @@ bfd_mmap (bfd *abfd, void *addr, bfd_size_type len,
 
   return abfd->iovec->bmmap (abfd, addr, len, prot, flags, offset);
 }
+
+/* Sections smaller than this are read rather than mapped; for them
+   the cost of setting up the mapping outweighs that of the copy.  */
+
+#define MMAP_MIN_SIZE (64 * 1024)
+
+/* A read-only view of part of a file, as returned by
+   _bfd_mmap_readonly.  */
+
+struct bfd_mmap_view
+{
+  /* The start of the mapping, which is page aligned.  */
+  void *base;
+
+  /* The length of the mapping.  */
+  bfd_size_type size;
+};
+
+/*
+INTERNAL_FUNCTION
+	_bfd_mmap_readonly
+
+SYNOPSIS
+	void *_bfd_mmap_readonly (bfd *abfd, file_ptr offset,
+	                          bfd_size_type size, bfd_byte **data);
+
+DESCRIPTION
+	Map @var{size} bytes of @var{abfd} starting at file position
+	@var{offset} read-only into memory, and set *@var{data} to the
+	first of them.  Return a handle for <<_bfd_munmap_readonly>>, or
+	NULL if the data should be read instead.
+*/
+
+void *
+_bfd_mmap_readonly (bfd *abfd ATTRIBUTE_UNUSED,
+		    file_ptr offset ATTRIBUTE_UNUSED,
+		    bfd_size_type size ATTRIBUTE_UNUSED,
+		    bfd_byte **data ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_MMAP
+  static bfd_size_type pagesize;
+  struct bfd_mmap_view *view;
+  file_ptr pg_offset;
+  void *base;
+
+  /* Archive members and in-memory files are always read.  Neither
+     may a mapping extend past the end of the file, where touching it
+     would raise SIGBUS.  */
+  if (size < MMAP_MIN_SIZE
+      || abfd->direction != read_direction
+      || abfd->my_archive != NULL
+      || (abfd->flags & BFD_IN_MEMORY) != 0
+      || offset < 0
+      || (bfd_size_type) offset + size > (bfd_size_type) bfd_get_size (abfd)
+      || size != (size_t) size)
+    return NULL;
+
+  if (pagesize == 0)
+    pagesize = getpagesize ();
+
+  pg_offset = offset & ~(file_ptr) (pagesize - 1);
+  base = bfd_mmap (abfd, NULL, size + (offset - pg_offset), PROT_READ,
+		   MAP_PRIVATE, pg_offset);
+  if (base == (void *) -1)
+    return NULL;
+
+  view = bfd_malloc (sizeof (struct bfd_mmap_view));
+  if (view == NULL)
+    {
+      munmap (base, size + (offset - pg_offset));
+      return NULL;
+    }
+  view->base = base;
+  view->size = size + (offset - pg_offset);
+  *data = (bfd_byte *) base + (offset - pg_offset);
+  return view;
+#else
+  return NULL;
+#endif
+}
+
+/*
+INTERNAL_FUNCTION
+	_bfd_munmap_readonly
+
+SYNOPSIS
+	void _bfd_munmap_readonly (void *view);
+
+DESCRIPTION
+	Release a mapping made by <<_bfd_mmap_readonly>>.
+*/
+
+void
+_bfd_munmap_readonly (void *view)
+{
+#ifdef HAVE_MMAP
+  struct bfd_mmap_view *v = (struct bfd_mmap_view *) view;
+
+  munmap (v->base, v->size);
+  free (v);
+#else
+  abort ();
+#endif
+}
@@ -30,12 +30,15 @@ SECTION
 	the application to open as many BFDs as it wants without
 	regard to the underlying operating system's file descriptor
 	limit (often as low as 20 open files).  The module in
-	<<cache.c>> maintains a least recently used list of
-	<<BFD_CACHE_MAX_OPEN>> files, and exports the name
-	<<bfd_cache_lookup>>, which runs around and makes sure that
-	the required BFD is open. If not, then it chooses a file to
-	close, closes it and opens the one wanted, returning its file
-	handle.
+	<<cache.c>> maintains a least recently used list of open
+	files, and exports the name <<bfd_cache_lookup>>, which runs
+	around and makes sure that the required BFD is open. If not,
+	then it chooses a file to close, closes it and opens the one
+	wanted, returning its file handle.
+
+	The number of files kept open is an eighth of the process's
+	limit on open files, but at least 10.  It can be set instead
+	with the environment variable <<BFD_CACHE_MAX_OPEN>>.
 
 SUBSECTION
 	Caching functions
@@ -50,6 +53,10 @@ SUBSECTION
 #include <sys/mman.h>
 #endif
 
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
 /* In some cases we can optimize cache operation when reopening files.
    For instance, a flush is entirely unnecessary if the file is already
    closed, so a flush would use CACHE_NO_OPEN.  Similarly, a seek using
@@ -66,14 +73,72 @@ enum cache_flag {
 };
 
 /* The maximum number of files which the cache will keep open at
-   one time.  */
+   one time, or zero if it has not been computed yet.  */
 
-#define BFD_CACHE_MAX_OPEN 10
+static int max_open_files;
 
 /* The number of BFD files we have open.  */
 
 static int open_files;
 
+/* The number of lookups which found the file open, and the number
+   which had to reopen it.  */
+
+static unsigned long cache_hits;
+static unsigned long cache_misses;
+
+/* Return the maximum number of files which the cache will keep open
+   at one time.  */
+
+static int
+bfd_cache_max_open (void)
+{
+  if (max_open_files == 0)
+    {
+      const char *env = getenv ("BFD_CACHE_MAX_OPEN");
+      int max = 0;
+
+      if (env != NULL)
+	max = atoi (env);
+      if (max <= 0)
+	{
+#ifdef HAVE_GETRLIMIT
+	  struct rlimit rlim;
+
+	  if (getrlimit (RLIMIT_NOFILE, &rlim) == 0
+	      && rlim.rlim_cur != (rlim_t) RLIM_INFINITY)
+	    max = rlim.rlim_cur / 8;
+	  else
+#endif
+#ifdef _SC_OPEN_MAX
+	    max = sysconf (_SC_OPEN_MAX) / 8;
+#else
+	    max = 10;
+#endif
+	  if (max < 10)
+	    max = 10;
+	}
+      max_open_files = max;
+    }
+  return max_open_files;
+}
+
+/* Return TRUE if reads from ABFD use pread at the position which the
+   BFD tracks itself, instead of the stream's file position.  The
+   stream of an archive is shared by all of its elements, so this
+   saves a seek every time a different element is read, and a file
+   which was closed need not be repositioned when it is reopened.  */
+
+static bfd_boolean
+use_pread (bfd *abfd ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_PREAD
+  return abfd->direction == read_direction;
+#else
+  return FALSE;
+#endif
+}
+
 /* Zero, or a pointer to the topmost BFD on the chain.  This is
    used by the <<bfd_cache_lookup>> macro in @file{libbfd.h} to
    determine when it can avoid a function call.  */
@@ -168,7 +233,8 @@ close_one (void)
       return TRUE;
     }
 
-  kill->where = real_ftell ((FILE *) kill->iostream);
+  if (! use_pread (kill))
+    kill->where = real_ftell ((FILE *) kill->iostream);
 
   return bfd_cache_delete (kill);
 }
@@ -180,15 +246,15 @@ close_one (void)
 
 #define bfd_cache_lookup(x, flag) \
   ((x) == bfd_last_cache			\
-   ? (FILE *) (bfd_last_cache->iostream)	\
+   ? (++cache_hits,				\
+      (FILE *) (bfd_last_cache->iostream))	\
    : bfd_cache_lookup_worker (x, flag))
 
 /* Called when the macro <<bfd_cache_lookup>> fails to find a
    quick answer.  Find a file descriptor for @var{abfd}.  If
-   necessary, it open it.  If there are already more than
-   <<BFD_CACHE_MAX_OPEN>> files open, it tries to close one first, to
-   avoid running out of file descriptors.  It will return NULL
-   if it is unable to (re)open the @var{abfd}.  */
+   necessary, it open it.  If the cache is already full, it tries
+   to close one first, to avoid running out of file descriptors.
+   It will return NULL if it is unable to (re)open the @var{abfd}.  */
 
 static FILE *
 bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
@@ -208,15 +274,18 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 	  snip (abfd);
 	  insert (abfd);
 	}
+      ++cache_hits;
       return (FILE *) abfd->iostream;
     }
 
   if (flag & CACHE_NO_OPEN)
     return NULL;
 
+  ++cache_misses;
   if (bfd_open_file (abfd) == NULL)
     ;
   else if (!(flag & CACHE_NO_SEEK)
+	   && ! use_pread (abfd)
 	   && real_fseek ((FILE *) abfd->iostream, abfd->where, SEEK_SET) != 0
 	   && !(flag & CACHE_NO_SEEK_ERROR))
     bfd_set_error (bfd_error_system_call);
@@ -231,7 +300,12 @@ bfd_cache_lookup_worker (bfd *abfd, enum cache_flag flag)
 static file_ptr
 cache_btell (struct bfd *abfd)
 {
-  FILE *f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
+  FILE *f;
+
+  if (use_pread (abfd))
+    return abfd->where + (abfd->my_archive != NULL ? abfd->origin : 0);
+
+  f = bfd_cache_lookup (abfd, CACHE_NO_OPEN);
   if (f == NULL)
     return abfd->where;
   return real_ftell (f);
@@ -240,7 +314,23 @@ cache_btell (struct bfd *abfd)
 static int
 cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
 {
-  FILE *f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : 0);
+  FILE *f;
+
+  /* With pread there is no file position to move; bfd_seek records
+     the new position in the BFD.  */
+  if (use_pread (abfd))
+    {
+      if (whence == SEEK_CUR)
+	offset += abfd->where + (abfd->my_archive != NULL ? abfd->origin : 0);
+      if (offset < 0)
+	{
+	  errno = EINVAL;
+	  return -1;
+	}
+      return 0;
+    }
+
+  f = bfd_cache_lookup (abfd, whence != SEEK_CUR ? CACHE_NO_SEEK : 0);
   if (f == NULL)
     return -1;
   return real_fseek (f, offset, whence);
@@ -253,8 +343,12 @@ cache_bseek (struct bfd *abfd, file_ptr offset, int whence)
    contents (0 for non-archive elements).  For archive entries this is the
    first octet in the file, NOT the beginning of the archive header.  */
 
+/* Read NBYTES from ABFD into BUF.  DONE is the number of bytes which
+   have already been read since ABFD's position was last updated.  */
+
 static file_ptr
-cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
+cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes,
+	       file_ptr done ATTRIBUTE_UNUSED)
 {
   FILE *f;
   file_ptr nread;
@@ -274,6 +368,34 @@ cache_bread_1 (struct bfd *abfd, void *buf, file_ptr nbytes)
   if (f == NULL)
     return 0;
 
+#ifdef HAVE_PREAD
+  if (use_pread (abfd))
+    {
+      file_ptr pos = (abfd->where + done
+		      + (abfd->my_archive != NULL ? abfd->origin : 0));
+
+      nread = 0;
+      while (nread < nbytes)
+	{
+	  ssize_t got = pread (fileno (f), (char *) buf + nread,
+			       nbytes - nread, pos + nread);
+	  if (got < 0)
+	    {
+	      if (errno == EINTR)
+		continue;
+	      bfd_set_error (bfd_error_system_call);
+	      return -1;
+	    }
+	  if (got == 0)
+	    break;
+	  nread += got;
+	}
+      if (nread < nbytes)
+	bfd_set_error (bfd_error_file_truncated);
+      return nread;
+    }
+#endif
+
 #if defined (__VAX) && defined (VMS)
   /* Apparently fread on Vax VMS does not keep the record length
      information.  */
@@ -321,7 +443,8 @@ cache_bread (struct bfd *abfd, void *buf, file_ptr nbytes)
       if (chunk_size > max_chunk_size)
         chunk_size = max_chunk_size;
 
-      chunk_nread = cache_bread_1 (abfd, (char *) buf + nread, chunk_size);
+      chunk_nread = cache_bread_1 (abfd, (char *) buf + nread, chunk_size,
+				   nread);
 
       /* Update the nread count.
 
@@ -441,7 +564,7 @@ bfd_boolean
 bfd_cache_init (bfd *abfd)
 {
   BFD_ASSERT (abfd->iostream != NULL);
-  if (open_files >= BFD_CACHE_MAX_OPEN)
+  if (open_files >= bfd_cache_max_open ())
     {
       if (! close_one ())
 	return FALSE;
@@ -508,6 +631,30 @@ bfd_cache_close_all ()
   return ret;
 }
 
+/*
+FUNCTION
+	bfd_cache_get_stats
+
+SYNOPSIS
+	void bfd_cache_get_stats
+	  (unsigned long *hits, unsigned long *misses, int *max_open);
+
+DESCRIPTION
+	Set *@var{hits} to the number of times a file was found open
+	in the cache, *@var{misses} to the number of times it had to
+	be reopened, and *@var{max_open} to the number of files the
+	cache keeps open at most.
+*/
+
+void
+bfd_cache_get_stats (unsigned long *hits, unsigned long *misses,
+		     int *max_open)
+{
+  *hits = cache_hits;
+  *misses = cache_misses;
+  *max_open = bfd_cache_max_open ();
+}
+
 /*
 INTERNAL_FUNCTION
 	bfd_open_file
@@ -528,7 +675,7 @@ bfd_open_file (bfd *abfd)
 {
   abfd->cacheable = TRUE;	/* Allow it to be closed later.  */
 
-  if (open_files >= BFD_CACHE_MAX_OPEN)
+  if (open_files >= bfd_cache_max_open ())
     {
       if (! close_one ())
 	return NULL;
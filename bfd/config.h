@@ -103,6 +103,9 @@
 /* Define to 1 if you have the `getpagesize' function. */
 #define HAVE_GETPAGESIZE 1
 
+/* Define to 1 if you have the `getrlimit' function. */
+#define HAVE_GETRLIMIT 1
+
 /* Define to 1 if you have the `getuid' function. */
 #define HAVE_GETUID 1
 
@@ -136,6 +139,9 @@
 /* Define to 1 if you have the <ndir.h> header file, and it defines `DIR'. */
 /* #undef HAVE_NDIR_H */
 
+/* Define to 1 if you have the `pread' function. */
+#define HAVE_PREAD 1
+
 /* Define if <sys/procfs.h> has prpsinfo32_t. */
 /* #undef HAVE_PRPSINFO32_T */
 
@@ -216,6 +222,9 @@
 /* Define to 1 if you have the <sys/procfs.h> header file. */
 #define HAVE_SYS_PROCFS_H 1
 
+/* Define to 1 if you have the <sys/resource.h> header file. */
+#define HAVE_SYS_RESOURCE_H 1
+
 /* Define to 1 if you have the <sys/stat.h> header file. */
 #define HAVE_SYS_STAT_H 1
 
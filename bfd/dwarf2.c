@@ -116,6 +116,13 @@ struct dwarf2_debug
   /* Pointer to the .debug_abbrev section loaded into memory.  */
   bfd_byte *dwarf_abbrev_buffer;
 
+  /* The bfd_map_section_contents handles for the buffers.  */
+  void *info_ptr_view;
+  void *dwarf_abbrev_view;
+  void *dwarf_line_view;
+  void *dwarf_str_view;
+  void *dwarf_ranges_view;
+
   /* Length of the loaded .debug_abbrev section.  */
   bfd_size_type dwarf_abbrev_size;
 
@@ -169,6 +176,22 @@ struct dwarf2_debug
 #define STASH_INFO_HASH_OFF        0
 #define STASH_INFO_HASH_ON         1
 #define STASH_INFO_HASH_DISABLED   2
+
+  /* Number of comp_units read so far.  */
+  unsigned int num_comp_units;
+
+  /* Number of times find_nearest_line is called.  This is used in
+     the heuristic for building the unit index.  */
+  int unit_index_count;
+
+#define STASH_UNIT_INDEX_TRIGGER   100
+
+  /* The address ranges of all comp_units, sorted by address, or NULL
+     if the index has not been built.  */
+  struct addr_range *unit_index;
+
+  /* Number of entries in UNIT_INDEX.  */
+  unsigned int unit_index_size;
 };
 
 struct arange
@@ -178,6 +201,24 @@ struct arange
   bfd_vma high;
 };
 
+/* An entry in an address index: a table of address ranges sorted by
+   their low address, which lets us find the ranges containing an
+   address without walking every list.  */
+
+struct addr_range
+{
+  bfd_vma low;
+  bfd_vma high;
+  /* The largest HIGH of this entry and all the entries before it.
+     Searching back from the last entry whose LOW is not above an
+     address, we can stop as soon as this is not above the address.  */
+  bfd_vma max_high;
+  /* The order in which the entry was added, to break ties.  */
+  unsigned int order;
+  /* The comp_unit or funcinfo this range belongs to.  */
+  void *data;
+};
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the line number information.  */
 
@@ -252,6 +293,16 @@ struct comp_unit
 
   /* TRUE if symbols are cached in hash table for faster lookup by name.  */
   bfd_boolean cached;
+
+  /* The order in which this unit was read, starting from zero.  */
+  unsigned int unit_number;
+
+  /* The ranges of the functions in FUNCTION_TABLE, sorted by address,
+     or NULL if the index has not been built.  */
+  struct addr_range *function_index;
+
+  /* Number of entries in FUNCTION_INDEX.  */
+  unsigned int function_index_size;
 };
 
 /* This data structure holds the information of an abbrev.  */
@@ -399,10 +450,12 @@ lookup_info_hash_table (struct info_hash_table *hash_table, const char *key)
 }
 
 /* Read a section into its appropriate place in the dwarf2_debug
-   struct (indicated by SECTION_BUFFER and SECTION_SIZE).  If SYMS is
-   not NULL, use bfd_simple_get_relocated_section_contents to read the
-   section contents, otherwise use bfd_get_section_contents.  Fail if
-   the located section does not contain at least OFFSET bytes.  */
+   struct (indicated by SECTION_BUFFER, SECTION_VIEW and SECTION_SIZE).
+   If SYMS is not NULL and the section needs relocating, use
+   bfd_simple_get_relocated_section_contents to read the section
+   contents, otherwise use bfd_map_section_contents.  The buffer is
+   released with bfd_unmap_section_contents.  Fail if the located
+   section does not contain at least OFFSET bytes.  */
 
 static bfd_boolean
 read_section (bfd *           abfd,
@@ -411,6 +464,7 @@ read_section (bfd *           abfd,
 	      asymbol **      syms,
 	      bfd_uint64_t    offset,
 	      bfd_byte **     section_buffer,
+	      void **         section_view,
 	      bfd_size_type * section_size)
 {
   asection *msec;
@@ -433,20 +487,27 @@ read_section (bfd *           abfd,
 	}
 
       *section_size = msec->rawsize ? msec->rawsize : msec->size;
-      if (syms)
+      *section_view = NULL;
+      if (syms
+	  && (abfd->flags & (HAS_RELOC | EXEC_P | DYNAMIC)) == HAS_RELOC
+	  && (msec->flags & SEC_RELOC) != 0)
 	{
 	  *section_buffer
 	      = bfd_simple_get_relocated_section_contents (abfd, msec, NULL, syms);
 	  if (! *section_buffer)
 	    return FALSE;
 	}
-      else
+      else if (section_is_compressed)
 	{
-	  *section_buffer = bfd_malloc (*section_size);
-	  if (! *section_buffer)
+	  /* bfd_uncompress_section_contents replaces the buffer, so it
+	     must be a malloc'd copy.  */
+	  if (! bfd_malloc_and_get_section (abfd, msec, section_buffer))
 	    return FALSE;
-	  if (! bfd_get_section_contents (abfd, msec, *section_buffer,
-					  0, *section_size))
+	}
+      else
+	{
+	  if (! bfd_map_section_contents (abfd, msec, section_buffer,
+					  section_view))
 	    return FALSE;
 	}
 
@@ -556,7 +617,8 @@ read_indirect_string (struct comp_unit * unit,
 
   if (! read_section (unit->abfd, ".debug_str", ".zdebug_str",
 		      stash->syms, offset,
-		      &stash->dwarf_str_buffer, &stash->dwarf_str_size))
+		      &stash->dwarf_str_buffer, &stash->dwarf_str_view,
+		      &stash->dwarf_str_size))
     return NULL;
 
   str = (char *) stash->dwarf_str_buffer + offset;
@@ -639,7 +701,8 @@ read_abbrevs (bfd *abfd, bfd_uint64_t offset, struct dwarf2_debug *stash)
 
   if (! read_section (abfd, ".debug_abbrev", ".zdebug_abbrev",
 		      stash->syms, offset,
-		      &stash->dwarf_abbrev_buffer, &stash->dwarf_abbrev_size))
+		      &stash->dwarf_abbrev_buffer, &stash->dwarf_abbrev_view,
+		      &stash->dwarf_abbrev_size))
     return 0;
 
   amt = sizeof (struct abbrev_info*) * ABBREV_HASH_SIZE;
@@ -915,6 +978,9 @@ struct line_info_table
   struct fileinfo* files;
   struct line_info* last_line;  /* largest VMA */
   struct line_info* lcl_head;   /* local head; used in 'add_line_info' */
+  /* The lines in order of increasing VMA, built on the first lookup.  */
+  struct line_info** sorted_lines;
+  unsigned int num_sorted_lines;
 };
 
 /* Remember some information about each function.  If the function is
@@ -1166,6 +1232,62 @@ arange_add (bfd *abfd, struct arange *first_arange, bfd_vma low_pc, bfd_vma high
   first_arange->next = arange;
 }
 
+/* Compare two entries of an address index, for qsort.  */
+
+static int
+compare_addr_ranges (const void *a, const void *b)
+{
+  const struct addr_range *r1 = a;
+  const struct addr_range *r2 = b;
+
+  if (r1->low != r2->low)
+    return r1->low < r2->low ? -1 : 1;
+  if (r1->order != r2->order)
+    return r1->order < r2->order ? -1 : 1;
+  return 0;
+}
+
+/* Sort the COUNT entries of the address index TABLE and set their
+   max_high fields.  */
+
+static void
+sort_addr_index (struct addr_range *table, unsigned int count)
+{
+  bfd_vma max_high = 0;
+  unsigned int i;
+
+  qsort (table, count, sizeof (*table), compare_addr_ranges);
+  for (i = 0; i < count; i++)
+    {
+      if (table[i].high > max_high)
+	max_high = table[i].high;
+      table[i].max_high = max_high;
+    }
+}
+
+/* Return the number of entries of the address index TABLE whose low
+   address is not above ADDR.  The entries containing ADDR are found
+   by searching back from there while max_high is above ADDR.  */
+
+static unsigned int
+addr_index_upper_bound (const struct addr_range *table, unsigned int count,
+			bfd_vma addr)
+{
+  unsigned int lo = 0;
+  unsigned int hi = count;
+
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      if (table[mid].low <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  return lo;
+}
+
 /* Decode the line number information for UNIT.  */
 
 static struct line_info_table*
@@ -1183,7 +1305,8 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
 
   if (! read_section (abfd, ".debug_line", ".zdebug_line",
 		      stash->syms, unit->line_offset,
-		      &stash->dwarf_line_buffer, &stash->dwarf_line_size))
+		      &stash->dwarf_line_buffer, &stash->dwarf_line_view,
+		      &stash->dwarf_line_size))
     return 0;
 
   amt = sizeof (struct line_info_table);
@@ -1200,6 +1323,8 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
   table->files = NULL;
   table->last_line = NULL;
   table->lcl_head = NULL;
+  table->sorted_lines = NULL;
+  table->num_sorted_lines = 0;
 
   line_ptr = stash->dwarf_line_buffer + unit->line_offset;
 
@@ -1485,6 +1610,34 @@ decode_line_info (struct comp_unit *unit, struct dwarf2_debug *stash)
   return table;
 }
 
+/* Build the array of the lines in TABLE in order of increasing VMA.
+   Return FALSE if we run out of memory.  */
+
+static bfd_boolean
+build_sorted_lines (struct line_info_table *table)
+{
+  struct line_info* each_line;
+  unsigned int count = 0;
+  bfd_size_type amt;
+
+  for (each_line = table->last_line;
+       each_line;
+       each_line = each_line->prev_line)
+    count++;
+
+  amt = count * sizeof (struct line_info *);
+  table->sorted_lines = bfd_alloc (table->abfd, amt);
+  if (table->sorted_lines == NULL)
+    return FALSE;
+
+  table->num_sorted_lines = count;
+  for (each_line = table->last_line;
+       each_line;
+       each_line = each_line->prev_line)
+    table->sorted_lines[--count] = each_line;
+  return TRUE;
+}
+
 /* If ADDR is within TABLE set the output parameters and return TRUE,
    otherwise return FALSE.  The output parameters, FILENAME_PTR and
    LINENUMBER_PTR, are pointers to the objects to be filled in.  */
@@ -1496,63 +1649,68 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 				   const char **filename_ptr,
 				   unsigned int *linenumber_ptr)
 {
-  /* Note: table->last_line should be a descendingly sorted list. */
-  struct line_info* next_line = table->last_line;
-  struct line_info* each_line = NULL;
+  struct line_info** lines;
+  struct line_info* next_line;
+  struct line_info* each_line;
+  unsigned int count;
+  unsigned int lo, hi;
+
   *filename_ptr = NULL;
 
-  if (!next_line)
+  if (!table->last_line)
     return FALSE;
 
-  each_line = next_line->prev_line;
+  if (!table->sorted_lines && !build_sorted_lines (table))
+    return FALSE;
 
-  /* Check for large addresses */
-  if (addr > next_line->address)
-    each_line = NULL; /* ensure we skip over the normal case */
+  lines = table->sorted_lines;
+  count = table->num_sorted_lines;
 
-  /* Normal case: search the list; save  */
-  while (each_line && next_line)
+  /* Find the last line whose VMA is not above ADDR.  ADDR lies
+     between it and the next line.  */
+  lo = 0;
+  hi = count;
+  while (lo < hi)
     {
-      /* If we have an address match, save this info.  This allows us
-	 to return as good as results as possible for strange debugging
-	 info.  */
-      bfd_boolean addr_match = FALSE;
-      if (each_line->address <= addr && addr < next_line->address)
-	{
-	  addr_match = TRUE;
+      unsigned int mid = lo + (hi - lo) / 2;
 
-	  /* If this line appears to span functions, and addr is in the
-	     later function, return the first line of that function instead
-	     of the last line of the earlier one.  This check is for GCC
-	     2.95, which emits the first line number for a function late.  */
+      if (lines[mid]->address <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
 
-	  if (function != NULL)
+  if (lo > 0 && lo < count)
+    {
+      each_line = lines[lo - 1];
+      next_line = lines[lo];
+
+      /* If this line appears to span functions, and addr is in the
+	 later function, return the first line of that function instead
+	 of the last line of the earlier one.  This check is for GCC
+	 2.95, which emits the first line number for a function late.  */
+
+      if (function != NULL)
+	{
+	  bfd_vma lowest_pc;
+	  struct arange *arange;
+
+	  /* Find the lowest address in the function's range list */
+	  lowest_pc = function->arange.low;
+	  for (arange = &function->arange;
+	       arange;
+	       arange = arange->next)
 	    {
-	      bfd_vma lowest_pc;
-	      struct arange *arange;
-
-	      /* Find the lowest address in the function's range list */
-	      lowest_pc = function->arange.low;
-	      for (arange = &function->arange;
-		   arange;
-		   arange = arange->next)
-		{
-		  if (function->arange.low < lowest_pc)
-		    lowest_pc = function->arange.low;
-		}
-	      /* Check for spanning function and set outgoing line info */
-	      if (addr >= lowest_pc
-		  && each_line->address < lowest_pc
-		  && next_line->address > lowest_pc)
-		{
-		  *filename_ptr = next_line->filename;
-		  *linenumber_ptr = next_line->line;
-		}
-	      else
-		{
-		  *filename_ptr = each_line->filename;
-		  *linenumber_ptr = each_line->line;
-		}
+	      if (function->arange.low < lowest_pc)
+		lowest_pc = function->arange.low;
+	    }
+	  /* Check for spanning function and set outgoing line info */
+	  if (addr >= lowest_pc
+	      && each_line->address < lowest_pc
+	      && next_line->address > lowest_pc)
+	    {
+	      *filename_ptr = next_line->filename;
+	      *linenumber_ptr = next_line->line;
 	    }
 	  else
 	    {
@@ -1560,22 +1718,28 @@ lookup_address_in_line_info_table (struct line_info_table *table,
 	      *linenumber_ptr = each_line->line;
 	    }
 	}
+      else
+	{
+	  *filename_ptr = each_line->filename;
+	  *linenumber_ptr = each_line->line;
+	}
 
-      if (addr_match && !each_line->end_sequence)
+      if (!each_line->end_sequence)
 	return TRUE; /* we have definitely found what we want */
-
-      next_line = each_line;
-      each_line = each_line->prev_line;
     }
 
-  /* At this point each_line is NULL but next_line is not.  If we found
-     a candidate end-of-sequence point in the loop above, we can return
-     that (compatibility with a bug in the Intel compiler); otherwise,
-     assuming that we found the containing function for this address in
-     this compilation unit, return the first line we have a number for
-     (compatibility with GCC 2.95).  */
+  /* If we found a candidate end-of-sequence point above, we can
+     return that (compatibility with a bug in the Intel compiler);
+     otherwise, assuming that we found the containing function for
+     this address in this compilation unit, return the first line we
+     have a number for (compatibility with GCC 2.95).  For an address
+     above all the lines, that is the last line.  */
   if (*filename_ptr == NULL && function != NULL)
     {
+      if (addr > lines[count - 1]->address)
+	next_line = lines[count - 1];
+      else
+	next_line = lines[0];
       *filename_ptr = next_line->filename;
       *linenumber_ptr = next_line->line;
       return TRUE;
@@ -1592,15 +1756,64 @@ read_debug_ranges (struct comp_unit *unit)
   struct dwarf2_debug *stash = unit->stash;
   return read_section (unit->abfd, ".debug_ranges", ".zdebug_ranges",
 		       stash->syms, 0,
-		       &stash->dwarf_ranges_buffer, &stash->dwarf_ranges_size);
+		       &stash->dwarf_ranges_buffer, &stash->dwarf_ranges_view,
+		       &stash->dwarf_ranges_size);
 }
 
 /* Function table functions.  */
 
+/* Build the index of the address ranges of the functions of UNIT.
+   Return FALSE if we run out of memory.  */
+
+static bfd_boolean
+build_function_index (struct comp_unit *unit)
+{
+  struct funcinfo* each_func;
+  struct arange *arange;
+  struct addr_range *table;
+  unsigned int count = 0;
+  bfd_size_type amt;
+
+  for (each_func = unit->function_table;
+       each_func;
+       each_func = each_func->prev_func)
+    for (arange = &each_func->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	count++;
+
+  /* Allocate at least one entry, so that an empty index is not
+     mistaken for one which has not been built.  */
+  amt = (count > 0 ? count : 1) * sizeof (struct addr_range);
+  table = bfd_alloc (unit->abfd, amt);
+  if (table == NULL)
+    return FALSE;
+
+  count = 0;
+  for (each_func = unit->function_table;
+       each_func;
+       each_func = each_func->prev_func)
+    for (arange = &each_func->arange; arange; arange = arange->next)
+      if (arange->low < arange->high)
+	{
+	  table[count].low = arange->low;
+	  table[count].high = arange->high;
+	  table[count].order = count;
+	  table[count].data = each_func;
+	  count++;
+	}
+
+  sort_addr_index (table, count);
+  unit->function_index = table;
+  unit->function_index_size = count;
+  return TRUE;
+}
+
 /* If ADDR is within TABLE, set FUNCTIONNAME_PTR, and return TRUE.
    Note that we need to find the function that has the smallest
    range that contains ADDR, to handle inlined functions without
-   depending upon them being ordered in TABLE by increasing range. */
+   depending upon them being ordered in TABLE by increasing range.
+   Of two ranges of the same size, we take the one which comes first
+   in TABLE.  */
 
 static bfd_boolean
 lookup_address_in_function_table (struct comp_unit *unit,
@@ -1608,31 +1821,34 @@ lookup_address_in_function_table (struct comp_unit *unit,
 				  struct funcinfo **function_ptr,
 				  const char **functionname_ptr)
 {
-  struct funcinfo* each_func;
-  struct funcinfo* best_fit = NULL;
-  struct arange *arange;
+  struct addr_range *table;
+  struct addr_range *best_fit = NULL;
+  unsigned int i;
 
-  for (each_func = unit->function_table;
-       each_func;
-       each_func = each_func->prev_func)
+  if (!unit->function_index && !build_function_index (unit))
+    return FALSE;
+
+  table = unit->function_index;
+  for (i = addr_index_upper_bound (table, unit->function_index_size, addr);
+       i > 0 && table[i - 1].max_high > addr;
+       i--)
     {
-      for (arange = &each_func->arange;
-	   arange;
-	   arange = arange->next)
-	{
-	  if (addr >= arange->low && addr < arange->high)
-	    {
-	      if (!best_fit ||
-		  ((arange->high - arange->low) < (best_fit->arange.high - best_fit->arange.low)))
-		best_fit = each_func;
-	    }
-	}
+      struct addr_range *range = &table[i - 1];
+
+      if (addr < range->high
+	  && (!best_fit
+	      || range->high - range->low < best_fit->high - best_fit->low
+	      || (range->high - range->low == best_fit->high - best_fit->low
+		  && range->order < best_fit->order)))
+	best_fit = range;
     }
 
   if (best_fit)
     {
-      *functionname_ptr = best_fit->name;
-      *function_ptr = best_fit;
+      struct funcinfo *function = best_fit->data;
+
+      *functionname_ptr = function->name;
+      *function_ptr = function;
       return TRUE;
     }
   else
@@ -2851,6 +3067,350 @@ stash_find_line_fast (struct dwarf2_debug *stash,
 				   filename_ptr, linenumber_ptr);
 }
 
+/* Read the header of the next compilation unit in the .debug_info
+   buffer of STASH and add the unit to the list of units.  Set
+   *UNIT_PTR to the unit, or to NULL if the unit is empty.  Return
+   FALSE if the debugging information is damaged.  ADDR_SIZE is as
+   for find_line.  */
+
+static bfd_boolean
+read_next_comp_unit (struct dwarf2_debug *stash,
+		     unsigned int addr_size,
+		     struct comp_unit **unit_ptr)
+{
+  bfd_vma length;
+  unsigned int offset_size = addr_size;
+  bfd_byte *info_ptr_unit = stash->info_ptr;
+  struct comp_unit *each;
+
+  *unit_ptr = NULL;
+
+  /* If the previous unit was the last one in its section, move on
+     to the next section.  */
+  while (stash->sec != NULL
+	 && ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr)
+	     == stash->sec->size))
+    {
+      stash->sec = find_debug_info (stash->bfd, stash->sec);
+      stash->sec_info_ptr = stash->info_ptr;
+    }
+
+  length = read_4_bytes (stash->bfd, stash->info_ptr);
+  /* A 0xffffff length is the DWARF3 way of indicating
+     we use 64-bit offsets, instead of 32-bit offsets.  */
+  if (length == 0xffffffff)
+    {
+      offset_size = 8;
+      length = read_8_bytes (stash->bfd, stash->info_ptr + 4);
+      stash->info_ptr += 12;
+    }
+  /* A zero length is the IRIX way of indicating 64-bit offsets,
+     mostly because the 64-bit length will generally fit in 32
+     bits, and the endianness helps.  */
+  else if (length == 0)
+    {
+      offset_size = 8;
+      length = read_4_bytes (stash->bfd, stash->info_ptr + 4);
+      stash->info_ptr += 8;
+    }
+  /* In the absence of the hints above, we assume 32-bit DWARF2
+     offsets even for targets with 64-bit addresses, because:
+       a) most of the time these targets will not have generated
+	  more than 2Gb of debug info and so will not need 64-bit
+	  offsets,
+     and
+       b) if they do use 64-bit offsets but they are not using
+	  the size hints that are tested for above then they are
+	  not conforming to the DWARF3 standard anyway.  */
+  else if (addr_size == 8)
+    {
+      offset_size = 4;
+      stash->info_ptr += 4;
+    }
+  else
+    stash->info_ptr += 4;
+
+  if (length == 0)
+    return TRUE;
+
+  each = parse_comp_unit (stash, length, info_ptr_unit, offset_size);
+  if (!each)
+    /* The dwarf information is damaged, don't trust it any
+       more.  */
+    return FALSE;
+  stash->info_ptr += length;
+
+  each->unit_number = stash->num_comp_units++;
+
+  if (stash->all_comp_units)
+    stash->all_comp_units->prev_unit = each;
+  else
+    stash->last_comp_unit = each;
+
+  each->next_unit = stash->all_comp_units;
+  stash->all_comp_units = each;
+
+  *unit_ptr = each;
+  return TRUE;
+}
+
+/* Add an entry for UNIT covering LOW to HIGH to the unit index of
+   STASH, growing it if needed.  *ALLOCATED is the number of entries
+   allocated.  Return FALSE if we run out of memory.  */
+
+static bfd_boolean
+add_unit_range (struct dwarf2_debug *stash,
+		unsigned int *allocated,
+		struct comp_unit *unit,
+		bfd_vma low,
+		bfd_vma high)
+{
+  struct addr_range *range;
+
+  if (low >= high)
+    return TRUE;
+
+  if (stash->unit_index_size >= *allocated)
+    {
+      unsigned int new_allocated = *allocated ? *allocated * 2 : 64;
+      struct addr_range *tmp;
+
+      tmp = bfd_realloc (stash->unit_index,
+			 new_allocated * sizeof (struct addr_range));
+      if (tmp == NULL)
+	return FALSE;
+      stash->unit_index = tmp;
+      *allocated = new_allocated;
+    }
+
+  range = &stash->unit_index[stash->unit_index_size];
+  range->low = low;
+  range->high = high;
+  range->order = stash->unit_index_size;
+  range->data = unit;
+  stash->unit_index_size++;
+  return TRUE;
+}
+
+/* Add the address ranges listed in the .debug_aranges section of
+   the debug bfd of STASH to its unit index.  UNITS is the array of
+   all the units in the order they were read, which is also the
+   order of their offsets.  Return FALSE if we run out of memory;
+   damaged sets are just skipped.  */
+
+static bfd_boolean
+add_debug_aranges (struct dwarf2_debug *stash,
+		   struct comp_unit **units,
+		   unsigned int *allocated)
+{
+  bfd *abfd = stash->bfd;
+  bfd_byte *buffer = NULL;
+  void *view = NULL;
+  bfd_size_type size = 0;
+  bfd_byte *ptr;
+  bfd_byte *end;
+  bfd_boolean ret = TRUE;
+
+  if (! read_section (abfd, ".debug_aranges", NULL, NULL, 0,
+		      &buffer, &view, &size))
+    {
+      bfd_unmap_section_contents (buffer, view);
+      return TRUE;
+    }
+
+  ptr = buffer;
+  end = buffer + size;
+  while (ret && end - ptr >= 4)
+    {
+      bfd_byte *set_start = ptr;
+      bfd_byte *set_end;
+      bfd_vma length;
+      bfd_uint64_t info_offset;
+      unsigned int offset_size = 4;
+      unsigned int version, addr_size, segment_size, tuple_size;
+      unsigned int lo, hi;
+      struct comp_unit *unit;
+
+      length = read_4_bytes (abfd, ptr);
+      ptr += 4;
+      if (length == 0xffffffff)
+	{
+	  if (end - ptr < 8)
+	    break;
+	  length = read_8_bytes (abfd, ptr);
+	  ptr += 8;
+	  offset_size = 8;
+	}
+      if (length > (bfd_vma) (end - ptr) || length < 4 + offset_size)
+	break;
+      set_end = ptr + length;
+
+      version = read_2_bytes (abfd, ptr);
+      ptr += 2;
+      if (offset_size == 4)
+	info_offset = read_4_bytes (abfd, ptr);
+      else
+	info_offset = read_8_bytes (abfd, ptr);
+      ptr += offset_size;
+      addr_size = read_1_byte (abfd, ptr);
+      segment_size = read_1_byte (abfd, ptr + 1);
+      ptr += 2;
+
+      /* Find the unit the set describes.  */
+      lo = 0;
+      hi = stash->num_comp_units;
+      while (lo < hi)
+	{
+	  unsigned int mid = lo + (hi - lo) / 2;
+	  bfd_uint64_t offset;
+
+	  offset = units[mid]->info_ptr_unit - stash->info_ptr_memory;
+
+	  if (offset < info_offset)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      unit = NULL;
+      if (lo < stash->num_comp_units
+	  && (bfd_uint64_t) (units[lo]->info_ptr_unit
+			     - stash->info_ptr_memory) == info_offset)
+	unit = units[lo];
+
+      if (version == 2
+	  && segment_size == 0
+	  && unit != NULL
+	  && addr_size == unit->addr_size)
+	{
+	  /* The tuples are aligned to twice the address size, counting
+	     from the start of the set.  */
+	  tuple_size = 2 * addr_size;
+	  ptr = set_start + ((ptr - set_start + tuple_size - 1)
+			     / tuple_size * tuple_size);
+	  while (ret && set_end - ptr >= (bfd_signed_vma) tuple_size)
+	    {
+	      bfd_vma low = read_address (unit, ptr);
+	      bfd_vma range_length = read_address (unit, ptr + addr_size);
+
+	      ptr += tuple_size;
+	      if (low == 0 && range_length == 0)
+		break;
+	      ret = add_unit_range (stash, allocated, unit, low,
+				    low + range_length);
+	    }
+	}
+
+      ptr = set_end;
+    }
+
+  bfd_unmap_section_contents (buffer, view);
+  return ret;
+}
+
+/* Read the rest of the compilation unit headers of STASH and build
+   the sorted index of the address ranges of all its units.  The
+   ranges come from the units themselves and, for a final link with a
+   single .debug_info section, from .debug_aranges, which can also
+   describe units whose DIEs give no address range.  If anything goes
+   wrong we do without the index.  ADDR_SIZE is as for find_line.  */
+
+static void
+stash_build_unit_index (struct dwarf2_debug *stash, unsigned int addr_size)
+{
+  struct comp_unit *each;
+  struct comp_unit **units = NULL;
+  struct arange *arange;
+  unsigned int allocated = 0;
+  asection *msec;
+
+  while (stash->info_ptr < stash->info_ptr_end)
+    if (! read_next_comp_unit (stash, addr_size, &each))
+      break;
+
+  if (stash->num_comp_units == 0)
+    return;
+
+  for (each = stash->all_comp_units; each; each = each->next_unit)
+    for (arange = &each->arange; arange; arange = arange->next)
+      if (! add_unit_range (stash, &allocated, each, arange->low,
+			    arange->high))
+	goto fail;
+
+  msec = find_debug_info (stash->bfd, NULL);
+  if ((stash->bfd->flags & (EXEC_P | DYNAMIC)) != 0
+      && msec != NULL
+      && find_debug_info (stash->bfd, msec) == NULL
+      && bfd_get_section_by_name (stash->bfd, ".debug_aranges") != NULL)
+    {
+      units = bfd_malloc (stash->num_comp_units * sizeof (*units));
+      if (units == NULL)
+	goto fail;
+      for (each = stash->all_comp_units; each; each = each->next_unit)
+	units[each->unit_number] = each;
+      if (! add_debug_aranges (stash, units, &allocated))
+	goto fail;
+      free (units);
+    }
+
+  if (stash->unit_index == NULL)
+    goto fail;
+  sort_addr_index (stash->unit_index, stash->unit_index_size);
+  return;
+
+ fail:
+  if (units)
+    free (units);
+  if (stash->unit_index)
+    free (stash->unit_index);
+  stash->unit_index = NULL;
+  stash->unit_index_size = 0;
+}
+
+/* Look up ADDR in the unit index of STASH.  The units containing ADDR
+   are tried in the same order as the list of units, most recently
+   read first.  The parameters and return value are as for
+   comp_unit_find_nearest_line.  */
+
+static bfd_boolean
+stash_find_nearest_line_fast (struct dwarf2_debug *stash,
+			      bfd_vma addr,
+			      const char **filename_ptr,
+			      const char **functionname_ptr,
+			      unsigned int *linenumber_ptr)
+{
+  struct addr_range *table = stash->unit_index;
+  unsigned int first = addr_index_upper_bound (table, stash->unit_index_size,
+					       addr);
+  unsigned int bound = stash->num_comp_units;
+
+  for (;;)
+    {
+      struct comp_unit *next = NULL;
+      unsigned int i;
+
+      for (i = first; i > 0 && table[i - 1].max_high > addr; i--)
+	{
+	  struct comp_unit *unit = table[i - 1].data;
+
+	  if (addr < table[i - 1].high
+	      && unit->unit_number < bound
+	      && (!next || unit->unit_number > next->unit_number))
+	    next = unit;
+	}
+
+      if (!next)
+	return FALSE;
+
+      if (!next->error
+	  && comp_unit_find_nearest_line (next, addr, filename_ptr,
+					  functionname_ptr, linenumber_ptr,
+					  stash))
+	return TRUE;
+
+      bound = next->unit_number;
+    }
+}
+
 /* Find the source code location of SYMBOL.  If SYMBOL is NULL
    then find the nearest source code location corresponding to
    the address SECTION + OFFSET.
@@ -2984,7 +3544,8 @@ find_line (bfd *abfd,
 	  total_size = msec->size;
 	  if (! read_section (debug_bfd, ".debug_info", ".zdebug_info",
 			      symbols, 0,
-			      &stash->info_ptr_memory, &total_size))
+			      &stash->info_ptr_memory, &stash->info_ptr_view,
+			      &total_size))
 	    goto done;
 	}
       else
@@ -3074,6 +3635,13 @@ find_line (bfd *abfd,
 
   stash->inliner_chain = NULL;
 
+  /* The DWARF2 spec says that the initial length field, and the
+     offset of the abbreviation table, should both be 4-byte values.
+     However, some compilers do things differently.  */
+  if (addr_size == 0)
+    addr_size = 4;
+  BFD_ASSERT (addr_size == 4 || addr_size == 8);
+
   /* Check the previously read comp. units first.  */
   if (do_line)
     {
@@ -3111,86 +3679,47 @@ find_line (bfd *abfd,
     }
   else
     {
-      for (each = stash->all_comp_units; each; each = each->next_unit)
+      /* Once we have been asked about enough addresses, it pays to
+	 read all the unit headers and index their address ranges,
+	 rather than trying each unit in turn.  */
+      if (stash->unit_index == NULL)
+	{
+	  if (stash->unit_index_count < STASH_UNIT_INDEX_TRIGGER)
+	    stash->unit_index_count++;
+	  else
+	    stash_build_unit_index (stash, addr_size);
+	}
+
+      if (stash->unit_index != NULL)
 	{
-	  found = (comp_unit_contains_address (each, addr)
-		   && comp_unit_find_nearest_line (each, addr,
-						   filename_ptr,
-						   functionname_ptr,
-						   linenumber_ptr,
-						   stash));
+	  found = stash_find_nearest_line_fast (stash, addr, filename_ptr,
+						functionname_ptr,
+						linenumber_ptr);
 	  if (found)
 	    goto done;
 	}
+      else
+	for (each = stash->all_comp_units; each; each = each->next_unit)
+	  {
+	    found = (comp_unit_contains_address (each, addr)
+		     && comp_unit_find_nearest_line (each, addr,
+						     filename_ptr,
+						     functionname_ptr,
+						     linenumber_ptr,
+						     stash));
+	    if (found)
+	      goto done;
+	  }
     }
 
-  /* The DWARF2 spec says that the initial length field, and the
-     offset of the abbreviation table, should both be 4-byte values.
-     However, some compilers do things differently.  */
-  if (addr_size == 0)
-    addr_size = 4;
-  BFD_ASSERT (addr_size == 4 || addr_size == 8);
-
   /* Read each remaining comp. units checking each as they are read.  */
   while (stash->info_ptr < stash->info_ptr_end)
     {
-      bfd_vma length;
-      unsigned int offset_size = addr_size;
-      bfd_byte *info_ptr_unit = stash->info_ptr;
-
-      length = read_4_bytes (stash->bfd, stash->info_ptr);
-      /* A 0xffffff length is the DWARF3 way of indicating
-	 we use 64-bit offsets, instead of 32-bit offsets.  */
-      if (length == 0xffffffff)
-	{
-	  offset_size = 8;
-	  length = read_8_bytes (stash->bfd, stash->info_ptr + 4);
-	  stash->info_ptr += 12;
-	}
-      /* A zero length is the IRIX way of indicating 64-bit offsets,
-	 mostly because the 64-bit length will generally fit in 32
-	 bits, and the endianness helps.  */
-      else if (length == 0)
-	{
-	  offset_size = 8;
-	  length = read_4_bytes (stash->bfd, stash->info_ptr + 4);
-	  stash->info_ptr += 8;
-	}
-      /* In the absence of the hints above, we assume 32-bit DWARF2
-	 offsets even for targets with 64-bit addresses, because:
-	   a) most of the time these targets will not have generated
-	      more than 2Gb of debug info and so will not need 64-bit
-	      offsets,
-	 and
-	   b) if they do use 64-bit offsets but they are not using
-	      the size hints that are tested for above then they are
-	      not conforming to the DWARF3 standard anyway.  */
-      else if (addr_size == 8)
-	{
-	  offset_size = 4;
-	  stash->info_ptr += 4;
-	}
-      else
-	stash->info_ptr += 4;
+      if (! read_next_comp_unit (stash, addr_size, &each))
+	break;
 
-      if (length > 0)
+      if (each)
 	{
-	  each = parse_comp_unit (stash, length, info_ptr_unit,
-				  offset_size);
-	  if (!each)
-	    /* The dwarf information is damaged, don't trust it any
-	       more.  */
-	    break;
-	  stash->info_ptr += length;
-
-	  if (stash->all_comp_units)
-	    stash->all_comp_units->prev_unit = each;
-	  else
-	    stash->last_comp_unit = each;
-	  
-	  each->next_unit = stash->all_comp_units;
-	  stash->all_comp_units = each;
-	  
 	  /* DW_AT_low_pc and DW_AT_high_pc are optional for
 	     compilation units.  If we don't have them (i.e.,
 	     unit->high == 0), we need to consult the line info table
@@ -3213,13 +3742,6 @@ find_line (bfd *abfd,
 						     linenumber_ptr,
 						     stash));
 
-	  if ((bfd_vma) (stash->info_ptr - stash->sec_info_ptr)
-	      == stash->sec->size)
-	    {
-	      stash->sec = find_debug_info (stash->bfd, stash->sec);
-	      stash->sec_info_ptr = stash->info_ptr;
-	    }
-
 	  if (found)
 	    goto done;
 	}
@@ -3361,14 +3883,16 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd)
 	}
     }
 
-  if (stash->dwarf_abbrev_buffer)
-    free (stash->dwarf_abbrev_buffer);
-  if (stash->dwarf_line_buffer)
-    free (stash->dwarf_line_buffer);
-  if (stash->dwarf_str_buffer)
-    free (stash->dwarf_str_buffer);
-  if (stash->dwarf_ranges_buffer)
-    free (stash->dwarf_ranges_buffer);
-  if (stash->info_ptr_memory)
-    free (stash->info_ptr_memory);
+  bfd_unmap_section_contents (stash->dwarf_abbrev_buffer,
+			      stash->dwarf_abbrev_view);
+  bfd_unmap_section_contents (stash->dwarf_line_buffer,
+			      stash->dwarf_line_view);
+  bfd_unmap_section_contents (stash->dwarf_str_buffer,
+			      stash->dwarf_str_view);
+  bfd_unmap_section_contents (stash->dwarf_ranges_buffer,
+			      stash->dwarf_ranges_view);
+  bfd_unmap_section_contents (stash->info_ptr_memory,
+			      stash->info_ptr_view);
+  if (stash->unit_index)
+    free (stash->unit_index);
 }
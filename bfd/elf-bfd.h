@@ -1505,6 +1505,13 @@ struct elf_obj_tdata
   /* A place to stash dwarf2 info for this bfd.  */
   void *dwarf2_find_line_info;
 
+  /* The sorted table of function symbols used by elf_find_function.  */
+  struct elf_function_index *function_index;
+
+  /* String tables mapped by bfd_elf_get_str_section, to be unmapped
+     when the bfd is closed.  */
+  struct elf_mapped_view *mapped_views;
+
   /* An array of stub sections indexed by symbol number, used by the
      MIPS ELF linker.  FIXME: We should figure out some way to only
      include this field for a MIPS ELF target.  */
@@ -259,6 +259,14 @@ bfd_elf_mkcorefile (bfd *abfd)
   return bfd_elf_make_generic_object (abfd);
 }
 
+/* A string table mapped by bfd_elf_get_str_section.  */
+
+struct elf_mapped_view
+{
+  struct elf_mapped_view *next;
+  void *view;
+};
+
 static char *
 bfd_elf_get_str_section (bfd *abfd, unsigned int shindex)
 {
@@ -266,6 +274,7 @@ bfd_elf_get_str_section (bfd *abfd, unsigned int shindex)
   bfd_byte *shstrtab = NULL;
   file_ptr offset;
   bfd_size_type shstrtabsize;
+  void *view;
 
   i_shdrp = elf_elfsections (abfd);
   if (i_shdrp == 0
@@ -280,6 +289,27 @@ bfd_elf_get_str_section (bfd *abfd, unsigned int shindex)
       offset = i_shdrp[shindex]->sh_offset;
       shstrtabsize = i_shdrp[shindex]->sh_size;
 
+      /* Large string tables are mapped rather than copied, provided
+	 that they are terminated.  */
+      view = _bfd_mmap_readonly (abfd, offset, shstrtabsize, &shstrtab);
+      if (view != NULL)
+	{
+	  struct elf_mapped_view *mapped = NULL;
+
+	  if (shstrtab[shstrtabsize - 1] == '\0')
+	    mapped = bfd_alloc (abfd, sizeof (struct elf_mapped_view));
+	  if (mapped != NULL)
+	    {
+	      mapped->view = view;
+	      mapped->next = elf_tdata (abfd)->mapped_views;
+	      elf_tdata (abfd)->mapped_views = mapped;
+	      i_shdrp[shindex]->contents = shstrtab;
+	      return (char *) shstrtab;
+	    }
+	  _bfd_munmap_readonly (view);
+	  shstrtab = NULL;
+	}
+
       /* Allocate and clear an extra byte at the end, to prevent crashes
 	 in case the string table is not terminated.  */
       if (shstrtabsize + 1 <= 1
@@ -7027,21 +7057,58 @@ _bfd_elf_set_arch_mach (bfd *abfd,
   return bfd_default_set_arch_mach (abfd, arch, machine);
 }
 
-/* Find the function to a particular section and offset,
-   for error reporting.  */
+/* An entry in the table of function symbols used by
+   elf_find_function.  */
 
-static bfd_boolean
-elf_find_function (bfd *abfd,
-		   asection *section,
-		   asymbol **symbols,
-		   bfd_vma offset,
-		   const char **filename_ptr,
-		   const char **functionname_ptr)
+struct elf_function_entry
 {
+  asection *section;
+  bfd_vma value;
+  /* The position of the symbol in the symbol table.  */
+  unsigned int order;
+  asymbol *func;
   const char *filename;
-  asymbol *func, *file;
-  bfd_vma low_func;
+};
+
+/* The table of function symbols used by elf_find_function, sorted by
+   section, value and position in the symbol table.  */
+
+struct elf_function_index
+{
+  /* The symbol table the table was built from.  */
+  asymbol **symbols;
+  unsigned int count;
+  struct elf_function_entry *entries;
+};
+
+/* Compare two elf_function_entry structures, for qsort.  */
+
+static int
+elf_function_entry_compare (const void *a, const void *b)
+{
+  const struct elf_function_entry *e1 = a;
+  const struct elf_function_entry *e2 = b;
+
+  if (e1->section->id != e2->section->id)
+    return e1->section->id < e2->section->id ? -1 : 1;
+  if (e1->value != e2->value)
+    return e1->value < e2->value ? -1 : 1;
+  if (e1->order != e2->order)
+    return e1->order < e2->order ? -1 : 1;
+  return 0;
+}
+
+/* Build the table of function symbols of SYMBOLS for ABFD.  Each
+   entry records the file name which a search for the symbol by
+   walking the symbol table would report.  */
+
+static struct elf_function_index *
+elf_build_function_index (bfd *abfd, asymbol **symbols)
+{
+  struct elf_function_index *table;
+  asymbol *file;
   asymbol **p;
+  unsigned int count;
   /* ??? Given multiple file symbols, it is impossible to reliably
      choose the right file name for global symbols.  File symbols are
      local symbols, and thus all file symbols must sort before any
@@ -7053,10 +7120,20 @@ elf_find_function (bfd *abfd,
   enum { nothing_seen, symbol_seen, file_after_symbol_seen } state;
   const struct elf_backend_data *bed = get_elf_backend_data (abfd);
 
-  filename = NULL;
-  func = NULL;
+  table = bfd_alloc (abfd, sizeof (*table));
+  if (table == NULL)
+    return NULL;
+
+  for (count = 0, p = symbols; *p != NULL; p++)
+    count++;
+
+  table->symbols = symbols;
+  table->count = 0;
+  table->entries = bfd_alloc (abfd, (count + 1) * sizeof (*table->entries));
+  if (table->entries == NULL)
+    return NULL;
+
   file = NULL;
-  low_func = 0;
   state = nothing_seen;
 
   for (p = symbols; *p != NULL; p++)
@@ -7078,17 +7155,21 @@ elf_find_function (bfd *abfd,
 	  if (!bed->is_function_type (type))
 	    break;
 	case STT_NOTYPE:
-	  if (bfd_get_section (&q->symbol) == section
-	      && q->symbol.value >= low_func
-	      && q->symbol.value <= offset)
+	  if (bfd_get_section (&q->symbol) != NULL)
 	    {
-	      func = (asymbol *) q;
-	      low_func = q->symbol.value;
-	      filename = NULL;
+	      struct elf_function_entry *entry;
+
+	      entry = &table->entries[table->count];
+	      entry->section = bfd_get_section (&q->symbol);
+	      entry->value = q->symbol.value;
+	      entry->order = p - symbols;
+	      entry->func = (asymbol *) q;
+	      entry->filename = NULL;
 	      if (file != NULL
 		  && (ELF_ST_BIND (q->internal_elf_sym.st_info) == STB_LOCAL
 		      || state != file_after_symbol_seen))
-		filename = bfd_asymbol_name (file);
+		entry->filename = bfd_asymbol_name (file);
+	      table->count++;
 	    }
 	  break;
 	}
@@ -7096,13 +7177,63 @@ elf_find_function (bfd *abfd,
 	state = symbol_seen;
     }
 
-  if (func == NULL)
+  qsort (table->entries, table->count, sizeof (*table->entries),
+	 elf_function_entry_compare);
+  return table;
+}
+
+/* Find the function to a particular section and offset,
+   for error reporting.  This is the last function symbol in SECTION
+   with the highest value not above OFFSET.  The symbols are indexed
+   the first time we are asked about them.  */
+
+static bfd_boolean
+elf_find_function (bfd *abfd,
+		   asection *section,
+		   asymbol **symbols,
+		   bfd_vma offset,
+		   const char **filename_ptr,
+		   const char **functionname_ptr)
+{
+  struct elf_function_index *table;
+  struct elf_function_entry *entry;
+  unsigned int lo, hi;
+
+  table = elf_tdata (abfd)->function_index;
+  if (table == NULL || table->symbols != symbols)
+    {
+      table = elf_build_function_index (abfd, symbols);
+      if (table == NULL)
+	return FALSE;
+      elf_tdata (abfd)->function_index = table;
+    }
+
+  /* Find the first entry after the symbols in SECTION not above
+     OFFSET.  */
+  lo = 0;
+  hi = table->count;
+  while (lo < hi)
+    {
+      unsigned int mid = lo + (hi - lo) / 2;
+
+      entry = &table->entries[mid];
+      if (entry->section->id < section->id
+	  || (entry->section == section && entry->value <= offset))
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  if (lo == 0)
+    return FALSE;
+  entry = &table->entries[lo - 1];
+  if (entry->section != section)
     return FALSE;
 
   if (filename_ptr)
-    *filename_ptr = filename;
+    *filename_ptr = entry->filename;
   if (functionname_ptr)
-    *functionname_ptr = bfd_asymbol_name (func);
+    *functionname_ptr = bfd_asymbol_name (entry->func);
 
   return TRUE;
 }
@@ -7359,6 +7490,16 @@ _bfd_elf_close_and_cleanup (bfd *abfd)
       if (elf_tdata (abfd) != NULL && elf_shstrtab (abfd) != NULL)
 	_bfd_elf_strtab_free (elf_shstrtab (abfd));
       _bfd_dwarf2_cleanup_debug_info (abfd);
+      if (elf_tdata (abfd) != NULL)
+	{
+	  struct elf_mapped_view *mapped;
+
+	  for (mapped = elf_tdata (abfd)->mapped_views;
+	       mapped != NULL;
+	       mapped = mapped->next)
+	    _bfd_munmap_readonly (mapped->view);
+	  elf_tdata (abfd)->mapped_views = NULL;
+	}
     }
 
   return _bfd_generic_close_and_cleanup (abfd);
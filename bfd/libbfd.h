@@ -777,6 +777,11 @@ struct bfd_iovec
   void *(*bmmap) (struct bfd *abfd, void *addr, bfd_size_type len,
                   int prot, int flags, file_ptr offset);
 };
+void *_bfd_mmap_readonly (bfd *abfd, file_ptr offset,
+    bfd_size_type size, bfd_byte **data);
+
+void _bfd_munmap_readonly (void *view);
+
 /* Extracted from bfdwin.c.  */
 struct _bfd_window_internal {
   struct _bfd_window_internal *next;
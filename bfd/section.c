@@ -1502,6 +1502,73 @@ bfd_malloc_and_get_section (bfd *abfd, sec_ptr sec, bfd_byte **buf)
 
   return bfd_get_section_contents (abfd, sec, p, 0, sz);
 }
+
+/*
+FUNCTION
+	bfd_map_section_contents
+
+SYNOPSIS
+	bfd_boolean bfd_map_section_contents
+	  (bfd *abfd, asection *section, bfd_byte **buf, void **view);
+
+DESCRIPTION
+	Make all data from @var{section} in BFD @var{abfd} available
+	in *@var{buf}, which must not be modified.  Where possible the
+	data is mapped from the file, so that large sections cost
+	neither a copy nor memory of their own; otherwise it is read
+	into a malloc'd buffer.  *@var{view} is set to a handle to
+	pass, along with *@var{buf}, to <<bfd_unmap_section_contents>>
+	once the data is no longer needed.
+*/
+
+bfd_boolean
+bfd_map_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **buf,
+			  void **view)
+{
+  bfd_size_type sz = sec->rawsize ? sec->rawsize : sec->size;
+
+  *view = NULL;
+  if (sz != 0
+      && (sec->flags & (SEC_HAS_CONTENTS | SEC_IN_MEMORY
+			| SEC_CONSTRUCTOR)) == SEC_HAS_CONTENTS
+      && (abfd->xvec->_bfd_get_section_contents
+	  == _bfd_generic_get_section_contents))
+    {
+      *view = _bfd_mmap_readonly (abfd, sec->filepos, sz, buf);
+      if (*view != NULL)
+	return TRUE;
+    }
+
+  if (bfd_malloc_and_get_section (abfd, sec, buf))
+    return TRUE;
+
+  if (*buf != NULL)
+    free (*buf);
+  *buf = NULL;
+  return FALSE;
+}
+
+/*
+FUNCTION
+	bfd_unmap_section_contents
+
+SYNOPSIS
+	void bfd_unmap_section_contents (bfd_byte *buf, void *view);
+
+DESCRIPTION
+	Release section data @var{buf} obtained from
+	<<bfd_map_section_contents>> with handle @var{view}.  A NULL
+	@var{view} means @var{buf} is simply freed.
+*/
+
+void
+bfd_unmap_section_contents (bfd_byte *buf, void *view)
+{
+  if (view != NULL)
+    _bfd_munmap_readonly (view);
+  else if (buf != NULL)
+    free (buf);
+}
 /*
 FUNCTION
 	bfd_copy_private_section_data
@@ -38,10 +38,21 @@
 #include "demangle.h"
 #include "bucomm.h"
 
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+#define USE_WORKERS 1
+#endif
+
 static bfd_boolean unwind_inlines;	/* -i, unwind inlined functions. */
 static bfd_boolean with_functions;	/* -f, show function names.  */
 static bfd_boolean do_demangle;		/* -C, demangle names.  */
 static bfd_boolean base_names;		/* -s, strip directory names.  */
+static bfd_boolean batch_mode;		/* -B, read all addresses first.  */
+static bfd_boolean machine_readable;	/* -M, one line per address.  */
+static int jobs = 1;			/* -J, batch mode worker processes.  */
 
 static int naddr;		/* Number of addresses to process.  */
 static char **addr;		/* Hex addresses to process.  */
@@ -51,10 +62,13 @@ static asymbol **syms;		/* Symbol table.  */
 static struct option long_options[] =
 {
   {"basenames", no_argument, NULL, 's'},
+  {"batch", no_argument, NULL, 'B'},
   {"demangle", optional_argument, NULL, 'C'},
   {"exe", required_argument, NULL, 'e'},
   {"functions", no_argument, NULL, 'f'},
   {"inlines", no_argument, NULL, 'i'},
+  {"jobs", required_argument, NULL, 'J'},
+  {"machine-readable", no_argument, NULL, 'M'},
   {"section", required_argument, NULL, 'j'},
   {"target", required_argument, NULL, 'b'},
   {"help", no_argument, NULL, 'H'},
@@ -66,7 +80,11 @@ static void usage (FILE *, int);
 static void slurp_symtab (bfd *);
 static void find_address_in_section (bfd *, asection *, void *);
 static void find_offset_in_section (bfd *, asection *);
+static void out_append (const char *);
+static void translate_address (bfd *, asection *);
+static bfd_boolean read_address (bfd_boolean, bfd_vma *);
 static void translate_addresses (bfd *, asection *);
+static void translate_addresses_batch (bfd *, asection *);
 
 /* Print a usage message to STREAM and exit with STATUS.  */
 
@@ -85,6 +103,9 @@ usage (FILE *stream, int status)
   -s --basenames         Strip directory names\n\
   -f --functions         Show function names\n\
   -C --demangle[=style]  Demangle function names\n\
+  -B --batch             Read all addresses before translating any of them\n\
+  -J --jobs=<number>     Translate using <number> processes (implies -B)\n\
+  -M --machine-readable  Print one tab-separated line per address\n\
   -h --help              Display this information\n\
   -v --version           Display the program's version\n\
 \n"));
@@ -172,85 +193,161 @@ find_offset_in_section (bfd *abfd, asection *section)
 				 &filename, &functionname, &line);
 }
 
-/* Read hexadecimal addresses from stdin, translate into
-   file_name:line_number and optionally function name.  */
+/* The output for one address is collected here, so that batch mode
+   can hold on to it until it is printed in input order.  */
+
+static char *out_buf;
+static size_t out_len;
+static size_t out_size;
+
+/* Append STR to the output buffer, keeping it NUL terminated.  */
 
 static void
-translate_addresses (bfd *abfd, asection *section)
+out_append (const char *str)
 {
-  int read_stdin = (naddr == 0);
+  size_t len = strlen (str);
 
-  for (;;)
+  if (out_len + len + 1 > out_size)
     {
-      if (read_stdin)
-	{
-	  char addr_hex[100];
+      out_size = (out_len + len + 1) * 2;
+      out_buf = xrealloc (out_buf, out_size);
+    }
+  memcpy (out_buf + out_len, str, len + 1);
+  out_len += len;
+}
 
-	  if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
-	    break;
-	  pc = bfd_scan_vma (addr_hex, NULL, 16);
-	}
-      else
-	{
-	  if (naddr <= 0)
-	    break;
-	  --naddr;
-	  pc = bfd_scan_vma (*addr++, NULL, 16);
-	}
+/* Translate the address in PC into file_name:line_number and
+   optionally function name, leaving the text in the output buffer.  */
 
-      found = FALSE;
-      if (section)
-	find_offset_in_section (abfd, section);
-      else
-	bfd_map_over_sections (abfd, find_address_in_section, NULL);
+static void
+translate_address (bfd *abfd, asection *section)
+{
+  char buf[64];
+
+  out_len = 0;
+  if (machine_readable)
+    {
+      out_append ("0x");
+      bfd_sprintf_vma (abfd, buf, pc);
+      out_append (buf);
+    }
+
+  found = FALSE;
+  if (section)
+    find_offset_in_section (abfd, section);
+  else
+    bfd_map_over_sections (abfd, find_address_in_section, NULL);
 
-      if (! found)
+  if (! found)
+    {
+      if (machine_readable)
+	out_append ("\t??\t??\t0");
+      else
 	{
 	  if (with_functions)
-	    printf ("??\n");
-	  printf ("??:0\n");
+	    out_append ("??\n");
+	  out_append ("??:0\n");
 	}
-      else
-	{
-	  do {
+    }
+  else
+    {
+      do {
+	const char *name = NULL;
+	char *alloc = NULL;
+
+	if (with_functions || machine_readable)
+	  {
+	    name = functionname;
+	    if (name == NULL || *name == '\0')
+	      name = "??";
+	    else if (do_demangle)
+	      {
+		alloc = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
+		if (alloc != NULL)
+		  name = alloc;
+	      }
+	  }
+
+	if (base_names && filename != NULL)
+	  {
+	    char *h;
+
+	    h = strrchr (filename, '/');
+	    if (h != NULL)
+	      filename = h + 1;
+	  }
+
+	if (machine_readable)
+	  {
+	    out_append ("\t");
+	    out_append (name);
+	    out_append ("\t");
+	    out_append (filename ? filename : "??");
+	    sprintf (buf, "\t%u", line);
+	    out_append (buf);
+	  }
+	else
+	  {
 	    if (with_functions)
 	      {
-		const char *name;
-		char *alloc = NULL;
+		out_append (name);
+		out_append ("\n");
+	      }
+	    out_append (filename ? filename : "??");
+	    sprintf (buf, ":%u\n", line);
+	    out_append (buf);
+	  }
+
+	if (alloc != NULL)
+	  free (alloc);
+
+	if (!unwind_inlines)
+	  found = FALSE;
+	else
+	  found = bfd_find_inliner_info (abfd, &filename, &functionname, &line);
+      } while (found);
+    }
 
-		name = functionname;
-		if (name == NULL || *name == '\0')
-		  name = "??";
-		else if (do_demangle)
-		  {
-		    alloc = bfd_demangle (abfd, name, DMGL_ANSI | DMGL_PARAMS);
-		    if (alloc != NULL)
-		      name = alloc;
-		  }
+  if (machine_readable)
+    out_append ("\n");
+}
 
-		printf ("%s\n", name);
+/* Read the next hexadecimal address from the command line or from
+   stdin into *VALUE.  Returns FALSE when there are no more.  */
 
-		if (alloc != NULL)
-		  free (alloc);
-	      }
+static bfd_boolean
+read_address (bfd_boolean read_stdin, bfd_vma *value)
+{
+  if (read_stdin)
+    {
+      char addr_hex[100];
 
-	    if (base_names && filename != NULL)
-	      {
-		char *h;
+      if (fgets (addr_hex, sizeof addr_hex, stdin) == NULL)
+	return FALSE;
+      *value = bfd_scan_vma (addr_hex, NULL, 16);
+    }
+  else
+    {
+      if (naddr <= 0)
+	return FALSE;
+      --naddr;
+      *value = bfd_scan_vma (*addr++, NULL, 16);
+    }
+  return TRUE;
+}
 
-		h = strrchr (filename, '/');
-		if (h != NULL)
-		  filename = h + 1;
-	      }
+/* Read hexadecimal addresses from stdin, translate into
+   file_name:line_number and optionally function name.  */
 
-	    printf ("%s:%u\n", filename ? filename : "??", line);
-	    if (!unwind_inlines)
-	      found = FALSE;
-	    else
-	      found = bfd_find_inliner_info (abfd, &filename, &functionname, &line);
-	  } while (found);
+static void
+translate_addresses (bfd *abfd, asection *section)
+{
+  bfd_boolean read_stdin = (naddr == 0);
 
-	}
+  while (read_address (read_stdin, &pc))
+    {
+      translate_address (abfd, section);
+      fwrite (out_buf, 1, out_len, stdout);
 
       /* fflush() is essential for using this command as a server
          child process that reads addresses from a pipe and responds
@@ -260,6 +357,225 @@ translate_addresses (bfd *abfd, asection *section)
     }
 }
 
+/* An address read in batch mode, and its position in the input.  */
+
+struct batch_address
+{
+  bfd_vma pc;
+  unsigned int input;
+};
+
+/* Sort batch mode addresses by value, then by input position.  */
+
+static int
+compare_batch_addresses (const void *a, const void *b)
+{
+  const struct batch_address *x = (const struct batch_address *) a;
+  const struct batch_address *y = (const struct batch_address *) b;
+
+  if (x->pc != y->pc)
+    return x->pc < y->pc ? -1 : 1;
+  if (x->input != y->input)
+    return x->input < y->input ? -1 : 1;
+  return 0;
+}
+
+/* Translate the addresses PCS[FIRST] up to PCS[LAST], storing a copy
+   of the output for each in RESULTS.  */
+
+static void
+resolve_addresses (bfd *abfd, asection *section, const bfd_vma *pcs,
+		   unsigned int first, unsigned int last, char **results)
+{
+  unsigned int i;
+
+  for (i = first; i < last; i++)
+    {
+      pc = pcs[i];
+      translate_address (abfd, section);
+      results[i] = xmalloc (out_len + 1);
+      memcpy (results[i], out_buf, out_len + 1);
+    }
+}
+
+#ifdef USE_WORKERS
+
+/* Translate the COUNT addresses in PCS using JOBS worker processes,
+   each of which handles a contiguous range of them.  A BFD can not be
+   shared between threads, so each worker is a separate process which
+   reopens the file and writes its results to a temporary file.  A
+   range for which no worker could be started is translated here.  */
+
+static void
+resolve_addresses_in_workers (bfd *abfd, asection *section,
+			      const bfd_vma *pcs, unsigned int count,
+			      char **results)
+{
+  unsigned int chunk = (count + jobs - 1) / jobs;
+  FILE **files = (FILE **) xcalloc (jobs, sizeof (FILE *));
+  pid_t *pids = (pid_t *) xcalloc (jobs, sizeof (pid_t));
+  int w;
+
+  /* Each worker must open the file itself, since a shared descriptor
+     has a shared file position.  */
+  bfd_cache_close_all ();
+  fflush (stdout);
+  fflush (stderr);
+
+  for (w = 0; w < jobs; w++)
+    {
+      unsigned int first = w * chunk;
+      unsigned int last = first + chunk;
+
+      if (first >= count)
+	break;
+      if (last > count)
+	last = count;
+
+      files[w] = tmpfile ();
+      if (files[w] != NULL)
+	{
+	  pids[w] = fork ();
+	  if (pids[w] < 0)
+	    {
+	      fclose (files[w]);
+	      files[w] = NULL;
+	    }
+	}
+      if (files[w] == NULL)
+	{
+	  resolve_addresses (abfd, section, pcs, first, last, results);
+	  continue;
+	}
+
+      if (pids[w] == 0)
+	{
+	  int status = 0;
+	  unsigned int i;
+
+	  for (i = first; i < last; i++)
+	    {
+	      pc = pcs[i];
+	      translate_address (abfd, section);
+	      if (fwrite (&out_len, sizeof out_len, 1, files[w]) != 1
+		  || fwrite (out_buf, 1, out_len, files[w]) != out_len)
+		{
+		  status = 1;
+		  break;
+		}
+	    }
+	  if (fclose (files[w]) != 0)
+	    status = 1;
+	  fflush (stderr);
+	  _exit (status);
+	}
+    }
+
+  for (w = 0; w < jobs; w++)
+    {
+      unsigned int first = w * chunk;
+      unsigned int last = first + chunk;
+      unsigned int i;
+      int status;
+
+      if (files[w] == NULL)
+	continue;
+      if (last > count)
+	last = count;
+
+      if (waitpid (pids[w], &status, 0) != pids[w]
+	  || !WIFEXITED (status)
+	  || WEXITSTATUS (status) != 0)
+	fatal (_("worker process failed"));
+
+      rewind (files[w]);
+      for (i = first; i < last; i++)
+	{
+	  size_t len;
+
+	  if (fread (&len, sizeof len, 1, files[w]) != 1)
+	    fatal (_("error reading worker output"));
+	  results[i] = xmalloc (len + 1);
+	  if (fread (results[i], 1, len, files[w]) != len)
+	    fatal (_("error reading worker output"));
+	  results[i][len] = '\0';
+	}
+      fclose (files[w]);
+    }
+
+  free (pids);
+  free (files);
+}
+
+#endif /* USE_WORKERS */
+
+/* Read all the hexadecimal addresses, then translate each distinct
+   one in address order, which keeps the lookups in the debugging
+   information close together.  The results are printed in input
+   order.  */
+
+static void
+translate_addresses_batch (bfd *abfd, asection *section)
+{
+  bfd_boolean read_stdin = (naddr == 0);
+  struct batch_address *input = NULL;
+  unsigned int count = 0;
+  unsigned int alloc = 0;
+  unsigned int nunique;
+  unsigned int *slot;
+  bfd_vma *pcs;
+  char **results;
+  bfd_vma value;
+  unsigned int i;
+
+  while (read_address (read_stdin, &value))
+    {
+      if (count == alloc)
+	{
+	  alloc = alloc ? alloc * 2 : 1024;
+	  input = (struct batch_address *)
+	    xrealloc (input, alloc * sizeof (struct batch_address));
+	}
+      input[count].pc = value;
+      input[count].input = count;
+      count++;
+    }
+
+  if (count == 0)
+    return;
+
+  qsort (input, count, sizeof (struct batch_address),
+	 compare_batch_addresses);
+
+  pcs = (bfd_vma *) xmalloc (count * sizeof (bfd_vma));
+  slot = (unsigned int *) xmalloc (count * sizeof (unsigned int));
+  nunique = 0;
+  for (i = 0; i < count; i++)
+    {
+      if (nunique == 0 || pcs[nunique - 1] != input[i].pc)
+	pcs[nunique++] = input[i].pc;
+      slot[input[i].input] = nunique - 1;
+    }
+  free (input);
+
+  results = (char **) xcalloc (nunique, sizeof (char *));
+#ifdef USE_WORKERS
+  if (jobs > 1 && nunique > 1)
+    resolve_addresses_in_workers (abfd, section, pcs, nunique, results);
+  else
+#endif
+    resolve_addresses (abfd, section, pcs, 0, nunique, results);
+
+  for (i = 0; i < count; i++)
+    fputs (results[slot[i]], stdout);
+
+  for (i = 0; i < nunique; i++)
+    free (results[i]);
+  free (results);
+  free (slot);
+  free (pcs);
+}
+
 /* Process a file.  Returns an exit value for main().  */
 
 static int
@@ -302,7 +618,10 @@ process_file (const char *file_name, const char *section_name,
 
   slurp_symtab (abfd);
 
-  translate_addresses (abfd, section);
+  if (batch_mode)
+    translate_addresses_batch (abfd, section);
+  else
+    translate_addresses (abfd, section);
 
   if (syms != NULL)
     {
@@ -343,7 +662,7 @@ main (int argc, char **argv)
   file_name = NULL;
   section_name = NULL;
   target = NULL;
-  while ((c = getopt_long (argc, argv, "b:Ce:sfHhij:Vv", long_options, (int *) 0))
+  while ((c = getopt_long (argc, argv, "b:BCe:sfHhij:J:MVv", long_options, (int *) 0))
 	 != EOF)
     {
       switch (c)
@@ -390,6 +709,22 @@ main (int argc, char **argv)
 	case 'j':
 	  section_name = optarg;
 	  break;
+	case 'B':
+	  batch_mode = TRUE;
+	  break;
+	case 'J':
+	  jobs = atoi (optarg);
+	  if (jobs < 1)
+	    fatal (_("invalid number of jobs: %s"), optarg);
+#ifndef USE_WORKERS
+	  if (jobs > 1)
+	    non_fatal (_("worker processes are not supported, --jobs ignored"));
+#endif
+	  batch_mode = TRUE;
+	  break;
+	case 'M':
+	  machine_readable = TRUE;
+	  break;
 	default:
 	  usage (stderr, 1);
 	  break;
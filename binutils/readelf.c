@@ -46,6 +46,9 @@
 #include <assert.h>
 #include <sys/stat.h>
 #include <time.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 #ifdef HAVE_ZLIB_H
 #include <zlib.h>
 #endif
@@ -165,7 +168,7 @@ static Elf_Internal_Syminfo * dynamic_syminfo;
 static unsigned long dynamic_syminfo_offset;
 static unsigned int dynamic_syminfo_nent;
 static char program_interpreter[PATH_MAX];
-static bfd_vma dynamic_info[DT_JMPREL + 1];
+static bfd_vma dynamic_info[DT_RELRENT + 1];
 static bfd_vma dynamic_info_DT_GNU_HASH;
 static bfd_vma version_info[16];
 static Elf_Internal_Ehdr elf_header;
@@ -283,16 +286,50 @@ static void (* byte_put) (unsigned char *, bfd_vma, int);
 #define strneq(a,b,n)	  (strncmp ((a), (b), (n)) == 0)
 #define const_strneq(a,b) (strncmp ((a), (b), sizeof (b) - 1) == 0)
 
+/* The file being examined, mapped into memory by map_file, or NULL.
+   FILE_MAP_STREAM is the stream it was opened as; reads from any other
+   stream, such as a member of a thin archive, still go through stdio.  */
+
+static unsigned char * file_map;
+static size_t file_map_size;
+static FILE * file_map_stream;
+
+/* Return the address in the file map of NMEMB elements of SIZE bytes
+   at OFFSET in FILE, or NULL if they are not all mapped.  */
+
+static unsigned char *
+mapped_range (FILE * file, long offset, size_t size, size_t nmemb)
+{
+  unsigned long start;
+
+  if (file_map == NULL || file != file_map_stream)
+    return NULL;
+
+  if (offset < 0 || archive_file_offset + offset < 0)
+    return NULL;
+  start = archive_file_offset + offset;
+
+  if (nmemb > ~(size_t) 0 / size
+      || start > file_map_size
+      || size * nmemb > file_map_size - start)
+    return NULL;
+
+  return file_map + start;
+}
+
 static void *
 get_data (void * var, FILE * file, long offset, size_t size, size_t nmemb,
 	  const char * reason)
 {
   void * mvar;
+  unsigned char * mapped;
 
   if (size == 0 || nmemb == 0)
     return NULL;
 
-  if (fseek (file, archive_file_offset + offset, SEEK_SET))
+  mapped = mapped_range (file, offset, size, nmemb);
+  if (mapped == NULL
+      && fseek (file, archive_file_offset + offset, SEEK_SET))
     {
       error (_("Unable to seek to 0x%lx for %s\n"),
 	     (unsigned long) archive_file_offset + offset, reason);
@@ -317,7 +354,9 @@ get_data (void * var, FILE * file, long offset, size_t size, size_t nmemb,
       ((char *) mvar)[size * nmemb] = '\0';
     }
 
-  if (fread (mvar, size, nmemb, file) != nmemb)
+  if (mapped != NULL)
+    memcpy (mvar, mapped, size * nmemb);
+  else if (fread (mvar, size, nmemb, file) != nmemb)
     {
       error (_("Unable to read in 0x%lx bytes of %s\n"),
 	     (unsigned long)(size * nmemb), reason);
@@ -329,6 +368,99 @@ get_data (void * var, FILE * file, long offset, size_t size, size_t nmemb,
   return mvar;
 }
 
+/* Like get_data with a NULL VAR, but when the data lies in the file
+   map return it in place rather than a copy.  The result must not be
+   modified, and is released with release_data.  */
+
+static void *
+get_mapped_data (FILE * file, long offset, size_t size, size_t nmemb,
+		 const char * reason)
+{
+  unsigned char * mapped;
+
+  if (size == 0 || nmemb == 0)
+    return NULL;
+
+  mapped = mapped_range (file, offset, size, nmemb);
+  if (mapped != NULL)
+    return mapped;
+
+  return get_data (NULL, file, offset, size, nmemb, reason);
+}
+
+/* Like get_mapped_data for SIZE bytes holding strings, such as a
+   string table.  They are only used in place if they end in a NUL,
+   so that no string can run off their end.  */
+
+static char *
+get_mapped_strings (FILE * file, long offset, size_t size,
+		    const char * reason)
+{
+  unsigned char * mapped;
+
+  if (size == 0)
+    return NULL;
+
+  mapped = mapped_range (file, offset, 1, size);
+  if (mapped != NULL && mapped[size - 1] == '\0')
+    return (char *) mapped;
+
+  return get_data (NULL, file, offset, 1, size, reason);
+}
+
+/* Release DATA returned by get_data, get_mapped_data or
+   get_mapped_strings.  */
+
+static void
+release_data (void * data)
+{
+  unsigned char * p = (unsigned char *) data;
+
+  if (p == NULL)
+    return;
+
+  if (file_map != NULL && p >= file_map && p < file_map + file_map_size)
+    return;
+
+  free (data);
+}
+
+/* Map FILE, which is SIZE bytes long, into memory so that reads from
+   it need neither stdio buffers nor a copy.  If it can not be mapped,
+   everything is read through stdio as before.  */
+
+static void
+map_file (FILE * file, off_t size)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  void * map;
+
+  if (size <= 0 || (off_t) (size_t) size != size)
+    return;
+
+  map = mmap (NULL, (size_t) size, PROT_READ, MAP_PRIVATE,
+	      fileno (file), 0);
+  if (map == MAP_FAILED)
+    return;
+
+  file_map = (unsigned char *) map;
+  file_map_size = (size_t) size;
+  file_map_stream = file;
+#endif
+}
+
+static void
+unmap_file (void)
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  if (file_map != NULL)
+    munmap (file_map, file_map_size);
+#endif
+  file_map = NULL;
+  file_map_size = 0;
+  file_map_stream = NULL;
+}
+
 static void
 byte_put_little_endian (unsigned char * field, bfd_vma value, int size)
 {
@@ -1623,6 +1755,10 @@ get_dynamic_type (unsigned long type)
     case DT_PREINIT_ARRAY: return "PREINIT_ARRAY";
     case DT_PREINIT_ARRAYSZ: return "PREINIT_ARRAYSZ";
 
+    case DT_RELRSZ:	return "RELRSZ";
+    case DT_RELR:	return "RELR";
+    case DT_RELRENT:	return "RELRENT";
+
     case DT_CHECKSUM:	return "CHECKSUM";
     case DT_PLTPADSZ:	return "PLTPADSZ";
     case DT_MOVEENT:	return "MOVEENT";
@@ -2762,6 +2898,7 @@ get_section_type_name (unsigned int sh_type)
     case SHT_GNU_HASH:		return "GNU_HASH";
     case SHT_GROUP:		return "GROUP";
     case SHT_SYMTAB_SHNDX:	return "SYMTAB SECTION INDICIES";
+    case SHT_RELR:		return "RELR";
     case SHT_GNU_verdef:	return "VERDEF";
     case SHT_GNU_verneed:	return "VERNEED";
     case SHT_GNU_versym:	return "VERSYM";
@@ -3731,8 +3868,8 @@ get_32bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
   Elf_Internal_Sym * psym;
   unsigned int j;
 
-  esyms = get_data (NULL, file, section->sh_offset, 1, section->sh_size,
-		    _("symbols"));
+  esyms = get_mapped_data (file, section->sh_offset, 1, section->sh_size,
+			   _("symbols"));
   if (!esyms)
     return NULL;
 
@@ -3741,11 +3878,11 @@ get_32bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
       && (symtab_shndx_hdr->sh_link
 	  == (unsigned long) (section - section_headers)))
     {
-      shndx = get_data (NULL, file, symtab_shndx_hdr->sh_offset,
-			1, symtab_shndx_hdr->sh_size, _("symtab shndx"));
+      shndx = get_mapped_data (file, symtab_shndx_hdr->sh_offset,
+			       1, symtab_shndx_hdr->sh_size, _("symtab shndx"));
       if (!shndx)
 	{
-	  free (esyms);
+	  release_data (esyms);
 	  return NULL;
 	}
     }
@@ -3756,9 +3893,8 @@ get_32bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
   if (isyms == NULL)
     {
       error (_("Out of memory\n"));
-      if (shndx)
-	free (shndx);
-      free (esyms);
+      release_data (shndx);
+      release_data (esyms);
       return NULL;
     }
 
@@ -3779,9 +3915,8 @@ get_32bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
       psym->st_other = BYTE_GET (esyms[j].st_other);
     }
 
-  if (shndx)
-    free (shndx);
-  free (esyms);
+  release_data (shndx);
+  release_data (esyms);
 
   return isyms;
 }
@@ -3796,8 +3931,8 @@ get_64bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
   Elf_Internal_Sym * psym;
   unsigned int j;
 
-  esyms = get_data (NULL, file, section->sh_offset, 1, section->sh_size,
-		    _("symbols"));
+  esyms = get_mapped_data (file, section->sh_offset, 1, section->sh_size,
+			   _("symbols"));
   if (!esyms)
     return NULL;
 
@@ -3806,11 +3941,11 @@ get_64bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
       && (symtab_shndx_hdr->sh_link
 	  == (unsigned long) (section - section_headers)))
     {
-      shndx = get_data (NULL, file, symtab_shndx_hdr->sh_offset,
-			1, symtab_shndx_hdr->sh_size, _("symtab shndx"));
+      shndx = get_mapped_data (file, symtab_shndx_hdr->sh_offset,
+			       1, symtab_shndx_hdr->sh_size, _("symtab shndx"));
       if (!shndx)
 	{
-	  free (esyms);
+	  release_data (esyms);
 	  return NULL;
 	}
     }
@@ -3821,9 +3956,8 @@ get_64bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
   if (isyms == NULL)
     {
       error (_("Out of memory\n"));
-      if (shndx)
-	free (shndx);
-      free (esyms);
+      release_data (shndx);
+      release_data (esyms);
       return NULL;
     }
 
@@ -3844,13 +3978,109 @@ get_64bit_elf_symbols (FILE * file, Elf_Internal_Shdr * section)
       psym->st_size  = BYTE_GET (esyms[j].st_size);
     }
 
-  if (shndx)
-    free (shndx);
-  free (esyms);
+  release_data (shndx);
+  release_data (esyms);
 
   return isyms;
 }
 
+/* Symbol and string tables of the current object, indexed by section
+   number.  Several dump options walk the same tables, so each is read
+   and decoded only once; they are freed by free_table_cache.  */
+
+static Elf_Internal_Sym ** symbol_table_cache;
+static char ** string_table_cache;
+static unsigned int table_cache_size;
+
+/* Return the index of SECTION in the section headers, allocating the
+   table caches if need be, or -1 if it is not one of them.  */
+
+static int
+table_cache_index (Elf_Internal_Shdr * section)
+{
+  if (section_headers == NULL
+      || section < section_headers
+      || section >= section_headers + elf_header.e_shnum)
+    return -1;
+
+  if (table_cache_size == 0)
+    {
+      table_cache_size = elf_header.e_shnum;
+      symbol_table_cache = (Elf_Internal_Sym **)
+	xcalloc (table_cache_size, sizeof (Elf_Internal_Sym *));
+      string_table_cache = (char **)
+	xcalloc (table_cache_size, sizeof (char *));
+    }
+
+  return section - section_headers;
+}
+
+/* Return the decoded symbols of the symbol table SECTION.  The result
+   is owned by the cache and must not be freed.  */
+
+static Elf_Internal_Sym *
+get_symbol_table (FILE * file, Elf_Internal_Shdr * section)
+{
+  int num = table_cache_index (section);
+
+  if (num < 0)
+    {
+      error (_("Bad symbol table section\n"));
+      return NULL;
+    }
+
+  if (symbol_table_cache[num] == NULL)
+    symbol_table_cache[num] = GET_ELF_SYMBOLS (file, section);
+
+  return symbol_table_cache[num];
+}
+
+/* Return the contents of the string table SECTION.  The result is
+   owned by the cache and must not be modified or freed.  */
+
+static char *
+get_string_table (FILE * file, Elf_Internal_Shdr * section,
+		  const char * reason)
+{
+  int num = table_cache_index (section);
+
+  if (num < 0)
+    {
+      error (_("Bad string table section\n"));
+      return NULL;
+    }
+
+  if (string_table_cache[num] == NULL)
+    string_table_cache[num]
+      = get_mapped_strings (file, section->sh_offset, section->sh_size,
+			    reason);
+
+  return string_table_cache[num];
+}
+
+static void
+free_table_cache (void)
+{
+  unsigned int i;
+
+  for (i = 0; i < table_cache_size; i++)
+    {
+      if (symbol_table_cache[i] != NULL)
+	free (symbol_table_cache[i]);
+      release_data (string_table_cache[i]);
+    }
+
+  if (table_cache_size != 0)
+    {
+      free (symbol_table_cache);
+      free (string_table_cache);
+    }
+
+  symbol_table_cache = NULL;
+  string_table_cache = NULL;
+  table_cache_size = 0;
+}
+
 static const char *
 get_elf_section_flags (bfd_vma sh_flags)
 {
@@ -4550,9 +4780,7 @@ process_section_groups (FILE * file)
 	  if (symtab_sec != sec)
 	    {
 	      symtab_sec = sec;
-	      if (symtab)
-		free (symtab);
-	      symtab = GET_ELF_SYMBOLS (file, symtab_sec);
+	      symtab = get_symbol_table (file, symtab_sec);
 	    }
 
 	  sym = symtab + section->sh_info;
@@ -4568,8 +4796,6 @@ process_section_groups (FILE * file)
 
 	      group_name = SECTION_NAME (section_headers + sym->st_shndx);
 	      strtab_sec = NULL;
-	      if (strtab)
-		free (strtab);
 	      strtab = NULL;
 	      strtab_size = 0;
 	    }
@@ -4579,8 +4805,6 @@ process_section_groups (FILE * file)
 	      if (symtab_sec->sh_link >= elf_header.e_shnum)
 		{
 		  strtab_sec = NULL;
-		  if (strtab)
-		    free (strtab);
 		  strtab = NULL;
 		  strtab_size = 0;
 		}
@@ -4588,19 +4812,16 @@ process_section_groups (FILE * file)
 		       != (sec = section_headers + symtab_sec->sh_link))
 		{
 		  strtab_sec = sec;
-		  if (strtab)
-		    free (strtab);
-		  strtab = get_data (NULL, file, strtab_sec->sh_offset,
-				     1, strtab_sec->sh_size,
-				     _("string table"));
+		  strtab = get_string_table (file, strtab_sec,
+					     _("string table"));
 		  strtab_size = strtab != NULL ? strtab_sec->sh_size : 0;
 		}
 	      group_name = sym->st_name < strtab_size
 			   ? strtab + sym->st_name : "<corrupt>";
 	    }
 
-	  start = get_data (NULL, file, section->sh_offset,
-			    1, section->sh_size, _("section data"));
+	  start = get_mapped_data (file, section->sh_offset,
+				   1, section->sh_size, _("section data"));
 
 	  indices = start;
 	  size = (section->sh_size / section->sh_entsize) - 1;
@@ -4669,17 +4890,12 @@ process_section_groups (FILE * file)
 	      group->root = g;
 	    }
 
-	  if (start)
-	    free (start);
+	  release_data (start);
 
 	  group++;
 	}
     }
 
-  if (symtab)
-    free (symtab);
-  if (strtab)
-    free (strtab);
   return 1;
 }
 
@@ -4696,6 +4912,59 @@ static struct
     { "PLT", DT_JMPREL, DT_PLTRELSZ, UNKNOWN }
 };
 
+/* Display the addresses relocated by the packed relative relocations
+   found at the specified offset.  Each entry is either an address,
+   which is relocated and starts a run, or, if its low bit is set, a
+   bitmap of the words following the current run which are also
+   relocated.  */
+
+static void
+dump_relr_relocations (FILE * file,
+		       unsigned long relr_offset,
+		       unsigned long relr_size)
+{
+  unsigned int entsize = is_32bit_elf ? 4 : 8;
+  unsigned int nbits = entsize * 8 - 1;
+  unsigned char * relrs;
+  unsigned long count;
+  unsigned long i;
+  bfd_vma where = 0;
+
+  count = relr_size / entsize;
+  relrs = get_data (NULL, file, relr_offset, count, entsize,
+		    _("packed relocs"));
+  if (relrs == NULL)
+    return;
+
+  printf (is_32bit_elf ? _(" Offset\n") : _("  Offset\n"));
+
+  for (i = 0; i < count; i++)
+    {
+      bfd_vma entry = byte_get (relrs + i * entsize, entsize);
+
+      if ((entry & 1) == 0)
+	{
+	  print_vma (entry, LONG_HEX);
+	  putchar ('\n');
+	  where = entry + entsize;
+	}
+      else
+	{
+	  bfd_vma addr = where;
+
+	  for (entry >>= 1; entry != 0; entry >>= 1, addr += entsize)
+	    if ((entry & 1) != 0)
+	      {
+		print_vma (addr, LONG_HEX);
+		putchar ('\n');
+	      }
+	  where += nbits * entsize;
+	}
+    }
+
+  free (relrs);
+}
+
 /* Process the reloc section.  */
 
 static int
@@ -4754,6 +5023,19 @@ process_relocs (FILE * file)
 	    }
 	}
 
+      rel_size = dynamic_info[DT_RELRSZ];
+      rel_offset = dynamic_info[DT_RELR];
+      if (rel_size)
+	{
+	  has_dynamic_reloc = 1;
+	  printf
+	    (_("\n'RELR' relocation section at offset 0x%lx contains %ld bytes:\n"),
+	     rel_offset, rel_size);
+	  dump_relr_relocations (file,
+				 offset_from_vma (file, rel_offset, rel_size),
+				 rel_size);
+	}
+
       if (! has_dynamic_reloc)
 	printf (_("\nThere are no dynamic relocations in this file.\n"));
     }
@@ -4768,13 +5050,30 @@ process_relocs (FILE * file)
 	   i++, section++)
 	{
 	  if (   section->sh_type != SHT_RELA
-	      && section->sh_type != SHT_REL)
+	      && section->sh_type != SHT_REL
+	      && section->sh_type != SHT_RELR)
 	    continue;
 
 	  rel_offset = section->sh_offset;
 	  rel_size   = section->sh_size;
 
-	  if (rel_size)
+	  if (rel_size && section->sh_type == SHT_RELR)
+	    {
+	      printf (_("\nRelocation section "));
+
+	      if (string_table == NULL)
+		printf ("%d", section->sh_name);
+	      else
+		printf (_("'%s'"), SECTION_NAME (section));
+
+	      printf (_(" at offset 0x%lx contains %lu entries:\n"),
+		      rel_offset,
+		      (unsigned long) (rel_size / (is_32bit_elf ? 4 : 8)));
+
+	      dump_relr_relocations (file, rel_offset, rel_size);
+	      found = 1;
+	    }
+	  else if (rel_size)
 	    {
 	      Elf_Internal_Shdr * strsec;
 	      int is_rela;
@@ -4806,7 +5105,7 @@ process_relocs (FILE * file)
                     continue;
 
 		  nsyms = symsec->sh_size / symsec->sh_entsize;
-		  symtab = GET_ELF_SYMBOLS (file, symsec);
+		  symtab = get_symbol_table (file, symsec);
 
 		  if (symtab == NULL)
 		    continue;
@@ -4816,17 +5115,13 @@ process_relocs (FILE * file)
 		    {
 		      strsec = section_headers + symsec->sh_link;
 
-		      strtab = get_data (NULL, file, strsec->sh_offset,
-					 1, strsec->sh_size,
-					 _("string table"));
+		      strtab = get_string_table (file, strsec,
+						 _("string table"));
 		      strtablen = strtab == NULL ? 0 : strsec->sh_size;
 		    }
 
 		  dump_relocations (file, rel_offset, rel_size,
 				    symtab, nsyms, strtab, strtablen, is_rela);
-		  if (strtab)
-		    free (strtab);
-		  free (symtab);
 		}
 	      else
 		dump_relocations (file, rel_offset, rel_size,
@@ -5109,11 +5404,10 @@ ia64_process_unwind (FILE * file)
 	  && sec->sh_link < elf_header.e_shnum)
 	{
 	  aux.nsyms = sec->sh_size / sec->sh_entsize;
-	  aux.symtab = GET_ELF_SYMBOLS (file, sec);
+	  aux.symtab = get_symbol_table (file, sec);
 
 	  strsec = section_headers + sec->sh_link;
-	  aux.strtab = get_data (NULL, file, strsec->sh_offset,
-				 1, strsec->sh_size, _("string table"));
+	  aux.strtab = get_string_table (file, strsec, _("string table"));
 	  aux.strtab_size = aux.strtab != NULL ? strsec->sh_size : 0;
 	}
       else if (sec->sh_type == SHT_IA_64_UNWIND)
@@ -5223,11 +5517,6 @@ ia64_process_unwind (FILE * file)
 	}
     }
 
-  if (aux.symtab)
-    free (aux.symtab);
-  if (aux.strtab)
-    free ((char *) aux.strtab);
-
   return 1;
 }
 
@@ -5517,11 +5806,10 @@ hppa_process_unwind (FILE * file)
 	  && sec->sh_link < elf_header.e_shnum)
 	{
 	  aux.nsyms = sec->sh_size / sec->sh_entsize;
-	  aux.symtab = GET_ELF_SYMBOLS (file, sec);
+	  aux.symtab = get_symbol_table (file, sec);
 
 	  strsec = section_headers + sec->sh_link;
-	  aux.strtab = get_data (NULL, file, strsec->sh_offset,
-				 1, strsec->sh_size, _("string table"));
+	  aux.strtab = get_string_table (file, strsec, _("string table"));
 	  aux.strtab_size = aux.strtab != NULL ? strsec->sh_size : 0;
 	}
       else if (streq (SECTION_NAME (sec), ".PARISC.unwind"))
@@ -5552,11 +5840,6 @@ hppa_process_unwind (FILE * file)
 	}
     }
 
-  if (aux.symtab)
-    free (aux.symtab);
-  if (aux.strtab)
-    free ((char *) aux.strtab);
-
   return 1;
 }
 
@@ -6265,6 +6548,7 @@ process_dynamic_section (FILE * file)
 	case DT_TEXTREL	:
 	case DT_JMPREL	:
 	case DT_RUNPATH	:
+	case DT_RELR	:
 	  dynamic_info[entry->d_tag] = entry->d_un.d_val;
 
 	  if (do_dynamic)
@@ -6318,6 +6602,8 @@ process_dynamic_section (FILE * file)
 	case DT_RELAENT	:
 	case DT_SYMENT	:
 	case DT_RELENT	:
+	case DT_RELRSZ	:
+	case DT_RELRENT	:
 	  dynamic_info[entry->d_tag] = entry->d_un.d_val;
 	case DT_PLTPADSZ:
 	case DT_MOVEENT	:
@@ -6698,12 +6984,12 @@ process_version_sections (FILE * file)
 
 	    found = 1;
 
-	    symbols = GET_ELF_SYMBOLS (file, link_section);
+	    symbols = get_symbol_table (file, link_section);
 
 	    string_sec = section_headers + link_section->sh_link;
 
-	    strtab = get_data (NULL, file, string_sec->sh_offset, 1,
-			       string_sec->sh_size, _("version string table"));
+	    strtab = get_string_table (file, string_sec,
+				       _("version string table"));
 	    if (!strtab)
 	      break;
 
@@ -6719,13 +7005,10 @@ process_version_sections (FILE * file)
 	    off = offset_from_vma (file,
 				   version_info[DT_VERSIONTAGIDX (DT_VERSYM)],
 				   total * sizeof (short));
-	    edata = get_data (NULL, file, off, total, sizeof (short),
-			      _("version symbol data"));
+	    edata = get_mapped_data (file, off, total, sizeof (short),
+				     _("version symbol data"));
 	    if (!edata)
-	      {
-		free (strtab);
-		break;
-	      }
+	      break;
 
 	    data = cmalloc (total, sizeof (short));
 
@@ -6733,7 +7016,7 @@ process_version_sections (FILE * file)
 	      data[cnt] = byte_get (edata + cnt * sizeof (short),
 				    sizeof (short));
 
-	    free (edata);
+	    release_data (edata);
 
 	    for (cnt = 0; cnt < total; cnt += 4)
 	      {
@@ -6886,8 +7169,6 @@ process_version_sections (FILE * file)
 	      }
 
 	    free (data);
-	    free (strtab);
-	    free (symbols);
 	  }
 	  break;
 
@@ -7402,7 +7683,7 @@ process_symbol_table (FILE * file)
 	  else
 	    printf (_("   Num:    Value          Size Type    Bind   Vis      Ndx Name\n"));
 
-	  symtab = GET_ELF_SYMBOLS (file, section);
+	  symtab = get_symbol_table (file, section);
 	  if (symtab == NULL)
 	    continue;
 
@@ -7417,8 +7698,7 @@ process_symbol_table (FILE * file)
 
 	      string_sec = section_headers + section->sh_link;
 
-	      strtab = get_data (NULL, file, string_sec->sh_offset,
-				 1, string_sec->sh_size, _("string table"));
+	      strtab = get_string_table (file, string_sec, _("string table"));
 	      strtab_size = strtab != NULL ? string_sec->sh_size : 0;
 	    }
 
@@ -7581,10 +7861,6 @@ process_symbol_table (FILE * file)
 
 	      putchar ('\n');
 	    }
-
-	  free (symtab);
-	  if (strtab != string_table)
-	    free (strtab);
 	}
     }
   else if (do_syms)
@@ -8222,7 +8498,7 @@ apply_relocations (void * file,
 	is_rela = FALSE;
 
       symsec = section_headers + relsec->sh_link;
-      symtab = GET_ELF_SYMBOLS (file, symsec);
+      symtab = get_symbol_table (file, symsec);
 
       for (rp = relocs; rp < relocs + num_relocs; ++rp)
 	{
@@ -8301,7 +8577,6 @@ apply_relocations (void * file,
 	    byte_put (loc, addend + sym->st_value, reloc_size);
 	}
 
-      free (symtab);
       free (relocs);
       break;
     }
@@ -8321,10 +8596,13 @@ disassemble_section (Elf_Internal_Shdr * section, FILE * file)
 #endif
 
 /* Reads in the contents of SECTION from FILE, returning a pointer
-   to a malloc'ed buffer or NULL if something went wrong.  */
+   to a malloc'ed buffer or NULL if something went wrong.  If MAPPED,
+   the result may instead point into the file map, in which case it
+   must not be modified; either way it is released with release_data.  */
 
 static char *
-get_section_contents (Elf_Internal_Shdr * section, FILE * file)
+get_section_contents (Elf_Internal_Shdr * section, FILE * file,
+		      bfd_boolean mapped)
 {
   bfd_size_type num_bytes;
 
@@ -8337,6 +8615,10 @@ get_section_contents (Elf_Internal_Shdr * section, FILE * file)
       return NULL;
     }
 
+  if (mapped)
+    return get_mapped_data (file, section->sh_offset, 1, num_bytes,
+			    _("section contents"));
+
   return get_data (NULL, file, section->sh_offset, 1, num_bytes,
 		   _("section contents"));
 }
@@ -8354,7 +8636,7 @@ dump_section_as_strings (Elf_Internal_Shdr * section, FILE * file)
   char * name = SECTION_NAME (section);
   bfd_boolean some_strings_shown;
 
-  start = get_section_contents (section, file);
+  start = get_section_contents (section, file, FALSE);
   if (start == NULL)
     return;
 
@@ -8423,7 +8705,7 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
   unsigned char * data;
   unsigned char * start;
 
-  start = (unsigned char *) get_section_contents (section, file);
+  start = (unsigned char *) get_section_contents (section, file, ! relocate);
   if (start == NULL)
     return;
 
@@ -8497,7 +8779,7 @@ dump_section_as_bytes (Elf_Internal_Shdr * section,
       bytes -= lbytes;
     }
 
-  free (start);
+  release_data (start);
 
   putchar ('\n');
 }
@@ -8592,8 +8874,15 @@ load_specific_debug_section (enum dwarf_section_display_enum debug,
   snprintf (buf, sizeof (buf), _("%s section data"), section->name);
   section->address = sec->sh_addr;
   section->size = sec->sh_size;
-  section->start = get_data (NULL, file, sec->sh_offset, 1,
-			     sec->sh_size, buf);
+  /* Unless the contents are to be uncompressed or relocated they can
+     be used in place in the file map.  */
+  if (section_is_compressed
+      || (debug_displays [debug].relocate && elf_header.e_type == ET_REL))
+    section->start = get_data (NULL, file, sec->sh_offset, 1,
+			       sec->sh_size, buf);
+  else
+    section->start = (unsigned char *)
+      get_mapped_strings (file, sec->sh_offset, sec->sh_size, buf);
   if (section->start == NULL)
     return 0;
 
@@ -8637,7 +8926,7 @@ free_debug_section (enum dwarf_section_display_enum debug)
   if (section->start == NULL)
     return;
 
-  free ((char *) section->start);
+  release_data (section->start);
   section->start = NULL;
   section->address = 0;
   section->size = 0;
@@ -10706,6 +10995,8 @@ process_object (char * file_name, FILE * file)
       section_groups = NULL;
     }
 
+  free_table_cache ();
+
   free_debug_memory ();
 
   return 0;
@@ -11377,6 +11668,8 @@ process_file (char * file_name)
       return 1;
     }
 
+  map_file (file, statbuf.st_size);
+
   if (memcmp (armag, ARMAG, SARMAG) == 0)
     ret = process_archive (file_name, file, FALSE);
   else if (memcmp (armag, ARMAGT, SARMAG) == 0)
@@ -11392,6 +11685,7 @@ process_file (char * file_name)
       ret = process_object (file_name, file);
     }
 
+  unmap_file ();
   fclose (file);
 
   return ret;
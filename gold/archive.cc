@@ -25,6 +25,8 @@
 #include <cerrno>
 #include <cstring>
 #include <climits>
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include "libiberty.h"
 #include "filenames.h"
@@ -86,7 +88,8 @@ const char Archive::arfmag[2] = { '`', '\n' };
 Archive::Archive(const std::string& name, Input_file* input_file,
                  bool is_thin_archive, Dirsearch* dirpath, Task* task)
   : name_(name), input_file_(input_file), armap_(), armap_names_(),
-    extended_names_(), armap_checked_(), seen_offsets_(), members_(),
+    extended_names_(), armap_checked_(), armap_index_(), seen_offsets_(),
+    members_(),
     is_thin_archive_(is_thin_archive), included_member_(false),
     nested_archives_(), dirpath_(dirpath), task_(task), num_members_(0)
 {
@@ -600,11 +603,16 @@ Archive::read_symbols(off_t off)
 // Select members from the archive and add them to the link.  We walk
 // through the elements in the archive map, and look each one up in
 // the symbol table.  If it exists as a strong undefined symbol, we
-// pull in the corresponding element.  We have to do this in a loop,
-// since pulling in one element may create new undefined symbols which
-// may be satisfied by other objects in the archive.  Return true in
-// the normal case, false if the first member we tried to add from
-// this archive had an incompatible target.
+// pull in the corresponding element.  Pulling in one element may
+// create new undefined symbols which may be satisfied by other
+// objects in the archive.  Rather than walking the whole archive map
+// again, the symbol table records the strong undefined references
+// made by the elements we pull in, and we look at just the entries
+// in the archive map for those symbols.  We look at them in the same
+// order as repeated walks over the archive map would, so the same
+// elements are pulled in in the same order.  Return true in the
+// normal case, false if the first member we tried to add from this
+// archive had an incompatible target.
 
 bool
 Archive::add_symbols(Symbol_table* symtab, Layout* layout,
@@ -622,120 +630,232 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 
   const size_t armap_size = this->armap_.size();
 
+  if (this->armap_index_.empty())
+    this->build_armap_index();
+
   // This is a quick optimization, since we usually see many symbols
   // in a row with the same offset.  last_seen_offset holds the last
   // offset we saw that was present in the seen_offsets_ set.
   off_t last_seen_offset = -1;
 
-  // Track which symbols in the symbol table we've already found to be
-  // defined.
+  symtab->set_log_undefined(true);
 
-  char* tmpbuf = NULL;
-  size_t tmpbuflen = 0;
-  bool added_new_object;
-  do
+  // The first pass looks at every entry.  Entries which may be
+  // satisfied after an element is pulled in are saved in NEXT_PASS if
+  // we have already passed them.
+  std::vector<size_t> next_pass;
+  for (size_t i = 0; i < armap_size; ++i)
     {
-      added_new_object = false;
-      for (size_t i = 0; i < armap_size; ++i)
+      Symbol* sym;
+      std::string why;
+      if (!this->should_include_member(symtab, i, &last_seen_offset, &sym,
+				       &why))
+	continue;
+
+      if (!this->include_member(symtab, layout, input_objects,
+				last_seen_offset, mapfile, sym, why.c_str()))
 	{
-          if (this->armap_checked_[i])
-            continue;
-	  if (this->armap_[i].file_offset == last_seen_offset)
-            {
-              this->armap_checked_[i] = true;
-              continue;
-            }
-	  if (this->seen_offsets_.find(this->armap_[i].file_offset)
-              != this->seen_offsets_.end())
-	    {
-              this->armap_checked_[i] = true;
-	      last_seen_offset = this->armap_[i].file_offset;
-	      continue;
-	    }
+	  symtab->set_log_undefined(false);
+	  return false;
+	}
 
-	  const char* sym_name = (this->armap_names_.data()
-				  + this->armap_[i].name_offset);
+      this->queue_armap_entries(symtab, i, NULL, &next_pass);
+    }
 
-	  // In an object file, and therefore in an archive map, an
-	  // '@' in the name separates the symbol name from the
-	  // version name.  If there are two '@' characters, this is
-	  // the default version.
-	  const char* ver = strchr(sym_name, '@');
-	  bool def = false;
-	  if (ver != NULL)
-	    {
-	      size_t symlen = ver - sym_name;
-	      if (symlen + 1 > tmpbuflen)
-		{
-		  tmpbuf = static_cast<char*>(realloc(tmpbuf, symlen + 1));
-		  tmpbuflen = symlen + 1;
-		}
-	      memcpy(tmpbuf, sym_name, symlen);
-	      tmpbuf[symlen] = '\0';
-	      sym_name = tmpbuf;
-
-	      ++ver;
-	      if (*ver == '@')
-		{
-		  ++ver;
-		  def = true;
-		}
-	    }
+  // Each later pass looks at the saved entries in order.  THIS_PASS
+  // is a heap holding the entries still to look at in this pass.
+  std::vector<size_t> this_pass;
+  while (!next_pass.empty())
+    {
+      this_pass.swap(next_pass);
+      next_pass.clear();
+      std::make_heap(this_pass.begin(), this_pass.end(),
+		     std::greater<size_t>());
 
-	  Symbol* sym = symtab->lookup(sym_name, ver);
-	  if (def
-	      && (sym == NULL
-		  || !sym->is_undefined()
-		  || sym->binding() == elfcpp::STB_WEAK))
-	    sym = symtab->lookup(sym_name, NULL);
+      size_t last = armap_size;
+      while (!this_pass.empty())
+	{
+	  std::pop_heap(this_pass.begin(), this_pass.end(),
+			std::greater<size_t>());
+	  size_t i = this_pass.back();
+	  this_pass.pop_back();
 
-	  if (sym == NULL)
-	    {
-	      // Check whether the symbol was named in a -u option.
-	      if (!parameters->options().is_undefined(sym_name))
-		continue;
-	    }
-	  else if (!sym->is_undefined())
-	    {
-              this->armap_checked_[i] = true;
-	      continue;
-	    }
-	  else if (sym->binding() == elfcpp::STB_WEAK)
+	  // The same entry may be queued more than once.
+	  if (i == last)
 	    continue;
+	  last = i;
 
-	  // We want to include this object in the link.
-	  last_seen_offset = this->armap_[i].file_offset;
-	  this->seen_offsets_.insert(last_seen_offset);
-          this->armap_checked_[i] = true;
-
+	  Symbol* sym;
 	  std::string why;
-	  if (sym == NULL)
-	    {
-	      why = "-u ";
-	      why += sym_name;
-	    }
+	  if (!this->should_include_member(symtab, i, &last_seen_offset, &sym,
+					   &why))
+	    continue;
+
 	  if (!this->include_member(symtab, layout, input_objects,
 				    last_seen_offset, mapfile, sym,
 				    why.c_str()))
 	    {
-	      if (tmpbuf != NULL)
-		free(tmpbuf);
+	      symtab->set_log_undefined(false);
 	      return false;
 	    }
 
-	  added_new_object = true;
+	  this->queue_armap_entries(symtab, i, &this_pass, &next_pass);
 	}
     }
-  while (added_new_object);
 
-  if (tmpbuf != NULL)
-    free(tmpbuf);
+  symtab->set_log_undefined(false);
 
   input_objects->archive_stop(this);
 
   return true;
 }
 
+// Build the index of the archive map, so that we can find the entries
+// for a symbol without walking the whole map.
+
+void
+Archive::build_armap_index()
+{
+  const size_t armap_size = this->armap_.size();
+  this->armap_index_.reserve(armap_size);
+  for (size_t i = 0; i < armap_size; ++i)
+    {
+      const char* sym_name = (this->armap_names_.data()
+			      + this->armap_[i].name_offset);
+      size_t len = strcspn(sym_name, "@");
+      this->armap_index_.push_back(std::make_pair(Stringpool::hash_string(sym_name,
+									  len),
+						  i));
+    }
+  std::sort(this->armap_index_.begin(), this->armap_index_.end());
+}
+
+// Check entry I in the archive map.  An entry is marked as checked if
+// we never need to look at it again.
+
+bool
+Archive::should_include_member(Symbol_table* symtab, size_t i,
+			       off_t* last_seen_offset, Symbol** psym,
+			       std::string* why)
+{
+  if (this->armap_checked_[i])
+    return false;
+  if (this->armap_[i].file_offset == *last_seen_offset)
+    {
+      this->armap_checked_[i] = true;
+      return false;
+    }
+  if (this->seen_offsets_.find(this->armap_[i].file_offset)
+      != this->seen_offsets_.end())
+    {
+      this->armap_checked_[i] = true;
+      *last_seen_offset = this->armap_[i].file_offset;
+      return false;
+    }
+
+  const char* sym_name = (this->armap_names_.data()
+			  + this->armap_[i].name_offset);
+
+  // In an object file, and therefore in an archive map, an '@' in the
+  // name separates the symbol name from the version name.  If there
+  // are two '@' characters, this is the default version.
+  std::string name_without_version;
+  const char* ver = strchr(sym_name, '@');
+  bool def = false;
+  if (ver != NULL)
+    {
+      name_without_version.assign(sym_name, ver - sym_name);
+      sym_name = name_without_version.c_str();
+
+      ++ver;
+      if (*ver == '@')
+	{
+	  ++ver;
+	  def = true;
+	}
+    }
+
+  Symbol* sym = symtab->lookup(sym_name, ver);
+  if (def
+      && (sym == NULL
+	  || !sym->is_undefined()
+	  || sym->binding() == elfcpp::STB_WEAK))
+    sym = symtab->lookup(sym_name, NULL);
+
+  if (sym == NULL)
+    {
+      // Check whether the symbol was named in a -u option.
+      if (!parameters->options().is_undefined(sym_name))
+	return false;
+    }
+  else if (!sym->is_undefined())
+    {
+      this->armap_checked_[i] = true;
+      return false;
+    }
+  else if (sym->binding() == elfcpp::STB_WEAK)
+    return false;
+
+  // We want to include this object in the link.
+  *last_seen_offset = this->armap_[i].file_offset;
+  this->seen_offsets_.insert(*last_seen_offset);
+  this->armap_checked_[i] = true;
+
+  why->clear();
+  if (sym == NULL)
+    {
+      *why = "-u ";
+      *why += sym_name;
+    }
+  *psym = sym;
+  return true;
+}
+
+// Find the entries in the archive map for the symbols which have
+// gotten strong undefined references since the last call.  Entries
+// after POS are added to the heap THIS_PASS, or are ignored if
+// THIS_PASS is NULL because the caller will look at every entry
+// anyhow.  Entries at or before POS are added to NEXT_PASS.
+
+void
+Archive::queue_armap_entries(Symbol_table* symtab, size_t pos,
+			     std::vector<size_t>* this_pass,
+			     std::vector<size_t>* next_pass)
+{
+  std::vector<Symbol*> syms;
+  symtab->take_undefined_log(&syms);
+  for (std::vector<Symbol*>::const_iterator p = syms.begin();
+       p != syms.end();
+       ++p)
+    {
+      const char* name = (*p)->name();
+      size_t len = strlen(name);
+      size_t hash_code = Stringpool::hash_string(name, len);
+      std::vector<std::pair<size_t, size_t> >::const_iterator q =
+	std::lower_bound(this->armap_index_.begin(), this->armap_index_.end(),
+			 std::make_pair(hash_code, static_cast<size_t>(0)));
+      for (; q != this->armap_index_.end() && q->first == hash_code; ++q)
+	{
+	  size_t i = q->second;
+	  if (this->armap_checked_[i])
+	    continue;
+	  const char* sym_name = (this->armap_names_.data()
+				  + this->armap_[i].name_offset);
+	  if (strncmp(sym_name, name, len) != 0
+	      || (sym_name[len] != '\0' && sym_name[len] != '@'))
+	    continue;
+	  if (i <= pos)
+	    next_pass->push_back(i);
+	  else if (this_pass != NULL)
+	    {
+	      this_pass->push_back(i);
+	      std::push_heap(this_pass->begin(), this_pass->end(),
+			     std::greater<size_t>());
+	    }
+	}
+    }
+}
+
 // Include all the archive members in the link.  This is for --whole-archive.
 
 bool
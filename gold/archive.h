@@ -208,6 +208,24 @@ class Archive
   bool
   include_all_members(Symbol_table*, Layout*, Input_objects*, Mapfile*);
 
+  // Build armap_index_.
+  void
+  build_armap_index();
+
+  // Return whether to include the member for entry I in the archive
+  // map.  If so, set *PSYM and *WHY for include_member.
+  bool
+  should_include_member(Symbol_table*, size_t i, off_t* last_seen_offset,
+			Symbol** psym, std::string* why);
+
+  // Queue the entries in the archive map for the symbols which have
+  // new strong undefined references.  POS is the entry which was just
+  // checked.
+  void
+  queue_armap_entries(Symbol_table*, size_t pos,
+		      std::vector<size_t>* this_pass,
+		      std::vector<size_t>* next_pass);
+
   // Include an archive member in the link.
   bool
   include_member(Symbol_table*, Layout*, Input_objects*, off_t off,
@@ -277,6 +295,10 @@ class Archive
   // Track which symbols in the archive map are for elements which are
   // defined or which have already been included in the link.
   std::vector<bool> armap_checked_;
+  // An index of the archive map: the hash code of each symbol name,
+  // without any version, and the index of its entry, sorted by hash
+  // code.
+  std::vector<std::pair<size_t, size_t> > armap_index_;
   // Track which elements have been included by offset.
   Unordered_set<off_t, Seen_hash> seen_offsets_;
   // Table of objects whose symbols have been pre-read.
@@ -146,18 +146,47 @@ template<int size>
 void
 Symbol_table::do_allocate_commons(Layout* layout, Mapfile* mapfile)
 {
-  if (!this->commons_.empty())
+  Commons_type commons;
+  this->collect_commons(&Symbol_table_shard::commons, &commons);
+  if (!commons.empty())
     this->do_allocate_commons_list<size>(layout, COMMONS_NORMAL,
-					 &this->commons_, mapfile);
-  if (!this->tls_commons_.empty())
+					 &commons, mapfile);
+
+  Commons_type tls_commons;
+  this->collect_commons(&Symbol_table_shard::tls_commons, &tls_commons);
+  if (!tls_commons.empty())
     this->do_allocate_commons_list<size>(layout, COMMONS_TLS,
-					 &this->tls_commons_, mapfile);
-  if (!this->small_commons_.empty())
+					 &tls_commons, mapfile);
+
+  Commons_type small_commons;
+  this->collect_commons(&Symbol_table_shard::small_commons, &small_commons);
+  if (!small_commons.empty())
     this->do_allocate_commons_list<size>(layout, COMMONS_SMALL,
-					 &this->small_commons_, mapfile);
-  if (!this->large_commons_.empty())
+					 &small_commons, mapfile);
+
+  Commons_type large_commons;
+  this->collect_commons(&Symbol_table_shard::large_commons, &large_commons);
+  if (!large_commons.empty())
     this->do_allocate_commons_list<size>(layout, COMMONS_LARGE,
-					 &this->large_commons_, mapfile);
+					 &large_commons, mapfile);
+}
+
+// Collect the common symbols of one type from each shard of the
+// symbol table, in shard order.  WHICH is the list to collect.
+
+void
+Symbol_table::collect_commons(Commons_type Symbol_table_shard::* which,
+			      Commons_type* commons) const
+{
+  size_t count = 0;
+  for (unsigned int i = 0; i < shard_count; ++i)
+    count += (this->shards_[i].*which).size();
+  commons->reserve(count);
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      const Commons_type& list(this->shards_[i].*which);
+      commons->insert(commons->end(), list.begin(), list.end());
+    }
 }
 
 // Allocate the common symbols in a list.  IS_TLS indicates whether
@@ -28,111 +28,316 @@
 
 #include "parameters.h"
 #include "options.h"
+#include "layout.h"
 #include "compressed_output.h"
 
 namespace gold
 {
 
-// Compress UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns true
-// if it successfully compressed, false if it failed for any reason
-// (including not having zlib support in the library).  If it returns
-// true, it allocates memory for the compressed data using new, and
-// sets *COMPRESSED_DATA and *COMPRESSED_SIZE to appropriate values.
-// It also writes a header before COMPRESSED_DATA: 4 bytes saying
-// "ZLIB", and 8 bytes indicating the uncompressed size, in big-endian
-// order.
+// The section contents are compressed in chunks of this size.  A
+// chunk can not refer back to data in the previous chunk, which
+// costs a little in the compression ratio, so the chunks should not
+// be too small.
+
+static const size_t compress_chunk_size = 1024 * 1024;
+
+// The size of the header we write before the zlib stream: 4 bytes
+// saying "ZLIB", and 8 bytes indicating the uncompressed size, in
+// big-endian order.
+
+static const size_t compressed_header_size = 12;
+
+// The zlib stream has a 2 byte header and a 4 byte Adler-32 trailer
+// around the deflate data.
+
+static const size_t zlib_header_size = 2;
+static const size_t zlib_trailer_size = 4;
 
 #ifdef HAVE_ZLIB_H
 
-static bool
-zlib_compress(const unsigned char* uncompressed_data,
-              unsigned long uncompressed_size,
-              unsigned char** compressed_data,
-              unsigned long* compressed_size)
-{
-  const int header_size = 12;
-  *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
-  *compressed_data = new unsigned char[*compressed_size + header_size];
-
-  int compress_level;
-  if (parameters->options().optimize() >= 1)
-    compress_level = 9;
-  else
-    compress_level = 1;
-
-  int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data) + header_size,
-                     compressed_size,
-                     reinterpret_cast<const Bytef*>(uncompressed_data),
-                     uncompressed_size,
-                     compress_level);
-  if (rc == Z_OK)
+// Return the zlib compression level and strategy to use.
+
+static void
+zlib_compress_options(const General_options* options, int* level,
+		      int* strategy)
+{
+  if (strcmp(options->compress_debug_sections(), "zlib-fast") == 0)
     {
-      memcpy(*compressed_data, "ZLIB", 4);
-      elfcpp::Swap_unaligned<64, true>::writeval(*compressed_data + 4,
-						 uncompressed_size);
-      *compressed_size += header_size;
-      return true;
+      // Only look for runs of repeated bytes.  This is much faster
+      // than the usual string matching, and debugging information
+      // has plenty of runs of zero bytes.  The output is still an
+      // ordinary zlib stream.
+      *level = 1;
+      *strategy = Z_RLE;
     }
   else
     {
-      delete[] *compressed_data;
-      *compressed_data = NULL;
+      if (parameters->options().optimize() >= 1)
+	*level = 9;
+      else
+	*level = 1;
+      *strategy = Z_DEFAULT_STRATEGY;
+    }
+}
+
+// Compress UNCOMPRESSED_SIZE bytes at UNCOMPRESSED_DATA as a raw
+// deflate stream.  If IS_LAST is false, end with a sync flush, so
+// that the deflate data of another chunk may follow.  Returns true
+// if it successfully compressed, false if it failed for any reason.
+// If it returns true, it allocates memory for the compressed data
+// using new, and sets *COMPRESSED_DATA and *COMPRESSED_SIZE.
+
+static bool
+zlib_compress_chunk(const General_options* options,
+		    const unsigned char* uncompressed_data,
+		    size_t uncompressed_size, bool is_last,
+		    unsigned char** compressed_data,
+		    size_t* compressed_size)
+{
+  int level;
+  int strategy;
+  zlib_compress_options(options, &level, &strategy);
+
+  z_stream strm;
+  memset(&strm, 0, sizeof strm);
+  if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, strategy) != Z_OK)
+    return false;
+
+  // deflateBound allows for the end of the stream; allow a few more
+  // bytes for a sync flush.
+  size_t bound = deflateBound(&strm, uncompressed_size) + 16;
+  unsigned char* buf = new unsigned char[bound];
+
+  strm.next_in = const_cast<Bytef*>(uncompressed_data);
+  strm.avail_in = uncompressed_size;
+  strm.next_out = buf;
+  strm.avail_out = bound;
+  int rc = deflate(&strm, is_last ? Z_FINISH : Z_SYNC_FLUSH);
+  bool ok = ((is_last ? rc == Z_STREAM_END : rc == Z_OK)
+	     && strm.avail_in == 0
+	     && strm.avail_out > 0);
+  size_t size = bound - strm.avail_out;
+  deflateEnd(&strm);
+
+  if (!ok)
+    {
+      delete[] buf;
       return false;
     }
+
+  *compressed_data = buf;
+  *compressed_size = size;
+  return true;
+}
+
+// Return the Adler-32 checksum of a chunk.
+
+static unsigned long
+zlib_chunk_adler(const unsigned char* data, size_t size)
+{
+  return adler32(adler32(0L, Z_NULL, 0), data, size);
+}
+
+// Combine the Adler-32 checksums of two adjacent chunks.  LEN2 is
+// the size of the second chunk.
+
+static unsigned long
+zlib_combine_adler(unsigned long adler1, unsigned long adler2, size_t len2)
+{
+  return adler32_combine(adler1, adler2, len2);
+}
+
+// Return the zlib stream header.
+
+static void
+zlib_stream_header(const General_options* options, unsigned char* header)
+{
+  int level;
+  int strategy;
+  zlib_compress_options(options, &level, &strategy);
+
+  // CMF: deflate with a 32K window.  FLG: the compression level,
+  // and a check value which makes the header a multiple of 31.
+  unsigned int cmf = 0x78;
+  unsigned int flevel;
+  if (level == 1)
+    flevel = 0;
+  else if (level < 6)
+    flevel = 1;
+  else if (level == 6)
+    flevel = 2;
+  else
+    flevel = 3;
+  unsigned int flg = flevel << 6;
+  flg += 31 - (cmf * 256 + flg) % 31;
+  header[0] = cmf;
+  header[1] = flg;
 }
 
 #else // !defined(HAVE_ZLIB_H)
 
 static bool
-zlib_compress(const unsigned char*, unsigned long,
-              unsigned char**, unsigned long*)
+zlib_compress_chunk(const General_options*, const unsigned char*, size_t,
+		    bool, unsigned char**, size_t*)
 {
   return false;
 }
 
+static unsigned long
+zlib_chunk_adler(const unsigned char*, size_t)
+{
+  return 0;
+}
+
+static unsigned long
+zlib_combine_adler(unsigned long, unsigned long, size_t)
+{
+  return 0;
+}
+
+static void
+zlib_stream_header(const General_options*, unsigned char*)
+{
+  gold_unreachable();
+}
+
 #endif // !defined(HAVE_ZLIB_H)
 
 // Class Output_compressed_section.
 
-// Set the final data size of a compressed section.  This is where
-// we actually compress the section data.
+Output_compressed_section::~Output_compressed_section()
+{
+  this->free_chunks();
+}
+
+// Free the compressed data of the chunks.
+
+void
+Output_compressed_section::free_chunks()
+{
+  for (std::vector<Chunk>::iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      delete[] p->compressed;
+      p->compressed = NULL;
+    }
+}
+
+// Prepare to compress the section.  At this point the contents of
+// all regular input sections will have been copied into the
+// postprocessing buffer, and relocations will have been applied.
+// Copy in the contents of anything other than a regular input
+// section, and divide the buffer into chunks.
+
+unsigned int
+Output_compressed_section::prepare_compression()
+{
+  gold_assert(!this->prepared_);
+  this->prepared_ = true;
+
+  this->write_to_postprocessing_buffer();
+
+  const unsigned char* data = this->postprocessing_buffer();
+  size_t size = this->postprocessing_buffer_size();
+
+  if (strcmp(this->options_->compress_debug_sections(), "none") == 0
+      || size == 0)
+    return 0;
+
+  size_t chunk_count = (size + compress_chunk_size - 1) / compress_chunk_size;
+  this->chunks_.resize(chunk_count);
+  for (size_t i = 0; i < chunk_count; ++i)
+    {
+      Chunk* chunk = &this->chunks_[i];
+      chunk->uncompressed = data + i * compress_chunk_size;
+      chunk->uncompressed_size = std::min(compress_chunk_size,
+					  size - i * compress_chunk_size);
+      chunk->compressed = NULL;
+      chunk->compressed_size = 0;
+      chunk->adler = 0;
+    }
+  return chunk_count;
+}
+
+// Compress a single chunk.
+
+void
+Output_compressed_section::compress_chunk(unsigned int chunk)
+{
+  gold_assert(chunk < this->chunks_.size());
+  Chunk* c = &this->chunks_[chunk];
+  bool is_last = chunk + 1 == this->chunks_.size();
+  if (!zlib_compress_chunk(this->options_, c->uncompressed,
+			   c->uncompressed_size, is_last, &c->compressed,
+			   &c->compressed_size))
+    {
+      c->compressed = NULL;
+      return;
+    }
+  c->adler = zlib_chunk_adler(c->uncompressed, c->uncompressed_size);
+}
+
+// Set the final data size of a compressed section.  The chunks have
+// normally been compressed by Compress_chunk_tasks by now; if not, we
+// compress them here.
 
 void
 Output_compressed_section::set_final_data_size()
 {
   off_t uncompressed_size = this->postprocessing_buffer_size();
 
-  // (Try to) compress the data.
-  unsigned long compressed_size;
-  unsigned char* uncompressed_data = this->postprocessing_buffer();
+  if (!this->prepared_)
+    {
+      unsigned int chunk_count = this->prepare_compression();
+      for (unsigned int i = 0; i < chunk_count; ++i)
+	this->compress_chunk(i);
+    }
 
-  // At this point the contents of all regular input sections will
-  // have been copied into the postprocessing buffer, and relocations
-  // will have been applied.  Now we need to copy in the contents of
-  // anything other than a regular input section.
-  this->write_to_postprocessing_buffer();
+  // There is nothing to compress in an empty section, so leave it
+  // uncompressed without complaint.
+  if (uncompressed_size == 0)
+    {
+      this->set_data_size(0);
+      return;
+    }
+
+  bool success = !this->chunks_.empty();
+  size_t compressed_size = (compressed_header_size + zlib_header_size
+			    + zlib_trailer_size);
+  for (std::vector<Chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      if (p->compressed == NULL)
+	{
+	  success = false;
+	  break;
+	}
+      compressed_size += p->compressed_size;
+    }
 
-  bool success = false;
-  if (strcmp(this->options_->compress_debug_sections(), "zlib") == 0)
-    success = zlib_compress(uncompressed_data, uncompressed_size,
-                            &this->data_, &compressed_size);
   if (success)
     {
       // This converts .debug_foo to .zdebug_foo
       this->new_section_name_ = std::string(".z") + (this->name() + 1);
       this->set_name(this->new_section_name_.c_str());
       this->set_data_size(compressed_size);
+      this->compressed_ = true;
     }
   else
     {
-      gold_warning(_("not compressing section data: zlib error"));
-      gold_assert(this->data_ == NULL);
+      if (strcmp(this->options_->compress_debug_sections(), "none") != 0)
+	gold_warning(_("not compressing section data: zlib error"));
+      this->free_chunks();
+      this->chunks_.clear();
       this->set_data_size(uncompressed_size);
     }
 }
 
 // Write out a compressed section.  If we couldn't compress, we just
-// write it out as normal, uncompressed data.
+// write it out as normal, uncompressed data.  The compressed chunks
+// are freed as they are written.
 
 void
 Output_compressed_section::do_write(Output_file* of)
@@ -140,11 +345,96 @@ Output_compressed_section::do_write(Output_file* of)
   off_t offset = this->offset();
   off_t data_size = this->data_size();
   unsigned char* view = of->get_output_view(offset, data_size);
-  if (this->data_ == NULL)
+  if (!this->compressed_)
     memcpy(view, this->postprocessing_buffer(), data_size);
   else
-    memcpy(view, this->data_, data_size);
+    {
+      // The postprocessing buffer size is now the compressed size,
+      // so get the uncompressed size from the chunks.
+      uint64_t uncompressed_size = 0;
+      for (std::vector<Chunk>::const_iterator p = this->chunks_.begin();
+	   p != this->chunks_.end();
+	   ++p)
+	uncompressed_size += p->uncompressed_size;
+
+      unsigned char* pov = view;
+      memcpy(pov, "ZLIB", 4);
+      elfcpp::Swap_unaligned<64, true>::writeval(pov + 4, uncompressed_size);
+      pov += compressed_header_size;
+
+      zlib_stream_header(this->options_, pov);
+      pov += zlib_header_size;
+
+      unsigned long adler = 1;
+      for (std::vector<Chunk>::iterator p = this->chunks_.begin();
+	   p != this->chunks_.end();
+	   ++p)
+	{
+	  memcpy(pov, p->compressed, p->compressed_size);
+	  pov += p->compressed_size;
+	  adler = zlib_combine_adler(adler, p->adler, p->uncompressed_size);
+	  delete[] p->compressed;
+	  p->compressed = NULL;
+	}
+
+      elfcpp::Swap_unaligned<32, true>::writeval(pov, adler);
+      pov += zlib_trailer_size;
+
+      gold_assert(pov - view == data_size);
+    }
   of->write_output_view(offset, data_size, view);
 }
 
+// Class Compress_chunk_task.
+
+// We can always run this task.
+
+Task_token*
+Compress_chunk_task::is_runnable()
+{
+  return NULL;
+}
+
+// We need to unlock CHUNKS_BLOCKER when finished.
+
+void
+Compress_chunk_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->chunks_blocker_);
+}
+
+// Compress the chunk.
+
+void
+Compress_chunk_task::run(Workqueue*)
+{
+  this->os_->compress_chunk(this->chunk_);
+}
+
+// Return a name for the task.
+
+std::string
+Compress_chunk_task::get_name() const
+{
+  char buf[30];
+  snprintf(buf, sizeof buf, " chunk %u", this->chunk_);
+  return std::string("Compress_chunk_task ") + this->os_->name() + buf;
+}
+
+// Class Compress_sections_task_runner.
+
+// Queue a task for each chunk of each compressed section, followed by
+// the task which writes out the sections after the input sections.
+
+void
+Compress_sections_task_runner::run(Workqueue* workqueue, const Task*)
+{
+  Task_token* chunks_blocker = new Task_token(true);
+  this->layout_->queue_compression_tasks(workqueue, chunks_blocker);
+  workqueue->queue(new Write_after_input_sections_task(this->layout_,
+						       this->of_,
+						       chunks_blocker,
+						       this->final_blocker_));
+}
+
 } // End namespace gold.
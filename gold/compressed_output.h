@@ -29,18 +29,27 @@
 #define GOLD_COMPRESSED_OUTPUT_H
 
 #include <string>
+#include <vector>
 
 #include "output.h"
+#include "workqueue.h"
 
 namespace gold
 {
 
 class General_options;
+class Layout;
 
 // This is used for a section whose data should be compressed.  It is
 // a regular Output_section which computes its contents into a buffer
 // and then postprocesses it.
 
+// The contents are divided into chunks which are compressed
+// independently, so that when running with threads the chunks can be
+// compressed in parallel.  Each chunk but the last is ended with a
+// sync flush, so the compressed chunks concatenate into a single zlib
+// stream which any consumer of compressed sections can read.
+
 class Output_compressed_section : public Output_section
 {
  public:
@@ -48,9 +57,23 @@ class Output_compressed_section : public Output_section
 			    const char* name, elfcpp::Elf_Word flags,
 			    elfcpp::Elf_Xword type)
     : Output_section(name, flags, type),
-      options_(options)
+      options_(options), chunks_(), prepared_(false), compressed_(false),
+      new_section_name_()
   { this->set_requires_postprocessing(); }
 
+  ~Output_compressed_section();
+
+  // Prepare to compress the section contents, and return the number
+  // of chunks.  This must be called after all the input sections have
+  // been written to the postprocessing buffer.
+  unsigned int
+  prepare_compression();
+
+  // Compress chunk CHUNK.  This may be called for different chunks
+  // at the same time.
+  void
+  compress_chunk(unsigned int chunk);
+
  protected:
   // Set the final data size.
   void
@@ -61,14 +84,92 @@ class Output_compressed_section : public Output_section
   do_write(Output_file*);
 
  private:
+  // A compressed chunk of the section contents.
+  struct Chunk
+  {
+    // The uncompressed data.
+    const unsigned char* uncompressed;
+    // The size of the uncompressed data.
+    size_t uncompressed_size;
+    // The compressed data, allocated with new[].  This is NULL if the
+    // chunk could not be compressed.
+    unsigned char* compressed;
+    // The size of the compressed data.
+    size_t compressed_size;
+    // The Adler-32 checksum of the uncompressed data.
+    unsigned long adler;
+  };
+
+  // Free the compressed chunks.
+  void
+  free_chunks();
+
   // The options--this includes the compression type.
   const General_options* options_;
-  // The compressed data.
-  unsigned char* data_;
+  // The chunks of the section.
+  std::vector<Chunk> chunks_;
+  // Whether prepare_compression has been called.
+  bool prepared_;
+  // Whether we successfully compressed the section.
+  bool compressed_;
   // The new section name if we do compress.
   std::string new_section_name_;
 };
 
+// This task compresses one chunk of an Output_compressed_section.
+
+class Compress_chunk_task : public Task
+{
+ public:
+  // CHUNKS_BLOCKER is unblocked when all the chunks are done.
+  Compress_chunk_task(Output_compressed_section* os, unsigned int chunk,
+		      Task_token* chunks_blocker)
+    : os_(os), chunk_(chunk), chunks_blocker_(chunks_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Output_compressed_section* os_;
+  unsigned int chunk_;
+  Task_token* chunks_blocker_;
+};
+
+// This task function queues the tasks which compress the chunks of
+// all the compressed sections, and then queues the
+// Write_after_input_sections_task which lays out and writes them.
+
+class Compress_sections_task_runner : public Task_function_runner
+{
+ public:
+  // FINAL_BLOCKER is passed to the Write_after_input_sections_task.
+  Compress_sections_task_runner(Layout* layout, Output_file* of,
+				Task_token* final_blocker)
+    : layout_(layout), of_(of), final_blocker_(final_blocker)
+  { }
+
+  // Run the operation.
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  Layout* layout_;
+  Output_file* of_;
+  Task_token* final_blocker_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_COMPRESSED_OUTPUT_H)
@@ -129,9 +129,11 @@ ResetLineStateMachine(struct LineStateMachine* lsm, bool default_is_stmt)
 
 template<int size, bool big_endian>
 Sized_dwarf_line_info<size, big_endian>::Sized_dwarf_line_info(Object* object,
-                                                               off_t read_shndx)
-  : data_valid_(false), buffer_(NULL), symtab_buffer_(NULL),
-    directories_(), files_(), current_header_index_(-1)
+                                                               off_t read_shndx,
+							       bool parse)
+  : data_valid_(false), buffer_(NULL), buffer_copy_(NULL),
+    read_shndx_(read_shndx), symtab_buffer_(NULL), directories_(), files_(),
+    current_header_index_(-1)
 {
   unsigned int debug_shndx;
   for (debug_shndx = 0; debug_shndx < object->shnum(); ++debug_shndx)
@@ -181,9 +183,35 @@ Sized_dwarf_line_info<size, big_endian>::Sized_dwarf_line_info(Object* object,
     }
 
   // Now that we have successfully read all the data, parse the debug
-  // info.
+  // info.  The relocations are always read now, since that may need
+  // to read the file.  After that, only the line information itself
+  // is used; if we are not parsing it yet, copy it, since our view
+  // of the file may go away once OBJECT is unlocked.
   this->data_valid_ = true;
-  this->read_line_mappings(object, read_shndx);
+  this->read_relocs(object);
+  if (parse)
+    this->read_line_mappings(read_shndx);
+  else
+    {
+      section_size_type buffer_size = this->buffer_end_ - this->buffer_;
+      this->buffer_copy_ = new unsigned char[buffer_size];
+      memcpy(this->buffer_copy_, this->buffer_, buffer_size);
+      this->buffer_ = this->buffer_copy_;
+      this->buffer_end_ = this->buffer_copy_ + buffer_size;
+    }
+}
+
+// Parse the line information which the constructor copied.
+
+template<int size, bool big_endian>
+void
+Sized_dwarf_line_info<size, big_endian>::do_parse()
+{
+  if (this->data_valid_)
+    {
+      gold_assert(this->buffer_copy_ != NULL);
+      this->read_line_mappings(this->read_shndx_);
+    }
 }
 
 // Read the DWARF header.
@@ -223,6 +251,11 @@ Sized_dwarf_line_info<size, big_endian>::read_header_prolog(
   header_.min_insn_length = *lineptr;
   lineptr += 1;
 
+  // DWARF4 adds the maximum number of operations per instruction,
+  // which is only used for VLIW targets.
+  if (header_.version >= 4)
+    lineptr += 1;
+
   header_.default_is_stmt = *lineptr;
   lineptr += 1;
 
@@ -594,16 +627,24 @@ Sized_dwarf_line_info<size, big_endian>::read_relocs(Object* object)
 
 template<int size, bool big_endian>
 void
-Sized_dwarf_line_info<size, big_endian>::read_line_mappings(Object* object,
-							    off_t shndx)
+Sized_dwarf_line_info<size, big_endian>::read_line_mappings(off_t shndx)
 {
   gold_assert(this->data_valid_ == true);
 
-  this->read_relocs(object);
   while (this->buffer_ < this->buffer_end_)
     {
       const unsigned char* lineptr = this->buffer_;
       lineptr = this->read_header_prolog(lineptr);
+
+      // We can not read the header tables of later versions, such as
+      // DWARF5, so we skip those units.
+      if (header_.version < 2 || header_.version > 4)
+	{
+	  this->buffer_ += (header_.offset_size == 8 ? 12 : 4);
+	  this->buffer_ += header_.total_length;
+	  continue;
+	}
+
       lineptr = this->read_header_tables(lineptr);
       lineptr = this->read_lines(lineptr, shndx);
       this->buffer_ = lineptr;
@@ -807,6 +848,63 @@ Sized_dwarf_line_info<size, big_endian>::do_addr2line(unsigned int shndx,
 
 // Dwarf_line_info routines.
 
+// Return a new Dwarf_line_info of the right size and endianness.
+
+Dwarf_line_info*
+Dwarf_line_info::create(Object* object, unsigned int shndx)
+{
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      return new Sized_dwarf_line_info<32, false>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      return new Sized_dwarf_line_info<32, true>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      return new Sized_dwarf_line_info<64, false>(object, shndx);
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      return new Sized_dwarf_line_info<64, true>(object, shndx);
+#endif
+    default:
+      gold_unreachable();
+    }
+}
+
+// Return a new Dwarf_line_info of the right size and endianness,
+// which parses the line information only when asked.
+
+Dwarf_line_info*
+Dwarf_line_info::create_unparsed(Object* object)
+{
+  switch (parameters->size_and_endianness())
+    {
+#ifdef HAVE_TARGET_32_LITTLE
+    case Parameters::TARGET_32_LITTLE:
+      return new Sized_dwarf_line_info<32, false>(object, -1U, false);
+#endif
+#ifdef HAVE_TARGET_32_BIG
+    case Parameters::TARGET_32_BIG:
+      return new Sized_dwarf_line_info<32, true>(object, -1U, false);
+#endif
+#ifdef HAVE_TARGET_64_LITTLE
+    case Parameters::TARGET_64_LITTLE:
+      return new Sized_dwarf_line_info<64, false>(object, -1U, false);
+#endif
+#ifdef HAVE_TARGET_64_BIG
+    case Parameters::TARGET_64_BIG:
+      return new Sized_dwarf_line_info<64, true>(object, -1U, false);
+#endif
+    default:
+      gold_unreachable();
+    }
+}
+
 static unsigned int next_generation_count = 0;
 
 struct Addr2line_cache_entry
@@ -858,27 +956,7 @@ Dwarf_line_info::one_addr2line(Object* object,
   // cache.
   if (lineinfo == NULL)
   {
-    switch (parameters->size_and_endianness())
-      {
-#ifdef HAVE_TARGET_32_LITTLE
-        case Parameters::TARGET_32_LITTLE:
-          lineinfo = new Sized_dwarf_line_info<32, false>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_32_BIG
-        case Parameters::TARGET_32_BIG:
-          lineinfo = new Sized_dwarf_line_info<32, true>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_64_LITTLE
-        case Parameters::TARGET_64_LITTLE:
-          lineinfo = new Sized_dwarf_line_info<64, false>(object, shndx); break;
-#endif
-#ifdef HAVE_TARGET_64_BIG
-        case Parameters::TARGET_64_BIG:
-          lineinfo = new Sized_dwarf_line_info<64, true>(object, shndx); break;
-#endif
-        default:
-          gold_unreachable();
-      }
+    lineinfo = Dwarf_line_info::create(object, shndx);
     addr2line_cache.push_back(Addr2line_cache_entry(object, shndx, lineinfo));
   }
 
@@ -78,6 +78,27 @@ class Dwarf_line_info
   addr2line(unsigned int shndx, off_t offset)
   { return do_addr2line(shndx, offset); }
 
+  // Return a new Dwarf_line_info for OBJECT, which must be locked.
+  // If SHNDX is not -1U, only read the line information for that
+  // section; otherwise, read it for every section, so that many
+  // lookups in the object only need to parse the line table once.
+  static Dwarf_line_info*
+  create(Object* object, unsigned int shndx);
+
+  // Return a new Dwarf_line_info for every section of OBJECT, which
+  // must be locked.  This reads everything it needs from OBJECT,
+  // keeping its own copy of the line table, but does not parse the
+  // line table until parse is called.  Since parse does not use
+  // OBJECT, it may be called after OBJECT is unlocked, in any thread.
+  static Dwarf_line_info*
+  create_unparsed(Object* object);
+
+  // Parse the line table of a Dwarf_line_info returned by
+  // create_unparsed.
+  void
+  parse()
+  { this->do_parse(); }
+
   // A helper function for a single addr2line lookup.  It also keeps a
   // cache of the last CACHE_SIZE Dwarf_line_info objects it created;
   // set to 0 not to cache at all.  The larger CACHE_SIZE is, the more
@@ -96,6 +117,9 @@ class Dwarf_line_info
  private:
   virtual std::string
   do_addr2line(unsigned int shndx, off_t offset) = 0;
+
+  virtual void
+  do_parse() = 0;
 };
 
 template<int size, bool big_endian>
@@ -104,18 +128,26 @@ class Sized_dwarf_line_info : public Dwarf_line_info
  public:
   // Initializes a .debug_line reader for a given object file.
   // If SHNDX is specified and non-negative, only read the debug
-  // information that pertains to the specified section.
-  Sized_dwarf_line_info(Object* object, off_t read_shndx = -1U);
+  // information that pertains to the specified section.  If PARSE is
+  // false, copy the line information, and parse it in do_parse.
+  Sized_dwarf_line_info(Object* object, off_t read_shndx = -1U,
+			bool parse = true);
+
+  ~Sized_dwarf_line_info()
+  { delete[] this->buffer_copy_; }
 
  private:
   std::string
   do_addr2line(unsigned int shndx, off_t offset);
 
+  void
+  do_parse();
+
   // Start processing line info, and populates the offset_map_.
   // If SHNDX is non-negative, only store debug information that
   // pertains to the specified section.
   void
-  read_line_mappings(Object*, off_t shndx);
+  read_line_mappings(off_t shndx);
 
   // Reads the relocation section associated with .debug_line and
   // stores relocation information in reloc_map_.
@@ -181,6 +213,11 @@ class Sized_dwarf_line_info : public Dwarf_line_info
   // the line info to read is.
   const unsigned char* buffer_;
   const unsigned char* buffer_end_;
+  // If we were asked not to parse the line information right away,
+  // this is our copy of it, which buffer_ points into.
+  unsigned char* buffer_copy_;
+  // The section for which to read the line information, for do_parse.
+  off_t read_shndx_;
 
   // This has relocations that point into buffer.
   Track_relocs<size, big_endian> track_relocs_;
@@ -29,6 +29,7 @@
 #include "parameters.h"
 #include "script.h"
 #include "symtab.h"
+#include "workqueue.h"
 #include "dynobj.h"
 
 namespace gold
@@ -328,6 +329,8 @@ Sized_dynobj<size, big_endian>::do_read_symbols(Read_symbols_data* sd)
   sd->external_symbols_offset = 0;
   sd->symbol_names = NULL;
   sd->symbol_names_size = 0;
+  sd->allow_shard_adder = false;
+  sd->shard_adder = NULL;
 
   if (this->dynsym_shndx_ != -1U)
     {
@@ -746,14 +749,58 @@ Sized_dynobj<size, big_endian>::do_get_global_symbol_counts(
   *used = count;
 }
 
+// The number of dynamic symbols to handle in one range when hashing
+// them in parallel.
+
+static const unsigned int dynsym_range_size = 8192;
+
+// Compute the hash codes of the names of a list of symbols, a range
+// at a time.
+
+class Dynsym_hash_work : public Parallel_work
+{
+ public:
+  Dynsym_hash_work(const std::vector<Symbol*>& syms,
+		   uint32_t (*hashfn)(const char*),
+		   std::vector<uint32_t>* hashvals)
+    : syms_(syms), hashfn_(hashfn), hashvals_(hashvals)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last)
+  {
+    for (unsigned int i = first; i < last; ++i)
+      (*this->hashvals_)[i] = this->hashfn_(this->syms_[i]->name());
+  }
+
+ private:
+  const std::vector<Symbol*>& syms_;
+  uint32_t (*hashfn_)(const char*);
+  std::vector<uint32_t>* hashvals_;
+};
+
+void
+Dynobj::hash_symbols(Workqueue* workqueue, const std::vector<Symbol*>& syms,
+		     uint32_t (*hashfn)(const char*),
+		     std::vector<uint32_t>* hashvals)
+{
+  hashvals->resize(syms.size());
+  Dynsym_hash_work work(syms, hashfn, hashvals);
+  work.run(workqueue, syms.size(), dynsym_range_size);
+}
+
 // Given a vector of hash codes, compute the number of hash buckets to
 // use.
 
 unsigned int
-Dynobj::compute_bucket_count(const std::vector<uint32_t>& hashcodes,
+Dynobj::compute_bucket_count(Workqueue* workqueue,
+			     const std::vector<uint32_t>& hashcodes,
 			     bool for_gnu_hash_table)
 {
-  // FIXME: Implement optional hash table optimization.
+  if (parameters->options().optimize() >= 1 && !hashcodes.empty())
+    return Dynobj::optimize_bucket_count(workqueue, hashcodes,
+					 for_gnu_hash_table);
 
   // Array used to determine the number of hash table buckets to use
   // based on the number of symbols there are.  If there are fewer
@@ -785,6 +832,98 @@ Dynobj::compute_bucket_count(const std::vector<uint32_t>& hashcodes,
   return ret;
 }
 
+// Measure the lookup cost of a hash table for each of a list of
+// bucket counts.  The cost is the one used by the old GNU linker: the
+// sum of the squares of the chain lengths, which grows with the
+// number of comparisons needed to find a symbol, plus the size of the
+// table, all scaled by the square of the number of pages used by the
+// buckets.
+
+class Bucket_count_work : public Parallel_work
+{
+ public:
+  Bucket_count_work(const std::vector<uint32_t>& hashcodes,
+		    const std::vector<unsigned int>& candidates,
+		    std::vector<uint64_t>* costs)
+    : hashcodes_(hashcodes), candidates_(candidates), costs_(costs)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last);
+
+ private:
+  const std::vector<uint32_t>& hashcodes_;
+  const std::vector<unsigned int>& candidates_;
+  std::vector<uint64_t>* costs_;
+};
+
+void
+Bucket_count_work::do_range(unsigned int first, unsigned int last)
+{
+  const unsigned int symcount = this->hashcodes_.size();
+  std::vector<unsigned int> counts;
+  for (unsigned int i = first; i < last; ++i)
+    {
+      const unsigned int bucketcount = this->candidates_[i];
+      counts.assign(bucketcount, 0);
+      for (unsigned int j = 0; j < symcount; ++j)
+	++counts[this->hashcodes_[j] % bucketcount];
+
+      uint64_t cost = (2 + static_cast<uint64_t>(symcount)) * 4;
+      for (unsigned int j = 0; j < bucketcount; ++j)
+	cost += static_cast<uint64_t>(counts[j]) * counts[j];
+      const uint64_t pages = bucketcount / (4096 / 4) + 1;
+      (*this->costs_)[i] = cost * pages * pages;
+    }
+}
+
+// The most bucket counts to try for -O.  The old GNU linker tries
+// every count from a quarter of the number of symbols to twice it,
+// which is quadratic in the number of symbols; we try at most this
+// many counts spread evenly over the same range.
+
+static const unsigned int max_bucket_candidates = 128;
+
+unsigned int
+Dynobj::optimize_bucket_count(Workqueue* workqueue,
+			      const std::vector<uint32_t>& hashcodes,
+			      bool for_gnu_hash_table)
+{
+  const unsigned int symcount = hashcodes.size();
+  unsigned int minsize = symcount / 4;
+  if (minsize < (for_gnu_hash_table ? 2 : 1))
+    minsize = for_gnu_hash_table ? 2 : 1;
+  unsigned int maxsize = symcount * 2;
+  if (maxsize <= minsize)
+    maxsize = minsize + 1;
+
+  std::vector<unsigned int> candidates;
+  const unsigned int range = maxsize - minsize;
+  const unsigned int step = (range + max_bucket_candidates - 1)
+			     / max_bucket_candidates;
+  for (unsigned int i = minsize; i < maxsize; i += step)
+    {
+      // The GNU dynamic linker handles a multiple of 32 buckets
+      // poorly in a GNU hash table, since the bloom filter uses the
+      // low bits of the hash code too.
+      unsigned int bucketcount = i;
+      if (for_gnu_hash_table && (bucketcount & 31) == 0)
+	++bucketcount;
+      candidates.push_back(bucketcount);
+    }
+
+  std::vector<uint64_t> costs(candidates.size());
+  Bucket_count_work work(hashcodes, candidates, &costs);
+  work.run(workqueue, candidates.size(), 1);
+
+  unsigned int best = 0;
+  for (unsigned int i = 1; i < candidates.size(); ++i)
+    if (costs[i] < costs[best])
+      best = i;
+  return candidates[best];
+}
+
 // The standard ELF hash function.  This hash function must not
 // change, as the dynamic linker uses it also.
 
@@ -816,7 +955,8 @@ Dynobj::elf_hash(const char* name)
 // symbol table.
 
 void
-Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
+Dynobj::create_elf_hash_table(Workqueue* workqueue,
+			      const std::vector<Symbol*>& dynsyms,
 			      unsigned int local_dynsym_count,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
@@ -824,12 +964,12 @@ Dynobj::create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
   unsigned int dynsym_count = dynsyms.size();
 
   // Get the hash values for all the symbols.
-  std::vector<uint32_t> dynsym_hashvals(dynsym_count);
-  for (unsigned int i = 0; i < dynsym_count; ++i)
-    dynsym_hashvals[i] = Dynobj::elf_hash(dynsyms[i]->name());
+  std::vector<uint32_t> dynsym_hashvals;
+  Dynobj::hash_symbols(workqueue, dynsyms, Dynobj::elf_hash,
+		       &dynsym_hashvals);
 
   const unsigned int bucketcount =
-    Dynobj::compute_bucket_count(dynsym_hashvals, false);
+    Dynobj::compute_bucket_count(workqueue, dynsym_hashvals, false);
 
   std::vector<uint32_t> bucket(bucketcount);
   std::vector<uint32_t> chain(local_dynsym_count + dynsym_count);
@@ -929,7 +1069,8 @@ Dynobj::gnu_hash(const char* name)
 // symbol table.
 
 void
-Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
+Dynobj::create_gnu_hash_table(Workqueue* workqueue,
+			      const std::vector<Symbol*>& dynsyms,
 			      unsigned int local_dynsym_count,
 			      unsigned char** pphash,
 			      unsigned int* phashlen)
@@ -939,8 +1080,7 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
   // Sort the dynamic symbols into two vectors.  Symbols which we do
   // not want to put into the hash table we store into
   // UNHASHED_DYNSYMS.  Symbols which we do want to store we put into
-  // HASHED_DYNSYMS.  DYNSYM_HASHVALS is parallel to HASHED_DYNSYMS,
-  // and records the hash codes.
+  // HASHED_DYNSYMS.
 
   std::vector<Symbol*> unhashed_dynsyms;
   unhashed_dynsyms.reserve(count);
@@ -948,9 +1088,6 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
   std::vector<Symbol*> hashed_dynsyms;
   hashed_dynsyms.reserve(count);
 
-  std::vector<uint32_t> dynsym_hashvals;
-  dynsym_hashvals.reserve(count);
-  
   for (unsigned int i = 0; i < count; ++i)
     {
       Symbol* sym = dynsyms[i];
@@ -960,12 +1097,15 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       if (sym->is_undefined())
 	unhashed_dynsyms.push_back(sym);
       else
-	{
-	  hashed_dynsyms.push_back(sym);
-	  dynsym_hashvals.push_back(Dynobj::gnu_hash(sym->name()));
-	}
+	hashed_dynsyms.push_back(sym);
     }
 
+  // DYNSYM_HASHVALS is parallel to HASHED_DYNSYMS, and records the
+  // hash codes.
+  std::vector<uint32_t> dynsym_hashvals;
+  Dynobj::hash_symbols(workqueue, hashed_dynsyms, Dynobj::gnu_hash,
+		       &dynsym_hashvals);
+
   // Put the unhashed symbols at the start of the global portion of
   // the dynamic symbol table.
   const unsigned int unhashed_count = unhashed_dynsyms.size();
@@ -985,7 +1125,8 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       if (big_endian)
 	{
 #ifdef HAVE_TARGET_32_BIG
-	  Dynobj::sized_create_gnu_hash_table<32, true>(hashed_dynsyms,
+	  Dynobj::sized_create_gnu_hash_table<32, true>(workqueue,
+							hashed_dynsyms,
 							dynsym_hashvals,
 							unhashed_dynsym_index,
 							pphash,
@@ -997,7 +1138,8 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       else
 	{
 #ifdef HAVE_TARGET_32_LITTLE
-	  Dynobj::sized_create_gnu_hash_table<32, false>(hashed_dynsyms,
+	  Dynobj::sized_create_gnu_hash_table<32, false>(workqueue,
+							 hashed_dynsyms,
 							 dynsym_hashvals,
 							 unhashed_dynsym_index,
 							 pphash,
@@ -1012,7 +1154,8 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       if (big_endian)
 	{
 #ifdef HAVE_TARGET_64_BIG
-	  Dynobj::sized_create_gnu_hash_table<64, true>(hashed_dynsyms,
+	  Dynobj::sized_create_gnu_hash_table<64, true>(workqueue,
+							hashed_dynsyms,
 							dynsym_hashvals,
 							unhashed_dynsym_index,
 							pphash,
@@ -1024,7 +1167,8 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
       else
 	{
 #ifdef HAVE_TARGET_64_LITTLE
-	  Dynobj::sized_create_gnu_hash_table<64, false>(hashed_dynsyms,
+	  Dynobj::sized_create_gnu_hash_table<64, false>(workqueue,
+							 hashed_dynsyms,
 							 dynsym_hashvals,
 							 unhashed_dynsym_index,
 							 pphash,
@@ -1038,12 +1182,85 @@ Dynobj::create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
     gold_unreachable();
 }
 
+// Build the bloom filter of a GNU hash table.  Each range of symbols
+// sets bits in its own copy of the filter, and the copies are then
+// merged.
+
+template<int size>
+class Gnu_hash_bloom_work : public Parallel_work
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_WXword Word;
+
+  Gnu_hash_bloom_work(const std::vector<uint32_t>& hashvals,
+		      unsigned int range_size, uint32_t shift1,
+		      uint32_t shift2, uint32_t maskwords)
+    : hashvals_(hashvals), range_size_(range_size), shift1_(shift1),
+      shift2_(shift2), maskwords_(maskwords),
+      bitmasks_(hashvals.size() / range_size
+		+ (hashvals.size() % range_size != 0))
+  { }
+
+  // Build the filter, and OR it into *BITMASK.
+  void
+  build(Workqueue*, std::vector<Word>* bitmask);
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last);
+
+ private:
+  const std::vector<uint32_t>& hashvals_;
+  unsigned int range_size_;
+  uint32_t shift1_;
+  uint32_t shift2_;
+  uint32_t maskwords_;
+  // The filter for each range.
+  std::vector<std::vector<Word> > bitmasks_;
+};
+
+template<int size>
+void
+Gnu_hash_bloom_work<size>::do_range(unsigned int first, unsigned int last)
+{
+  std::vector<Word>& bitmask(this->bitmasks_[first / this->range_size_]);
+  bitmask.resize(this->maskwords_);
+  const uint32_t mask = (1U << this->shift1_) - 1U;
+  for (unsigned int i = first; i < last; ++i)
+    {
+      uint32_t hashval = this->hashvals_[i];
+      unsigned int val = (hashval >> this->shift1_) & (this->maskwords_ - 1);
+      bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
+      bitmask[val] |= ((static_cast<Word>(1U))
+		       << ((hashval >> this->shift2_) & mask));
+    }
+}
+
+template<int size>
+void
+Gnu_hash_bloom_work<size>::build(Workqueue* workqueue,
+				 std::vector<Word>* bitmask)
+{
+  this->run(workqueue, this->hashvals_.size(), this->range_size_);
+  for (unsigned int i = 0; i < this->bitmasks_.size(); ++i)
+    {
+      const std::vector<Word>& b(this->bitmasks_[i]);
+      for (unsigned int j = 0; j < this->maskwords_; ++j)
+	(*bitmask)[j] |= b[j];
+    }
+}
+
+// The most copies of the bloom filter to build.
+
+static const unsigned int max_bloom_ranges = 16;
+
 // Create the actual data for a GNU hash table.  This is just a copy
 // of the code from the old GNU linker.
 
 template<int size, bool big_endian>
 void
 Dynobj::sized_create_gnu_hash_table(
+    Workqueue* workqueue,
     const std::vector<Symbol*>& hashed_dynsyms,
     const std::vector<uint32_t>& dynsym_hashvals,
     unsigned int unhashed_dynsym_count,
@@ -1075,7 +1292,7 @@ Dynobj::sized_create_gnu_hash_table(
     }
 
   const unsigned int bucketcount =
-    Dynobj::compute_bucket_count(dynsym_hashvals, true);
+    Dynobj::compute_bucket_count(workqueue, dynsym_hashvals, true);
 
   const unsigned int nsyms = hashed_dynsyms.size();
 
@@ -1102,7 +1319,6 @@ Dynobj::sized_create_gnu_hash_table(
 	maskbitslog2 = 6;
       shift1 = 6;
     }
-  uint32_t mask = (1U << shift1) - 1U;
   uint32_t shift2 = maskbitslog2;
   uint32_t maskbits = 1U << maskbitslog2;
   uint32_t maskwords = 1U << (maskbitslog2 - shift1);
@@ -1143,17 +1359,20 @@ Dynobj::sized_create_gnu_hash_table(
       p += 4;
     }
 
+  unsigned int bloom_range_size = nsyms / max_bloom_ranges + 1;
+  if (bloom_range_size < dynsym_range_size)
+    bloom_range_size = dynsym_range_size;
+  Gnu_hash_bloom_work<size> bloom(dynsym_hashvals, bloom_range_size,
+				  shift1, shift2, maskwords);
+  bloom.build(workqueue, &bitmask);
+
   for (unsigned int i = 0; i < nsyms; ++i)
     {
       Symbol* sym = hashed_dynsyms[i];
       uint32_t hashval = dynsym_hashvals[i];
 
       unsigned int bucket = hashval % bucketcount;
-      unsigned int val = ((hashval >> shift1)
-			  & ((maskbits >> shift1) - 1));
-      bitmask[val] |= (static_cast<Word>(1U)) << (hashval & mask);
-      bitmask[val] |= (static_cast<Word>(1U)) << ((hashval >> shift2) & mask);
-      val = hashval & ~ 1U;
+      unsigned int val = hashval & ~ 1U;
       if (counts[bucket] == 1)
 	{
 	  // Last element terminates the chain.
@@ -1396,6 +1615,19 @@ Versions::record_version(const Symbol_table* symtab,
     }
 }
 
+// Record a reference to version NAME in FILENAME.
+
+void
+Versions::record_need(Stringpool* dynpool, const char* filename,
+		      const char* name)
+{
+  gold_assert(!this->is_finalized_);
+
+  Stringpool::Key name_key;
+  name = dynpool->add(name, true, &name_key);
+  this->add_need(dynpool, filename, name, name_key);
+}
+
 // We've found a symbol SYM defined in version VERSION.
 
 void
@@ -32,6 +32,7 @@ namespace gold
 {
 
 class Version_script_info;
+class Workqueue;
 
 // A dynamic object (ET_DYN).  This is an abstract base class itself.
 // The implementations is the template class Sized_dynobj.
@@ -79,9 +80,11 @@ class Dynobj : public Object
   // Create a standard ELF hash table, setting *PPHASH and *PHASHLEN.
   // DYNSYMS is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the
   // number of local dynamic symbols, which is the index of the first
-  // dynamic gobal symbol.
+  // dynamic gobal symbol.  WORKQUEUE is used to share the work with
+  // other threads; it may be NULL.
   static void
-  create_elf_hash_table(const std::vector<Symbol*>& dynsyms,
+  create_elf_hash_table(Workqueue* workqueue,
+			const std::vector<Symbol*>& dynsyms,
 			unsigned int local_dynsym_count,
 			unsigned char** pphash,
 			unsigned int* phashlen);
@@ -89,9 +92,10 @@ class Dynobj : public Object
   // Create a GNU hash table, setting *PPHASH and *PHASHLEN.  DYNSYMS
   // is the global dynamic symbols.  LOCAL_DYNSYM_COUNT is the number
   // of local dynamic symbols, which is the index of the first dynamic
-  // gobal symbol.
+  // gobal symbol.  WORKQUEUE is as for create_elf_hash_table.
   static void
-  create_gnu_hash_table(const std::vector<Symbol*>& dynsyms,
+  create_gnu_hash_table(Workqueue* workqueue,
+			const std::vector<Symbol*>& dynsyms,
 			unsigned int local_dynsym_count,
 			unsigned char** pphash, unsigned int* phashlen);
 
@@ -111,11 +115,24 @@ class Dynobj : public Object
   static uint32_t
   gnu_hash(const char*);
 
+  // Compute the hash codes of the names of SYMS, using HASHFN, into
+  // *HASHVALS.
+  static void
+  hash_symbols(Workqueue*, const std::vector<Symbol*>& syms,
+	       uint32_t (*hashfn)(const char*),
+	       std::vector<uint32_t>* hashvals);
+
   // Compute the number of hash buckets to use.
   static unsigned int
-  compute_bucket_count(const std::vector<uint32_t>& hashcodes,
+  compute_bucket_count(Workqueue*, const std::vector<uint32_t>& hashcodes,
 		       bool for_gnu_hash_table);
 
+  // Search for the number of hash buckets which gives the lowest
+  // lookup cost, for -O.
+  static unsigned int
+  optimize_bucket_count(Workqueue*, const std::vector<uint32_t>& hashcodes,
+			bool for_gnu_hash_table);
+
   // Sized version of create_elf_hash_table.
   template<bool big_endian>
   static void
@@ -127,7 +144,8 @@ class Dynobj : public Object
   // Sized version of create_gnu_hash_table.
   template<int size, bool big_endian>
   static void
-  sized_create_gnu_hash_table(const std::vector<Symbol*>& hashed_dynsyms,
+  sized_create_gnu_hash_table(Workqueue*,
+			      const std::vector<Symbol*>& hashed_dynsyms,
 			      const std::vector<uint32_t>& dynsym_hashvals,
 			      unsigned int unhashed_dynsym_count,
 			      unsigned char** pphash,
@@ -519,6 +537,12 @@ class Versions
   finalize(Symbol_table* symtab, unsigned int dynsym_index,
 	   std::vector<Symbol*>* syms);
 
+  // Record a reference to version NAME in the shared library
+  // FILENAME which is not made by any symbol.  This must be called
+  // before finalize.
+  void
+  record_need(Stringpool*, const char* filename, const char* name);
+
   // Return whether there are any version definitions.
   bool
   any_defs() const
@@ -29,6 +29,7 @@
 #include "dwarf.h"
 #include "symtab.h"
 #include "reloc.h"
+#include "workqueue.h"
 #include "ehframe.h"
 
 namespace gold
@@ -84,7 +85,8 @@ Eh_frame_hdr::Eh_frame_hdr(Output_section* eh_frame_section,
     eh_frame_section_(eh_frame_section),
     eh_frame_data_(eh_frame_data),
     fde_offsets_(),
-    any_unrecognized_eh_frame_sections_(false)
+    any_unrecognized_eh_frame_sections_(false),
+    workqueue_(NULL)
 {
 }
 
@@ -182,15 +184,12 @@ Eh_frame_hdr::do_sized_write(Output_file* of)
       // relocations which are, of course, target specific.  This code
       // is run after all those relocations have been applied to the
       // output file.  Here we read the output file again to find the
-      // PC values.  Then we sort the list and write it out.
+      // PC values, sorting the list, and then write it out.
 
       Fde_addresses<size> fde_addresses(this->fde_offsets_.size());
       this->get_fde_addresses<size, big_endian>(of, &this->fde_offsets_,
 						&fde_addresses);
 
-      std::sort(fde_addresses.begin(), fde_addresses.end(),
-		Fde_address_compare<size>());
-
       typename elfcpp::Elf_types<size>::Elf_Addr output_address;
       output_address = this->address();
 
@@ -284,11 +283,128 @@ Eh_frame_hdr::get_fde_pc(
   return pc;
 }
 
+// The number of FDEs for which Fde_address_work finds the PCs at a
+// time, and the number which Fde_sort_work sorts at a time.  Sorting
+// larger runs means fewer passes to merge them.
+
+const unsigned int fde_address_range_size = 4096;
+const unsigned int fde_sort_run_size = 65536;
+
+// Parallel_work to find the output PCs of the FDEs.  Index I is FDE I.
+
+template<int size, bool big_endian>
+class Eh_frame_hdr::Fde_address_work : public Parallel_work
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+
+  Fde_address_work(Eh_frame_hdr* hdr, Address eh_frame_address,
+		   const unsigned char* eh_frame_contents,
+		   const Fde_offsets* fde_offsets,
+		   Fde_addresses<size>* fde_addresses)
+    : hdr_(hdr), eh_frame_address_(eh_frame_address),
+      eh_frame_contents_(eh_frame_contents), fde_offsets_(fde_offsets),
+      fde_addresses_(fde_addresses)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last)
+  {
+    for (unsigned int i = first; i < last; ++i)
+      {
+	const Fde_offset& fo((*this->fde_offsets_)[i]);
+	Address fde_pc;
+	fde_pc = this->hdr_->get_fde_pc<size, big_endian>(
+	    this->eh_frame_address_, this->eh_frame_contents_,
+	    fo.first, fo.second);
+	this->fde_addresses_->set(i, fde_pc,
+				  this->eh_frame_address_ + fo.first);
+      }
+  }
+
+ private:
+  Eh_frame_hdr* hdr_;
+  Address eh_frame_address_;
+  const unsigned char* eh_frame_contents_;
+  const Fde_offsets* fde_offsets_;
+  Fde_addresses<size>* fde_addresses_;
+};
+
+// Parallel_work to sort the FDEs in runs of fde_sort_run_size.  Index
+// I is run I.
+
+template<int size>
+class Eh_frame_hdr::Fde_sort_work : public Parallel_work
+{
+ public:
+  Fde_sort_work(Fde_addresses<size>* fde_addresses)
+    : fde_addresses_(fde_addresses)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last)
+  {
+    unsigned int count = this->fde_addresses_->count();
+    for (unsigned int i = first; i < last; ++i)
+      {
+	unsigned int start = i * fde_sort_run_size;
+	unsigned int end = std::min(start + fde_sort_run_size, count);
+	std::sort(this->fde_addresses_->begin() + start,
+		  this->fde_addresses_->begin() + end,
+		  Fde_address_compare<size>());
+      }
+  }
+
+ private:
+  Fde_addresses<size>* fde_addresses_;
+};
+
+// Parallel_work to merge pairs of adjacent sorted runs of RUN_SIZE
+// FDEs.  Index I merges runs 2*I and 2*I+1.
+
+template<int size>
+class Eh_frame_hdr::Fde_merge_work : public Parallel_work
+{
+ public:
+  Fde_merge_work(Fde_addresses<size>* fde_addresses, unsigned int run_size)
+    : fde_addresses_(fde_addresses), run_size_(run_size)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last)
+  {
+    unsigned int count = this->fde_addresses_->count();
+    for (unsigned int i = first; i < last; ++i)
+      {
+	unsigned int start = 2 * i * this->run_size_;
+	unsigned int middle = start + this->run_size_;
+	if (middle >= count)
+	  continue;
+	unsigned int end = std::min(middle + this->run_size_, count);
+	std::inplace_merge(this->fde_addresses_->begin() + start,
+			   this->fde_addresses_->begin() + middle,
+			   this->fde_addresses_->begin() + end,
+			   Fde_address_compare<size>());
+      }
+  }
+
+ private:
+  Fde_addresses<size>* fde_addresses_;
+  unsigned int run_size_;
+};
+
 // Given an array of FDE offsets in the .eh_frame section, return an
 // array of offsets from the exception frame header to the FDE's
-// output PC and to the output address of the FDE itself.  We get the
-// FDE's PC by actually looking in the .eh_frame section we just wrote
-// to the output file.
+// output PC and to the output address of the FDE itself, sorted by
+// PC.  We get the FDE's PC by actually looking in the .eh_frame
+// section we just wrote to the output file.  With a large number of
+// FDEs this takes a while, so we share the work with other threads:
+// we sort runs of FDEs in parallel and then merge them in rounds,
+// also in parallel.  Since no two FDEs compare equal, the result
+// does not depend on how the work is divided.
 
 template<int size, bool big_endian>
 void
@@ -303,18 +419,28 @@ Eh_frame_hdr::get_fde_addresses(Output_file* of,
   const unsigned char* eh_frame_contents = of->get_input_view(eh_frame_offset,
 							      eh_frame_size);
 
-  for (Fde_offsets::const_iterator p = fde_offsets->begin();
-       p != fde_offsets->end();
-       ++p)
-    {
-      typename elfcpp::Elf_types<size>::Elf_Addr fde_pc;
-      fde_pc = this->get_fde_pc<size, big_endian>(eh_frame_address,
+  unsigned int count = fde_offsets->size();
+  fde_addresses->resize(count);
+  Fde_address_work<size, big_endian> address_work(this, eh_frame_address,
 						  eh_frame_contents,
-						  p->first, p->second);
-      fde_addresses->push_back(fde_pc, eh_frame_address + p->first);
-    }
+						  fde_offsets, fde_addresses);
+  address_work.run(this->workqueue_, count, fde_address_range_size);
 
   of->free_input_view(eh_frame_offset, eh_frame_size, eh_frame_contents);
+
+  unsigned int run_count = ((count + fde_sort_run_size - 1)
+			    / fde_sort_run_size);
+  Fde_sort_work<size> sort_work(fde_addresses);
+  sort_work.run(this->workqueue_, run_count, 1);
+
+  for (unsigned int run_size = fde_sort_run_size;
+       run_size < count;
+       run_size *= 2)
+    {
+      unsigned int pair_count = (count + 2 * run_size - 1) / (2 * run_size);
+      Fde_merge_work<size> merge_work(fde_addresses, run_size);
+      merge_work.run(this->workqueue_, pair_count, 1);
+    }
 }
 
 // Class Fde.
@@ -511,20 +637,39 @@ Eh_frame::skip_leb128(const unsigned char** pp, const unsigned char* pend)
   return false;
 }
 
-// Add input section SHNDX in OBJECT to an exception frame section.
-// SYMBOLS is the contents of the symbol table section (size
-// SYMBOLS_SIZE), SYMBOL_NAMES is the symbol names section (size
-// SYMBOL_NAMES_SIZE).  RELOC_SHNDX is the index of a relocation
-// section applying to SHNDX, or 0 if none, or -1U if more than one.
-// RELOC_TYPE is the type of the reloc section if there is one, either
-// SHT_REL or SHT_RELA.  We try to parse the input exception frame
-// data into our data structures.  If we can't do it, we return false
-// to mean that the section should be handled as a normal input
-// section.
+// Class Parsed_eh_frame.
+
+// The destructor deletes any CIEs and FDEs which were not added to
+// the output.
+
+Parsed_eh_frame::~Parsed_eh_frame()
+{
+  for (std::vector<std::pair<Cie*, bool> >::iterator p = this->cies_.begin();
+       p != this->cies_.end();
+       ++p)
+    delete p->first;
+  for (std::vector<Cie*>::iterator p = this->duplicate_cies_.begin();
+       p != this->duplicate_cies_.end();
+       ++p)
+    delete *p;
+  for (std::vector<Parsed_fde>::iterator p = this->fdes_.begin();
+       p != this->fdes_.end();
+       ++p)
+    delete p->fde;
+}
+
+// Read input section SHNDX in OBJECT.  SYMBOLS is the contents of the
+// symbol table section (size SYMBOLS_SIZE), SYMBOL_NAMES is the
+// symbol names section (size SYMBOL_NAMES_SIZE).  RELOC_SHNDX is the
+// index of a relocation section applying to SHNDX, or 0 if none, or
+// -1U if more than one.  RELOC_TYPE is the type of the reloc section
+// if there is one, either SHT_REL or SHT_RELA.  We try to parse the
+// input exception frame data into our data structures.  If we can't
+// do it, the result is marked as not recognized.
 
 template<int size, bool big_endian>
-bool
-Eh_frame::add_ehframe_input_section(
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section(
     Sized_relobj<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
@@ -540,54 +685,137 @@ Eh_frame::add_ehframe_input_section(
 							    &contents_len,
 							    false);
   if (contents_len == 0)
-    return false;
+    return NULL;
 
   // If this is the marker section for the end of the data, then
-  // return false to force it to be handled as an ordinary input
+  // return NULL to force it to be handled as an ordinary input
   // section.  If we don't do this, we won't correctly handle the case
   // of unrecognized .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
+    return NULL;
+
+  Parsed_eh_frame* parsed = new Parsed_eh_frame();
+  parsed->recognized_ =
+    Eh_frame::do_parse_ehframe_input_section(object, symbols, symbols_size,
+					     symbol_names, symbol_names_size,
+					     shndx, reloc_shndx, reloc_type,
+					     pcontents, contents_len, parsed);
+  return parsed;
+}
+
+// Add input section SHNDX in OBJECT to an exception frame section.
+// The arguments are as for parse_ehframe_input_section.  Normally
+// OBJECT already read the section when it read its symbols; if not,
+// we read it now.  If we can't parse the section, we return false to
+// mean that the section should be handled as a normal input section.
+
+template<int size, bool big_endian>
+bool
+Eh_frame::add_ehframe_input_section(
+    Sized_relobj<size, big_endian>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type)
+{
+  Parsed_eh_frame* parsed = object->release_parsed_eh_frame(shndx);
+  if (parsed == NULL)
+    parsed = Eh_frame::parse_ehframe_input_section(object, symbols,
+						   symbols_size,
+						   symbol_names,
+						   symbol_names_size,
+						   shndx, reloc_shndx,
+						   reloc_type);
+  if (parsed == NULL)
     return false;
 
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
+  if (!parsed->recognized())
     {
       if (this->eh_frame_hdr_ != NULL)
 	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
+      delete parsed;
+      return false;
+    }
 
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
+  this->add_parsed_eh_frame(object, parsed);
+  delete parsed;
+  return true;
+}
 
-      return false;
+// Add the CIEs and FDEs read from an input section in OBJECT.  We
+// take ownership of them, leaving PARSED empty.
+
+template<int size, bool big_endian>
+void
+Eh_frame::add_parsed_eh_frame(Sized_relobj<size, big_endian>* object,
+			      Parsed_eh_frame* parsed)
+{
+  // Merge each mergeable CIE with one we have already seen, if any.
+  // This gives the CIE to use for each entry in PARSED->CIES_.
+  std::vector<Cie*> cies;
+  cies.reserve(parsed->cies_.size());
+  for (std::vector<std::pair<Cie*, bool> >::const_iterator p =
+	 parsed->cies_.begin();
+       p != parsed->cies_.end();
+       ++p)
+    {
+      Cie* cie = p->first;
+      if (!p->second)
+	{
+	  this->unmergeable_cie_offsets_.push_back(cie);
+	  cies.push_back(cie);
+	  continue;
+	}
+
+      std::pair<Cie_offsets::iterator, bool> ins =
+	this->cie_offsets_.insert(cie);
+      if (!ins.second)
+	{
+	  // We are deleting this CIE.  Record that in our mapping from
+	  // input sections to the output section.
+	  cie->discard(&this->merge_map_);
+	  delete cie;
+	}
+      cies.push_back(*ins.first);
     }
+  parsed->cies_.clear();
 
-  // Now that we know we are using this section, record any new CIEs
-  // that we found.
-  for (New_cies::const_iterator p = new_cies.begin();
-       p != new_cies.end();
+  for (std::vector<Cie*>::iterator p = parsed->duplicate_cies_.begin();
+       p != parsed->duplicate_cies_.end();
        ++p)
     {
-      if (p->second)
-	this->cie_offsets_.insert(p->first);
-      else
-	this->unmergeable_cie_offsets_.push_back(p->first);
+      (*p)->discard(&this->merge_map_);
+      delete *p;
     }
+  parsed->duplicate_cies_.clear();
 
-  return true;
+  for (std::vector<Parsed_eh_frame::Parsed_fde>::const_iterator p =
+	 parsed->fdes_.begin();
+       p != parsed->fdes_.end();
+       ++p)
+    {
+      if (p->fde_shndx != 0 && !object->is_section_included(p->fde_shndx))
+	{
+	  // This FDE applies to a section which we are discarding.  We
+	  // can discard this FDE.
+	  p->fde->add_mapping(-1, &this->merge_map_);
+	  delete p->fde;
+	}
+      else
+	cies[p->cie_index]->add_fde(p->fde);
+    }
+  parsed->fdes_.clear();
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// The bulk of the implementation of parse_ehframe_input_section.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::do_parse_ehframe_input_section(
     Sized_relobj<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
@@ -598,7 +826,7 @@ Eh_frame::do_add_ehframe_input_section(
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Parsed_eh_frame* parsed)
 {
   typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
   Track_relocs<size, big_endian> relocs;
@@ -651,17 +879,18 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!Eh_frame::read_cie(object, shndx, symbols, symbols_size,
+				  symbol_names, symbol_names_size,
+				  pcontents, p, pentend, &relocs, &cies,
+				  parsed))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!Eh_frame::read_fde(object, shndx, symbols, symbols_size,
+				  pcontents, id, p, pentend, &relocs, &cies,
+				  parsed))
 	    return false;
 	}
 
@@ -686,7 +915,7 @@ Eh_frame::read_cie(Sized_relobj<size, big_endian>* object,
 		   const unsigned char *pcieend,
 		   Track_relocs<size, big_endian>* relocs,
 		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Parsed_eh_frame* parsed)
 {
   bool mergeable = true;
 
@@ -879,48 +1108,31 @@ Eh_frame::read_cie(Sized_relobj<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
+  Cie* cie = new Cie(object, shndx, (pcie - 8) - pcontents, fde_encoding,
+		     personality_name, pcie, pcieend - pcie);
+
+  // See if we already saw this CIE in this input section.  We merge
+  // it with CIEs from other input sections in add_parsed_eh_frame.
+  unsigned int cie_index = parsed->cies_.size();
   if (mergeable)
     {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
+      for (unsigned int i = 0; i < parsed->cies_.size(); ++i)
 	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
+	  if (*parsed->cies_[i].first == *cie)
 	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
+	      cie_index = i;
+	      break;
 	    }
 	}
     }
 
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
+  if (cie_index == parsed->cies_.size())
+    parsed->cies_.push_back(std::make_pair(cie, mergeable));
   else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      this->merge_map_.add_mapping(object, shndx, (pcie - 8) - pcontents,
-				   pcieend - (pcie - 8), -1);
-    }
+    parsed->duplicate_cies_.push_back(cie);
 
   // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  cies->insert(std::make_pair(pcie - pcontents, cie_index));
 
   return true;
 }
@@ -938,7 +1150,8 @@ Eh_frame::read_fde(Sized_relobj<size, big_endian>* object,
 		   const unsigned char* pfde,
 		   const unsigned char *pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   const Offsets_to_cie* cies,
+		   Parsed_eh_frame* parsed)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
@@ -947,7 +1160,6 @@ Eh_frame::read_fde(Sized_relobj<size, big_endian>* object,
   Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
 
   // The FDE should start with a reloc to the start of the code which
   // it describes.
@@ -976,20 +1188,20 @@ Eh_frame::read_fde(Sized_relobj<size, big_endian>* object,
   fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
 				       &is_ordinary);
 
-  if (is_ordinary
-      && fde_shndx != elfcpp::SHN_UNDEF
-      && fde_shndx < object->shnum()
-      && !object->is_section_included(fde_shndx))
-    {
-      // This FDE applies to a section which we are discarding.  We
-      // can discard this FDE.
-      this->merge_map_.add_mapping(object, shndx, (pfde - 8) - pcontents,
-				   pfdeend - (pfde - 8), -1);
-      return true;
-    }
-
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+  // If the FDE applies to a section which we discard, we can discard
+  // the FDE.  We don't know yet which sections are discarded, so we
+  // record the section and let add_parsed_eh_frame check it.
+  if (!is_ordinary
+      || fde_shndx == elfcpp::SHN_UNDEF
+      || fde_shndx >= object->shnum())
+    fde_shndx = 0;
+
+  Parsed_eh_frame::Parsed_fde parsed_fde;
+  parsed_fde.fde = new Fde(object, shndx, (pfde - 8) - pcontents,
+			   pfde, pfdeend - pfde);
+  parsed_fde.cie_index = pcie->second;
+  parsed_fde.fde_shndx = fde_shndx;
+  parsed->fdes_.push_back(parsed_fde);
 
   return true;
 }
@@ -1140,6 +1352,18 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<32, false>(
+    Sized_relobj<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1154,6 +1378,18 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<32, true>(
+    Sized_relobj<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1168,6 +1404,18 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<64, false>(
+    Sized_relobj<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1182,6 +1430,18 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+Parsed_eh_frame*
+Eh_frame::parse_ehframe_input_section<64, true>(
+    Sized_relobj<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    const unsigned char* symbol_names,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type);
 #endif
 
 } // End namespace gold.
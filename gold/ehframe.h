@@ -37,6 +37,7 @@ template<int size, bool big_endian>
 class Track_relocs;
 
 class Eh_frame;
+class Workqueue;
 
 // This class manages the .eh_frame_hdr section, which holds the data
 // for the PT_GNU_EH_FRAME segment.  gcc's unwind support code uses
@@ -44,16 +45,21 @@ class Eh_frame;
 // the time required to register the exception handlers at startup
 // time and when a shared object is loaded, and the time required to
 // deregister the exception handlers when a shared object is unloaded.
-
-// FIXME: gcc supports using storing a sorted lookup table for the
-// FDEs in the PT_GNU_EH_FRAME segment, but we do not yet generate
-// that.
+// The section holds a table of the FDEs sorted by PC, which the
+// unwinder searches with a binary search.
 
 class Eh_frame_hdr : public Output_section_data
 {
  public:
   Eh_frame_hdr(Output_section* eh_frame_section, const Eh_frame*);
 
+  // Set the workqueue to use to build the sorted table when writing
+  // the section.  If this is not called, or is passed NULL, the table
+  // is built by the calling thread.
+  void
+  set_workqueue(Workqueue* workqueue)
+  { this->workqueue_ = workqueue; }
+
   // Record that we found an unrecognized .eh_frame section.
   void
   found_unrecognized_eh_frame_section()
@@ -110,11 +116,19 @@ class Eh_frame_hdr : public Output_section_data
       : fde_addresses_()
     { this->fde_addresses_.reserve(reserve); }
 
+    // Make room for COUNT entries, to be set with set.
     void
-    push_back(Address pc_address, Address fde_address)
-    {
-      this->fde_addresses_.push_back(std::make_pair(pc_address, fde_address));
-    }
+    resize(unsigned int count)
+    { this->fde_addresses_.resize(count); }
+
+    // Set entry I.
+    void
+    set(unsigned int i, Address pc_address, Address fde_address)
+    { this->fde_addresses_[i] = std::make_pair(pc_address, fde_address); }
+
+    unsigned int
+    count() const
+    { return this->fde_addresses_.size(); }
 
     iterator
     begin()
@@ -128,16 +142,31 @@ class Eh_frame_hdr : public Output_section_data
     Fde_address_list fde_addresses_;
   };
 
-  // Compare Fde_address objects.
+  // Compare Fde_address objects.  FDEs with the same PC are ordered
+  // by address, so that the sorted table does not depend on how the
+  // sort was split up.
   template<int size>
   struct Fde_address_compare
   {
     bool
     operator()(const typename Fde_addresses<size>::Fde_address& f1,
 	       const typename Fde_addresses<size>::Fde_address& f2) const
-    { return f1.first < f2.first; }
+    {
+      if (f1.first != f2.first)
+	return f1.first < f2.first;
+      return f1.second < f2.second;
+    }
   };
 
+  template<int size, bool big_endian>
+  class Fde_address_work;
+
+  template<int size>
+  class Fde_sort_work;
+
+  template<int size>
+  class Fde_merge_work;
+
   // Return the PC to which an FDE refers.
   template<int size, bool big_endian>
   typename elfcpp::Elf_types<size>::Elf_Addr
@@ -145,7 +174,7 @@ class Eh_frame_hdr : public Output_section_data
 	     const unsigned char* eh_frame_contents,
 	     section_offset_type fde_offset, unsigned char fde_encoding);
 
-  // Convert Fde_offsets to Fde_addresses.
+  // Convert Fde_offsets to Fde_addresses, sorted by PC.
   template<int size, bool big_endian>
   void
   get_fde_addresses(Output_file* of,
@@ -161,6 +190,8 @@ class Eh_frame_hdr : public Output_section_data
   // Whether we found any .eh_frame sections which we could not
   // process.
   bool any_unrecognized_eh_frame_sections_;
+  // The workqueue to use when building the sorted table, or NULL.
+  Workqueue* workqueue_;
 };
 
 // This class holds an FDE.
@@ -180,7 +211,8 @@ class Fde
   length() const
   { return this->contents_.length() + 8; }
 
-  // Add a mapping for this FDE to MERGE_MAP.
+  // Add a mapping for this FDE to MERGE_MAP.  An OUTPUT_OFFSET of -1
+  // means that the FDE is discarded.
   void
   add_mapping(section_offset_type output_offset, Merge_map* merge_map) const
   {
@@ -251,6 +283,15 @@ class Cie
   fde_count() const
   { return this->fdes_.size(); }
 
+  // Record in MERGE_MAP that this CIE is discarded, because it is the
+  // same as a CIE we have already seen.
+  void
+  discard(Merge_map* merge_map) const
+  {
+    merge_map->add_mapping(this->object_, this->shndx_, this->input_offset_,
+			   this->contents_.length() + 8, -1);
+  }
+
   // Set the output offset of this CIE to OUTPUT_OFFSET.  It will be
   // followed by all its FDEs.  ADDRALIGN is the required address
   // alignment, typically 4 or 8.  This updates MERGE_MAP with the
@@ -294,6 +335,58 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+// The CIEs and FDEs read from one input .eh_frame section, before
+// they are added to the output.  Reading a section only looks at its
+// own object, so an object reads its .eh_frame section when it reads
+// its symbols, in parallel with other input files.  Merging the CIEs
+// with the ones already seen, and discarding the FDEs for discarded
+// sections, is left to Eh_frame::add_ehframe_input_section, which is
+// called for one input file at a time in the usual order, so the
+// output does not depend on the order in which files were read.
+
+class Parsed_eh_frame
+{
+ public:
+  Parsed_eh_frame()
+    : recognized_(false), cies_(), duplicate_cies_(), fdes_()
+  { }
+
+  ~Parsed_eh_frame();
+
+  // Whether we were able to read the section.
+  bool
+  recognized() const
+  { return this->recognized_; }
+
+ private:
+  friend class Eh_frame;
+
+  Parsed_eh_frame(const Parsed_eh_frame&);
+  Parsed_eh_frame& operator=(const Parsed_eh_frame&);
+
+  // An FDE read from the section.
+  struct Parsed_fde
+  {
+    // The FDE.
+    Fde* fde;
+    // The index of its CIE in cies_.
+    unsigned int cie_index;
+    // The section to which it applies, if the FDE should be discarded
+    // when that section is; otherwise 0.
+    unsigned int fde_shndx;
+  };
+
+  // Whether we were able to read the section.
+  bool recognized_;
+  // The distinct CIEs, and whether each may be merged with CIEs from
+  // other input sections.
+  std::vector<std::pair<Cie*, bool> > cies_;
+  // CIEs which are the same as one of cies_, and so are discarded.
+  std::vector<Cie*> duplicate_cies_;
+  // The FDEs.
+  std::vector<Parsed_fde> fdes_;
+};
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -324,6 +417,22 @@ class Eh_frame : public Output_section_data
 			    unsigned int shndx, unsigned int reloc_shndx,
 			    unsigned int reloc_type);
 
+  // Read the input section SHNDX in OBJECT, with the same arguments
+  // as add_ehframe_input_section.  This only looks at OBJECT, so it
+  // may be called for different objects at the same time.  The
+  // result is passed back to add_ehframe_input_section by way of
+  // Sized_relobj::release_parsed_eh_frame.  This returns NULL if the
+  // section should be treated as an ordinary input section.
+  template<int size, bool big_endian>
+  static Parsed_eh_frame*
+  parse_ehframe_input_section(Sized_relobj<size, big_endian>* object,
+			      const unsigned char* symbols,
+			      section_size_type symbols_size,
+			      const unsigned char* symbol_names,
+			      section_size_type symbol_names_size,
+			      unsigned int shndx, unsigned int reloc_shndx,
+			      unsigned int reloc_type);
+
   // Return the number of FDEs.
   unsigned int
   fde_count() const;
@@ -367,22 +476,19 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
-
-  // A list of CIEs, and a bool indicating whether the CIE is
-  // mergeable.
-  typedef std::vector<std::pair<Cie*, bool> > New_cies;
+  // A mapping from offsets to the index of a CIE in
+  // Parsed_eh_frame::cies_.  This is used while reading an input
+  // section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie;
 
   // Skip an LEB128.
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // The implementation of parse_ehframe_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj<size, big_endian>* object,
+  static bool
+  do_parse_ehframe_input_section(Sized_relobj<size, big_endian>* object,
 			       const unsigned char* symbols,
 			       section_size_type symbols_size,
 			       const unsigned char* symbol_names,
@@ -392,11 +498,11 @@ class Eh_frame : public Output_section_data
 			       unsigned int reloc_type,
 			       const unsigned char* pcontents,
 			       section_size_type contents_len,
-			       New_cies*);
+			       Parsed_eh_frame*);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -408,11 +514,11 @@ class Eh_frame : public Output_section_data
 	   const unsigned char *pcieend,
 	   Track_relocs<size, big_endian>* relocs,
 	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Parsed_eh_frame* parsed);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_fde(Sized_relobj<size, big_endian>* object,
 	   unsigned int shndx,
 	   const unsigned char* symbols,
@@ -422,7 +528,15 @@ class Eh_frame : public Output_section_data
 	   const unsigned char* pfde,
 	   const unsigned char *pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   const Offsets_to_cie* cies,
+	   Parsed_eh_frame* parsed);
+
+  // Add the CIEs and FDEs in PARSED, read from an input section in
+  // OBJECT.
+  template<int size, bool big_endian>
+  void
+  add_parsed_eh_frame(Sized_relobj<size, big_endian>* object,
+		      Parsed_eh_frame* parsed);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -117,6 +117,42 @@ Errors::info(const char* format, va_list args)
   fputc('\n', stderr);
 }
 
+// If RELINFO says that diagnostics at reloc locations should be
+// reported later, add an entry for one and return it.  Otherwise
+// return NULL.
+
+template<int size, bool big_endian>
+static Deferred_reloc_diagnostic*
+defer_at_location(const Relocate_info<size, big_endian>* relinfo,
+		  Deferred_reloc_diagnostic::Kind kind,
+		  size_t relnum, off_t reloffset)
+{
+  if (relinfo->deferred == NULL)
+    return NULL;
+  relinfo->deferred->push_back(Deferred_reloc_diagnostic());
+  Deferred_reloc_diagnostic* d = &relinfo->deferred->back();
+  d->kind = kind;
+  d->reloc_shndx = relinfo->reloc_shndx;
+  d->data_shndx = relinfo->data_shndx;
+  d->relnum = relnum;
+  d->reloffset = reloffset;
+  d->sym = NULL;
+  return d;
+}
+
+// Return the text of a deferred error or warning.
+
+static std::string
+deferred_message(const char* format, va_list args)
+{
+  char* buf = NULL;
+  if (vasprintf(&buf, format, args) < 0)
+    gold_nomem();
+  std::string ret(buf);
+  free(buf);
+  return ret;
+}
+
 // Report an error at a reloc location.
 
 template<int size, bool big_endian>
@@ -125,6 +161,15 @@ Errors::error_at_location(const Relocate_info<size, big_endian>* relinfo,
 			  size_t relnum, off_t reloffset,
 			  const char* format, va_list args)
 {
+  Deferred_reloc_diagnostic* d =
+    defer_at_location(relinfo, Deferred_reloc_diagnostic::DEFERRED_ERROR,
+		      relnum, reloffset);
+  if (d != NULL)
+    {
+      d->message = deferred_message(format, args);
+      return;
+    }
+
   fprintf(stderr, _("%s: %s: error: "), this->program_name_,
 	  relinfo->location(relnum, reloffset).c_str());
   vfprintf(stderr, format, args);
@@ -141,6 +186,15 @@ Errors::warning_at_location(const Relocate_info<size, big_endian>* relinfo,
 			    size_t relnum, off_t reloffset,
 			    const char* format, va_list args)
 {
+  Deferred_reloc_diagnostic* d =
+    defer_at_location(relinfo, Deferred_reloc_diagnostic::DEFERRED_WARNING,
+		      relnum, reloffset);
+  if (d != NULL)
+    {
+      d->message = deferred_message(format, args);
+      return;
+    }
+
   fprintf(stderr, _("%s: %s: warning: "), this->program_name_,
 	  relinfo->location(relnum, reloffset).c_str());
   vfprintf(stderr, format, args);
@@ -281,6 +335,16 @@ gold_undefined_symbol_at_location(const Symbol* sym,
 		      const Relocate_info<size, big_endian>* relinfo,
 		      size_t relnum, off_t reloffset)
 {
+  Deferred_reloc_diagnostic* d =
+    defer_at_location(relinfo,
+		      Deferred_reloc_diagnostic::DEFERRED_UNDEFINED_SYMBOL,
+		      relnum, reloffset);
+  if (d != NULL)
+    {
+      d->sym = sym;
+      return;
+    }
+
   parameters->errors()->undefined_symbol(sym,
                                          relinfo->location(relnum, reloffset));
 }
@@ -24,6 +24,7 @@
 
 #include <cstring>
 #include <cerrno>
+#include <algorithm>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/mman.h>
@@ -84,6 +85,8 @@ File_read::View::is_locked()
 unsigned long long File_read::total_mapped_bytes;
 unsigned long long File_read::current_mapped_bytes;
 unsigned long long File_read::maximum_mapped_bytes;
+unsigned long long File_read::total_readahead_bytes;
+unsigned long long File_read::total_released_bytes;
 
 File_read::~File_read()
 {
@@ -180,13 +183,17 @@ File_read::release()
   // we waste time trying to clear cached archive views.  Similarly
   // for releasing the descriptor.
   if (this->object_count_ <= 1)
+    this->clear_views(false);
+
+  // Pages which are still mapped are not dropped, so this must follow
+  // clear_views.
+  if (this->release_size_ > 0)
+    this->do_release_pages();
+
+  if (this->object_count_ <= 1 && this->is_descriptor_opened_)
     {
-      this->clear_views(false);
-      if (this->is_descriptor_opened_)
-	{
-	  release_descriptor(this->descriptor_, false);
-	  this->is_descriptor_opened_ = false;
-	}
+      release_descriptor(this->descriptor_, false);
+      this->is_descriptor_opened_ = false;
     }
 
   this->released_ = true;
@@ -611,6 +618,90 @@ File_read::read_multiple(off_t base, const Read_multiple& rm)
     }
 }
 
+// Request readahead of several pieces of data.  Pieces which are less
+// than a page apart are combined, so that the system sees a few large
+// requests rather than many small ones.
+
+void
+File_read::readahead(off_t base, Readahead* ra)
+{
+  if (this->contents_ != NULL || ra->empty())
+    return;
+
+  std::sort(ra->begin(), ra->end());
+
+  off_t start = (*ra)[0].file_offset;
+  off_t end = start + (*ra)[0].size;
+  for (Readahead::const_iterator p = ra->begin() + 1; p != ra->end(); ++p)
+    {
+      if (p->file_offset - end < File_read::page_size)
+	end = std::max(end, p->file_offset + p->size);
+      else
+	{
+	  this->do_readahead(base + start, end - start);
+	  start = p->file_offset;
+	  end = start + p->size;
+	}
+    }
+  this->do_readahead(base + start, end - start);
+}
+
+// Request readahead of SIZE bytes at START.  This is only a hint, so
+// we don't report failure.
+
+void
+File_read::do_readahead(off_t start, off_t size)
+{
+#ifdef HAVE_POSIX_FADVISE
+  this->reopen_descriptor();
+  if (::posix_fadvise(this->descriptor_, start, size,
+		      POSIX_FADV_WILLNEED) == 0)
+    File_read::total_readahead_bytes += size;
+#endif
+}
+
+// Arrange to drop SIZE bytes at START from the page cache when the
+// file is released.  If this is called more than once before the
+// file is released, we drop the range covering all the requests.
+
+void
+File_read::release_pages(off_t start, off_t size)
+{
+  gold_assert(this->is_locked());
+  if (this->contents_ != NULL || size == 0)
+    return;
+
+  if (this->release_size_ == 0)
+    {
+      this->release_start_ = start;
+      this->release_size_ = size;
+    }
+  else
+    {
+      off_t end = std::max(this->release_start_ + this->release_size_,
+			   start + size);
+      this->release_start_ = std::min(this->release_start_, start);
+      this->release_size_ = end - this->release_start_;
+    }
+}
+
+// Drop the pages requested by release_pages from the page cache.
+// This is only a hint, so we don't report failure.  This is called
+// by release, which releases the descriptor afterward.
+
+void
+File_read::do_release_pages()
+{
+#ifdef HAVE_POSIX_FADVISE
+  this->reopen_descriptor();
+  if (::posix_fadvise(this->descriptor_, this->release_start_,
+		      this->release_size_, POSIX_FADV_DONTNEED) == 0)
+    File_read::total_released_bytes += this->release_size_;
+#endif
+  this->release_start_ = 0;
+  this->release_size_ = 0;
+}
+
 // Mark all views as no longer cached.
 
 void
@@ -698,6 +789,12 @@ File_read::print_stats()
 	  program_name, File_read::total_mapped_bytes);
   fprintf(stderr, _("%s: maximum bytes mapped for read at one time: %llu\n"),
 	  program_name, File_read::maximum_mapped_bytes);
+  if (parameters->options().readahead())
+    fprintf(stderr, _("%s: total bytes requested for readahead: %llu\n"),
+	    program_name, File_read::total_readahead_bytes);
+  if (parameters->options().release_input_pages())
+    fprintf(stderr, _("%s: total input bytes released from cache: %llu\n"),
+	    program_name, File_read::total_released_bytes);
 }
 
 // Class File_view.
@@ -780,9 +877,11 @@ File_read::get_mtime()
   if (fstat(this->descriptor_, &file_stat) < 0)
     gold_fatal(_("%s: stat failed: %s"), this->name_.c_str(),
 	       strerror(errno));
-  // TODO: do a configure check if st_mtim is present and get the
-  // nanoseconds part if it is.
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+  return Timespec(file_stat.st_mtime, file_stat.st_mtim.tv_nsec);
+#else
   return Timespec(file_stat.st_mtime, 0);
+#endif
 }
 
 // Open the file.
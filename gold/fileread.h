@@ -66,7 +66,7 @@ class File_read
   File_read()
     : name_(), descriptor_(-1), is_descriptor_opened_(false), object_count_(0),
       size_(0), token_(false), views_(), saved_views_(), contents_(NULL),
-      mapped_bytes_(0), released_(true)
+      mapped_bytes_(0), released_(true), release_start_(0), release_size_(0)
   { }
 
   ~File_read();
@@ -196,6 +196,39 @@ class File_read
   void
   read_multiple(off_t base, const Read_multiple&);
 
+  // A struct used to describe data which will be read soon.
+  struct Readahead_entry
+  {
+    // The file offset of the data.
+    off_t file_offset;
+    // The amount of data.
+    off_t size;
+
+    Readahead_entry(off_t o, off_t s)
+      : file_offset(o), size(s)
+    { }
+
+    bool
+    operator<(const Readahead_entry& e) const
+    { return this->file_offset < e.file_offset; }
+  };
+
+  typedef std::vector<Readahead_entry> Readahead;
+
+  // Tell the system that the data described by the vector will be
+  // read soon, so that it can start reading it in the background.
+  // BASE is a base offset to be added to all the offsets in the
+  // vector.  This sorts the vector.
+  void
+  readahead(off_t base, Readahead*);
+
+  // Tell the system that the SIZE bytes at file offset START will
+  // not be read again, so that it may drop them from the page cache.
+  // The pages are dropped when the file is next released, once its
+  // views have been unmapped.  The file must be locked.
+  void
+  release_pages(off_t start, off_t size);
+
   // Dump statistical information to stderr.
   static void
   print_stats();
@@ -230,6 +263,14 @@ class File_read
   // This variable may not be accurate when running multi-threaded.
   static unsigned long long maximum_mapped_bytes;
 
+  // Total bytes for which readahead was requested during the link.
+  // This variable may not be accurate when running multi-threaded.
+  static unsigned long long total_readahead_bytes;
+
+  // Total bytes dropped from the page cache during the link.  This
+  // variable may not be accurate when running multi-threaded.
+  static unsigned long long total_released_bytes;
+
   // A view into the file.
   class View
   {
@@ -376,6 +417,14 @@ class File_read
   void
   do_readv(off_t base, const Read_multiple&, size_t start, size_t count);
 
+  // Request readahead of SIZE bytes at START.
+  void
+  do_readahead(off_t start, off_t size);
+
+  // Drop the pages requested by release_pages.
+  void
+  do_release_pages();
+
   // File name.
   std::string name_;
   // File descriptor.
@@ -402,6 +451,10 @@ class File_read
   size_t mapped_bytes_;
   // Whether the file was released.
   bool released_;
+  // The range of the file to drop from the page cache when the file
+  // is released, set by release_pages.
+  off_t release_start_;
+  off_t release_size_;
 };
 
 // A view of file data that persists even when the file is unlocked.
@@ -31,44 +31,251 @@ namespace gold
 
 // Garbage collection uses a worklist style algorithm to determine the 
 // transitive closure of all referenced sections.
-void 
-Garbage_collection::do_transitive_closure()
+//
+// Each section which may be collected is given an index, and the
+// referenced sections are recorded in a bitmap.  The sections are
+// divided into partitions of consecutive indexes.  When running with
+// threads there are several partitions, and the closure is done in
+// rounds: in each round a Gc_mark_task for each partition follows
+// the references from the sections waiting for it, and marks the
+// sections of that partition which it reaches.  Sections of other
+// partitions are passed to them for the next round.  Since only one
+// task sets the bits of any partition, no further locking is needed.
+
+// Add the sections of OBJ.
+
+void
+Garbage_collection::add_object(Object* obj)
+{
+  std::pair<Object_base::iterator, bool> ins =
+    this->object_base_.insert(std::make_pair(obj, this->section_count_));
+  if (!ins.second)
+    return;
+  this->section_count_ += obj->shnum();
+  this->section_refs_.resize(this->section_count_);
+}
+
+// Set *PINDEX to the index of section SHNDX of OBJ.
+
+bool
+Garbage_collection::section_index(const Object* obj, unsigned int shndx,
+                                  unsigned int* pindex) const
+{
+  Object_base::const_iterator p = this->object_base_.find(obj);
+  if (p == this->object_base_.end() || shndx >= obj->shnum())
+    return false;
+  *pindex = p->second + shndx;
+  return true;
+}
+
+// Record a reference from one section to another.  Each source object
+// only changes the reference lists of its own sections, so this may be
+// called for different source objects at the same time.
+
+void
+Garbage_collection::add_reference(Object* src_obj, unsigned int src_shndx,
+                                  Object* dst_obj, unsigned int dst_shndx)
 {
-  while (!this->worklist().empty())
+  unsigned int src_index;
+  unsigned int dst_index;
+  if (!this->section_index(src_obj, src_shndx, &src_index)
+      || !this->section_index(dst_obj, dst_shndx, &dst_index))
+    return;
+  this->section_refs_[src_index].push_back(dst_index);
+}
+
+// Start the transitive closure from the sections on the worklist.
+
+void
+Garbage_collection::queue_transitive_closure(Workqueue* workqueue,
+                                             Task_token* gc_blocker)
+{
+  unsigned int partitions = (parameters->options().threads()
+                             ? partition_count
+                             : 1);
+
+  // Each partition covers a whole number of words of the bitmap.
+  unsigned int size = (this->section_count_ + partitions - 1) / partitions;
+  this->partition_size_ = std::max(32U, (size + 31) & ~31U);
+  partitions = ((this->section_count_ + this->partition_size_ - 1)
+                / this->partition_size_);
+
+  this->referenced_.assign((this->section_count_ + 31) / 32, 0);
+  this->inbox_.resize(partitions);
+  this->outbox_.resize(partitions);
+  for (unsigned int i = 0; i < partitions; ++i)
+    this->outbox_[i].resize(partitions);
+
+  while (!this->work_list_.empty())
     {
-      // Add elements from the work list to the referenced list
-      // one by one.
-      Section_id entry = this->worklist().front();
-      this->worklist().pop();
-      if (this->referenced_list().find(entry)
-          == this->referenced_list().end()) 
-        {
-          this->referenced_list().insert(entry);
-        }
-      else
+      unsigned int index;
+      if (this->section_index(this->work_list_.front().first,
+                              this->work_list_.front().second,
+                              &index))
+        this->inbox_[this->partition(index)].push_back(index);
+      this->work_list_.pop();
+    }
+
+  this->queue_mark_round(workqueue, gc_blocker);
+}
+
+// Queue a Gc_mark_task for each partition with sections waiting for
+// it, followed by a Gc_mark_round_task.
+
+void
+Garbage_collection::queue_mark_round(Workqueue* workqueue,
+                                     Task_token* gc_blocker)
+{
+  Task_token* round_blocker = new Task_token(true);
+  for (size_t i = 0; i < this->inbox_.size(); ++i)
+    if (!this->inbox_[i].empty())
+      round_blocker->add_blocker();
+  for (size_t i = 0; i < this->inbox_.size(); ++i)
+    if (!this->inbox_[i].empty())
+      workqueue->queue_soon(new Gc_mark_task(this, i, round_blocker));
+  workqueue->queue_soon(new Gc_mark_round_task(this, round_blocker,
+                                               gc_blocker));
+}
+
+// Mark the sections of PARTITION reachable from the sections waiting
+// for it.  Sections of other partitions are put in the outbox.
+
+void
+Garbage_collection::mark_partition(unsigned int partition)
+{
+  std::vector<unsigned int> work;
+  work.swap(this->inbox_[partition]);
+  std::vector<std::vector<unsigned int> >& outbox(this->outbox_[partition]);
+
+  while (!work.empty())
+    {
+      unsigned int index = work.back();
+      work.pop_back();
+      gold_assert(this->partition(index) == partition);
+      if (this->is_referenced(index))
+        continue;
+      this->set_referenced(index);
+
+      const std::vector<unsigned int>& refs(this->section_refs_[index]);
+      for (std::vector<unsigned int>::const_iterator p = refs.begin();
+           p != refs.end();
+           ++p)
         {
-          continue;
+          unsigned int dst_partition = this->partition(*p);
+          if (dst_partition != partition)
+            outbox[dst_partition].push_back(*p);
+          else if (!this->is_referenced(*p))
+            work.push_back(*p);
         }
-      Garbage_collection::Section_ref::iterator find_it = 
-                this->section_reloc_map().find(entry);
-      if (find_it == this->section_reloc_map().end()) 
-          continue;
-      Garbage_collection::Sections_reachable v = find_it->second;
-      // Scan the vector of references for each work_list entry. 
-      for (Garbage_collection::Sections_reachable::iterator it_v = v.begin();
-           it_v != v.end();
-           ++it_v)
+    }
+}
+
+// Pass the sections in the outboxes to the partitions they belong to.
+// Sections which have already been marked are dropped.
+
+bool
+Garbage_collection::finish_mark_round()
+{
+  bool any = false;
+  for (size_t i = 0; i < this->outbox_.size(); ++i)
+    {
+      for (size_t j = 0; j < this->outbox_[i].size(); ++j)
         {
-          // Do not add already processed sections to the work_list. 
-          if (this->referenced_list().find(*it_v)
-              == this->referenced_list().end())
+          std::vector<unsigned int>& out(this->outbox_[i][j]);
+          for (std::vector<unsigned int>::const_iterator p = out.begin();
+               p != out.end();
+               ++p)
             {
-              this->worklist().push(*it_v);   
+              if (!this->is_referenced(*p))
+                {
+                  this->inbox_[j].push_back(*p);
+                  any = true;
+                }
             }
+          out.clear();
         }
     }
-  this->worklist_ready();
+
+  if (!any)
+    {
+      // The reference lists are no longer needed.
+      std::vector<std::vector<unsigned int> >().swap(this->section_refs_);
+      this->inbox_.clear();
+      this->outbox_.clear();
+      this->worklist_ready();
+    }
+
+  return any;
 }
 
-} // End namespace gold.
+// Class Gc_mark_task.
+
+// We can always run this task.
+
+Task_token*
+Gc_mark_task::is_runnable()
+{
+  return NULL;
+}
+
+// We need to unlock BLOCKER when finished.
 
+void
+Gc_mark_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->blocker_);
+}
+
+// Mark the sections.
+
+void
+Gc_mark_task::run(Workqueue*)
+{
+  this->gc_->mark_partition(this->partition_);
+}
+
+// Return a debugging name for the task.
+
+std::string
+Gc_mark_task::get_name() const
+{
+  char buf[30];
+  snprintf(buf, sizeof buf, "Gc_mark_task %u", this->partition_);
+  return std::string(buf);
+}
+
+// Class Gc_mark_round_task.
+
+// Wait until the round of marking is done.
+
+Task_token*
+Gc_mark_round_task::is_runnable()
+{
+  if (this->round_blocker_->is_blocked())
+    return this->round_blocker_;
+  return NULL;
+}
+
+// We need to unlock GC_BLOCKER when finished.
+
+void
+Gc_mark_round_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->gc_blocker_);
+}
+
+// Finish the round, and start another one if there are more sections
+// to mark.  The next Gc_mark_round_task also unlocks GC_BLOCKER, so
+// add a blocker for it.
+
+void
+Gc_mark_round_task::run(Workqueue* workqueue)
+{
+  if (this->gc_->finish_mark_round())
+    {
+      workqueue->add_blocker(this->gc_blocker_);
+      this->gc_->queue_mark_round(workqueue, this->gc_blocker_);
+    }
+}
+
+} // End namespace gold.
@@ -28,6 +28,7 @@
 
 #include "elfcpp.h"
 #include "symtab.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -48,32 +49,22 @@ typedef std::pair<Object *, unsigned int> Section_id;
 
 class Garbage_collection
 {
-  struct Section_id_hash
-  {
-    size_t operator()(const Section_id& loc) const
-    { return reinterpret_cast<uintptr_t>(loc.first) ^ loc.second; }
-  };
-
  public:
 
-  typedef Unordered_set<Section_id, Section_id_hash> Sections_reachable;
-  typedef std::map<Section_id, Sections_reachable> Section_ref;
   typedef std::queue<Section_id> Worklist_type;
 
+  // The number of partitions of the sections for the transitive
+  // closure when running with threads.
+  static const unsigned int partition_count = 16;
+
   Garbage_collection()
-  : is_worklist_ready_(false)
+  : is_worklist_ready_(false), work_list_(), object_base_(),
+    section_count_(0), section_refs_(), referenced_(), partition_size_(0),
+    inbox_(), outbox_()
   { }
 
   // Accessor methods for the private members.
 
-  Sections_reachable&
-  referenced_list()
-  { return referenced_list_; }
-
-  Section_ref&
-  section_reloc_map()
-  { return this->section_reloc_map_; }
-
   Worklist_type&
   worklist()
   { return this->work_list_; }
@@ -86,19 +77,165 @@ class Garbage_collection
   worklist_ready()
   { this->is_worklist_ready_ = true; }
 
+  // Add the sections of OBJ to the sections which may be collected.
+  // This must be called for every object before the relocs of any
+  // object are processed.
+  void
+  add_object(Object* obj);
+
+  // Record that section SRC_SHNDX of SRC_OBJ refers to section
+  // DST_SHNDX of DST_OBJ.  This is called by gc_process_relocs, which
+  // may run for different source objects at the same time.
+  void
+  add_reference(Object* src_obj, unsigned int src_shndx, Object* dst_obj,
+                unsigned int dst_shndx);
+
+  // Queue tasks to do a transitive closure on all references from the
+  // sections on the worklist.  GC_BLOCKER is unblocked when it is done.
+  void
+  queue_transitive_closure(Workqueue*, Task_token* gc_blocker);
+
+  // Mark the sections reachable from the sections waiting for
+  // PARTITION.  This is called by Gc_mark_task, for different
+  // partitions at the same time.
+  void
+  mark_partition(unsigned int partition);
+
+  // Finish a round of marking.  Returns true if there are more sections
+  // to mark.  This is called by Gc_mark_round_task.
+  bool
+  finish_mark_round();
+
+  // Queue the tasks for a round of marking.  GC_BLOCKER is unblocked
+  // when the transitive closure is done.
   void
-  do_transitive_closure();
+  queue_mark_round(Workqueue*, Task_token* gc_blocker);
 
   bool
   is_section_garbage(Object* obj, unsigned int shndx)
-  { return (this->referenced_list().find(Section_id(obj, shndx))
-            == this->referenced_list().end()); }
+  {
+    unsigned int index;
+    return (!this->section_index(obj, shndx, &index)
+            || !this->is_referenced(index));
+  }
+
  private:
+  typedef Unordered_map<const Object*, unsigned int> Object_base;
+
+  // Set *PINDEX to the index of section SHNDX of OBJ.  Returns false
+  // if the section was not added by add_object.
+  bool
+  section_index(const Object* obj, unsigned int shndx,
+                unsigned int* pindex) const;
+
+  // Return the partition which marks section INDEX.
+  unsigned int
+  partition(unsigned int index) const
+  { return index / this->partition_size_; }
+
+  // Return whether section INDEX has been marked as referenced.
+  bool
+  is_referenced(unsigned int index) const
+  { return (this->referenced_[index / 32] & (1U << (index % 32))) != 0; }
+
+  // Mark section INDEX as referenced.
+  void
+  set_referenced(unsigned int index)
+  { this->referenced_[index / 32] |= 1U << (index % 32); }
 
-  Worklist_type work_list_;
   bool is_worklist_ready_;
-  Section_ref section_reloc_map_;
-  Sections_reachable referenced_list_;
+  // The sections which are known to be referenced, before the
+  // transitive closure.
+  Worklist_type work_list_;
+  // Each section added by add_object is given an index.  This maps
+  // each object to the index of its first section.
+  Object_base object_base_;
+  // The number of sections.
+  unsigned int section_count_;
+  // The indexes of the sections each section refers to.
+  std::vector<std::vector<unsigned int> > section_refs_;
+  // A bit for each section, set if the section is referenced.  Each
+  // partition only sets the bits of its own sections, and the
+  // partitions are aligned to whole words.
+  std::vector<uint32_t> referenced_;
+  // The number of sections in each partition.
+  unsigned int partition_size_;
+  // The sections waiting to be marked by each partition.
+  std::vector<std::vector<unsigned int> > inbox_;
+  // The sections found by each partition which belong to each other
+  // partition, indexed by source partition and then destination
+  // partition.
+  std::vector<std::vector<std::vector<unsigned int> > > outbox_;
+};
+
+// This task marks the sections of one partition for garbage
+// collection.
+
+class Gc_mark_task : public Task
+{
+ public:
+  // BLOCKER is unblocked when all the partitions are done.
+  Gc_mark_task(Garbage_collection* gc, unsigned int partition,
+               Task_token* blocker)
+    : gc_(gc), partition_(partition), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Garbage_collection* gc_;
+  unsigned int partition_;
+  Task_token* blocker_;
+};
+
+// This task runs after each round of Gc_mark_tasks.  It passes the
+// sections found by each partition to the partitions they belong to,
+// and queues another round if needed.
+
+class Gc_mark_round_task : public Task
+{
+ public:
+  // ROUND_BLOCKER is unblocked when the Gc_mark_tasks are done.
+  // GC_BLOCKER is unblocked when the transitive closure is done.
+  Gc_mark_round_task(Garbage_collection* gc, Task_token* round_blocker,
+                     Task_token* gc_blocker)
+    : gc_(gc), round_blocker_(round_blocker), gc_blocker_(gc_blocker)
+  { }
+
+  ~Gc_mark_round_task()
+  { delete this->round_blocker_; }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Gc_mark_round_task"; }
+
+ private:
+  Garbage_collection* gc_;
+  Task_token* round_blocker_;
+  Task_token* gc_blocker_;
 };
 
 // Data to pass between successive invocations of do_layout
@@ -231,21 +368,7 @@ gc_process_relocs(
             }
         }
       if (parameters->options().gc_sections())
-        {
-          Section_id src_id(src_obj, src_indx);
-          Section_id dst_id(dst_obj, dst_indx);
-          Garbage_collection::Section_ref::iterator map_it;
-          map_it = symtab->gc()->section_reloc_map().find(src_id);
-          if (map_it == symtab->gc()->section_reloc_map().end())
-            {
-              symtab->gc()->section_reloc_map()[src_id].insert(dst_id);
-            }
-          else
-            {
-              Garbage_collection::Sections_reachable& v(map_it->second);
-              v.insert(dst_id);
-            }
-        }
+        symtab->gc()->add_reference(src_obj, src_indx, dst_obj, dst_indx);
     }
   return;
 }
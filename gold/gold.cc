@@ -38,6 +38,7 @@
 #include "common.h"
 #include "object.h"
 #include "layout.h"
+#include "compressed_output.h"
 #include "reloc.h"
 #include "defstd.h"
 #include "plugin.h"
@@ -91,8 +92,21 @@ do_gold_unreachable(const char* filename, int lineno, const char* function)
   gold_exit(false);
 }
 
+// The type of a function which queues up some of the middle set of
+// tasks.
+
+typedef void (*Middle_tasks_function)(const General_options&,
+				      const Task*,
+				      const Input_objects*,
+				      Symbol_table*,
+				      Layout*,
+				      Workqueue*,
+				      Mapfile*);
+
 // This class arranges to run the functions done in the middle of the
-// link.  It is just a closure.
+// link.  It is just a closure.  FUNCTION is the function to run; the
+// middle of the link is split up when garbage collection or identical
+// code folding queue tasks of their own.
 
 class Middle_runner : public Task_function_runner
 {
@@ -100,9 +114,10 @@ class Middle_runner : public Task_function_runner
   Middle_runner(const General_options& options,
 		const Input_objects* input_objects,
 		Symbol_table* symtab,
-		Layout* layout, Mapfile* mapfile)
+		Layout* layout, Mapfile* mapfile,
+		Middle_tasks_function function = queue_middle_tasks)
     : options_(options), input_objects_(input_objects), symtab_(symtab),
-      layout_(layout), mapfile_(mapfile)
+      layout_(layout), mapfile_(mapfile), function_(function)
   { }
 
   void
@@ -114,13 +129,14 @@ class Middle_runner : public Task_function_runner
   Symbol_table* symtab_;
   Layout* layout_;
   Mapfile* mapfile_;
+  Middle_tasks_function function_;
 };
 
 void
 Middle_runner::run(Workqueue* workqueue, const Task* task)
 {
-  queue_middle_tasks(this->options_, task, this->input_objects_, this->symtab_,
-		     this->layout_, workqueue, this->mapfile_);
+  (*this->function_)(this->options_, task, this->input_objects_,
+		     this->symtab_, this->layout_, workqueue, this->mapfile_);
 }
 
 // This class arranges the tasks to process the relocs for garbage collection.
@@ -248,6 +264,18 @@ queue_middle_gc_tasks(const General_options& options,
   // unused sections before any scanning of the relocs can take place.
   Task_token* blocker = new Task_token(true);
   Task_token* symtab_lock = new Task_token(false);
+
+  // Give every section an index before processing any relocations.
+  // Adding an object may reallocate the reference lists, so this
+  // must not overlap with a Gc_process_relocs task.
+  if (parameters->options().gc_sections())
+    {
+      for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+           p != input_objects->relobj_end();
+           ++p)
+        symtab->gc()->add_object(*p);
+    }
+
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
        p != input_objects->relobj_end();
        ++p)
@@ -258,13 +286,14 @@ queue_middle_gc_tasks(const General_options& options,
 				       symtab_lock, blocker));
     }
 
-  Task_token* this_blocker = new Task_token(true);
+  // The middle tasks must wait until all the relocs have been
+  // processed.
   workqueue->queue(new Task_function(new Middle_runner(options,
                                                        input_objects,
                                                        symtab,
                                                        layout,
                                                        mapfile),
-                                     this_blocker,
+                                     blocker,
                                      "Task_function Middle_runner"));
 }
 
@@ -308,16 +337,52 @@ queue_middle_tasks(const General_options& options,
       // Symbols named with -u should not be considered garbage.
       symtab->gc_mark_undef_symbols();
       gold_assert(symtab->gc() != NULL);
-      // Do a transitive closure on all references to determine the worklist.
-      symtab->gc()->do_transitive_closure();
+      // Do a transitive closure on all references to determine the
+      // worklist.  This is done by a set of tasks; the rest of the
+      // middle tasks are queued when they are done.
+      Task_token* gc_blocker = new Task_token(true);
+      gc_blocker->add_blocker();
+      symtab->gc()->queue_transitive_closure(workqueue, gc_blocker);
+      Middle_runner* runner = new Middle_runner(options, input_objects,
+                                                symtab, layout, mapfile,
+                                                queue_middle_layout_tasks);
+      workqueue->queue(new Task_function(runner, gc_blocker,
+                                         "Task_function Middle_runner"));
+      return;
     }
 
+  queue_middle_layout_tasks(options, task, input_objects, symtab, layout,
+                            workqueue, mapfile);
+}
+
+// Queue up the rest of the middle set of tasks, after garbage
+// collection has been done.
+
+void
+queue_middle_layout_tasks(const General_options& options,
+			  const Task* task,
+			  const Input_objects* input_objects,
+			  Symbol_table* symtab,
+			  Layout* layout,
+			  Workqueue* workqueue,
+			  Mapfile* mapfile)
+{
   // If identical code folding (--icf) is chosen it makes sense to do it 
   // only after garbage collection (--gc-sections) as we do not want to 
-  // be folding sections that will be garbage.
-  if (parameters->options().icf())
+  // be folding sections that will be garbage.  The sections are hashed
+  // by a set of tasks; this function is run again when they are done.
+  if (parameters->options().icf() && !symtab->icf()->is_icf_ready())
     {
-      symtab->icf()->find_identical_sections(input_objects, symtab);
+      Task_token* icf_blocker = new Task_token(true);
+      icf_blocker->add_blocker();
+      symtab->icf()->queue_find_identical_sections(workqueue, input_objects,
+                                                   symtab, icf_blocker);
+      Middle_runner* runner = new Middle_runner(options, input_objects,
+                                                symtab, layout, mapfile,
+                                                queue_middle_layout_tasks);
+      workqueue->queue(new Task_function(runner, icf_blocker,
+                                         "Task_function Middle_runner"));
+      return;
     }
 
   // Call Object::layout for the second time to determine the 
@@ -401,8 +466,7 @@ queue_middle_tasks(const General_options& options,
   input_objects->check_dynamic_dependencies();
 
   // See if any of the input definitions violate the One Definition Rule.
-  // TODO: if this is too slow, do this as a task, rather than inline.
-  symtab->detect_odr_violations(task, options.output_file_name());
+  symtab->detect_odr_violations(task, workqueue, options.output_file_name());
 
   // Create any automatic note sections.
   layout->create_notes();
@@ -436,6 +500,13 @@ queue_middle_tasks(const General_options& options,
   Task_token* blocker = new Task_token(true);
   Task_token* symtab_lock = new Task_token(false);
 
+  // With threads, the strings of merged string sections are added to
+  // their string pools by tasks which run alongside the relocation
+  // scanning.  Queue them first, since the scanning may create new
+  // output sections.
+  if (parameters->options().threads())
+    layout->queue_merge_tasks(workqueue, blocker);
+
   // If doing garbage collection, the relocations have already been read.
   // Otherwise, read and scan the relocations.
   if (parameters->options().gc_sections() || parameters->options().icf())
@@ -582,19 +653,34 @@ queue_final_tasks(const General_options& options,
     {
       Task_token *new_final_blocker = new Task_token(true);
       new_final_blocker->add_blocker();
-      Task* t = new Write_after_input_sections_task(layout, of,
-						    final_blocker,
-						    new_final_blocker);
+      Task* t;
+      // If there are compressed sections, compress them in parallel
+      // before laying out the postprocessing sections.
+      if (layout->any_compressed_sections())
+	t = new Task_function(new Compress_sections_task_runner(layout, of,
+							       new_final_blocker),
+			      final_blocker,
+			      "Task_function Compress_sections_task_runner");
+      else
+	t = new Write_after_input_sections_task(layout, of, final_blocker,
+						new_final_blocker);
       workqueue->queue(t);
       final_blocker = new_final_blocker;
     }
 
   // Queue a task to close the output file.  This will be blocked by
-  // FINAL_BLOCKER.
-  workqueue->queue(new Task_function(new Close_task_runner(&options, layout,
-							   of),
-				     final_blocker,
-				     "Task_function Close_task_runner"));
+  // FINAL_BLOCKER.  For --build-id=tree, first queue a task to
+  // compute the build ID in parallel; it will queue the close task.
+  if (layout->build_id_uses_chunks())
+    workqueue->queue(new Task_function(new Build_id_task_runner(&options,
+								layout, of),
+				       final_blocker,
+				       "Task_function Build_id_task_runner"));
+  else
+    workqueue->queue(new Task_function(new Close_task_runner(&options,
+							     layout, of),
+				       final_blocker,
+				       "Task_function Close_task_runner"));
 }
 
 } // End namespace gold.
@@ -58,7 +58,7 @@ class Target_i386 : public Target_freebsd<32, false>
 
   Target_i386()
     : Target_freebsd<32, false>(&i386_info),
-      got_(NULL), plt_(NULL), got_plt_(NULL), rel_dyn_(NULL),
+      got_(NULL), plt_(NULL), got_plt_(NULL), rel_dyn_(NULL), relr_dyn_(NULL),
       copy_relocs_(elfcpp::R_386_COPY), dynbss_(NULL),
       got_mod_index_offset_(-1U), tls_base_symbol_defined_(false)
   { }
@@ -98,6 +98,10 @@ class Target_i386 : public Target_freebsd<32, false>
   void
   do_finalize_sections(Layout*);
 
+  // Finalize the sections which depend on the section addresses.
+  bool
+  do_finalize_address_dependent_sections();
+
   // Return the value to use for a dynamic which requires special
   // treatment.
   uint64_t
@@ -421,6 +425,8 @@ class Target_i386 : public Target_freebsd<32, false>
   Output_data_space* got_plt_;
   // The dynamic reloc section.
   Reloc_section* rel_dyn_;
+  // The packed relative relocs, for -z pack-relative-relocs.
+  Output_data_relr<32, false>* relr_dyn_;
   // Relocs saved to avoid a COPY reloc.
   Copy_relocs<elfcpp::SHT_REL, 32, false> copy_relocs_;
   // Space for variables copied with a COPY reloc.
@@ -506,6 +512,18 @@ Target_i386::rel_dyn_section(Layout* layout)
       this->rel_dyn_ = new Reloc_section(parameters->options().combreloc());
       layout->add_output_section_data(".rel.dyn", elfcpp::SHT_REL,
 				      elfcpp::SHF_ALLOC, this->rel_dyn_);
+
+      // The packed relocs are encoded when the addresses of the
+      // relocated locations are known, so we don't use them if a
+      // linker script may change where they go.
+      if (parameters->options().pack_relative_relocs()
+	  && !layout->script_options()->saw_sections_clause())
+	{
+	  this->relr_dyn_ = new Output_data_relr<32, false>();
+	  layout->add_output_section_data(".relr.dyn", elfcpp::SHT_RELR,
+					  elfcpp::SHF_ALLOC, this->relr_dyn_);
+	  this->rel_dyn_->set_relr(this->relr_dyn_, elfcpp::R_386_RELATIVE);
+	}
     }
   return this->rel_dyn_;
 }
@@ -1567,6 +1585,16 @@ Target_i386::scan_relocs(const General_options& options,
 void
 Target_i386::do_finalize_sections(Layout* layout)
 {
+  // If no relative relocs were packed, drop the empty section, so
+  // that there are no tags for it and no need for a C library which
+  // supports them.  Any relative relocs added from now on go in .rel.dyn.
+  if (this->relr_dyn_ != NULL && this->relr_dyn_->empty())
+    {
+      layout->remove_output_section(layout->find_output_section(".relr.dyn"));
+      this->rel_dyn_->set_relr(NULL, 0);
+      this->relr_dyn_ = NULL;
+    }
+
   // Fill in some more dynamic tags.
   Output_data_dynamic* const odyn = layout->dynamic_data();
   if (odyn != NULL)
@@ -1591,6 +1619,13 @@ Target_i386::do_finalize_sections(Layout* layout)
 			     elfcpp::Elf_sizes<32>::rel_size);
 	}
 
+      if (this->relr_dyn_ != NULL)
+	{
+	  odyn->add_section_address(elfcpp::DT_RELR, this->relr_dyn_);
+	  odyn->add_section_size(elfcpp::DT_RELRSZ, this->relr_dyn_);
+	  odyn->add_constant(elfcpp::DT_RELRENT, 32 / 8);
+	}
+
       if (!parameters->options().shared())
 	{
 	  // The value of the DT_DEBUG tag is filled in by the dynamic
@@ -2600,6 +2635,16 @@ Target_i386::relocate_for_relocatable(
     reloc_view_size);
 }
 
+// Encode the packed relative relocs, now that the addresses of the
+// locations they relocate are known.  Return true if they need more
+// space than they were given.
+
+bool
+Target_i386::do_finalize_address_dependent_sections()
+{
+  return this->relr_dyn_ != NULL && !this->relr_dyn_->encode();
+}
+
 // Return the value to use for a dynamic which requires special
 // treatment.  This is how we support equality comparisons of function
 // pointers across shared library boundaries, as described in the
@@ -107,6 +107,27 @@
 //
 // Performance : Less than 20 % link-time overhead on industry strength
 // applications.  Up to 6 %  text size reductions.
+//
+// Parallel hashing :
+// ----------------
+//
+// Most of the work is in building the contents of each section and
+// checksumming them, so this is done by an Icf_hash_task for each
+// object, and these tasks may run in parallel.  Each task holds the
+// lock on its object and reads no other object, so the contents of
+// merge sections referred to from other objects are read by the task
+// for the object which owns them during the first pass.  The first
+// pass checksums
+// the section contents, so that sections which are already known to be
+// unique are not processed any further.  A second pass builds the
+// contents of the remaining sections, including their relocs to
+// sections that cannot be folded, and records their relocs to sections
+// that could be folded.  The iterations described above are then done
+// by Icf_match_task, in section order, so the result does not depend
+// on the number of threads.  Each iteration only needs to checksum the
+// relocs to sections that could be folded, continuing the checksum of
+// the rest of the contents, and full comparisons are only done between
+// sections with the same checksum.
 
 #include "gold.h"
 #include "object.h"
@@ -120,113 +141,72 @@ namespace gold
 
 // This function determines if a section or a group of identical
 // sections has unique contents.  Such unique sections or groups can be
-// declared final and need not be processed any further.
-// Parameters :
-// ID_SECTION : Vector mapping a section index to a Section_id pair.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sections is already known to be unique.
-// SECTION_CONTENTS : Contains the section's text and relocs to sections
-//                    that cannot be folded.   SECTION_CONTENTS are NULL
-//                    implies that this function is being called for the
-//                    first time before the first iteration of icf.
-
-static void
-preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
-                               std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+// declared final and need not be processed any further.  This uses the
+// checksums stored in SECTION_INFO_, which are of the section contents
+// before the first iteration of icf, and of the section's text and
+// relocs to sections that cannot be folded afterward.
+
+void
+Icf::preprocess_for_unique_sections()
 {
   Unordered_map<uint32_t, unsigned int> uniq_map;
   std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < this->section_info_.size(); i++)
     {
-      if ((*is_secn_or_group_unique)[i])
+      Section_info* info = &this->section_info_[i];
+      if (info->is_unique)
         continue;
 
-      uint32_t cksum;
-      Section_id secn = id_section[i];
-      section_size_type plen;
-      if (section_contents == NULL)
-        {
-          const unsigned char* contents;
-          contents = secn.first->section_contents(secn.second,
-                                                  &plen,
-                                                  false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
-        }
-      else
-        {
-          const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
-                         0xffffffff);
-        }
-      uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
+      uniq_map_insert = uniq_map.insert(std::make_pair(info->cksum, i));
       if (uniq_map_insert.second)
-        {
-          (*is_secn_or_group_unique)[i] = true;
-        }
+        info->is_unique = true;
       else
         {
-          (*is_secn_or_group_unique)[i] = false;
-          (*is_secn_or_group_unique)[uniq_map_insert.first->second] = false;
+          info->is_unique = false;
+          this->section_info_[uniq_map_insert.first->second].is_unique = false;
         }
     }
 }
 
-// This returns the buffer containing the section's contents, both
-// text and relocs.  Relocs are differentiated as those pointing to
-// sections that could be folded and those that cannot.  Only relocs
-// pointing to sections that could be folded are recomputed on
-// subsequent invocations of this function.
+// This computes the section's contents, both text and relocs.  Relocs
+// are differentiated as those pointing to sections that could be folded
+// and those that cannot.  Relocs pointing to sections that cannot be
+// folded are put in the contents, which do not change.  Relocs pointing
+// to sections that could be folded are recorded in TRACKED_RELOCS and
+// TRACKED_ADDENDS, and are checksummed separately on each iteration by
+// tracked_reloc_contents.  This is called by the Icf_hash_tasks, for
+// different sections at the same time.
 // Parameters  :
-// FIRST_ITERATION    : true if it is the first invocation.
-// SECN               : Section for which contents are desired.
 // SECTION_NUM        : Unique section number of this section.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
-
-static std::string
-get_section_contents(bool first_iteration,
-                     const Section_id& secn,
-                     unsigned int section_num,
-                     unsigned int* num_tracked_relocs,
-                     Symbol_table* symtab,
-                     const std::vector<unsigned int>& kept_section_id,
-                     std::vector<std::string>* section_contents)
+
+void
+Icf::compute_section_contents(unsigned int section_num)
 {
-  section_size_type plen;
-  const unsigned char* contents = NULL;
+  const Section_id& secn(this->id_section_[section_num]);
+  Section_info* info = &this->section_info_[section_num];
 
-  if (first_iteration)
-    {
-      contents = secn.first->section_contents(secn.second,
-                                              &plen,
-                                              false);
-    }
+  section_size_type plen;
+  const unsigned char* contents = secn.first->section_contents(secn.second,
+                                                              &plen,
+                                                              false);
 
   // The buffer to hold all the contents including relocs.  A checksum
   // is then computed on this buffer.
-  std::string buffer;
-  std::string icf_reloc_buffer;
-
-  if (num_tracked_relocs)
-    *num_tracked_relocs = 0;
-
-  Icf::Section_list& seclist = symtab->icf()->section_reloc_list();
-  Icf::Symbol_list& symlist = symtab->icf()->symbol_reloc_list();
-  Icf::Addend_list& addendlist = symtab->icf()->addend_reloc_list();
+  std::string& buffer(info->contents);
+  buffer.clear();
+  info->num_tracked_relocs = 0;
+  info->tracked_relocs.clear();
+  info->tracked_addends.clear();
 
-  Icf::Section_list::iterator it_seclist = seclist.find(secn);
-  Icf::Symbol_list::iterator it_symlist = symlist.find(secn);
-  Icf::Addend_list::iterator it_addendlist = addendlist.find(secn);
+  const Section_list& seclist = this->section_reloc_list_;
+  const Symbol_list& symlist = this->symbol_reloc_list_;
+  const Addend_list& addendlist = this->addend_reloc_list_;
 
-  buffer.clear();
-  icf_reloc_buffer.clear();
+  Section_list::const_iterator it_seclist = seclist.find(secn);
+  Symbol_list::const_iterator it_symlist = symlist.find(secn);
+  Addend_list::const_iterator it_addendlist = addendlist.find(secn);
 
   // Process relocs and put them into the buffer.
 
@@ -234,12 +214,12 @@ get_section_contents(bool first_iteration,
     {
       gold_assert(it_symlist != symlist.end());
       gold_assert(it_addendlist != addendlist.end());
-      Icf::Sections_reachable_list v = it_seclist->second;
-      Icf::Symbol_info s = it_symlist->second;
-      Icf::Addend_info a = it_addendlist->second;
-      Icf::Sections_reachable_list::iterator it_v = v.begin();
-      Icf::Symbol_info::iterator it_s = s.begin();
-      Icf::Addend_info::iterator it_a = a.begin();
+      const Sections_reachable_list& v(it_seclist->second);
+      const Symbol_info& s(it_symlist->second);
+      const Addend_info& a(it_addendlist->second);
+      Sections_reachable_list::const_iterator it_v = v.begin();
+      Symbol_info::const_iterator it_s = s.begin();
+      Addend_info::const_iterator it_a = a.begin();
 
       for (; it_v != v.end(); ++it_v, ++it_s, ++it_a)
         {
@@ -257,58 +237,62 @@ get_section_contents(bool first_iteration,
           if (reloc_secn.first == secn.first
               && reloc_secn.second == secn.second)
             {
-              if (first_iteration)
-                {
-                  buffer.append("R");
-                  buffer.append(addend_str);
-                  buffer.append("@");
-                }
+              buffer.append("R");
+              buffer.append(addend_str);
+              buffer.append("@");
               continue;
             }
-          Icf::Uniq_secn_id_map& section_id_map =
-            symtab->icf()->section_to_int_map();
-          Icf::Uniq_secn_id_map::iterator section_id_map_it =
-            section_id_map.find(reloc_secn);
-          if (section_id_map_it != section_id_map.end())
+          Uniq_secn_id_map::const_iterator section_id_map_it =
+            this->section_id_.find(reloc_secn);
+          if (section_id_map_it != this->section_id_.end())
             {
               // This is a reloc to a section that might be folded.
-              if (num_tracked_relocs)
-                (*num_tracked_relocs)++;
-
-              char kept_section_str[10];
-              unsigned int secn_id = section_id_map_it->second;
-              snprintf(kept_section_str, sizeof(kept_section_str), "%u",
-                       kept_section_id[secn_id]);
-              if (first_iteration)
-                {
-                  buffer.append("ICF_R");
-                  buffer.append(addend_str);
-                }
-              icf_reloc_buffer.append(kept_section_str);
-              // Append the addend.
-              icf_reloc_buffer.append(addend_str);
-              icf_reloc_buffer.append("@");
+              info->num_tracked_relocs++;
+              buffer.append("ICF_R");
+              buffer.append(addend_str);
+              info->tracked_relocs.push_back(section_id_map_it->second);
+              info->tracked_addends.append(addend_str);
+              info->tracked_addends.append("@");
             }
           else
             {
               // This is a reloc to a section that cannot be folded.
-              // Process it only in the first iteration.
-              if (!first_iteration)
-                continue;
-
-              uint64_t secn_flags = (it_v->first)->section_flags(it_v->second);
+              // A section of another object was read by the task for
+              // that object.
+              const Referenced_section* ref = NULL;
+              uint64_t secn_flags;
+              if (reloc_secn.first == secn.first)
+                secn_flags = secn.first->section_flags(reloc_secn.second);
+              else
+                {
+                  Referenced_section_map::const_iterator p =
+                    this->referenced_sections_.find(reloc_secn);
+                  gold_assert(p != this->referenced_sections_.end());
+                  ref = &p->second;
+                  secn_flags = ref->flags;
+                }
               // This reloc points to a merge section.  Hash the
               // contents of this section.
               if ((secn_flags & elfcpp::SHF_MERGE) != 0)
                 {
-                  uint64_t entsize =
-                    (it_v->first)->section_entsize(it_v->second);
+                  uint64_t entsize;
+                  const unsigned char* secn_contents;
+                  if (ref == NULL)
+                    {
+                      entsize =
+                        reloc_secn.first->section_entsize(reloc_secn.second);
+                      section_size_type secn_len;
+                      secn_contents =
+                        reloc_secn.first->section_contents(reloc_secn.second,
+                                                           &secn_len, false);
+                    }
+                  else
+                    {
+                      entsize = ref->entsize;
+                      secn_contents = ref->contents;
+                    }
                   long long offset = it_a->first + it_a->second;
-                  section_size_type secn_len;
-                  const unsigned char* str_contents =
-                  (it_v->first)->section_contents(it_v->second,
-                                                  &secn_len,
-                                                  false) + offset;
+                  const unsigned char* str_contents = secn_contents + offset;
                   if ((secn_flags & elfcpp::SHF_STRINGS) != 0)
                     {
                       // String merge section.
@@ -380,23 +364,86 @@ get_section_contents(bool first_iteration,
         }
     }
 
-  if (first_iteration)
+  buffer.append("Contents = ");
+  buffer.append(reinterpret_cast<const char*>(contents), plen);
+
+  info->cksum = xcrc32(reinterpret_cast<const unsigned char*>(buffer.data()),
+                       buffer.length(), 0xffffffff);
+}
+
+// This returns the relocs of section SECTION_NUM to sections that could
+// be folded, using the current kept section of each.
+
+std::string
+Icf::tracked_reloc_contents(unsigned int section_num) const
+{
+  const Section_info& info(this->section_info_[section_num]);
+  std::string icf_reloc_buffer;
+  std::string::size_type pos = 0;
+  for (std::vector<unsigned int>::const_iterator p =
+         info.tracked_relocs.begin();
+       p != info.tracked_relocs.end();
+       ++p)
     {
-      buffer.append("Contents = ");
-      buffer.append(reinterpret_cast<const char*>(contents), plen);
-      // Store the section contents that dont change to avoid recomputing
-      // during the next call to this function.
-      (*section_contents)[section_num] = buffer;
+      char kept_section_str[10];
+      snprintf(kept_section_str, sizeof(kept_section_str), "%u",
+               this->kept_section_id_[*p]);
+      icf_reloc_buffer.append(kept_section_str);
+      // Append the addend, and the '@' which follows it.
+      std::string::size_type end = info.tracked_addends.find('@', pos);
+      gold_assert(end != std::string::npos);
+      icf_reloc_buffer.append(info.tracked_addends, pos, end + 1 - pos);
+      pos = end + 1;
     }
-  else
+  return icf_reloc_buffer;
+}
+
+// Hash the sections of the object numbered OBJECT_INDEX.  For
+// HASH_SECTION_CONTENTS, this computes a checksum of the contents of
+// each section, and reads the sections of the object referred to from
+// other objects.  For HASH_SECTION_RELOCS, this computes the contents
+// of each section which is not known to be unique.
+
+void
+Icf::hash_sections(Hash_pass pass, unsigned int object_index)
+{
+  Object_sections* os = &this->object_sections_[object_index];
+
+  if (pass == HASH_SECTION_CONTENTS)
     {
-      gold_assert(buffer.empty());
-      // Reuse the contents computed in the previous iteration.
-      buffer.append((*section_contents)[section_num]);
+      for (std::vector<Referenced_section*>::iterator p =
+             os->referenced.begin();
+           p != os->referenced.end();
+           ++p)
+        {
+          Referenced_section* ref = *p;
+          ref->flags = os->object->section_flags(ref->shndx);
+          if ((ref->flags & elfcpp::SHF_MERGE) == 0)
+            continue;
+          ref->entsize = os->object->section_entsize(ref->shndx);
+          section_size_type plen;
+          ref->contents = os->object->section_contents(ref->shndx, &plen,
+                                                       true);
+        }
     }
 
-  buffer.append(icf_reloc_buffer);
-  return buffer;
+  for (unsigned int i = os->begin; i < os->end; ++i)
+    {
+      Section_info* info = &this->section_info_[i];
+      if (info->is_unique)
+        continue;
+
+      if (pass == HASH_SECTION_CONTENTS)
+        {
+          const Section_id& secn(this->id_section_[i]);
+          section_size_type plen;
+          const unsigned char* contents =
+            secn.first->section_contents(secn.second, &plen, false);
+          info->cksum = xcrc32(contents, plen, 0xffffffff);
+        }
+      else
+        this->compute_section_contents(i);
+    }
 }
 
 // This function computes a checksum on each section to detect and form
@@ -412,137 +459,91 @@ get_section_contents(bool first_iteration,
 // identical sections.  A section is added to a group only after its
 // contents are explicitly compared with the kept section of the group.
 //
+// The checksum of a section is the checksum of its contents, which was
+// computed by the Icf_hash_tasks, continued over its relocs to sections
+// that could be folded.
+//
 // Parameters  :
 // ITERATION_NUM           : Invocation instance of this function.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
-//                      to ICF sections.
-// KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
-// ID_SECTION         : Vector mapping a section to an unique integer.
-// IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
-//                            sectionsis already known to be unique.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
-
-static bool
-match_sections(unsigned int iteration_num,
-               Symbol_table* symtab,
-               std::vector<unsigned int>* num_tracked_relocs,
-               std::vector<unsigned int>* kept_section_id,
-               const std::vector<Section_id>& id_section,
-               std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
+
+bool
+Icf::match_sections(unsigned int iteration_num)
 {
   Unordered_multimap<uint32_t, unsigned int> section_cksum;
   std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
             Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
   bool converged = true;
 
-  if (iteration_num == 1)
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   NULL);
-  else
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   section_contents);
+  // The unique sections before the first iteration were found before
+  // the contents were computed.
+  if (iteration_num > 1)
+    this->preprocess_for_unique_sections();
 
-  std::vector<std::string> full_section_contents;
+  // The relocs to sections that could be folded of the kept section
+  // of each group.
+  std::vector<std::string> kept_reloc_contents(this->section_info_.size());
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < this->section_info_.size(); i++)
     {
-      full_section_contents.push_back("");
-      if ((*is_secn_or_group_unique)[i])
+      Section_info* info = &this->section_info_[i];
+      if (info->is_unique)
         continue;
 
-      Section_id secn = id_section[i];
-      std::string this_secn_contents;
-      uint32_t cksum;
-      if (iteration_num == 1)
+      if (iteration_num > 1 && this->kept_section_id_[i] != i)
         {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, secn, i, &num_relocs,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
-      else
-        {
-          if ((*kept_section_id)[i] != i)
-            {
-              // This section is already folded into something.  See
-              // if it should point to a different kept section.
-              unsigned int kept_section = (*kept_section_id)[i];
-              if (kept_section != (*kept_section_id)[kept_section])
-                {
-                  (*kept_section_id)[i] = (*kept_section_id)[kept_section];
-                }
-              continue;
-            }
-          this_secn_contents = get_section_contents(false, secn, i, NULL,
-                                                    symtab, (*kept_section_id),
-                                                    section_contents);
+          // This section is already folded into something.  See
+          // if it should point to a different kept section.
+          unsigned int kept_section = this->kept_section_id_[i];
+          if (kept_section != this->kept_section_id_[kept_section])
+            this->kept_section_id_[i] = this->kept_section_id_[kept_section];
+          continue;
         }
 
-      const unsigned char* this_secn_contents_array =
-            reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
-      cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
-      size_t count = section_cksum.count(cksum);
+      std::string this_reloc_contents = this->tracked_reloc_contents(i);
+      uint32_t cksum =
+        xcrc32(reinterpret_cast<const unsigned char*>(this_reloc_contents.data()),
+               this_reloc_contents.length(), info->cksum);
 
-      if (count == 0)
+      key_range = section_cksum.equal_range(cksum);
+      Unordered_multimap<uint32_t, unsigned int>::iterator it;
+      // Search all the groups with this cksum for a match.
+      for (it = key_range.first; it != key_range.second; ++it)
         {
-          // Start a group with this cksum.
-          section_cksum.insert(std::make_pair(cksum, i));
-          full_section_contents[i] = this_secn_contents;
+          unsigned int kept_section = it->second;
+          if (this->section_info_[kept_section].contents != info->contents
+              || kept_reloc_contents[kept_section] != this_reloc_contents)
+            continue;
+          this->kept_section_id_[i] = kept_section;
+          converged = false;
+          break;
         }
-      else
+      if (it == key_range.second)
         {
-          key_range = section_cksum.equal_range(cksum);
-          Unordered_multimap<uint32_t, unsigned int>::iterator it;
-          // Search all the groups with this cksum for a match.
-          for (it = key_range.first; it != key_range.second; ++it)
-            {
-              unsigned int kept_section = it->second;
-              if (full_section_contents[kept_section].length()
-                  != this_secn_contents.length())
-                  continue;
-              if (memcmp(full_section_contents[kept_section].c_str(),
-                         this_secn_contents.c_str(),
-                         this_secn_contents.length()) != 0)
-                  continue;
-              (*kept_section_id)[i] = kept_section;
-              converged = false;
-              break;
-            }
-          if (it == key_range.second)
-            {
-              // Create a new group for this cksum.
-              section_cksum.insert(std::make_pair(cksum, i));
-              full_section_contents[i] = this_secn_contents;
-            }
+          // Create a new group for this cksum.
+          section_cksum.insert(std::make_pair(cksum, i));
+          kept_reloc_contents[i].swap(this_reloc_contents);
         }
+
       // If there are no relocs to foldable sections do not process
       // this section any further.
-      if (iteration_num == 1 && (*num_tracked_relocs)[i] == 0)
-        (*is_secn_or_group_unique)[i] = true;
+      if (iteration_num == 1 && info->num_tracked_relocs == 0)
+        info->is_unique = true;
     }
 
   return converged;
 }
 
-
 // This is the main ICF function called in gold.cc.  This does the
-// initialization and calls match_sections repeatedly (twice by default)
-// which computes the crc checksums and detects identical functions.
+// initialization and queues the Icf_hash_tasks which hash the sections
+// of each object.
 
 void
-Icf::find_identical_sections(const Input_objects* input_objects,
-                             Symbol_table* symtab)
+Icf::queue_find_identical_sections(Workqueue* workqueue,
+                                   const Input_objects* input_objects,
+                                   Symbol_table* symtab,
+                                   Task_token* icf_blocker)
 {
   unsigned int section_num = 0;
-  std::vector<unsigned int> num_tracked_relocs;
-  std::vector<bool> is_secn_or_group_unique;
-  std::vector<std::string> section_contents;
 
   // Decide which sections are possible candidates first.
 
@@ -550,6 +551,7 @@ Icf::find_identical_sections(const Input_objects* input_objects,
        p != input_objects->relobj_end();
        ++p)
     {
+      unsigned int first_section_num = section_num;
       for (unsigned int i = 0;i < (*p)->shnum(); ++i)
         {
           // Only looking to fold functions, so just look at .text sections.
@@ -563,13 +565,107 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           this->id_section_.push_back(Section_id(*p, i));
           this->section_id_[Section_id(*p, i)] = section_num;
           this->kept_section_id_.push_back(section_num);
-          num_tracked_relocs.push_back(0);
-          is_secn_or_group_unique.push_back(false);
-          section_contents.push_back("");
           section_num++;
         }
+      if (section_num > first_section_num)
+        this->object_sections_.push_back(Object_sections(*p,
+                                                         first_section_num,
+                                                         section_num));
+    }
+
+  this->section_info_.resize(section_num);
+
+  // Find the sections of other objects referred to by the relocs of
+  // the candidates.  An object with no candidates still needs a task
+  // to read them.
+  Unordered_map<Object*, unsigned int> object_index;
+  for (unsigned int i = 0; i < this->object_sections_.size(); ++i)
+    object_index[this->object_sections_[i].object] = i;
+  for (unsigned int i = 0; i < this->id_section_.size(); ++i)
+    {
+      const Section_id& secn(this->id_section_[i]);
+      Section_list::const_iterator p = this->section_reloc_list_.find(secn);
+      if (p == this->section_reloc_list_.end())
+        continue;
+      for (Sections_reachable_list::const_iterator q = p->second.begin();
+           q != p->second.end();
+           ++q)
+        {
+          if (q->first == secn.first
+              || this->section_id_.find(*q) != this->section_id_.end())
+            continue;
+          std::pair<Referenced_section_map::iterator, bool> ins =
+            this->referenced_sections_.insert(std::make_pair(*q,
+                                                  Referenced_section()));
+          if (!ins.second)
+            continue;
+          ins.first->second.shndx = q->second;
+          std::pair<Unordered_map<Object*, unsigned int>::iterator, bool> oi =
+            object_index.insert(std::make_pair(q->first,
+                                               this->object_sections_.size()));
+          if (oi.second)
+            this->object_sections_.push_back(Object_sections(q->first, 0, 0));
+          this->object_sections_[oi.first->second].referenced.push_back(
+            &ins.first->second);
+        }
     }
 
+  // Checksum the contents of the sections of each object.
+  Task_token* hash_blocker = new Task_token(true);
+  this->queue_hash_tasks(workqueue, HASH_SECTION_CONTENTS, hash_blocker);
+
+  workqueue->queue(new Task_function(new Icf_runner(this, icf_blocker),
+                                     hash_blocker,
+                                     "Task_function Icf_runner"));
+}
+
+// Mark the sections whose contents are unique, and queue the
+// Icf_hash_tasks which compute the contents of the rest.  Then queue
+// the Icf_match_task.
+
+void
+Icf::queue_hash_relocs_tasks(Workqueue* workqueue, Task_token* icf_blocker)
+{
+  this->preprocess_for_unique_sections();
+
+  Task_token* hash_blocker = new Task_token(true);
+  this->queue_hash_tasks(workqueue, HASH_SECTION_RELOCS, hash_blocker);
+
+  workqueue->queue_soon(new Icf_match_task(this, hash_blocker, icf_blocker));
+}
+
+// Queue an Icf_hash_task for PASS for each object which has anything
+// to hash.  BLOCKER is unblocked when they are done.
+
+void
+Icf::queue_hash_tasks(Workqueue* workqueue, Hash_pass pass,
+                      Task_token* blocker)
+{
+  std::vector<unsigned int> objects;
+  for (unsigned int i = 0; i < this->object_sections_.size(); ++i)
+    {
+      const Object_sections& os(this->object_sections_[i]);
+      if (os.begin < os.end
+          || (pass == HASH_SECTION_CONTENTS && !os.referenced.empty()))
+        objects.push_back(i);
+    }
+
+  for (size_t i = 0; i < objects.size(); ++i)
+    blocker->add_blocker();
+  for (std::vector<unsigned int>::const_iterator p = objects.begin();
+       p != objects.end();
+       ++p)
+    workqueue->queue_soon(new Icf_hash_task(this, pass,
+                                            this->object_sections_[*p].object,
+                                            *p, blocker));
+}
+
+// Form the groups of identical sections, calling match_sections
+// repeatedly (twice by default).
+
+void
+Icf::match_identical_sections()
+{
   unsigned int num_iterations = 0;
 
   // Default number of iterations to run ICF is 2.
@@ -582,10 +678,7 @@ Icf::find_identical_sections(const Input_objects* input_objects,
   while (!converged && (num_iterations < max_iterations))
     {
       num_iterations++;
-      converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
-                                 this->id_section_, &is_secn_or_group_unique,
-                                 &section_contents);
+      converged = this->match_sections(num_iterations);
     }
 
   if (parameters->options().print_icf_sections())
@@ -598,6 +691,11 @@ Icf::find_identical_sections(const Input_objects* input_objects,
                   program_name, num_iterations);
     }
 
+  // The section contents are no longer needed.
+  std::vector<Section_info>().swap(this->section_info_);
+  std::vector<Object_sections>().swap(this->object_sections_);
+  this->referenced_sections_.clear();
+
   this->icf_ready();
 }
 
@@ -631,4 +729,80 @@ Icf::get_folded_section(Object* dup_obj, unsigned int dup_shndx)
   return folded_section;
 }
 
+// Class Icf_hash_task.
+
+// We may not run this task while the object is locked.
+
+Task_token*
+Icf_hash_task::is_runnable()
+{
+  if (this->object_->is_locked())
+    return this->object_->token();
+  return NULL;
+}
+
+// Return the locks we hold: one on the file and one blocker.
+
+void
+Icf_hash_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->object_->token());
+  tl->add(this, this->blocker_);
+}
+
+// Hash the sections.
+
+void
+Icf_hash_task::run(Workqueue*)
+{
+  this->icf_->hash_sections(this->pass_, this->object_index_);
+  this->object_->release();
+}
+
+// Return a debugging name for the task.
+
+std::string
+Icf_hash_task::get_name() const
+{
+  return "Icf_hash_task " + this->object_->name();
+}
+
+// Class Icf_runner.
+
+// Queue the tasks to compute the section contents.
+
+void
+Icf_runner::run(Workqueue* workqueue, const Task*)
+{
+  this->icf_->queue_hash_relocs_tasks(workqueue, this->icf_blocker_);
+}
+
+// Class Icf_match_task.
+
+// Wait until the sections have been hashed.
+
+Task_token*
+Icf_match_task::is_runnable()
+{
+  if (this->hash_blocker_->is_blocked())
+    return this->hash_blocker_;
+  return NULL;
+}
+
+// We need to unlock ICF_BLOCKER when finished.
+
+void
+Icf_match_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->icf_blocker_);
+}
+
+// Form the groups of identical sections.
+
+void
+Icf_match_task::run(Workqueue*)
+{
+  this->icf_->match_identical_sections();
+}
+
 } // End of namespace gold.
@@ -27,6 +27,7 @@
 
 #include "elfcpp.h"
 #include "symtab.h"
+#include "workqueue.h"
 
 namespace gold
 {
@@ -58,11 +59,21 @@ class Icf
                         unsigned int,
                         Section_id_hash> Uniq_secn_id_map;
 
+  // The passes made over the sections by Icf_hash_task.
+  enum Hash_pass
+  {
+    // Compute a checksum of the section contents.
+    HASH_SECTION_CONTENTS,
+    // Compute the section contents including the relocs.
+    HASH_SECTION_RELOCS
+  };
+
   Icf()
   : id_section_(), section_id_(), kept_section_id_(),
     num_tracked_relocs(NULL), icf_ready_(false),
     section_reloc_list_(), symbol_reloc_list_(),
-    addend_reloc_list_()
+    addend_reloc_list_(), section_info_(), object_sections_(),
+    referenced_sections_()
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -71,10 +82,31 @@ class Icf
   get_folded_section(Object* dup_obj, unsigned int dup_shndx);
 
   // Forms groups of identical sections where the first member
-  // of each group is the kept section during folding.
+  // of each group is the kept section during folding.  This queues
+  // tasks which hash the sections of each object in parallel.
+  // ICF_BLOCKER is unblocked when the groups have been formed.
+  void
+  queue_find_identical_sections(Workqueue*,
+                                const Input_objects* input_objects,
+                                Symbol_table* symtab,
+                                Task_token* icf_blocker);
+
+  // Hash the sections of the object numbered OBJECT_INDEX.  This is
+  // called by Icf_hash_task, for different objects at the same time.
+  // The task must hold the lock on the object.
+  void
+  hash_sections(Hash_pass, unsigned int object_index);
+
+  // Queue the tasks which compute the section contents, after
+  // the checksums of the contents are known.  This is called by
+  // Icf_runner.
+  void
+  queue_hash_relocs_tasks(Workqueue*, Task_token* icf_blocker);
+
+  // Form the groups of identical sections once all the sections
+  // have been hashed.  This is called by Icf_match_task.
   void
-  find_identical_sections(const Input_objects* input_objects,
-                          Symbol_table* symtab);
+  match_identical_sections();
 
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
@@ -116,6 +148,97 @@ class Icf
   { return this->section_id_; }
 
  private:
+  // Information kept about each section while forming the groups of
+  // identical sections.
+  struct Section_info
+  {
+    Section_info()
+      : cksum(0), num_tracked_relocs(0), is_unique(false), contents(),
+        tracked_relocs(), tracked_addends()
+    { }
+
+    // A checksum of the section contents.  After the
+    // HASH_SECTION_RELOCS pass, a checksum of CONTENTS.
+    uint32_t cksum;
+    // The number of relocs to sections that could be folded.
+    unsigned int num_tracked_relocs;
+    // Whether this section or its group is known to be unique.
+    bool is_unique;
+    // The section's text and relocs to sections that cannot be
+    // folded.
+    std::string contents;
+    // The unique section numbers of the sections that could be
+    // folded referenced by relocs, other than the section itself.
+    std::vector<unsigned int> tracked_relocs;
+    // The symbol value and addend of each of those relocs, each
+    // followed by '@'.
+    std::string tracked_addends;
+  };
+
+  // A section referred to by a reloc of a candidate for folding in
+  // another object.  Only the task for the object which owns the
+  // section may read it, so what compute_section_contents needs to
+  // know about it is read by the HASH_SECTION_CONTENTS pass.
+  struct Referenced_section
+  {
+    Referenced_section()
+      : shndx(0), flags(0), entsize(0), contents(NULL)
+    { }
+
+    // The section index.
+    unsigned int shndx;
+    // The section flags.
+    uint64_t flags;
+    // The section entsize.
+    uint64_t entsize;
+    // The section contents, if it is a merge section.  These are read
+    // into a cached view, which stays valid after the object is
+    // released.
+    const unsigned char* contents;
+  };
+
+  typedef Unordered_map<Section_id, Referenced_section,
+                        Section_id_hash> Referenced_section_map;
+
+  // The sections of an object which are candidates for folding, and
+  // the sections of the object referred to from other objects.
+  struct Object_sections
+  {
+    Object_sections(Object* o, unsigned int b, unsigned int e)
+      : object(o), begin(b), end(e), referenced()
+    { }
+
+    // The object.
+    Object* object;
+    // The first unique section number.
+    unsigned int begin;
+    // One past the last unique section number.
+    unsigned int end;
+    // The entries in REFERENCED_SECTIONS_ for this object.
+    std::vector<Referenced_section*> referenced;
+  };
+
+  // Queue an Icf_hash_task for each object for PASS.
+  void
+  queue_hash_tasks(Workqueue*, Hash_pass pass, Task_token* blocker);
+
+  // Compute the contents of section SECTION_NUM.
+  void
+  compute_section_contents(unsigned int section_num);
+
+  // Return the relocs of section SECTION_NUM to sections that could
+  // be folded, given the current groups.
+  std::string
+  tracked_reloc_contents(unsigned int section_num) const;
+
+  // Mark the sections which are known to have unique contents.
+  void
+  preprocess_for_unique_sections();
+
+  // Compute checksums to form groups of identical sections.  Returns
+  // true if no section was newly folded.
+  bool
+  match_sections(unsigned int iteration_num);
 
   // Maps integers to sections.
   std::vector<Section_id> id_section_;
@@ -133,6 +256,105 @@ class Icf
   Section_list section_reloc_list_;
   Symbol_list symbol_reloc_list_;
   Addend_list addend_reloc_list_;
+
+  // Information about each section, used while forming the groups.
+  std::vector<Section_info> section_info_;
+  // The ranges of unique section numbers for each object.
+  std::vector<Object_sections> object_sections_;
+  // The sections referred to by candidates in other objects.
+  Referenced_section_map referenced_sections_;
+};
+
+// This task hashes the sections of one object for ICF.  It holds the
+// lock on the object, and reads no other object.
+
+class Icf_hash_task : public Task
+{
+ public:
+  // OBJECT_INDEX is the index of OBJECT in the objects being hashed.
+  // BLOCKER is unblocked when all the hashing tasks are done.
+  Icf_hash_task(Icf* icf, Icf::Hash_pass pass, Object* object,
+                unsigned int object_index, Task_token* blocker)
+    : icf_(icf), pass_(pass), object_(object), object_index_(object_index),
+      blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Icf* icf_;
+  Icf::Hash_pass pass_;
+  Object* object_;
+  unsigned int object_index_;
+  Task_token* blocker_;
+};
+
+// This task function runs after the checksums of the section contents
+// have been computed, and queues the tasks to hash the relocs.
+
+class Icf_runner : public Task_function_runner
+{
+ public:
+  Icf_runner(Icf* icf, Task_token* icf_blocker)
+    : icf_(icf), icf_blocker_(icf_blocker)
+  { }
+
+  // Run the operation.
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  Icf* icf_;
+  Task_token* icf_blocker_;
+};
+
+// This task forms the groups of identical sections once all the
+// sections have been hashed.
+
+class Icf_match_task : public Task
+{
+ public:
+  // HASH_BLOCKER is unblocked when the sections have been hashed.
+  // ICF_BLOCKER is unblocked when this task is done.
+  Icf_match_task(Icf* icf, Task_token* hash_blocker,
+                 Task_token* icf_blocker)
+    : icf_(icf), hash_blocker_(hash_blocker), icf_blocker_(icf_blocker)
+  { }
+
+  ~Icf_match_task()
+  { delete this->hash_blocker_; }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Icf_match_task"; }
+
+ private:
+  Icf* icf_;
+  Task_token* hash_blocker_;
+  Task_token* icf_blocker_;
 };
 
 } // End of namespace gold.
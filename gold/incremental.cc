@@ -21,6 +21,14 @@
 // MA 02110-1301, USA.
 
 #include "gold.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "filenames.h"
+
 #include "elfcpp.h"
 #include "output.h"
 #include "incremental.h"
@@ -32,7 +40,7 @@ namespace gold {
 
 // Version information. Will change frequently during the development, later
 // we could think about backward (and forward?) compatibility.
-const int INCREMENTAL_LINK_VERSION = 1;
+const int INCREMENTAL_LINK_VERSION = 3;
 
 namespace internal {
 
@@ -73,6 +81,9 @@ struct Incremental_inputs_entry_data
 
   // Padding.
   elfcpp::Elf_Half reserved;
+
+  // Size of the file.
+  elfcpp::Elf_Xword file_size;
 };
 
 }
@@ -138,17 +149,97 @@ class Incremental_inputs_entry_write
   { this->p_->timestamp_nsec = Convert<32, big_endian>::convert_host(v); }
 
   void
-  put_input_type(elfcpp::Elf_Word v)
-  { this->p_->input_type = Convert<32, big_endian>::convert_host(v); }
+  put_input_type(elfcpp::Elf_Half v)
+  { this->p_->input_type = Convert<16, big_endian>::convert_host(v); }
 
   void
-  put_reserved(elfcpp::Elf_Word v)
-  { this->p_->reserved = Convert<32, big_endian>::convert_host(v); }
+  put_reserved(elfcpp::Elf_Half v)
+  { this->p_->reserved = Convert<16, big_endian>::convert_host(v); }
+
+  void
+  put_file_size(elfcpp::Elf_Xword v)
+  { this->p_->file_size = Convert<64, big_endian>::convert_host(v); }
 
  private:
   internal::Incremental_inputs_entry_data* p_;
 };
 
+// Read the header of a .gnu_incremental_inputs section.
+template<int size, bool big_endian>
+class Incremental_inputs_header_read
+{
+ public:
+  Incremental_inputs_header_read(const unsigned char *p)
+    : p_(reinterpret_cast<const internal::Incremental_inputs_header_data*>(p))
+  { }
+
+  static const int data_size = sizeof(internal::Incremental_inputs_header_data);
+
+  elfcpp::Elf_Word
+  get_version() const
+  { return Convert<32, big_endian>::convert_host(this->p_->version); }
+
+  elfcpp::Elf_Word
+  get_input_file_count() const
+  { return Convert<32, big_endian>::convert_host(this->p_->input_file_count); }
+
+  elfcpp::Elf_Word
+  get_command_line_offset() const
+  {
+    return Convert<32, big_endian>::convert_host(this->p_->command_line_offset);
+  }
+
+ private:
+  const internal::Incremental_inputs_header_data* p_;
+};
+
+// Read an input entry of a .gnu_incremental_inputs section.
+template<int size, bool big_endian>
+class Incremental_inputs_entry_read
+{
+ public:
+  Incremental_inputs_entry_read(const unsigned char *p)
+    : p_(reinterpret_cast<const internal::Incremental_inputs_entry_data*>(p))
+  { }
+
+  static const int data_size = sizeof(internal::Incremental_inputs_entry_data);
+
+  elfcpp::Elf_Word
+  get_filename_offset() const
+  { return Convert<32, big_endian>::convert_host(this->p_->filename_offset); }
+
+  elfcpp::Elf_Xword
+  get_timestamp_sec() const
+  { return Convert<64, big_endian>::convert_host(this->p_->timestamp_sec); }
+
+  elfcpp::Elf_Word
+  get_timestamp_nsec() const
+  { return Convert<32, big_endian>::convert_host(this->p_->timestamp_nsec); }
+
+  elfcpp::Elf_Half
+  get_input_type() const
+  { return Convert<16, big_endian>::convert_host(this->p_->input_type); }
+
+  elfcpp::Elf_Xword
+  get_file_size() const
+  { return Convert<64, big_endian>::convert_host(this->p_->file_size); }
+
+ private:
+  const internal::Incremental_inputs_entry_data* p_;
+};
+
+// Return the modification time in the result of stat.
+
+static Timespec
+stat_mtime(const struct stat& st)
+{
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+  return Timespec(st.st_mtime, st.st_mtim.tv_nsec);
+#else
+  return Timespec(st.st_mtime, 0);
+#endif
+}
+
 // Add the command line to the string table, setting
 // command_line_key_.  In incremental builds, the command line is
 // stored in .gnu_incremental_inputs so that the next linker run can
@@ -183,7 +274,9 @@ Incremental_inputs::report_command_line(int argc, const char* const* argv)
         }
       args.append("'");
     }
-  this->strtab_->add(args.c_str(), true, &this->command_line_key_);
+  this->command_line_ = args;
+  this->strtab_->add(this->command_line_.c_str(), true,
+                     &this->command_line_key_);
 }
 
 // Record that the input argument INPUT is an achive ARCHIVE.  This is
@@ -198,7 +291,9 @@ Incremental_inputs::report_archive(const Input_argument* input,
   Input_info info;
   info.type = INCREMENTAL_INPUT_ARCHIVE;
   info.archive = archive;
+  info.filename = archive->filename();
   info.mtime = archive->file().get_mtime();
+  info.size = archive->file().filesize();
   this->inputs_map_.insert(std::make_pair(input, info));
 }
 
@@ -216,7 +311,9 @@ Incremental_inputs::report_object(const Input_argument* input,
 	       ? INCREMENTAL_INPUT_SHARED_LIBRARY
 	       : INCREMENTAL_INPUT_OBJECT);
   info.object = obj;
+  info.filename = obj->input_file()->filename();
   info.mtime = obj->input_file()->file().get_mtime();
+  info.size = obj->input_file()->file().filesize();
   this->inputs_map_.insert(std::make_pair(input, info));
 }
 
@@ -226,7 +323,7 @@ Incremental_inputs::report_object(const Input_argument* input,
 
 void
 Incremental_inputs::report_script(const Input_argument* input,
-                                  Timespec mtime,
+                                  Input_file* input_file,
                                   Script_info* script)
 {
   Hold_lock hl(*this->lock_);
@@ -234,10 +331,67 @@ Incremental_inputs::report_script(const Input_argument* input,
   Input_info info;
   info.type = INCREMENTAL_INPUT_SCRIPT;
   info.script = script;
-  info.mtime = mtime;
+  info.filename = input_file->filename();
+  info.mtime = input_file->file().get_mtime();
+  info.size = input_file->file().filesize();
   this->inputs_map_.insert(std::make_pair(input, info));
 }
 
+// Record that the file NAME was read because an option named it,
+// like a --version-script file.  MTIME and SIZE should be taken
+// before the file is read.
+
+void
+Incremental_inputs::report_option_file(const std::string& name,
+                                       const Timespec& mtime, off_t size)
+{
+  this->report_other_file(INCREMENTAL_INPUT_OPTION_FILE, name, mtime, size);
+}
+
+// Record that the file NAME was read because an option named it,
+// getting its modification time and size with stat.
+
+void
+Incremental_inputs::report_option_file(const char* name)
+{
+  struct stat file_stat;
+  if (::stat(name, &file_stat) < 0)
+    return;
+  this->report_option_file(name, stat_mtime(file_stat), file_stat.st_size);
+}
+
+// Record the linker executable, so that a different linker does not
+// reuse the output.  We can only find it through /proc; if there is
+// no /proc, nothing is recorded and the output is never reused.
+
+void
+Incremental_inputs::report_linker()
+{
+  static const char linker_name[] = "/proc/self/exe";
+  struct stat linker_stat;
+  if (::stat(linker_name, &linker_stat) < 0)
+    return;
+  this->report_other_file(INCREMENTAL_INPUT_LINKER, linker_name,
+                          stat_mtime(linker_stat), linker_stat.st_size);
+}
+
+// Record the file NAME of type TYPE which is not an input argument.
+
+void
+Incremental_inputs::report_other_file(Incremental_input_type type,
+                                      const std::string& name,
+                                      const Timespec& mtime, off_t size)
+{
+  Hold_lock hl(*this->lock_);
+
+  Input_info info;
+  info.type = type;
+  info.filename = name;
+  info.mtime = mtime;
+  info.size = size;
+  this->other_files_.push_back(info);
+}
+
 // Compute indexes in the order in which the inputs should appear in
 // .gnu_incremental_inputs.  This needs to be done after all the
 // scripts are parsed.  The function is first called for the command
@@ -271,7 +425,7 @@ Incremental_inputs::finalize_inputs(
       Input_info* info = &it->second;
       info->index = *index;
       (*index)++;
-      this->strtab_->add(p->file().name(), false, &info->filename_key);
+      this->strtab_->add(info->filename.c_str(), false, &info->filename_key);
       if (info->type == INCREMENTAL_INPUT_SCRIPT)
         {
           finalize_inputs(info->script->inputs()->begin(),
@@ -290,6 +444,15 @@ Incremental_inputs::finalize()
   unsigned int index = 0;
   finalize_inputs(this->inputs_->begin(), this->inputs_->end(), &index);
 
+  for (Other_files::iterator p = this->other_files_.begin();
+       p != this->other_files_.end();
+       ++p)
+    {
+      p->index = index;
+      ++index;
+      this->strtab_->add(p->filename.c_str(), false, &p->filename_key);
+    }
+
   // Sanity check.
   for (Inputs_info_map::const_iterator p = this->inputs_map_.begin();
        p != this->inputs_map_.end();
@@ -340,7 +503,8 @@ Incremental_inputs::sized_create_inputs_section_data()
   const int header_size =
       Incremental_inputs_header_write<size, big_endian>::data_size;
 
-  unsigned int sz = header_size + entry_size * this->inputs_map_.size();
+  unsigned int count = this->inputs_map_.size() + this->other_files_.size();
+  unsigned int sz = header_size + entry_size * count;
   unsigned char* buffer = new unsigned char[sz];
   unsigned char* inputs_base = buffer + header_size;
 
@@ -349,7 +513,7 @@ Incremental_inputs::sized_create_inputs_section_data()
   int cmd_offset = this->strtab_->get_offset_from_key(this->command_line_key_);
 
   header_writer.put_version(INCREMENTAL_LINK_VERSION);
-  header_writer.put_input_file_count(this->inputs_map_.size());
+  header_writer.put_input_file_count(count);
   header_writer.put_command_line_offset(cmd_offset);
   header_writer.put_reserved(0);
 
@@ -358,25 +522,392 @@ Incremental_inputs::sized_create_inputs_section_data()
        ++it)
     {
       gold_assert(it->second.index < this->inputs_map_.size());
-
-      unsigned char* entry_buffer =
-          inputs_base + it->second.index * entry_size;
-      Incremental_inputs_entry_write<size, big_endian> entry(entry_buffer);
-      int filename_offset =
-          this->strtab_->get_offset_from_key(it->second.filename_key);
-      entry.put_filename_offset(filename_offset);
-      // TODO: add per input data and timestamp.  Currently we store
-      // an out-of-bounds offset for future version of gold to reject
-      // such an incremental_inputs section.
-      entry.put_data_offset(0xffffffff);
-      entry.put_timestamp_sec(it->second.mtime.seconds);
-      entry.put_timestamp_nsec(it->second.mtime.nanoseconds);
-      entry.put_input_type(it->second.type);
-      entry.put_reserved(0);
+      this->write_input_entry<size, big_endian>(inputs_base, it->second);
+    }
+  for (Other_files::const_iterator p = this->other_files_.begin();
+       p != this->other_files_.end();
+       ++p)
+    {
+      gold_assert(p->index >= this->inputs_map_.size() && p->index < count);
+      this->write_input_entry<size, big_endian>(inputs_base, *p);
     }
 
   return new Output_data_const_buffer(buffer, sz, 8,
 				      "** incremental link inputs list");
 }
 
+// Write the entry for the input INFO in the .gnu_incremental_inputs
+// entries starting at INPUTS_BASE.
+
+template<int size, bool big_endian>
+void
+Incremental_inputs::write_input_entry(unsigned char* inputs_base,
+                                      const Input_info& info)
+{
+  const int entry_size =
+      Incremental_inputs_entry_write<size, big_endian>::data_size;
+  Incremental_inputs_entry_write<size, big_endian>
+      entry(inputs_base + info.index * entry_size);
+  entry.put_filename_offset(this->strtab_->get_offset_from_key(
+                              info.filename_key));
+  // TODO: add per input data.  Currently we store an out-of-bounds
+  // offset for future version of gold to reject such an
+  // incremental_inputs section.
+  entry.put_data_offset(0xffffffff);
+  entry.put_timestamp_sec(info.mtime.seconds);
+  entry.put_timestamp_nsec(info.mtime.nanoseconds);
+  entry.put_input_type(info.type);
+  entry.put_reserved(0);
+  entry.put_file_size(info.size);
+}
+
+// Class Incremental_checker.
+
+// Read LEN bytes at OFFSET in DESCRIPTOR into BUF.
+
+static bool
+read_output_data(int descriptor, void* buf, size_t len, off_t offset)
+{
+  unsigned char* p = static_cast<unsigned char*>(buf);
+  while (len > 0)
+    {
+      ssize_t bytes = ::pread(descriptor, p, len, offset);
+      if (bytes <= 0)
+        {
+          if (bytes < 0 && errno == EINTR)
+            continue;
+          return false;
+        }
+      p += bytes;
+      len -= bytes;
+      offset += bytes;
+    }
+  return true;
+}
+
+// Return whether any of the input arguments in [BEGIN, END) was
+// given with --incremental-changed.
+
+static bool
+any_input_changed(Input_argument_list::const_iterator begin,
+                  Input_argument_list::const_iterator end)
+{
+  for (Input_argument_list::const_iterator p = begin; p != end; ++p)
+    {
+      if (p->is_group())
+        {
+          if (any_input_changed(p->group()->begin(), p->group()->end()))
+            return true;
+        }
+      else if (p->file().options().incremental_disposition()
+               == INCREMENTAL_CHANGED)
+        return true;
+    }
+  return false;
+}
+
+// Return whether the output file is up to date.  Any problem reading
+// the output file just means that it is not.
+
+bool
+Incremental_checker::output_is_up_to_date()
+{
+  // A plugin may read files we know nothing about.
+  if (parameters->options().has_plugins())
+    return false;
+
+  const Input_arguments* inputs = this->incremental_inputs_->inputs();
+  if (inputs == NULL || any_input_changed(inputs->begin(), inputs->end()))
+    return false;
+
+  int descriptor = ::open(this->output_name_, O_RDONLY);
+  if (descriptor < 0)
+    return false;
+
+  static const unsigned char elfmagic[4] =
+    {
+      elfcpp::ELFMAG0, elfcpp::ELFMAG1,
+      elfcpp::ELFMAG2, elfcpp::ELFMAG3
+    };
+
+  bool ret = false;
+  unsigned char ehdr[elfcpp::Elf_sizes<64>::ehdr_size];
+  if (read_output_data(descriptor, ehdr, sizeof ehdr, 0)
+      && memcmp(ehdr, elfmagic, 4) == 0)
+    {
+      bool big_endian = ehdr[elfcpp::EI_DATA] == elfcpp::ELFDATA2MSB;
+      if (ehdr[elfcpp::EI_CLASS] == elfcpp::ELFCLASS32)
+        {
+          if (!big_endian)
+            {
+#ifdef HAVE_TARGET_32_LITTLE
+              ret = this->sized_output_is_up_to_date<32, false>(descriptor,
+                                                                ehdr);
+#endif
+            }
+          else
+            {
+#ifdef HAVE_TARGET_32_BIG
+              ret = this->sized_output_is_up_to_date<32, true>(descriptor,
+                                                               ehdr);
+#endif
+            }
+        }
+      else if (ehdr[elfcpp::EI_CLASS] == elfcpp::ELFCLASS64)
+        {
+          if (!big_endian)
+            {
+#ifdef HAVE_TARGET_64_LITTLE
+              ret = this->sized_output_is_up_to_date<64, false>(descriptor,
+                                                                ehdr);
+#endif
+            }
+          else
+            {
+#ifdef HAVE_TARGET_64_BIG
+              ret = this->sized_output_is_up_to_date<64, true>(descriptor,
+                                                               ehdr);
+#endif
+            }
+        }
+    }
+
+  ::close(descriptor);
+  return ret;
+}
+
+// Find the .gnu_incremental_inputs section and its string table in
+// the output file, and check the command line and each input
+// recorded there.
+
+template<int size, bool big_endian>
+bool
+Incremental_checker::sized_output_is_up_to_date(int descriptor,
+                                                const unsigned char* pehdr)
+{
+  const int shdr_size = elfcpp::Elf_sizes<size>::shdr_size;
+  elfcpp::Ehdr<size, big_endian> ehdr(pehdr);
+  if (ehdr.get_e_shentsize() != shdr_size)
+    return false;
+
+  // An input modified at the time the output was written might not
+  // be reflected in it.
+  struct stat output_stat;
+  if (::fstat(descriptor, &output_stat) < 0)
+    return false;
+  this->output_mtime_ = stat_mtime(output_stat);
+
+  unsigned int shnum = ehdr.get_e_shnum();
+  if (shnum == 0)
+    return false;
+  std::vector<unsigned char> shdrs(shnum * shdr_size);
+  if (!read_output_data(descriptor, &shdrs[0], shdrs.size(),
+                        ehdr.get_e_shoff()))
+    return false;
+
+  unsigned int inputs_shndx = 0;
+  for (unsigned int i = 1; i < shnum; ++i)
+    {
+      elfcpp::Shdr<size, big_endian> shdr(&shdrs[i * shdr_size]);
+      if (shdr.get_sh_type() == elfcpp::SHT_GNU_INCREMENTAL_INPUTS)
+        {
+          inputs_shndx = i;
+          break;
+        }
+    }
+  if (inputs_shndx == 0)
+    return false;
+
+  elfcpp::Shdr<size, big_endian> inputs_shdr(&shdrs[inputs_shndx
+                                                    * shdr_size]);
+  unsigned int strtab_shndx = inputs_shdr.get_sh_link();
+  if (strtab_shndx == 0 || strtab_shndx >= shnum)
+    return false;
+  elfcpp::Shdr<size, big_endian> strtab_shdr(&shdrs[strtab_shndx
+                                                    * shdr_size]);
+  if (strtab_shdr.get_sh_type() != elfcpp::SHT_STRTAB)
+    return false;
+
+  const int header_size =
+      Incremental_inputs_header_read<size, big_endian>::data_size;
+  const int entry_size =
+      Incremental_inputs_entry_read<size, big_endian>::data_size;
+
+  // Don't trust the sizes until they have been checked against the
+  // size of the file.
+  typedef typename elfcpp::Elf_types<size>::Elf_WXword Size_type;
+  Size_type file_size = output_stat.st_size;
+  Size_type inputs_size = inputs_shdr.get_sh_size();
+  Size_type strtab_size = strtab_shdr.get_sh_size();
+  if (inputs_size < static_cast<Size_type>(header_size)
+      || inputs_size > file_size
+      || strtab_size == 0
+      || strtab_size > file_size)
+    return false;
+
+  std::vector<unsigned char> inputs(inputs_size);
+  std::vector<char> strtab(strtab_size);
+  if (!read_output_data(descriptor, &inputs[0], inputs.size(),
+                        inputs_shdr.get_sh_offset())
+      || !read_output_data(descriptor, &strtab[0], strtab.size(),
+                           strtab_shdr.get_sh_offset())
+      || strtab.back() != '\0')
+    return false;
+
+  Incremental_inputs_header_read<size, big_endian> header(&inputs[0]);
+  if (header.get_version() != INCREMENTAL_LINK_VERSION)
+    return false;
+  unsigned int count = header.get_input_file_count();
+  if (count > (inputs.size() - header_size) / entry_size)
+    return false;
+
+  unsigned int cmd_offset = header.get_command_line_offset();
+  if (cmd_offset >= strtab.size()
+      || this->incremental_inputs_->command_line() != &strtab[cmd_offset])
+    return false;
+
+  std::vector<const char*> filenames;
+  filenames.reserve(count);
+  bool saw_linker = false;
+  for (unsigned int i = 0; i < count; ++i)
+    {
+      Incremental_inputs_entry_read<size, big_endian>
+          entry(&inputs[header_size + i * entry_size]);
+      unsigned int input_type = entry.get_input_type();
+      // The inputs added by a script are not searched for again
+      // below, so we can not tell whether they would still be found
+      // in the same files.
+      if (input_type == INCREMENTAL_INPUT_SCRIPT)
+        return false;
+      unsigned int filename_offset = entry.get_filename_offset();
+      if (filename_offset >= strtab.size())
+        return false;
+      Timespec mtime(entry.get_timestamp_sec(), entry.get_timestamp_nsec());
+      if (!this->input_is_unchanged(&strtab[filename_offset], mtime,
+                                    entry.get_file_size()))
+        return false;
+      // The files named by options are the same, since the command
+      // line is.  The linker entry names the running linker.
+      if (input_type == INCREMENTAL_INPUT_LINKER)
+        saw_linker = true;
+      else if (input_type != INCREMENTAL_INPUT_OPTION_FILE)
+        filenames.push_back(&strtab[filename_offset]);
+    }
+  if (!saw_linker)
+    return false;
+
+  // The inputs were recorded in the order of the command line.  Each
+  // of them must still be found in the file recorded for it: a -l
+  // option may now find a library in an earlier directory, or a
+  // shared library where it found an archive.
+  const Input_arguments* input_args = this->incremental_inputs_->inputs();
+  unsigned int index = 0;
+  return (this->inputs_are_found(input_args->begin(), input_args->end(),
+                                 filenames, &index)
+          && index == filenames.size());
+}
+
+// Return whether each input argument in [BEGIN, END) is found in the
+// file FILENAMES[*PINDEX], advancing *PINDEX past the files checked.
+
+bool
+Incremental_checker::inputs_are_found(
+    Input_argument_list::const_iterator begin,
+    Input_argument_list::const_iterator end,
+    const std::vector<const char*>& filenames,
+    unsigned int* pindex)
+{
+  for (Input_argument_list::const_iterator p = begin; p != end; ++p)
+    {
+      if (p->is_group())
+        {
+          if (!this->inputs_are_found(p->group()->begin(), p->group()->end(),
+                                      filenames, pindex))
+            return false;
+          continue;
+        }
+
+      std::string name;
+      if (*pindex >= filenames.size()
+          || !this->find_input_file(p->file(), &name)
+          || name != filenames[*pindex])
+        return false;
+      ++*pindex;
+    }
+  return true;
+}
+
+// Set *NAME to the file which would be opened for the input argument
+// INPUT, searching the library path as Input_file::open does.  Return
+// false if it is not found.
+
+bool
+Incremental_checker::find_input_file(const Input_file_argument& input,
+                                     std::string* name)
+{
+  if (IS_ABSOLUTE_PATH(input.name())
+      || (!input.is_lib() && input.extra_search_path() == NULL))
+    {
+      *name = input.name();
+      return true;
+    }
+
+  // Only a script adds inputs with an extra search path.
+  if (!input.is_lib())
+    return false;
+
+  std::string n1("lib");
+  n1 += input.name();
+  std::string n2;
+  if (parameters->options().is_static() || !input.options().Bdynamic())
+    n1 += ".a";
+  else
+    {
+      n2 = n1 + ".a";
+      n1 += ".so";
+    }
+
+  const General_options::Dir_list& dirs =
+    parameters->options().library_path();
+  for (General_options::Dir_list::const_iterator p = dirs.begin();
+       p != dirs.end();
+       ++p)
+    {
+      struct stat dummy_stat;
+      *name = p->name() + '/' + n1;
+      if (::stat(name->c_str(), &dummy_stat) == 0)
+        return true;
+      if (!n2.empty())
+        {
+          *name = p->name() + '/' + n2;
+          if (::stat(name->c_str(), &dummy_stat) == 0)
+            return true;
+        }
+    }
+  return false;
+}
+
+// Return whether the input file NAME still has the modification time
+// MTIME and size SIZE recorded for it, and so has not changed since
+// the output was linked.
+
+bool
+Incremental_checker::input_is_unchanged(const char* name,
+                                        const Timespec& mtime, off_t size)
+{
+  struct stat input_stat;
+  if (::stat(name, &input_stat) < 0)
+    return false;
+  Timespec input_mtime = stat_mtime(input_stat);
+  if (input_mtime.seconds != mtime.seconds
+      || input_mtime.nanoseconds != mtime.nanoseconds
+      || input_stat.st_size != size)
+    return false;
+  // The file may have been changed again, without changing its
+  // modification time, while the output was being written.
+  return (input_mtime.seconds < this->output_mtime_.seconds
+          || (input_mtime.seconds == this->output_mtime_.seconds
+              && input_mtime.nanoseconds < this->output_mtime_.nanoseconds));
+}
+
 } // End namespace gold.
@@ -24,6 +24,7 @@
 #define GOLD_INCREMENTAL_H
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "stringpool.h"
@@ -47,7 +48,11 @@ enum Incremental_input_type
   INCREMENTAL_INPUT_OBJECT = 1,
   INCREMENTAL_INPUT_ARCHIVE = 2,
   INCREMENTAL_INPUT_SHARED_LIBRARY = 3,
-  INCREMENTAL_INPUT_SCRIPT = 4
+  INCREMENTAL_INPUT_SCRIPT = 4,
+  // A file named by an option, such as --version-script.
+  INCREMENTAL_INPUT_OPTION_FILE = 5,
+  // The linker itself.
+  INCREMENTAL_INPUT_LINKER = 6
 };
 
 // This class contains the information needed during an incremental
@@ -56,8 +61,8 @@ class Incremental_inputs
 {
  public:
   Incremental_inputs()
-    : lock_(new Lock()), inputs_(NULL), command_line_key_(0),
-      strtab_(new Stringpool())
+    : lock_(new Lock()), inputs_(NULL), command_line_(),
+      command_line_key_(0), strtab_(new Stringpool())
   { }
   ~Incremental_inputs() { delete this->strtab_; }
 
@@ -65,11 +70,21 @@ class Incremental_inputs
   void
   report_command_line(int argc, const char* const* argv);
 
+  // Return the command line, as it is recorded.
+  const std::string&
+  command_line() const
+  { return this->command_line_; }
+
   // Record the input arguments obtained from parsing the command line.
   void
   report_inputs(const Input_arguments& inputs)
   { this->inputs_ = &inputs; }
 
+  // Return the input arguments.
+  const Input_arguments*
+  inputs() const
+  { return this->inputs_; }
+
   // Record that the input argument INPUT is an archive ARCHIVE.
   void
   report_archive(const Input_argument* input, Archive* archive);
@@ -78,11 +93,27 @@ class Incremental_inputs
   void
   report_object(const Input_argument* input, Object* obj);
 
-  // Record that the input argument INPUT is to an script SCRIPT.
+  // Record that the input argument INPUT is to an script SCRIPT, read
+  // from INPUT_FILE.
   void
-  report_script(const Input_argument* input, Timespec mtime,
+  report_script(const Input_argument* input, Input_file* input_file,
                 Script_info* script);
 
+  // Record that the file NAME, with modification time MTIME and size
+  // SIZE, was read because an option named it.
+  void
+  report_option_file(const std::string& name, const Timespec& mtime,
+                     off_t size);
+
+  // Likewise, but get the modification time and size from the file
+  // system.  This must be called before the file is read.
+  void
+  report_option_file(const char* name);
+
+  // Record the linker executable, if it can be found.
+  void
+  report_linker();
+
   // Prepare for layout.  Called from Layout::finalize.
   void
   finalize();
@@ -111,13 +142,18 @@ class Incremental_inputs
 		  Input_argument_list::const_iterator end,
 		  unsigned int* index);
 
+  // Record the file NAME of type TYPE which is not an input argument.
+  void
+  report_other_file(Incremental_input_type type, const std::string& name,
+                    const Timespec& mtime, off_t size);
+
   // Additional data about an input needed for an incremental link.
   // None of these pointers is owned by the structure.
   struct Input_info
   {
     Input_info()
       : type(INCREMENTAL_INPUT_INVALID), archive(NULL), filename_key(0),
-        index(0)
+        index(0), size(0)
     { }
 
     // Type of the file pointed by this argument.
@@ -136,6 +172,9 @@ class Incremental_inputs
       Script_info* script;
     };
 
+    // The name of the file which was found for the input argument.
+    std::string filename;
+
     // Key of the filename string in the section stringtable.
     Stringpool::Key filename_key;
 
@@ -144,10 +183,22 @@ class Incremental_inputs
     
     // Last modification time of the file.
     Timespec mtime;
+
+    // Size of the file.
+    off_t size;
   };
 
   typedef std::map<const Input_argument*, Input_info> Inputs_info_map;
 
+  // Files which are not input arguments, but which the output depends
+  // on.  They are recorded after the input arguments.
+  typedef std::vector<Input_info> Other_files;
+
+  // Write the .gnu_incremental_inputs entry for INFO.
+  template<int size, bool big_endian>
+  void
+  write_input_entry(unsigned char* inputs_base, const Input_info& info);
+
   // A lock guarding access to inputs_ during the first phase of linking, when
   // report_ function may be called from multiple threads.
   Lock* lock_;
@@ -155,9 +206,15 @@ class Incremental_inputs
   // The list of input arguments obtained from parsing the command line.
   const Input_arguments* inputs_;
 
+  // The command line, as it is stored in the string pool.
+  std::string command_line_;
+
   // A map containing additional information about the input elements.
   Inputs_info_map inputs_map_;
 
+  // The files other than the inputs.
+  Other_files other_files_;
+
   // The key of the command line string in the string pool.
   Stringpool::Key command_line_key_;
   // The .gnu_incremental_strtab string pool associated with the
@@ -165,6 +222,59 @@ class Incremental_inputs
   Stringpool* strtab_;
 };
 
+// This class checks whether the output file written by an earlier
+// incremental link is still up to date.  This is the case if it was
+// linked by the same linker with the same command line, and none of
+// the files it was linked from, including the files named by
+// options, have been modified since, according to the information
+// recorded in its .gnu_incremental_inputs section.
+
+class Incremental_checker
+{
+ public:
+  Incremental_checker(const char* output_name,
+                      const Incremental_inputs* incremental_inputs)
+    : output_name_(output_name), incremental_inputs_(incremental_inputs),
+      output_mtime_()
+  { }
+
+  // Return whether the output file is up to date, so that the link
+  // need not be done again.
+  bool
+  output_is_up_to_date();
+
+ private:
+  // Check the output file opened as DESCRIPTOR, whose ELF header is
+  // EHDR.
+  template<int size, bool big_endian>
+  bool
+  sized_output_is_up_to_date(int descriptor, const unsigned char* ehdr);
+
+  // Check an input file NAME recorded with the modification time
+  // MTIME and size SIZE.
+  bool
+  input_is_unchanged(const char* name, const Timespec& mtime, off_t size);
+
+  // Check that the input arguments in [BEGIN, END) are still found in
+  // the files FILENAMES recorded for them, starting at *PINDEX.
+  bool
+  inputs_are_found(Input_argument_list::const_iterator begin,
+                   Input_argument_list::const_iterator end,
+                   const std::vector<const char*>& filenames,
+                   unsigned int* pindex);
+
+  // Find the file for the input argument INPUT.
+  bool
+  find_input_file(const Input_file_argument& input, std::string* name);
+
+  // The name of the output file.
+  const char* output_name_;
+  // The information about the inputs of this link.
+  const Incremental_inputs* incremental_inputs_;
+  // The modification time of the output file.
+  Timespec output_mtime_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_INCREMENTAL_H)
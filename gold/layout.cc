@@ -25,9 +25,11 @@
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <utility>
 #include <fcntl.h>
+#include <fnmatch.h>
 #include <unistd.h>
 #include "libiberty.h"
 #include "md5.h"
@@ -64,6 +66,7 @@ Layout_task_runner::run(Workqueue* workqueue, const Task* task)
   off_t file_size = this->layout_->finalize(this->input_objects_,
 					    this->symtab_,
                                             this->target_,
+					    workqueue,
 					    task);
 
   // Now we know the final size of the output file and we know where
@@ -95,6 +98,8 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     dynpool_(),
     signatures_(),
     section_name_map_(),
+    section_order_map_(),
+    section_order_patterns_(),
     segment_list_(),
     section_list_(),
     unattached_section_list_(),
@@ -112,7 +117,9 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     eh_frame_data_(NULL),
     added_eh_frame_data_(false),
     eh_frame_hdr_section_(NULL),
+    eh_frame_hdr_data_(NULL),
     build_id_note_(NULL),
+    compressed_sections_(),
     debug_abbrev_(NULL),
     debug_info_(NULL),
     group_signatures_(),
@@ -144,6 +151,73 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
   this->namepool_.set_optimize();
 }
 
+// Read the section ordering file given by --section-ordering-file.
+// Each line holds the name of an input section, such as
+// ".text.hot_function", or a wildcard pattern matching such names.
+// Input sections are placed within their output section in the order
+// in which they are listed, before any sections which are not
+// listed.  Leading and trailing white space is ignored, as are empty
+// lines and lines starting with '#'.  Names are looked up in a hash
+// table, so the file may list many thousands of sections; patterns
+// are tried in order, so they should be used sparingly.
+
+void
+Layout::read_section_ordering_file()
+{
+  const char* filename = parameters->options().section_ordering_file();
+  if (this->incremental_inputs_ != NULL)
+    this->incremental_inputs_->report_option_file(filename);
+  std::ifstream in(filename);
+  if (!in)
+    {
+      gold_error(_("cannot open section ordering file %s: %s"),
+		 filename, strerror(errno));
+      return;
+    }
+
+  unsigned int position = 0;
+  std::string line;
+  while (std::getline(in, line))
+    {
+      std::string::size_type start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+	continue;
+      std::string::size_type end = line.find_last_not_of(" \t\r");
+      std::string name(line, start, end + 1 - start);
+
+      ++position;
+      if (strpbrk(name.c_str(), "?*[") != NULL)
+	this->section_order_patterns_.push_back(std::make_pair(name,
+							       position));
+      else
+	{
+	  // If a name is listed twice, the first position wins.
+	  this->section_order_map_.insert(std::make_pair(name, position));
+	}
+    }
+}
+
+// Return the position of the input section NAME in the section
+// ordering file, or 0 if it is not there.
+
+unsigned int
+Layout::find_section_order_index(const char* name) const
+{
+  Section_order_map::const_iterator p =
+    this->section_order_map_.find(std::string(name));
+  if (p != this->section_order_map_.end())
+    return p->second;
+
+  for (Section_order_patterns::const_iterator q =
+	 this->section_order_patterns_.begin();
+       q != this->section_order_patterns_.end();
+       ++q)
+    if (fnmatch(q->first.c_str(), name, 0) == 0)
+      return q->second;
+
+  return 0;
+}
+
 // Hash a key we use to look up an output section mapping.
 
 size_t
@@ -507,8 +581,13 @@ Layout::layout(Sized_relobj<size, big_endian>* object, unsigned int shndx,
 
   // FIXME: Handle SHF_LINK_ORDER somewhere.
 
+  unsigned int section_order_index = 0;
+  if (this->has_section_ordering())
+    section_order_index = this->find_section_order_index(name);
+
   *off = os->add_input_section(object, shndx, name, shdr, reloc_shndx,
-			       this->script_options_->saw_sections_clause());
+			       this->script_options_->saw_sections_clause(),
+			       section_order_index);
 
   return os;
 }
@@ -676,6 +755,7 @@ Layout::layout_eh_frame(Sized_relobj<size, big_endian>* object,
 		}
 
 	      this->eh_frame_data_->set_eh_frame_hdr(hdr_posd);
+	      this->eh_frame_hdr_data_ = hdr_posd;
 	    }
 	}
     }
@@ -711,7 +791,7 @@ Layout::layout_eh_frame(Sized_relobj<size, big_endian>* object,
       // Add it as a normal section.
       bool saw_sections_clause = this->script_options_->saw_sections_clause();
       *off = os->add_input_section(object, shndx, name, shdr, reloc_shndx,
-				   saw_sections_clause);
+				   saw_sections_clause, 0);
     }
 
   return os;
@@ -732,6 +812,47 @@ Layout::add_output_section_data(const char* name, elfcpp::Elf_Word type,
   return os;
 }
 
+// Remove the output section OS from the section list, the name map
+// and the segments.
+
+void
+Layout::remove_output_section(Output_section* os)
+{
+  Section_list::iterator p = std::find(this->section_list_.begin(),
+				       this->section_list_.end(), os);
+  gold_assert(p != this->section_list_.end());
+  this->section_list_.erase(p);
+
+  for (Section_name_map::iterator q = this->section_name_map_.begin();
+       q != this->section_name_map_.end();
+       ++q)
+    {
+      if (q->second == os)
+	{
+	  this->section_name_map_.erase(q);
+	  break;
+	}
+    }
+
+  if (this->sections_are_attached_)
+    {
+      if ((os->flags() & elfcpp::SHF_ALLOC) == 0)
+	{
+	  p = std::find(this->unattached_section_list_.begin(),
+			this->unattached_section_list_.end(), os);
+	  gold_assert(p != this->unattached_section_list_.end());
+	  this->unattached_section_list_.erase(p);
+	}
+      else
+	{
+	  for (Segment_list::iterator q = this->segment_list_.begin();
+	       q != this->segment_list_.end();
+	       ++q)
+	    (*q)->remove_output_section(os);
+	}
+    }
+}
+
 // Map section flags to segment flags.
 
 elfcpp::Elf_Word
@@ -771,8 +892,13 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
   if ((flags & elfcpp::SHF_ALLOC) == 0
       && strcmp(parameters->options().compress_debug_sections(), "none") != 0
       && is_compressible_debug_section(name))
-    os = new Output_compressed_section(&parameters->options(), name, type,
-				       flags);
+    {
+      Output_compressed_section* ocs =
+	new Output_compressed_section(&parameters->options(), name, type,
+				      flags);
+      this->compressed_sections_.push_back(ocs);
+      os = ocs;
+    }
 
   else if ((flags & elfcpp::SHF_ALLOC) == 0
            && parameters->options().strip_debug_non_line()
@@ -1204,7 +1330,7 @@ Layout::find_first_load_seg()
 
 off_t
 Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
-		 Target* target, const Task* task)
+		 Target* target, Workqueue* workqueue, const Task* task)
 {
   target->finalize_sections(this);
 
@@ -1229,7 +1355,7 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
       unsigned int local_dynamic_count;
       Versions versions(*this->script_options()->version_script_info(),
                         &this->dynpool_);
-      this->create_dynamic_symtab(input_objects, symtab, &dynstr,
+      this->create_dynamic_symtab(input_objects, symtab, workqueue, &dynstr,
 				  &local_dynamic_count, &dynamic_symbols,
 				  &versions);
 
@@ -1315,7 +1441,19 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   // they contain.
   off_t off;
   if (!parameters->options().relocatable())
-    off = this->set_segment_offsets(target, load_seg, &shndx);
+    {
+      off = this->set_segment_offsets(target, load_seg, &shndx);
+
+      // The target may have sections which can only be completed
+      // once the addresses are known.  If one of them grows, set the
+      // offsets again.
+      while (target->finalize_address_dependent_sections())
+	{
+	  this->reset_segment_offsets();
+	  shndx = 1;
+	  off = this->set_segment_offsets(target, load_seg, &shndx);
+	}
+    }
   else
     off = this->set_relocatable_section_offsets(file_header, &shndx);
 
@@ -1560,7 +1698,7 @@ Layout::create_build_id()
   std::string desc;
   if (strcmp(style, "md5") == 0)
     descsz = 128 / 8;
-  else if (strcmp(style, "sha1") == 0)
+  else if (strcmp(style, "sha1") == 0 || strcmp(style, "tree") == 0)
     descsz = 160 / 8;
   else if (strcmp(style, "uuid") == 0)
     {
@@ -2033,6 +2171,23 @@ Layout::set_segment_offsets(const Target* target, Output_segment* load_seg,
   return off;
 }
 
+// Reset the addresses and file offsets of the segments and the
+// sections in them, so that set_segment_offsets can be called again.
+
+void
+Layout::reset_segment_offsets()
+{
+  for (Data_list::iterator p = this->special_output_list_.begin();
+       p != this->special_output_list_.end();
+       ++p)
+    (*p)->reset_address_and_file_offset();
+
+  for (Segment_list::iterator p = this->segment_list_.begin();
+       p != this->segment_list_.end();
+       ++p)
+    (*p)->reset_addresses_and_offsets();
+}
+
 // Set the offsets of all the allocated sections when doing a
 // relocatable link.  This does the same jobs as set_segment_offsets,
 // only for a relocatable link.
@@ -2411,6 +2566,7 @@ Layout::allocated_output_section_count() const
 void
 Layout::create_dynamic_symtab(const Input_objects* input_objects,
                               Symbol_table* symtab,
+			      Workqueue* workqueue,
 			      Output_section **pdynstr,
 			      unsigned int* plocal_dynamic_count,
 			      std::vector<Symbol*>* pdynamic_symbols,
@@ -2449,6 +2605,24 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
   unsigned int local_symcount = index;
   *plocal_dynamic_count = local_symcount;
 
+  // The GNU C library will only load an object with packed relative
+  // relocs if it refers to the version GLIBC_ABI_DT_RELR, so that an
+  // older library which would ignore them refuses to run it.
+  if (this->find_output_section(".relr.dyn") != NULL)
+    {
+      for (Input_objects::Dynobj_iterator p = input_objects->dynobj_begin();
+	   p != input_objects->dynobj_end();
+	   ++p)
+	{
+	  if (strcmp((*p)->soname(), "libc.so.6") == 0)
+	    {
+	      pversions->record_need(&this->dynpool_, (*p)->soname(),
+				     "GLIBC_ABI_DT_RELR");
+	      break;
+	    }
+	}
+    }
+
   index = symtab->set_dynsym_indexes(index, pdynamic_symbols,
 				     &this->dynpool_, pversions);
 
@@ -2539,15 +2713,26 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
 
   *pdynstr = dynstr;
 
-  // Create the hash tables.
+  // Create the hash tables.  The GNU hash table must be built first,
+  // because it changes the order of the symbols in the dynamic symbol
+  // table.
+
+  const bool gnu_hash = (strcmp(parameters->options().hash_style(), "gnu") == 0
+			 || strcmp(parameters->options().hash_style(),
+				   "both") == 0);
+  unsigned char* pgnuhash = NULL;
+  unsigned int gnuhashlen = 0;
+  if (gnu_hash)
+    Dynobj::create_gnu_hash_table(workqueue, *pdynamic_symbols,
+				  local_symcount, &pgnuhash, &gnuhashlen);
 
   if (strcmp(parameters->options().hash_style(), "sysv") == 0
       || strcmp(parameters->options().hash_style(), "both") == 0)
     {
       unsigned char* phash;
       unsigned int hashlen;
-      Dynobj::create_elf_hash_table(*pdynamic_symbols, local_symcount,
-				    &phash, &hashlen);
+      Dynobj::create_elf_hash_table(workqueue, *pdynamic_symbols,
+				    local_symcount, &phash, &hashlen);
 
       Output_section* hashsec = this->choose_output_section(NULL, ".hash",
 							    elfcpp::SHT_HASH,
@@ -2566,21 +2751,15 @@ Layout::create_dynamic_symtab(const Input_objects* input_objects,
       odyn->add_section_address(elfcpp::DT_HASH, hashsec);
     }
 
-  if (strcmp(parameters->options().hash_style(), "gnu") == 0
-      || strcmp(parameters->options().hash_style(), "both") == 0)
+  if (gnu_hash)
     {
-      unsigned char* phash;
-      unsigned int hashlen;
-      Dynobj::create_gnu_hash_table(*pdynamic_symbols, local_symcount,
-				    &phash, &hashlen);
-
       Output_section* hashsec = this->choose_output_section(NULL, ".gnu.hash",
 							    elfcpp::SHT_GNU_HASH,
 							    elfcpp::SHF_ALLOC,
 							    false);
 
-      Output_section_data* hashdata = new Output_data_const_buffer(phash,
-								   hashlen,
+      Output_section_data* hashdata = new Output_data_const_buffer(pgnuhash,
+								   gnuhashlen,
 								   align,
 								   "** hash");
       hashsec->add_output_section_data(hashdata);
@@ -3212,11 +3391,43 @@ Layout::write_data(const Symbol_table* symtab, Output_file* of) const
     (*p)->write(of);
 }
 
+// Queue a Compress_chunk_task for each chunk of each compressed
+// section.  This is called after all the input sections have been
+// written.
+
+void
+Layout::queue_compression_tasks(Workqueue* workqueue,
+				Task_token* chunks_blocker)
+{
+  // Add all the blockers before queueing any task, so that
+  // CHUNKS_BLOCKER is not unblocked early.
+  std::vector<unsigned int> chunk_counts;
+  chunk_counts.reserve(this->compressed_sections_.size());
+  for (std::vector<Output_compressed_section*>::const_iterator p =
+	 this->compressed_sections_.begin();
+       p != this->compressed_sections_.end();
+       ++p)
+    {
+      unsigned int chunk_count = (*p)->prepare_compression();
+      for (unsigned int i = 0; i < chunk_count; ++i)
+	chunks_blocker->add_blocker();
+      chunk_counts.push_back(chunk_count);
+    }
+
+  for (size_t i = 0; i < this->compressed_sections_.size(); ++i)
+    {
+      Output_compressed_section* os = this->compressed_sections_[i];
+      for (unsigned int j = 0; j < chunk_counts[i]; ++j)
+	workqueue->queue_soon(new Compress_chunk_task(os, j, chunks_blocker));
+    }
+}
+
 // Write out the Output_sections which can only be written after the
 // input sections are complete.
 
 void
-Layout::write_sections_after_input_sections(Output_file* of)
+Layout::write_sections_after_input_sections(Output_file* of,
+					    Workqueue* workqueue)
 {
   // Determine the final section offsets, and thus the final output
   // file size.  Note we finalize the .shstrab last, to allow the
@@ -3239,6 +3450,10 @@ Layout::write_sections_after_input_sections(Output_file* of)
 	}
     }
 
+  // The .eh_frame_hdr section sorts a table of all the FDEs.
+  if (this->eh_frame_hdr_data_ != NULL)
+    this->eh_frame_hdr_data_->set_workqueue(workqueue);
+
   for (Section_list::const_iterator p = this->section_list_.begin();
        p != this->section_list_.end();
        ++p)
@@ -3260,34 +3475,105 @@ Layout::write_build_id(Output_file* of) const
   if (this->build_id_note_ == NULL)
     return;
 
-  const unsigned char* iv = of->get_input_view(0, this->output_file_size_);
-
   unsigned char* ov = of->get_output_view(this->build_id_note_->offset(),
 					  this->build_id_note_->data_size());
 
   const char* style = parameters->options().build_id();
-  if (strcmp(style, "sha1") == 0)
+  if (strcmp(style, "tree") == 0)
     {
+      // The digests of the chunks were computed by
+      // Build_id_chunk_tasks.  The build ID is the SHA-1 of the
+      // sequence of chunk digests.
+      gold_assert(!this->build_id_chunk_digests_.empty());
       sha1_ctx ctx;
       sha1_init_ctx(&ctx);
-      sha1_process_bytes(iv, this->output_file_size_, &ctx);
+      sha1_process_bytes(&this->build_id_chunk_digests_[0],
+			 this->build_id_chunk_digests_.size(), &ctx);
       sha1_finish_ctx(&ctx, ov);
     }
-  else if (strcmp(style, "md5") == 0)
+  else
     {
-      md5_ctx ctx;
-      md5_init_ctx(&ctx);
-      md5_process_bytes(iv, this->output_file_size_, &ctx);
-      md5_finish_ctx(&ctx, ov);
+      const unsigned char* iv = of->get_input_view(0,
+						   this->output_file_size_);
+
+      if (strcmp(style, "sha1") == 0)
+	{
+	  sha1_ctx ctx;
+	  sha1_init_ctx(&ctx);
+	  sha1_process_bytes(iv, this->output_file_size_, &ctx);
+	  sha1_finish_ctx(&ctx, ov);
+	}
+      else if (strcmp(style, "md5") == 0)
+	{
+	  md5_ctx ctx;
+	  md5_init_ctx(&ctx);
+	  md5_process_bytes(iv, this->output_file_size_, &ctx);
+	  md5_finish_ctx(&ctx, ov);
+	}
+      else
+	gold_unreachable();
+
+      of->free_input_view(0, this->output_file_size_, iv);
     }
-  else
-    gold_unreachable();
 
   of->write_output_view(this->build_id_note_->offset(),
 			this->build_id_note_->data_size(),
 			ov);
+}
+
+// For --build-id=tree, the output file is divided into chunks of this
+// size.  The build ID depends on this value, so it must not change.
+
+static const off_t build_id_chunk_size = 4 * 1024 * 1024;
+
+// The size of the digest of a chunk.
+
+static const size_t build_id_chunk_digest_size = 160 / 8;
+
+// Return whether the build ID is computed from chunk digests.
+
+bool
+Layout::build_id_uses_chunks() const
+{
+  return (this->build_id_note_ != NULL
+	  && strcmp(parameters->options().build_id(), "tree") == 0);
+}
+
+// Set up to compute the chunk digests for the build ID, and return
+// the number of chunks.  The last chunk may be short.
+
+unsigned int
+Layout::prepare_build_id_chunks()
+{
+  gold_assert(this->build_id_uses_chunks());
+  off_t file_size = this->output_file_size_;
+  unsigned int chunk_count = ((file_size + build_id_chunk_size - 1)
+			      / build_id_chunk_size);
+  this->build_id_chunk_digests_.resize(chunk_count
+				       * build_id_chunk_digest_size);
+  return chunk_count;
+}
+
+// Compute the SHA-1 digest of chunk CHUNK of the output file.
+
+void
+Layout::hash_build_id_chunk(Output_file* of, unsigned int chunk)
+{
+  off_t start = static_cast<off_t>(chunk) * build_id_chunk_size;
+  gold_assert(start < this->output_file_size_);
+  size_t size = std::min(build_id_chunk_size,
+			 this->output_file_size_ - start);
+
+  const unsigned char* iv = of->get_input_view(start, size);
+
+  unsigned char* digest = (&this->build_id_chunk_digests_[0]
+			   + chunk * build_id_chunk_digest_size);
+  sha1_ctx ctx;
+  sha1_init_ctx(&ctx);
+  sha1_process_bytes(iv, size, &ctx);
+  sha1_finish_ctx(&ctx, digest);
 
-  of->free_input_view(0, this->output_file_size_, iv);
+  of->free_input_view(start, size, iv);
 }
 
 // Write out a binary file.  This is called after the link is
@@ -3365,6 +3651,19 @@ Layout::print_stats() const
     (*p)->print_merge_stats();
 }
 
+// Queue tasks to finish processing the merge sections.  This is
+// called after all the input sections have been added, and before
+// Layout::finalize.
+
+void
+Layout::queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  for (Section_list::const_iterator p = this->section_list_.begin();
+       p != this->section_list_.end();
+       ++p)
+    (*p)->queue_merge_tasks(workqueue, blocker);
+}
+
 // Write_sections_task methods.
 
 // We can always run this task.
@@ -3440,11 +3739,12 @@ Write_symbols_task::locks(Task_locker* tl)
 // Run the task--write out the symbols.
 
 void
-Write_symbols_task::run(Workqueue*)
+Write_symbols_task::run(Workqueue* workqueue)
 {
   this->symtab_->write_globals(this->sympool_, this->dynpool_,
 			       this->layout_->symtab_xindex(),
-			       this->layout_->dynsym_xindex(), this->of_);
+			       this->layout_->dynsym_xindex(), this->of_,
+			       workqueue);
 }
 
 // Write_after_input_sections_task methods.
@@ -3470,9 +3770,64 @@ Write_after_input_sections_task::locks(Task_locker* tl)
 // Run the task.
 
 void
-Write_after_input_sections_task::run(Workqueue*)
+Write_after_input_sections_task::run(Workqueue* workqueue)
+{
+  this->layout_->write_sections_after_input_sections(this->of_, workqueue);
+}
+
+// Build_id_task_runner methods.
+
+// Queue a task for each chunk of the output file, and queue the task
+// to close the file after them.
+
+void
+Build_id_task_runner::run(Workqueue* workqueue, const Task*)
+{
+  unsigned int chunk_count = this->layout_->prepare_build_id_chunks();
+
+  // CHUNKS_BLOCKER is owned by the task which closes the file.  That
+  // task computes the build ID from the chunk digests, and as a
+  // Task_function it deletes its blocker after it runs, once every
+  // Build_id_chunk_task has released CHUNKS_BLOCKER.
+  Task_token* chunks_blocker = new Task_token(true);
+  for (unsigned int i = 0; i < chunk_count; ++i)
+    chunks_blocker->add_blocker();
+
+  for (unsigned int i = 0; i < chunk_count; ++i)
+    workqueue->queue_soon(new Build_id_chunk_task(this->layout_, this->of_,
+						  i, chunks_blocker));
+
+  workqueue->queue(new Task_function(new Close_task_runner(this->options_,
+							   this->layout_,
+							   this->of_),
+				     chunks_blocker,
+				     "Task_function Close_task_runner"));
+}
+
+// Build_id_chunk_task methods.
+
+// We can always run this task.
+
+Task_token*
+Build_id_chunk_task::is_runnable()
+{
+  return NULL;
+}
+
+// We need to unlock CHUNKS_BLOCKER when finished.
+
+void
+Build_id_chunk_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->chunks_blocker_);
+}
+
+// Run the task--compute the digest of the chunk.
+
+void
+Build_id_chunk_task::run(Workqueue*)
 {
-  this->layout_->write_sections_after_input_sections(this->of_);
+  this->layout_->hash_build_id_chunk(this->of_, this->chunk_);
 }
 
 // Close_task_runner methods.
@@ -53,7 +53,9 @@ class Output_data_dynamic;
 class Output_symtab_xindex;
 class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
+class Output_compressed_section;
 class Eh_frame;
+class Eh_frame_hdr;
 class Target;
 
 // This task function handles mapping the input sections to output
@@ -358,6 +360,12 @@ class Layout
 			  elfcpp::Elf_Xword flags,
 			  Output_section_data*);
 
+  // Remove the output section OS, which was created for data which
+  // turned out to be empty.  This must be called before the dynamic
+  // sections are finalized.
+  void
+  remove_output_section(Output_section* os);
+
   // Create dynamic sections if necessary.
   void
   create_initial_dynamic_sections(Symbol_table*);
@@ -438,14 +446,31 @@ class Layout
 			   bool is_group_name, Kept_section** kept_section);
 
   // Finalize the layout after all the input sections have been added.
+  // WORKQUEUE is used to share some of the work with other threads.
   off_t
-  finalize(const Input_objects*, Symbol_table*, Target*, const Task*);
+  finalize(const Input_objects*, Symbol_table*, Target*, Workqueue*,
+	   const Task*);
 
   // Return whether any sections require postprocessing.
   bool
   any_postprocessing_sections() const
   { return this->any_postprocessing_sections_; }
 
+  // Return whether any sections are compressed.
+  bool
+  any_compressed_sections() const
+  { return !this->compressed_sections_.empty(); }
+
+  // Queue tasks to compress the compressed sections.  CHUNKS_BLOCKER
+  // is unblocked when they are all done.
+  void
+  queue_compression_tasks(Workqueue*, Task_token* chunks_blocker);
+
+  // Queue tasks to finish processing the input sections added to
+  // merge sections.  BLOCKER is unblocked when they are all done.
+  void
+  queue_merge_tasks(Workqueue*, Task_token* blocker);
+
   // Return the size of the output file.
   off_t
   output_file_size() const
@@ -488,9 +513,10 @@ class Layout
   write_data(const Symbol_table*, Output_file*) const;
 
   // Write out output sections which can not be written until all the
-  // input sections are complete.
+  // input sections are complete.  WORKQUEUE may be used to share the
+  // work among threads.
   void
-  write_sections_after_input_sections(Output_file* of);
+  write_sections_after_input_sections(Output_file* of, Workqueue* workqueue);
 
   // Return an output section named NAME, or NULL if there is none.
   Output_section*
@@ -525,6 +551,23 @@ class Layout
   script_options() const
   { return this->script_options_; }
 
+  // Read the file named by --section-ordering-file.
+  void
+  read_section_ordering_file();
+
+  // Return whether --section-ordering-file listed any sections.
+  bool
+  has_section_ordering() const
+  {
+    return (!this->section_order_map_.empty()
+	    || !this->section_order_patterns_.empty());
+  }
+
+  // Return the position of the input section NAME in the section
+  // ordering file, counting from 1, or 0 if it is not listed.
+  unsigned int
+  find_section_order_index(const char* name) const;
+
   // Return the object managing inputs in incremental build. NULL in
   // non-incremental builds.
   Incremental_inputs*
@@ -535,6 +578,24 @@ class Layout
   void
   write_build_id(Output_file*) const;
 
+  // Return whether the build ID is computed from digests of chunks
+  // of the output file, which may be computed in parallel.  This is
+  // true for --build-id=tree.
+  bool
+  build_id_uses_chunks() const;
+
+  // Return the number of chunks of the output file for the build ID.
+  // This must be called after the output file is complete, and
+  // before hash_build_id_chunk.
+  unsigned int
+  prepare_build_id_chunks();
+
+  // Compute the digest of chunk CHUNK of the output file for the
+  // build ID.  This may be called for different chunks at the same
+  // time.
+  void
+  hash_build_id_chunk(Output_file*, unsigned int chunk);
+
   // Rewrite output file in binary format.
   void
   write_binary(Output_file* in) const;
@@ -670,7 +731,7 @@ class Layout
 
   // Create the dynamic symbol table.
   void
-  create_dynamic_symtab(const Input_objects*, Symbol_table*,
+  create_dynamic_symtab(const Input_objects*, Symbol_table*, Workqueue*,
 			Output_section** pdynstr,
 			unsigned int* plocal_dynamic_count,
 			std::vector<Symbol*>* pdynamic_symbols,
@@ -748,6 +809,11 @@ class Layout
   off_t
   set_segment_offsets(const Target*, Output_segment*, unsigned int* pshndx);
 
+  // Reset the offsets set by set_segment_offsets, so that they can be
+  // set again.
+  void
+  reset_segment_offsets();
+
   // Set the file offsets of the sections when doing a relocatable
   // link.
   off_t
@@ -798,6 +864,15 @@ class Layout
 
   typedef Unordered_map<Key, Output_section*, Hash_key> Section_name_map;
 
+  // Mapping from input section names in the section ordering file to
+  // their positions.
+  typedef Unordered_map<std::string, unsigned int> Section_order_map;
+
+  // Wildcard patterns in the section ordering file, with their
+  // positions.
+  typedef std::vector<std::pair<std::string, unsigned int> >
+    Section_order_patterns;
+
   // A comparison class for segments.
 
   struct Compare_segments
@@ -821,6 +896,10 @@ class Layout
   Signatures signatures_;
   // The mapping from input section name/type/flags to output sections.
   Section_name_map section_name_map_;
+  // The input section names listed in --section-ordering-file.
+  Section_order_map section_order_map_;
+  // The wildcard patterns listed in --section-ordering-file.
+  Section_order_patterns section_order_patterns_;
   // The list of output segments.
   Segment_list segment_list_;
   // The list of output sections.
@@ -857,8 +936,15 @@ class Layout
   bool added_eh_frame_data_;
   // The exception frame header output section if there is one.
   Output_section* eh_frame_hdr_section_;
+  // The exception frame header data if there is one.
+  Eh_frame_hdr* eh_frame_hdr_data_;
   // The space for the build ID checksum if there is one.
   Output_section_data* build_id_note_;
+  // For --build-id=tree, the digests of the chunks of the output
+  // file.
+  std::vector<unsigned char> build_id_chunk_digests_;
+  // The sections whose contents are compressed.
+  std::vector<Output_compressed_section*> compressed_sections_;
   // The output section containing dwarf abbreviations
   Output_reduced_debug_abbrev_section* debug_abbrev_;
   // The output section containing the dwarf debug info tree
@@ -1061,6 +1147,63 @@ class Close_task_runner : public Task_function_runner
   Output_file* of_;
 };
 
+// This task function queues the tasks which compute the digests of
+// the chunks of the output file for --build-id=tree, and then queues
+// the task which closes the file.
+
+class Build_id_task_runner : public Task_function_runner
+{
+ public:
+  Build_id_task_runner(const General_options* options, Layout* layout,
+		       Output_file* of)
+    : options_(options), layout_(layout), of_(of)
+  { }
+
+  // Run the operation.
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options* options_;
+  Layout* layout_;
+  Output_file* of_;
+};
+
+// This task computes the digest of one chunk of the output file for
+// --build-id=tree.
+
+class Build_id_chunk_task : public Task
+{
+ public:
+  // CHUNKS_BLOCKER is unblocked when all the chunks are done.
+  Build_id_chunk_task(Layout* layout, Output_file* of, unsigned int chunk,
+		      Task_token* chunks_blocker)
+    : layout_(layout), of_(of), chunk_(chunk),
+      chunks_blocker_(chunks_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Build_id_chunk_task"; }
+
+ private:
+  Layout* layout_;
+  Output_file* of_;
+  unsigned int chunk_;
+  Task_token* chunks_blocker_;
+};
+
 // A small helper function to align an address.
 
 inline uint64_t
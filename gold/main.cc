@@ -35,6 +35,7 @@
 #include "options.h"
 #include "parameters.h"
 #include "errors.h"
+#include "debug.h"
 #include "mapfile.h"
 #include "dirsearch.h"
 #include "workqueue.h"
@@ -227,10 +228,36 @@ main(int argc, char** argv)
   Layout layout(command_line.number_of_input_files(),
 		&command_line.script_options());
 
+  if (command_line.options().section_ordering_file() != NULL)
+    layout.read_section_ordering_file();
+
   if (layout.incremental_inputs() != NULL)
     {
       layout.incremental_inputs()->report_command_line(argc, argv);
       layout.incremental_inputs()->report_inputs(command_line.inputs());
+      // The output also depends on the files named by options, and
+      // on the linker itself.
+      const Command_line::Option_files& option_files =
+        command_line.option_files();
+      for (Command_line::Option_files::const_iterator p =
+             option_files.begin();
+           p != option_files.end();
+           ++p)
+        layout.incremental_inputs()->report_option_file(p->name, p->mtime,
+                                                        p->size);
+      layout.incremental_inputs()->report_linker();
+
+      // If nothing has changed since the output file was linked,
+      // there is nothing to do.  A map file can only be written by
+      // doing the link.
+      Incremental_checker checker(command_line.options().output_file_name(),
+                                  layout.incremental_inputs());
+      if (mapfile == NULL && checker.output_is_up_to_date())
+        {
+          gold_debug(DEBUG_FILES, "%s is up to date",
+                     command_line.options().output_file_name());
+          gold_exit(true);
+        }
     }
 
   // Get the search path from the -L options.
@@ -245,6 +272,8 @@ main(int argc, char** argv)
   // Run the main task processing loop.
   workqueue.process(0);
 
+  workqueue.write_trace();
+
   if (command_line.options().stats())
     {
       long run_time = get_run_time() - start_time;
@@ -257,6 +286,7 @@ main(int argc, char** argv)
 #endif
       File_read::print_stats();
       Archive::print_stats();
+      workqueue.print_stats();
       fprintf(stderr, _("%s: output file size: %lld bytes\n"),
 	      program_name, static_cast<long long>(layout.output_file_size()));
       symtab.print_stats();
@@ -30,6 +30,24 @@
 namespace gold
 {
 
+// Return the greatest common divisor of A and B.
+
+static section_size_type
+gcd(section_size_type a, section_size_type b)
+{
+  while (b != 0)
+    {
+      section_size_type t = a % b;
+      a = b;
+      b = t;
+    }
+  return a;
+}
+
+// Class Merge_offset_table.
+
+const section_offset_type Merge_offset_table::UNMAPPED;
+
 // Class Object_merge_map.
 
 // Destructor.
@@ -103,6 +121,11 @@ Object_merge_map::add_mapping(const Merge_map* merge_map, unsigned int shndx,
 {
   Input_merge_map* map = this->get_or_make_input_merge_map(merge_map, shndx);
 
+  // Eh_frame looks up the mappings of a section while scanning the
+  // relocations, and adds more mappings later.
+  if (map->finalized)
+    Object_merge_map::unfinalize_input_merge_map(map);
+
   // Try to merge the new entry in the last one we saw.
   if (!map->entries.empty())
     {
@@ -151,34 +174,10 @@ Object_merge_map::get_output_offset(const Merge_map* merge_map,
       || (merge_map != NULL && map->merge_map != merge_map))
     return false;
 
-  if (!map->sorted)
-    {
-      std::sort(map->entries.begin(), map->entries.end(),
-		Input_merge_compare());
-      map->sorted = true;
-    }
+  if (!map->finalized)
+    Object_merge_map::finalize_input_merge_map(map);
 
-  Input_merge_entry entry;
-  entry.input_offset = input_offset;
-  std::vector<Input_merge_entry>::const_iterator p =
-    std::lower_bound(map->entries.begin(), map->entries.end(),
-		     entry, Input_merge_compare());
-  if (p == map->entries.end() || p->input_offset > input_offset)
-    {
-      if (p == map->entries.begin())
-	return false;
-      --p;
-      gold_assert(p->input_offset <= input_offset);
-    }
-
-  if (input_offset - p->input_offset
-      >= static_cast<section_offset_type>(p->length))
-    return false;
-
-  *output_offset = p->output_offset;
-  if (*output_offset != -1)
-    *output_offset += (input_offset - p->input_offset);
-  return true;
+  return map->table.get_output_offset(input_offset, output_offset);
 }
 
 // Return whether this is the merge map for section SHNDX.
@@ -191,43 +190,150 @@ Object_merge_map::is_merge_section_for(const Merge_map* merge_map,
   return map != NULL && map->merge_map == merge_map;
 }
 
-// Initialize a mapping from input offsets to output addresses.
+// Return the final mappings for section SHNDX.
 
-template<int size>
-void
-Object_merge_map::initialize_input_to_output_map(
-    unsigned int shndx,
-    typename elfcpp::Elf_types<size>::Elf_Addr starting_address,
-    Unordered_map<section_offset_type,
-		  typename elfcpp::Elf_types<size>::Elf_Addr>* initialize_map)
+const Merge_offset_table*
+Object_merge_map::offset_table(unsigned int shndx)
 {
   Input_merge_map* map = this->get_input_merge_map(shndx);
   gold_assert(map != NULL);
+  if (!map->finalized)
+    Object_merge_map::finalize_input_merge_map(map);
+  return &map->table;
+}
 
-  gold_assert(initialize_map->empty());
-  // We know how many entries we are going to add.
-  // reserve_unordered_map takes an expected count of buckets, not a
-  // count of elements, so double it to try to reduce collisions.
-  reserve_unordered_map(initialize_map, map->entries.size() * 2);
+// Build the Merge_offset_table for MAP.  The entries are no longer
+// needed after this, so we free them.
 
-  for (Input_merge_map::Entries::const_iterator p = map->entries.begin();
-       p != map->entries.end();
-       ++p)
+void
+Object_merge_map::finalize_input_merge_map(Input_merge_map* map)
+{
+  gold_assert(!map->finalized);
+
+  if (!map->sorted)
     {
-      section_offset_type output_offset = p->output_offset;
-      if (output_offset != -1)
-	output_offset += starting_address;
+      std::sort(map->entries.begin(), map->entries.end(),
+		Input_merge_compare());
+      map->sorted = true;
+    }
+
+  const Input_merge_map::Entries& entries(map->entries);
+  Merge_offset_table* table = &map->table;
+  const size_t count = entries.size();
+
+  // Find the largest block size which divides the start and length
+  // of every mapping, and see whether the mappings cover the section
+  // without any holes.
+  section_size_type block_size = 0;
+  bool contiguous = true;
+  section_offset_type end = 0;
+  for (size_t i = 0; i < count; ++i)
+    {
+      const Input_merge_entry& entry(entries[i]);
+      if (entry.input_offset != end)
+	contiguous = false;
+      block_size = gcd(block_size,
+		       gcd(static_cast<section_size_type>(entry.input_offset),
+			   entry.length));
+      end = entry.input_offset + entry.length;
+    }
+  table->end_ = end;
+
+  // Use a direct index if it is no more than twice the size of the
+  // sorted arrays.  For merged strings the block size is normally
+  // one, and a direct index would be much too large.
+  if (count > 0
+      && contiguous
+      && block_size != 0
+      && static_cast<section_size_type>(end) / block_size <= 2 * count)
+    {
+      table->block_size_ = block_size;
+      table->output_offsets_.reserve(end / block_size);
+      for (size_t i = 0; i < count; ++i)
+	{
+	  const Input_merge_entry& entry(entries[i]);
+	  for (section_size_type off = 0;
+	       off < entry.length;
+	       off += block_size)
+	    table->output_offsets_.push_back(entry.output_offset == -1
+					     ? -1
+					     : entry.output_offset + off);
+	}
+    }
+  else
+    {
+      table->input_offsets_.reserve(count + 1);
+      table->output_offsets_.reserve(count);
+      end = 0;
+      for (size_t i = 0; i < count; ++i)
+	{
+	  const Input_merge_entry& entry(entries[i]);
+	  if (entry.input_offset != end)
+	    {
+	      table->input_offsets_.push_back(end);
+	      table->output_offsets_.push_back(Merge_offset_table::UNMAPPED);
+	    }
+	  table->input_offsets_.push_back(entry.input_offset);
+	  table->output_offsets_.push_back(entry.output_offset);
+	  end = entry.input_offset + entry.length;
+	}
+      table->input_offsets_.push_back(end);
+    }
+
+  Input_merge_map::Entries().swap(map->entries);
+  map->finalized = true;
+}
+
+// Convert the Merge_offset_table for MAP back into entries, so that
+// more mappings may be added.
+
+void
+Object_merge_map::unfinalize_input_merge_map(Input_merge_map* map)
+{
+  gold_assert(map->finalized && map->entries.empty());
+
+  Merge_offset_table* table = &map->table;
+  Input_merge_map::Entries* entries = &map->entries;
+  const size_t count = table->output_offsets_.size();
+  for (size_t i = 0; i < count; ++i)
+    {
+      Input_merge_entry entry;
+      entry.output_offset = table->output_offsets_[i];
+      if (table->block_size_ != 0)
+	{
+	  entry.input_offset = i * table->block_size_;
+	  entry.length = table->block_size_;
+	  if (!entries->empty())
+	    {
+	      Input_merge_entry& last(entries->back());
+	      if (entry.output_offset == -1
+		  ? last.output_offset == -1
+		  : (last.output_offset != -1
+		     && (last.output_offset
+			 + static_cast<section_offset_type>(last.length)
+			 == entry.output_offset)))
+		{
+		  last.length += entry.length;
+		  continue;
+		}
+	    }
+	}
       else
 	{
-	  // If we see a relocation against an address we have chosen
-	  // to discard, we relocate to zero.  FIXME: We could also
-	  // issue a warning in this case; that would require
-	  // reporting this somehow and checking it in the routines in
-	  // reloc.h.
-	  output_offset = 0;
+	  if (entry.output_offset == Merge_offset_table::UNMAPPED)
+	    continue;
+	  entry.input_offset = table->input_offsets_[i];
+	  entry.length = table->input_offsets_[i + 1] - entry.input_offset;
 	}
-      initialize_map->insert(std::make_pair(p->input_offset, output_offset));
+      entries->push_back(entry);
     }
+
+  std::vector<section_offset_type>().swap(table->input_offsets_);
+  std::vector<section_offset_type>().swap(table->output_offsets_);
+  table->block_size_ = 0;
+  table->end_ = 0;
+  map->sorted = true;
+  map->finalized = false;
 }
 
 // Class Merge_map.
@@ -460,18 +566,33 @@ Output_merge_data::do_print_merge_stats(const char* section_name)
 
 // Class Output_merge_string.
 
-// Add an input section to a merged string section.
+// Delete any pending input sections, which may be left over if
+// there was an error.
+
+template<typename Char_type>
+Output_merge_string<Char_type>::~Output_merge_string()
+{
+  for (typename Pending_sections::iterator p =
+	 this->pending_sections_.begin();
+       p != this->pending_sections_.end();
+       ++p)
+    delete *p;
+}
+
+// Add an input section to a merged string section.  Without threads,
+// the strings are added to the Stringpool here.  With threads, we
+// keep the section contents cached in memory and the strings are
+// added later by a Merge_strings_add_task.
 
 template<typename Char_type>
 bool
 Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 						     unsigned int shndx)
 {
+  const bool pending = parameters->options().threads();
   section_size_type len;
-  const unsigned char* pdata = object->section_contents(shndx, &len, false);
-
-  const Char_type* p = reinterpret_cast<const Char_type*>(pdata);
-  const Char_type* pend = p + len / sizeof(Char_type);
+  const unsigned char* pdata = object->section_contents(shndx, &len,
+							pending);
 
   if (len % sizeof(Char_type) != 0)
     {
@@ -480,41 +601,169 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
       return false;
     }
 
-  size_t count = 0;
+  const Char_type* p = reinterpret_cast<const Char_type*>(pdata);
+  len /= sizeof(Char_type);
+
+  if (len > 0 && p[len - 1] != 0)
+    gold_warning(_("%s: last entry in mergeable string section '%s' "
+		   "not null terminated"),
+		 object->name().c_str(),
+		 object->section_name(shndx).c_str());
+
+  if (pending)
+    {
+      Pending_section* ps = new Pending_section();
+      ps->object = object;
+      ps->shndx = shndx;
+      ps->contents = p;
+      ps->len = len;
+      this->pending_sections_.push_back(ps);
+      return true;
+    }
+
+  Input_strings strings;
+  this->find_strings(p, len, &strings);
+  this->add_strings(object, shndx, p, strings);
+  return true;
+}
+
+// Find the strings in the LEN characters at P.  A last string which
+// is not null terminated runs to the end of the data.
 
-  // The index I is in bytes, not characters.
-  section_size_type i = 0;
-  while (i < len)
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::find_strings(const Char_type* p,
+					     section_size_type len,
+					     Input_strings* strings)
+{
+  const Char_type* const pstart = p;
+  const Char_type* const pend = p + len;
+  while (p < pend)
     {
       const Char_type* pl;
-      for (pl = p; *pl != 0; ++pl)
-	{
-	  if (pl >= pend)
-	    {
-	      gold_warning(_("%s: last entry in mergeable string section '%s' "
-			     "not null terminated"),
-			   object->name().c_str(),
-			   object->section_name(shndx).c_str());
-	      break;
-	    }
-	}
+      for (pl = p; pl < pend && *pl != 0; ++pl)
+	;
+
+      Input_string is;
+      is.offset = (p - pstart) * sizeof(Char_type);
+      is.length = pl - p;
+      is.hash_code = Stringpool_template<Char_type>::hash_string(p, pl - p);
+      strings->push_back(is);
+
+      p = pl + 1;
+    }
+}
+
+// Add the strings STRINGS found in the contents P of an input section
+// to the Stringpool, and remember where they came from.
 
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_strings(Relobj* object,
+					    unsigned int shndx,
+					    const Char_type* p,
+					    const Input_strings& strings)
+{
+  for (typename Input_strings::const_iterator q = strings.begin();
+       q != strings.end();
+       ++q)
+    {
+      const Char_type* s = p + q->offset / sizeof(Char_type);
       Stringpool::Key key;
-      const Char_type* str = this->stringpool_.add_with_length(p, pl - p, true,
-							       &key);
+      const Char_type* str =
+	this->stringpool_.add_with_length_and_hash(s, q->length, q->hash_code,
+						   true, &key);
+
+      section_size_type bytelen_with_null =
+	(q->length + 1) * sizeof(Char_type);
+      this->merged_strings_.push_back(Merged_string(object, shndx, q->offset,
+						    str, bytelen_with_null,
+						    key));
+    }
+
+  this->input_count_ += strings.size();
+}
 
-      section_size_type bytelen_with_null = ((pl - p) + 1) * sizeof(Char_type);
-      this->merged_strings_.push_back(Merged_string(object, shndx, i, str,
-						    bytelen_with_null, key));
+// Queue the tasks to find the strings in the pending input sections
+// and to add them to the Stringpool.  The input sections are divided
+// among Merge_strings_find_tasks by size; a single
+// Merge_strings_add_task then adds the strings in order.
 
-      p = pl + 1;
-      i += bytelen_with_null;
-      ++count;
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::do_queue_merge_tasks(Workqueue* workqueue,
+						     Task_token* blocker)
+{
+  if (this->pending_sections_.empty())
+    return;
+
+  std::vector<std::pair<size_t, size_t> > ranges;
+  size_t begin = 0;
+  section_size_type bytes = 0;
+  for (size_t i = 0; i < this->pending_sections_.size(); ++i)
+    {
+      bytes += this->pending_sections_[i]->len * sizeof(Char_type);
+      if (bytes >= find_task_size)
+	{
+	  ranges.push_back(std::make_pair(begin, i + 1));
+	  begin = i + 1;
+	  bytes = 0;
+	}
     }
+  if (begin < this->pending_sections_.size())
+    ranges.push_back(std::make_pair(begin, this->pending_sections_.size()));
+
+  Task_token* find_blocker = new Task_token(true);
+  for (size_t i = 0; i < ranges.size(); ++i)
+    find_blocker->add_blocker();
+  blocker->add_blocker();
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+    workqueue->queue_soon(new Merge_strings_find_task<Char_type>(
+					this, ranges[i].first,
+					ranges[i].second, find_blocker));
+  workqueue->queue_soon(new Merge_strings_add_task<Char_type>(this,
+							       find_blocker,
+							       blocker));
+}
 
-  this->input_count_ += count;
+// Find the strings in the pending input sections [BEGIN, END).  Each
+// pending section is only looked at by one task.
 
-  return true;
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::find_pending_strings(size_t begin,
+						     size_t end)
+{
+  for (size_t i = begin; i < end; ++i)
+    {
+      Pending_section* ps = this->pending_sections_[i];
+      gold_assert(ps->strings.empty());
+      this->find_strings(ps->contents, ps->len, &ps->strings);
+    }
+}
+
+// Add the strings of all the pending input sections to the
+// Stringpool, in the order in which the sections were added.  If the
+// strings of a section have not been found, because no tasks were
+// queued, find them now.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::add_pending_strings()
+{
+  for (typename Pending_sections::iterator p =
+	 this->pending_sections_.begin();
+       p != this->pending_sections_.end();
+       ++p)
+    {
+      Pending_section* ps = *p;
+      if (ps->strings.empty() && ps->len > 0)
+	this->find_strings(ps->contents, ps->len, &ps->strings);
+      this->add_strings(ps->object, ps->shndx, ps->contents, ps->strings);
+      delete ps;
+    }
+  this->pending_sections_.clear();
 }
 
 // Finalize the mappings from the input sections to the output
@@ -524,6 +773,8 @@ template<typename Char_type>
 section_size_type
 Output_merge_string<Char_type>::finalize_merged_data()
 {
+  this->add_pending_strings();
+
   this->stringpool_.set_string_offsets();
 
   for (typename Merged_strings::const_iterator p =
@@ -626,22 +877,4 @@ class Output_merge_string<uint16_t>;
 template
 class Output_merge_string<uint32_t>;
 
-#if defined(HAVE_TARGET_32_LITTLE) || defined(HAVE_TARGET_32_BIG)
-template
-void
-Object_merge_map::initialize_input_to_output_map<32>(
-    unsigned int shndx,
-    elfcpp::Elf_types<32>::Elf_Addr starting_address,
-    Unordered_map<section_offset_type, elfcpp::Elf_types<32>::Elf_Addr>*);
-#endif
-
-#if defined(HAVE_TARGET_64_LITTLE) || defined(HAVE_TARGET_64_BIG)
-template
-void
-Object_merge_map::initialize_input_to_output_map<64>(
-    unsigned int shndx,
-    elfcpp::Elf_types<64>::Elf_Addr starting_address,
-    Unordered_map<section_offset_type, elfcpp::Elf_types<64>::Elf_Addr>*);
-#endif
-
 } // End namespace gold.
@@ -24,16 +24,95 @@
 #define GOLD_MERGE_H
 
 #include <climits>
+#include <algorithm>
 #include <map>
 #include <vector>
 
 #include "stringpool.h"
 #include "output.h"
+#include "workqueue.h"
 
 namespace gold
 {
 
 class Merge_map;
+class Object_merge_map;
+
+// The final mapping from offsets in one input section with mergeable
+// contents to offsets in the merged data.  Once all the mappings for
+// the section are known, Object_merge_map converts them into this
+// form, which is compact and is searched without any locking, so that
+// relocations may be applied by several tasks at once.
+
+// The mappings are normally stored as a sorted array of input offsets
+// and a parallel array of output offsets; the input offsets array has
+// an additional final entry giving the end of the section.  A hole in
+// the input section is given the output offset UNMAPPED.  When every
+// mapping starts and ends at a multiple of some block size, as is
+// typical for fixed-size constants, the output offsets array is
+// indexed by the input offset divided by that size instead, and the
+// input offsets array is not used.
+
+class Merge_offset_table
+{
+ public:
+  Merge_offset_table()
+    : input_offsets_(), output_offsets_(), block_size_(0), end_(0)
+  { }
+
+  // Return the output offset for INPUT_OFFSET, as for
+  // Object_merge_map::get_output_offset.
+  bool
+  get_output_offset(section_offset_type input_offset,
+		    section_offset_type* output_offset) const
+  {
+    if (input_offset < 0 || input_offset >= this->end_)
+      return false;
+
+    section_offset_type start;
+    section_offset_type out;
+    if (this->block_size_ != 0)
+      {
+	section_size_type i = input_offset / this->block_size_;
+	start = i * this->block_size_;
+	out = this->output_offsets_[i];
+      }
+    else
+      {
+	std::vector<section_offset_type>::const_iterator p =
+	  std::upper_bound(this->input_offsets_.begin(),
+			   this->input_offsets_.end(), input_offset);
+	gold_assert(p != this->input_offsets_.begin());
+	--p;
+	start = *p;
+	out = this->output_offsets_[p - this->input_offsets_.begin()];
+	if (out == UNMAPPED)
+	  return false;
+      }
+
+    if (out != -1)
+      out += input_offset - start;
+    *output_offset = out;
+    return true;
+  }
+
+ private:
+  friend class Object_merge_map;
+
+  // The output offset used for a part of the input section for which
+  // there is no mapping.
+  static const section_offset_type UNMAPPED = -2;
+
+  // The start of each mapping, followed by the end of the section.
+  // This is empty when BLOCK_SIZE_ is not zero.
+  std::vector<section_offset_type> input_offsets_;
+  // The output offset of each mapping, or of each block.
+  std::vector<section_offset_type> output_offsets_;
+  // The size of the blocks of a direct index, or zero.
+  section_size_type block_size_;
+  // The end of the last mapping.
+  section_offset_type end_;
+};
 
 // For each object with merge sections, we store an Object_merge_map.
 // This is used to map locations in input sections to a merged output
@@ -76,16 +155,11 @@ class Object_merge_map
   bool
   is_merge_section_for(const Merge_map*, unsigned int shndx);
 
-  // Initialize an mapping from input offsets to output addresses for
-  // section SHNDX.  STARTING_ADDRESS is the output address of the
-  // merged section.
-  template<int size>
-  void
-  initialize_input_to_output_map(
-      unsigned int shndx,
-      typename elfcpp::Elf_types<size>::Elf_Addr starting_address,
-      Unordered_map<section_offset_type,
-		    typename elfcpp::Elf_types<size>::Elf_Addr>*);
+  // Return the final mappings for section SHNDX.  This is called
+  // before the relocations for the object are applied, since after
+  // that the mappings may be read by several tasks at once.
+  const Merge_offset_table*
+  offset_table(unsigned int shndx);
 
  private:
   // Map input section offsets to a length and an output section
@@ -134,13 +208,18 @@ class Object_merge_map
     // we don't have it, rather than trying a lookup and returning an
     // answer which will receive the wrong offset.
     const Merge_map* merge_map;
-    // The list of mappings.
+    // The list of mappings, while they are being added.  This is
+    // cleared when TABLE is built.
     Entries entries;
     // Whether the ENTRIES field is sorted by input_offset.
     bool sorted;
+    // Whether TABLE has been built.
+    bool finalized;
+    // The final mappings.
+    Merge_offset_table table;
 
     Input_merge_map()
-      : merge_map(NULL), entries(), sorted(true)
+      : merge_map(NULL), entries(), sorted(true), finalized(false), table()
     { }
   };
 
@@ -157,6 +236,14 @@ class Object_merge_map
   Input_merge_map*
   get_or_make_input_merge_map(const Merge_map* merge_map, unsigned int shndx);
 
+  // Build the Merge_offset_table for MAP from its entries.
+  static void
+  finalize_input_merge_map(Input_merge_map* map);
+
+  // Convert the Merge_offset_table for MAP back into entries.
+  static void
+  unfinalize_input_merge_map(Input_merge_map* map);
+
   // Any given object file will normally only have a couple of input
   // sections with mergeable contents.  So we keep the first two input
   // section numbers inline, and push any further ones into a map.  A
@@ -377,17 +464,33 @@ class Output_merge_string : public Output_merge_base
  public:
   Output_merge_string(uint64_t addralign)
     : Output_merge_base(sizeof(Char_type), addralign), stringpool_(),
-      merged_strings_(), input_count_(0)
+      merged_strings_(), pending_sections_(), input_count_(0)
   {
     gold_assert(addralign <= sizeof(Char_type));
     this->stringpool_.set_no_zero_null();
   }
 
+  ~Output_merge_string();
+
+  // Find the strings in the pending input sections [BEGIN, END).
+  // This is called by a Merge_strings_find_task.
+  void
+  find_pending_strings(size_t begin, size_t end);
+
+  // Add the strings of all the pending input sections to the
+  // Stringpool.  This is called by a Merge_strings_add_task.
+  void
+  add_pending_strings();
+
  protected:
   // Add an input section.
   bool
   do_add_input_section(Relobj* object, unsigned int shndx);
 
+  // Queue tasks to add the strings of the pending input sections.
+  void
+  do_queue_merge_tasks(Workqueue*, Task_token*);
+
   // Do all the final processing after the input sections are read in.
   // Returns the final data size.
   section_size_type
@@ -456,15 +559,155 @@ class Output_merge_string : public Output_merge_base
 
   typedef std::vector<Merged_string> Merged_strings;
 
+  // A string found in an input section, before it is added to the
+  // Stringpool.
+  struct Input_string
+  {
+    // The offset in the input section, in bytes.
+    section_offset_type offset;
+    // The length of the string in characters, not including the null
+    // terminator.
+    size_t length;
+    // The hash code of the string, as computed by the Stringpool.
+    size_t hash_code;
+  };
+
+  typedef std::vector<Input_string> Input_strings;
+
+  // When running with threads, the input sections are not split into
+  // strings as they are added.  Instead we keep a pointer to their
+  // contents, which are read with a cached view so that they stay in
+  // memory until the section is finalized, and the strings are found
+  // and added to the Stringpool by tasks which run in parallel with
+  // other work.
+  struct Pending_section
+  {
+    // The input object.
+    Relobj* object;
+    // The input section in the input object.
+    unsigned int shndx;
+    // The contents of the input section.
+    const Char_type* contents;
+    // The length of the contents in characters.
+    section_size_type len;
+    // The strings found in the contents.
+    Input_strings strings;
+  };
+
+  typedef std::vector<Pending_section*> Pending_sections;
+
+  // The amount of pending input section data to give to each
+  // Merge_strings_find_task, in bytes.
+  static const section_size_type find_task_size = 1024 * 1024;
+
+  // Find the strings in the LEN characters at P, and add them to
+  // *STRINGS.
+  void
+  find_strings(const Char_type* p, section_size_type len,
+	       Input_strings* strings);
+
+  // Add the strings STRINGS found at P in section SHNDX of OBJECT to
+  // the Stringpool.
+  void
+  add_strings(Relobj* object, unsigned int shndx, const Char_type* p,
+	      const Input_strings& strings);
+
   // As we see the strings, we add them to a Stringpool.
   Stringpool_template<Char_type> stringpool_;
   // Map from a location in an input object to an entry in the
   // Stringpool.
   Merged_strings merged_strings_;
+  // The input sections whose strings have not yet been added to the
+  // Stringpool.
+  Pending_sections pending_sections_;
   // The number of entries seen in input files.
   size_t input_count_;
 };
 
+// This task finds the strings in some of the pending input sections
+// of a merged string section.
+
+template<typename Char_type>
+class Merge_strings_find_task : public Task
+{
+ public:
+  // BLOCKER is unblocked when the task is done.
+  Merge_strings_find_task(Output_merge_string<Char_type>* posd,
+			  size_t begin, size_t end, Task_token* blocker)
+    : posd_(posd), begin_(begin), end_(end), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->posd_->find_pending_strings(this->begin_, this->end_); }
+
+  std::string
+  get_name() const
+  { return "Merge_strings_find_task"; }
+
+ private:
+  Output_merge_string<Char_type>* posd_;
+  size_t begin_;
+  size_t end_;
+  Task_token* blocker_;
+};
+
+// This task adds the strings found by the Merge_strings_find_tasks to
+// the Stringpool of a merged string section, in the order in which
+// the input sections were seen, so that the result does not depend
+// on the order in which the tasks run.
+
+template<typename Char_type>
+class Merge_strings_add_task : public Task
+{
+ public:
+  // This runs when FIND_BLOCKER is unblocked, and unblocks BLOCKER.
+  Merge_strings_add_task(Output_merge_string<Char_type>* posd,
+			 Task_token* find_blocker, Task_token* blocker)
+    : posd_(posd), find_blocker_(find_blocker), blocker_(blocker)
+  { }
+
+  ~Merge_strings_add_task()
+  { delete this->find_blocker_; }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->find_blocker_->is_blocked())
+      return this->find_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->posd_->add_pending_strings(); }
+
+  std::string
+  get_name() const
+  { return "Merge_strings_add_task"; }
+
+ private:
+  Output_merge_string<Char_type>* posd_;
+  Task_token* find_blocker_;
+  Task_token* blocker_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_MERGE_H)
@@ -39,6 +39,7 @@
 #include "object.h"
 #include "dynobj.h"
 #include "plugin.h"
+#include "ehframe.h"
 
 namespace gold
 {
@@ -317,6 +318,17 @@ Relobj::is_section_name_included(const char* name)
   return false;
 }
 
+// Drop the pages of the input file used by this object from the page
+// cache when the object is released.  The object must be locked.
+
+void
+Relobj::release_input_pages()
+{
+  if (this->input_extent_ > 0)
+    this->input_file()->file().release_pages(this->offset(),
+					     this->input_extent_);
+}
+
 // Class Sized_relobj.
 
 template<int size, bool big_endian>
@@ -338,14 +350,18 @@ Sized_relobj<size, big_endian>::Sized_relobj(
     local_values_(),
     local_got_offsets_(),
     kept_comdat_sections_(),
+    split_relocate_(NULL),
     has_eh_frame_(false),
-    discarded_eh_frame_shndx_(-1U)
+    discarded_eh_frame_shndx_(-1U),
+    parsed_eh_frame_(NULL),
+    parsed_eh_frame_shndx_(0)
 {
 }
 
 template<int size, bool big_endian>
 Sized_relobj<size, big_endian>::~Sized_relobj()
 {
+  delete this->parsed_eh_frame_;
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -440,11 +456,11 @@ Sized_relobj<size, big_endian>::check_eh_frame_flags(
 	  && (shdr->get_sh_flags() & elfcpp::SHF_ALLOC) != 0);
 }
 
-// Return whether there is a GNU .eh_frame section, given the section
-// headers and the section names.
+// Return the index of the first GNU .eh_frame section, or 0 if there
+// is none, given the section headers and the section names.
 
 template<int size, bool big_endian>
-bool
+unsigned int
 Sized_relobj<size, big_endian>::find_eh_frame(
     const unsigned char* pshdrs,
     const char* names,
@@ -466,10 +482,67 @@ Sized_relobj<size, big_endian>::find_eh_frame(
 
 	  const char* name = names + shdr.get_sh_name();
 	  if (strcmp(name, ".eh_frame") == 0)
-	    return true;
+	    return i;
 	}
     }
-  return false;
+  return 0;
+}
+
+// Tell the system which parts of the input file we are going to read,
+// now that we know the section headers, so that the data is already
+// in memory when we want it.  We skip debugging sections which will
+// be stripped, and their relocations.  This also records how much of
+// the file the object uses, for release_input_pages.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::readahead_sections(
+    const unsigned char* pshdrs,
+    const char* names,
+    section_size_type names_size)
+{
+  const unsigned int shnum = this->shnum();
+  const bool strip_debug = parameters->options().strip_debug();
+  off_t extent = this->elf_file_.shoff() + shnum * This::shdr_size;
+  File_read::Readahead ra;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      if (shdr.get_sh_type() == elfcpp::SHT_NOBITS
+	  || shdr.get_sh_size() == 0)
+	continue;
+
+      off_t sh_offset = shdr.get_sh_offset();
+      off_t sh_size = shdr.get_sh_size();
+      if (sh_offset + sh_size > extent)
+	extent = sh_offset + sh_size;
+
+      if (strip_debug)
+	{
+	  unsigned int data_shndx = i;
+	  if (shdr.get_sh_type() == elfcpp::SHT_REL
+	      || shdr.get_sh_type() == elfcpp::SHT_RELA)
+	    data_shndx = this->adjust_shndx(shdr.get_sh_info());
+	  if (data_shndx < shnum)
+	    {
+	      typename This::Shdr data_shdr(pshdrs
+					    + data_shndx * This::shdr_size);
+	      if ((data_shdr.get_sh_flags() & elfcpp::SHF_ALLOC) == 0
+		  && data_shdr.get_sh_name() < names_size
+		  && is_prefix_of(".debug",
+				  names + data_shdr.get_sh_name()))
+		continue;
+	    }
+	}
+
+      ra.push_back(File_read::Readahead_entry(sh_offset, sh_size));
+    }
+
+  if (parameters->options().readahead())
+    this->input_file()->file().readahead(this->offset(), &ra);
+  if (parameters->options().release_input_pages())
+    this->set_input_extent(extent);
 }
 
 // Read the sections and symbols from an object file.
@@ -486,17 +559,26 @@ Sized_relobj<size, big_endian>::do_read_symbols(Read_symbols_data* sd)
 
   const unsigned char* namesu = sd->section_names->data();
   const char* names = reinterpret_cast<const char*>(namesu);
+  unsigned int eh_frame_shndx = 0;
   if (memmem(names, sd->section_names_size, ".eh_frame", 10) != NULL)
     {
-      if (this->find_eh_frame(pshdrs, names, sd->section_names_size))
+      eh_frame_shndx = this->find_eh_frame(pshdrs, names,
+					   sd->section_names_size);
+      if (eh_frame_shndx != 0)
         this->has_eh_frame_ = true;
     }
 
+  if (parameters->options().readahead()
+      || parameters->options().release_input_pages())
+    this->readahead_sections(pshdrs, names, sd->section_names_size);
+
   sd->symbols = NULL;
   sd->symbols_size = 0;
   sd->external_symbols_offset = 0;
   sd->symbol_names = NULL;
   sd->symbol_names_size = 0;
+  sd->allow_shard_adder = false;
+  sd->shard_adder = NULL;
 
   if (this->symtab_shndx_ == 0)
     {
@@ -564,6 +646,108 @@ Sized_relobj<size, big_endian>::do_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+  this->hash_symbol_names(sd);
+
+  if (eh_frame_shndx != 0)
+    this->read_eh_frame(sd, eh_frame_shndx);
+}
+
+// Read the .eh_frame section SHNDX, so that the work can be done
+// here, in parallel with other input files, rather than when laying
+// out the sections, which is done for one input file at a time.  The
+// result is picked up by Eh_frame::add_ehframe_input_section.  If
+// there is more than one .eh_frame section, the others are read then.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::read_eh_frame(Read_symbols_data* sd,
+					      unsigned int shndx)
+{
+  if (parameters->options().relocatable()
+      || this->input_file()->just_symbols()
+      || sd->symbols == NULL)
+    return;
+
+  // Find the reloc section, as do_layout does.
+  const unsigned int shnum = this->shnum();
+  unsigned int reloc_shndx = 0;
+  unsigned int reloc_type = elfcpp::SHT_NULL;
+  const unsigned char* p = sd->section_headers->data() + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if ((sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	  && this->adjust_shndx(shdr.get_sh_info()) == shndx)
+	{
+	  if (reloc_shndx != 0)
+	    reloc_shndx = -1U;
+	  else
+	    {
+	      reloc_shndx = i;
+	      reloc_type = sh_type;
+	    }
+	}
+    }
+
+  this->parsed_eh_frame_ =
+    Eh_frame::parse_ehframe_input_section(this,
+					  sd->symbols->data(),
+					  sd->symbols_size,
+					  sd->symbol_names->data(),
+					  sd->symbol_names_size,
+					  shndx, reloc_shndx, reloc_type);
+  if (this->parsed_eh_frame_ != NULL)
+    this->parsed_eh_frame_shndx_ = shndx;
+}
+
+// Compute the hash code of the name of the symbol at P into *PSNH.
+// In an object file an '@' in the name starts the version, which is
+// not part of the hash.
+
+template<int size, bool big_endian>
+static void
+hash_symbol_name(const unsigned char* p, const char* sym_names,
+		 section_size_type sym_names_size, Symbol_name_hash* psnh)
+{
+  elfcpp::Sym<size, big_endian> sym(p);
+  unsigned int st_name = sym.get_st_name();
+  if (st_name >= sym_names_size)
+    {
+      // add_symbols will report the error.
+      psnh->hash_code = 0;
+      psnh->length = 0;
+      return;
+    }
+  const char* name = sym_names + st_name;
+  const char* ver = strchr(name, '@');
+  size_t len = ver != NULL ? ver - name : strlen(name);
+  psnh->hash_code = Stringpool::hash_string(name, len);
+  psnh->length = len;
+}
+
+// Compute the hash codes of the external symbol names, so that the
+// work can be done here, in parallel with other input files, rather
+// than when adding the symbols to the symbol table, which is done
+// for one input file at a time.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::hash_symbol_names(Read_symbols_data* sd)
+{
+  const int sym_size = This::sym_size;
+  size_t symcount = ((sd->symbols_size - sd->external_symbols_offset)
+		     / sym_size);
+  const unsigned char* p = (sd->symbols->data()
+			    + sd->external_symbols_offset);
+  const char* sym_names =
+    reinterpret_cast<const char*>(sd->symbol_names->data());
+
+  sd->symbol_name_hashes.resize(symcount);
+  for (size_t i = 0; i < symcount; ++i, p += sym_size)
+    hash_symbol_name<size, big_endian>(p, sym_names, sd->symbol_names_size,
+				       &sd->symbol_name_hashes[i]);
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1446,12 +1630,39 @@ Sized_relobj<size, big_endian>::do_add_symbols(Symbol_table* symtab,
 
   this->symbols_.resize(symcount);
 
+  const unsigned char* syms = (sd->symbols->data()
+			       + sd->external_symbols_offset);
   const char* sym_names =
     reinterpret_cast<const char*>(sd->symbol_names->data());
-  symtab->add_from_relobj(this,
-			  sd->symbols->data() + sd->external_symbols_offset,
-			  symcount, this->local_symbol_count_,
-			  sym_names, sd->symbol_names_size,
+
+  if (sd->allow_shard_adder)
+    {
+      Symbol_shard_adder* adder =
+	symtab->make_relobj_shard_adder(this, syms, symcount,
+					this->local_symbol_count_,
+					sym_names, sd->symbol_names_size,
+					&sd->symbol_name_hashes,
+					&this->symbols_,
+					&this->defined_count_);
+      if (adder != NULL)
+	{
+	  // The symbols will be added later, so the adder keeps the
+	  // views of the symbol data.
+	  adder->hold_view(sd->symbols);
+	  sd->symbols = NULL;
+	  adder->hold_view(sd->symbol_names);
+	  sd->symbol_names = NULL;
+	  sd->shard_adder = adder;
+	  return;
+	}
+    }
+
+  const Symbol_name_hash* name_hashes = NULL;
+  if (symcount > 0 && sd->symbol_name_hashes.size() == symcount)
+    name_hashes = &sd->symbol_name_hashes[0];
+
+  symtab->add_from_relobj(this, syms, symcount, this->local_symbol_count_,
+			  sym_names, sd->symbol_names_size, name_hashes,
 			  &this->symbols_,
 			  &this->defined_count_);
 
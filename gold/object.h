@@ -45,12 +45,31 @@ class Output_symtab_xindex;
 class Pluginobj;
 class Dynobj;
 class Object_merge_map;
+class Merge_offset_table;
+class Parsed_eh_frame;
 class Relocatable_relocs;
 class Symbols_data;
+class Symbol_shard_adder;
+class Symbol;
 
 template<typename Stringpool_char>
 class Stringpool_template;
 
+// The hash code and length of the name of an external symbol, not
+// including any version.  These are computed when the symbols are
+// read, which happens in parallel for different input files, so that
+// adding the symbols to the symbol table does not need to scan the
+// names again.
+
+struct Symbol_name_hash
+{
+  // The hash code of the name, as computed by
+  // Stringpool::hash_string.
+  size_t hash_code;
+  // The length of the name, not counting any version.
+  unsigned int length;
+};
+
 // Data to pass from read_symbols() to add_symbols().
 
 struct Read_symbols_data
@@ -73,6 +92,17 @@ struct Read_symbols_data
   File_view* symbol_names;
   // Size of symbol name data in bytes.
   section_size_type symbol_names_size;
+  // Hash codes of the external symbol names, one per external symbol.
+  // This is empty if the hash codes were not computed.
+  std::vector<Symbol_name_hash> symbol_name_hashes;
+  // Whether add_symbols may hand back the work of adding the external
+  // symbols of a relocatable object in SHARD_ADDER, rather than adding
+  // them itself.
+  bool allow_shard_adder;
+  // If add_symbols handed back the work of adding the symbols, this is
+  // it.  The caller must run it for each shard of the symbol table and
+  // then delete it.
+  Symbol_shard_adder* shard_adder;
 
   // Version information.  This is only used on dynamic objects.
   // Version symbol data (from SHT_GNU_versym section).
@@ -97,6 +127,36 @@ struct Symbol_location_info
   int line_number;
 };
 
+// An error or warning found while applying a relocation, which is
+// reported later.  When the relocations of an object are applied by
+// several tasks at once, those tasks may not read the input file,
+// which is needed to describe the location of the relocation.
+
+struct Deferred_reloc_diagnostic
+{
+  enum Kind
+  {
+    DEFERRED_ERROR,
+    DEFERRED_WARNING,
+    DEFERRED_UNDEFINED_SYMBOL
+  };
+
+  Kind kind;
+  // Section index of relocation section.
+  unsigned int reloc_shndx;
+  // Section index of section being relocated.
+  unsigned int data_shndx;
+  // The relocation number and offset, as passed to the error routine.
+  size_t relnum;
+  off_t reloffset;
+  // The text of an error or warning.
+  std::string message;
+  // The undefined symbol.
+  const Symbol* sym;
+};
+
+typedef std::vector<Deferred_reloc_diagnostic> Deferred_reloc_diagnostics;
+
 // Data about a single relocation section.  This is read in
 // read_relocs and processed in scan_relocs.
 
@@ -627,7 +687,7 @@ class Relobj : public Object
       map_to_relocatable_relocs_(NULL),
       object_merge_map_(NULL),
       relocs_must_follow_section_writes_(false),
-      sd_(NULL)
+      input_extent_(0), sd_(NULL)
   { }
 
   // During garbage collection, the Read_symbols_data pass for 
@@ -718,6 +778,36 @@ class Relobj : public Object
 	   const Layout* layout, Output_file* of)
   { return this->do_relocate(options, symtab, layout, of); }
 
+  // Prepare to apply the relocations of a large object in several
+  // tasks.  This returns the number of tasks, each of which should
+  // call relocate_group; when they are all done, relocate_finish
+  // writes out the sections and the local symbols.  This returns 0
+  // if the object should simply be relocated with relocate.
+  unsigned int
+  relocate_split(const General_options& options, const Symbol_table* symtab,
+		 const Layout* layout, Output_file* of)
+  { return this->do_relocate_split(options, symtab, layout, of); }
+
+  // Apply the relocations in group GROUP, as set up by
+  // relocate_split.  This may run at the same time as other groups
+  // of the same object, and without the object being locked.
+  void
+  relocate_group(const General_options& options, const Symbol_table* symtab,
+		 const Layout* layout, unsigned int group)
+  { this->do_relocate_group(options, symtab, layout, group); }
+
+  // Finish relocating an object set up by relocate_split.
+  void
+  relocate_finish(const Layout* layout, Output_file* of)
+  { this->do_relocate_finish(layout, of); }
+
+  // Tell the system that we will not read the input file for this
+  // object again.  This is called after the object has been
+  // relocated, before it is released; the pages are dropped when it
+  // is released.  This only does anything for --release-input-pages.
+  void
+  release_input_pages();
+
   // Return whether an input section is being included in the link.
   bool
   is_section_included(unsigned int shndx) const
@@ -840,6 +930,21 @@ class Relobj : public Object
   do_relocate(const General_options& options, const Symbol_table* symtab,
 	      const Layout*, Output_file* of) = 0;
 
+  // Split the relocation of the object among several
+  // tasks--implemented by child class.
+  virtual unsigned int
+  do_relocate_split(const General_options& options, const Symbol_table*,
+		    const Layout*, Output_file* of) = 0;
+
+  // Apply the relocations of one group--implemented by child class.
+  virtual void
+  do_relocate_group(const General_options& options, const Symbol_table*,
+		    const Layout*, unsigned int group) = 0;
+
+  // Finish a split relocation--implemented by child class.
+  virtual void
+  do_relocate_finish(const Layout*, Output_file* of) = 0;
+
   // Get the offset of a section--implemented by child class.
   virtual uint64_t
   do_output_section_offset(unsigned int shndx) const = 0;
@@ -876,6 +981,12 @@ class Relobj : public Object
   set_relocs_must_follow_section_writes()
   { this->relocs_must_follow_section_writes_ = true; }
 
+  // Record the size of the part of the input file used by this
+  // object, for release_input_pages.
+  void
+  set_input_extent(off_t extent)
+  { this->input_extent_ = extent; }
+
  private:
   // Mapping from input sections to output section.
   Output_sections output_sections_;
@@ -888,6 +999,9 @@ class Relobj : public Object
   // Whether we need to wait for output sections to be written before
   // we can apply relocations.
   bool relocs_must_follow_section_writes_;
+  // The size of the part of the input file used by this object, or
+  // zero if we are not going to release its pages.
+  off_t input_extent_;
   // Used to store the relocs data computed by the Read_relocs pass. 
   // Used during garbage collection of unused sections.
   Read_relocs_data* rd_;
@@ -912,23 +1026,20 @@ class Merged_symbol_value
  public:
   typedef typename elfcpp::Elf_types<size>::Elf_Addr Value;
 
-  // We use a hash table to map offsets in the input section to output
-  // addresses.
-  typedef Unordered_map<section_offset_type, Value> Output_addresses;
-
   Merged_symbol_value(Value input_value, Value output_start_address)
     : input_value_(input_value), output_start_address_(output_start_address),
-      output_addresses_()
+      offset_table_(NULL)
   { }
 
-  // Initialize the hash table.
+  // Look up the final mappings for the section, for use while
+  // relocating the object.
   void
   initialize_input_to_output_map(const Relobj*, unsigned int input_shndx);
 
-  // Release the hash table to save space.
+  // Forget the final mappings.
   void
   free_input_to_output_map()
-  { this->output_addresses_.clear(); }
+  { this->offset_table_ = NULL; }
 
   // Get the output value corresponding to an addend.  The object and
   // input section index are passed in because the caller will have
@@ -959,18 +1070,12 @@ class Merged_symbol_value
 	input_offset += addend;
 	addend = 0;
       }
-    typename Output_addresses::const_iterator p =
-      this->output_addresses_.find(input_offset);
-    if (p != this->output_addresses_.end())
-      return p->second + addend;
-
     return (this->value_from_output_section(object, input_shndx, input_offset)
 	    + addend);
   }
 
  private:
-  // Get the output value for an input offset if we couldn't find it
-  // in the hash table.
+  // Get the output value for an input offset.
   Value
   value_from_output_section(const Relobj*, unsigned int input_shndx,
 			    Value input_offset) const;
@@ -980,9 +1085,10 @@ class Merged_symbol_value
   Value input_value_;
   // The start address of this merged section in the output file.
   Value output_start_address_;
-  // A hash table which maps offsets in the input section to output
-  // addresses.  This only maps specific offsets, not all offsets.
-  Output_addresses output_addresses_;
+  // The mappings from offsets in the input section to offsets in the
+  // merged data, while the object is being relocated.  Otherwise
+  // this is NULL, and we look up the mappings in the object.
+  const Merge_offset_table* offset_table_;
 };
 
 // This POD class is holds the value of a symbol.  This is used for
@@ -1315,6 +1421,20 @@ class Sized_relobj : public Relobj
   void
   setup(const typename elfcpp::Ehdr<size, big_endian>&);
 
+  // If the .eh_frame section SHNDX was read when reading the symbols,
+  // return the result and forget it; the caller must delete it.
+  // Otherwise return NULL.
+  Parsed_eh_frame*
+  release_parsed_eh_frame(unsigned int shndx)
+  {
+    if (shndx != this->parsed_eh_frame_shndx_)
+      return NULL;
+    Parsed_eh_frame* ret = this->parsed_eh_frame_;
+    this->parsed_eh_frame_ = NULL;
+    this->parsed_eh_frame_shndx_ = 0;
+    return ret;
+  }
+
   // Return the number of symbols.  This is only valid after
   // Object::add_symbols has been called.
   unsigned int
@@ -1516,15 +1636,35 @@ class Sized_relobj : public Relobj
   do_relocate(const General_options& options, const Symbol_table* symtab,
 	      const Layout*, Output_file* of);
 
+  // Split the relocation of the object among several tasks.
+  unsigned int
+  do_relocate_split(const General_options& options, const Symbol_table*,
+		    const Layout*, Output_file* of);
+
+  // Apply the relocations of one group.
+  void
+  do_relocate_group(const General_options& options, const Symbol_table*,
+		    const Layout*, unsigned int group);
+
+  // Finish a split relocation.
+  void
+  do_relocate_finish(const Layout*, Output_file* of);
+
   // Get the size of a section.
   uint64_t
   do_section_size(unsigned int shndx)
   { return this->elf_file_.section_size(shndx); }
 
-  // Get the name of a section.
+  // Get the name of a section.  While the relocations are split
+  // among several tasks, which may not read the input file, we use
+  // the names read beforehand.
   std::string
   do_section_name(unsigned int shndx)
-  { return this->elf_file_.section_name(shndx); }
+  {
+    if (this->split_relocate_ != NULL)
+      return this->split_relocate_->section_names[shndx];
+    return this->elf_file_.section_name(shndx);
+  }
 
   // Return the location of the contents of a section.
   Object::Location
@@ -1625,17 +1765,31 @@ class Sized_relobj : public Relobj
   void
   find_symtab(const unsigned char* pshdrs);
 
+  // Compute the hash codes of the external symbol names.
+  void
+  hash_symbol_names(Read_symbols_data*);
+
   // Return whether SHDR has the right flags for a GNU style exception
   // frame section.
   bool
   check_eh_frame_flags(const elfcpp::Shdr<size, big_endian>* shdr) const;
 
-  // Return whether there is a section named .eh_frame which might be
-  // a GNU style exception frame section.
-  bool
+  // Return the index of the first section named .eh_frame which
+  // might be a GNU style exception frame section, or 0 if there is
+  // none.
+  unsigned int
   find_eh_frame(const unsigned char* pshdrs, const char* names,
 		section_size_type names_size) const;
 
+  // Read the .eh_frame section SHNDX.
+  void
+  read_eh_frame(Read_symbols_data*, unsigned int shndx);
+
+  // Request readahead of the sections which will be read.
+  void
+  readahead_sections(const unsigned char* pshdrs, const char* names,
+		     section_size_type names_size);
+
   // Whether to include a section group in the link.
   bool
   include_section_group(Symbol_table*, Layout*, unsigned int, const char*,
@@ -1671,10 +1825,50 @@ class Sized_relobj : public Relobj
   void
   write_sections(const unsigned char* pshdrs, Output_file*, Views*);
 
-  // Relocate the sections in the output file.
+  // When the relocations of a large object are split among several
+  // tasks, this holds the information which they share.
+  struct Split_relocate
+  {
+    // The section headers.
+    const unsigned char* pshdrs;
+    // The views of the output file.
+    Views views;
+    // The contents of each relocation section, indexed by section
+    // index.
+    std::vector<const unsigned char*> prelocs;
+    // The views of the input file which hold the section headers and
+    // PRELOCS, locked so that they remain valid.
+    std::vector<File_view*> file_views;
+    // Group N handles the relocation sections with indexes from
+    // GROUP_STARTS[N] up to, but not including, GROUP_STARTS[N + 1].
+    std::vector<unsigned int> group_starts;
+    // The names of the sections, indexed by section index.
+    std::vector<std::string> section_names;
+    // The errors and warnings found by each group, which are reported
+    // once the object is locked again.
+    std::vector<Deferred_reloc_diagnostics> diagnostics;
+  };
+
+  // Relocate the sections in the output file.  This handles the
+  // relocation sections with indexes from FIRST up to, but not
+  // including, LAST.  If PRELOCS is not NULL, it holds the contents
+  // of the relocation sections, which are otherwise read from the
+  // input file.  DEFERRED is as in Relocate_info.
   void
   relocate_sections(const General_options& options, const Symbol_table*,
-		    const Layout*, const unsigned char* pshdrs, Views*);
+		    const Layout*, const unsigned char* pshdrs, Views*,
+		    unsigned int first, unsigned int last,
+		    const std::vector<const unsigned char*>* prelocs,
+		    Deferred_reloc_diagnostics* deferred);
+
+  // Report the errors and warnings saved by the groups of a split
+  // relocation.
+  void
+  report_deferred_diagnostics(const Layout*);
+
+  // Write out the views after relocation.
+  void
+  write_views(Output_file*, const Views&);
 
   // Scan the input relocations for --emit-relocs.
   void
@@ -1730,14 +1924,6 @@ class Sized_relobj : public Relobj
 		      Output_symtab_xindex*,
 		      Output_symtab_xindex*);
 
-  // Clear the local symbol information.
-  void
-  clear_local_symbols()
-  {
-    this->local_values_.clear();
-    this->local_got_offsets_.clear();
-  }
-
   // Record a mapping from discarded section SHNDX to the corresponding
   // kept section.
   void
@@ -1831,11 +2017,18 @@ class Sized_relobj : public Relobj
   std::vector<Address> section_offsets_;
   // Table mapping discarded comdat sections to corresponding kept sections.
   Kept_comdat_section_table kept_comdat_sections_;
+  // Information used while the relocations are split among several
+  // tasks; NULL at other times.
+  Split_relocate* split_relocate_;
   // Whether this object has a GNU style .eh_frame section.
   bool has_eh_frame_;
   // If this object has a GNU style .eh_frame section that is discarded in
   // output, record the index here.  Otherwise it is -1U.
   unsigned int discarded_eh_frame_shndx_;
+  // The .eh_frame section read by read_eh_frame, which has not yet
+  // been laid out, and its index.  The index is 0 if there is none.
+  Parsed_eh_frame* parsed_eh_frame_;
+  unsigned int parsed_eh_frame_shndx_;
   // The list of sections whose layout was deferred.
   std::vector<Deferred_layout> deferred_layout_;
 };
@@ -1946,6 +2139,11 @@ struct Relocate_info
   unsigned int reloc_shndx;
   // Section index of section being relocated.
   unsigned int data_shndx;
+  // If not NULL, errors and warnings at relocation locations are
+  // saved here rather than reported, because the input file may not
+  // be read.  This is used when the relocations of an object are
+  // applied by several tasks at once.
+  Deferred_reloc_diagnostics* deferred;
 
   // Return a string showing the location of a relocation.  This is
   // only used for error messages.
@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "elfcpp.h"
+#include "fileread.h"
 #include "script.h"
 
 namespace gold
@@ -599,7 +600,8 @@ class General_options
 	      N_("Bind defined function symbols locally"), NULL);
 
   DEFINE_optional_string(build_id, options::TWO_DASHES, '\0', "sha1",
-			 N_("Generate build ID note"),
+			 N_("Generate build ID note; STYLE is md5, sha1, "
+			    "tree, uuid, or 0xHEX"),
 			 N_("[=STYLE]"));
 
   DEFINE_bool(check_sections, options::TWO_DASHES, '\0', true,
@@ -609,8 +611,8 @@ class General_options
 #ifdef HAVE_ZLIB_H
   DEFINE_enum(compress_debug_sections, options::TWO_DASHES, '\0', "none",
               N_("Compress .debug_* sections in the output file"),
-              ("[none,zlib]"),
-              {"none", "zlib"});
+              ("[none,zlib,zlib-fast]"),
+              {"none", "zlib", "zlib-fast"});
 #else
   DEFINE_enum(compress_debug_sections, options::TWO_DASHES, '\0', "none",
               N_("Compress .debug_* sections in the output file"),
@@ -774,6 +776,18 @@ class General_options
   DEFINE_bool(relax, options::TWO_DASHES, '\0', false,
 	      N_("Relax branches on certain targets"), NULL);
 
+  DEFINE_bool(readahead, options::TWO_DASHES, '\0', false,
+	      N_("Read ahead the input sections which will be used"),
+	      N_("Do not read ahead input files (default)"));
+
+  DEFINE_bool(release_input_pages, options::TWO_DASHES, '\0', false,
+	      N_("Drop input file pages from the page cache when done"),
+	      N_("Leave input file pages in the page cache (default)"));
+
+  DEFINE_bool(stream_output, options::TWO_DASHES, '\0', false,
+	      N_("Write the output file as each part of it is finished"),
+	      N_("Map the whole output file into memory (default)"));
+
   // -R really means -rpath, but can mean --just-symbols for
   // compatibility with GNU ld.  -rpath is always -rpath, so we list
   // it separately.
@@ -787,6 +801,10 @@ class General_options
                  N_("Add DIR to link time shared library search path"),
                  N_("DIR"));
 
+  DEFINE_string(section_ordering_file, options::TWO_DASHES, '\0', NULL,
+                N_("Place input sections in the order listed in FILE"),
+                N_("FILE"));
+
   DEFINE_bool(strip_all, options::TWO_DASHES, 's', false,
               N_("Strip all symbols"), NULL);
   DEFINE_bool(strip_debug, options::TWO_DASHES, 'S', false,
@@ -880,6 +898,11 @@ class General_options
               N_("Include all archive contents"),
               N_("Include only needed archive contents"));
 
+  DEFINE_string(workqueue_trace, options::TWO_DASHES, '\0', NULL,
+                N_("Write a timeline of linker tasks to FILE in Chrome "
+                   "trace format"),
+                N_("FILE"));
+
   DEFINE_set(wrap, options::TWO_DASHES, '\0',
 	     N_("Use wrapper functions for SYMBOL"), N_("SYMBOL"));
 
@@ -941,6 +964,9 @@ class General_options
   DEFINE_bool(origin, options::DASH_Z, '\0', false,
 	      N_("Mark DSO to indicate that needs immediate $ORIGIN "
                  "processing at runtime"), NULL);
+  DEFINE_bool(pack_relative_relocs, options::DASH_Z, '\0', false,
+	      N_("Pack relative relocations into a .relr.dyn section"),
+	      N_("Do not pack relative relocations"));
   DEFINE_bool(relro, options::DASH_Z, '\0', false,
 	      N_("Where possible mark variables read-only after relocation"),
 	      N_("Don't mark variables read-only after relocation"));
@@ -1471,6 +1497,34 @@ class Command_line
   end() const
   { return this->inputs_.end(); }
 
+  // A file read while processing the options, such as a script given
+  // with -T or --version-script, with its modification time and size
+  // when it was opened.
+  struct Option_file
+  {
+    Option_file(const std::string& a_name, const Timespec& a_mtime,
+                off_t a_size)
+      : name(a_name), mtime(a_mtime), size(a_size)
+    { }
+
+    std::string name;
+    Timespec mtime;
+    off_t size;
+  };
+
+  typedef std::vector<Option_file> Option_files;
+
+  // Record that the file NAME was read while processing the options.
+  void
+  add_option_file(const std::string& name, const Timespec& mtime,
+                  off_t size)
+  { this->option_files_.push_back(Option_file(name, mtime, size)); }
+
+  // The files read while processing the options.
+  const Option_files&
+  option_files() const
+  { return this->option_files_; }
+
  private:
   Command_line(const Command_line&);
   Command_line& operator=(const Command_line&);
@@ -1479,6 +1533,7 @@ class Command_line
   Position_dependent_options position_options_;
   Script_options script_options_;
   Input_arguments inputs_;
+  Option_files option_files_;
 };
 
 } // End namespace gold.
@@ -38,6 +38,7 @@
 #include "reloc.h"
 #include "merge.h"
 #include "descriptors.h"
+#include "gold-threads.h"
 #include "output.h"
 
 // Some BSD systems still use MAP_ANON instead of MAP_ANONYMOUS
@@ -49,11 +50,14 @@
 // A dummy, non general, version of posix_fallocate.  Here we just set
 // the file size and hope that there is enough disk space.  FIXME: We
 // could allocate disk space by walking block by block and writing a
-// zero byte into each block.
+// zero byte into each block.  Like posix_fallocate, this returns an
+// error number rather than setting errno.
 static int
 posix_fallocate(int o, off_t offset, off_t len)
 {
-  return ftruncate(o, offset + len);
+  if (ftruncate(o, offset + len) < 0)
+    return errno;
+  return 0;
 }
 #endif // !defined(HAVE_POSIX_FALLOCATE)
 
@@ -279,6 +283,7 @@ Output_segment_headers::Output_segment_headers(
     gold_unreachable();
 
   this->set_data_size(segment_list.size() * phdr_size);
+  this->fix_data_size();
 }
 
 void
@@ -358,6 +363,7 @@ Output_file_header::Output_file_header(const Target* target,
     gold_unreachable();
 
   this->set_data_size(ehdr_size);
+  this->fix_data_size();
 }
 
 // Set the section table information for a file header.
@@ -1057,6 +1063,173 @@ Output_data_reloc_base<sh_type, dynamic, size, big_endian>::do_write(
   this->relocs_.clear();
 }
 
+// Class Output_data_relr.
+
+// Add a relocation at offset ADDRESS in OD.  The location is aligned
+// if OD is.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::add(Output_data* od, Address address)
+{
+  const Address wsize = size / 8;
+  if (od == NULL || address % wsize != 0 || od->addralign() < wsize)
+    return false;
+
+  Relr_entry entry;
+  entry.u.od = od;
+  entry.shndx = -1U;
+  entry.address = address;
+  this->entries_.push_back(entry);
+  return true;
+}
+
+// Add a relocation at offset ADDRESS in input section SHNDX of RELOBJ.
+// The location is aligned if the input section is, and is mapped
+// directly into the output section.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::add(Sized_relobj<size, big_endian>* relobj,
+					unsigned int shndx, Address address)
+{
+  const Address wsize = size / 8;
+  if (address % wsize != 0
+      || relobj->is_output_section_offset_invalid(shndx)
+      || relobj->section_addralign(shndx) < wsize)
+    return false;
+
+  Output_section* os = relobj->output_section(shndx);
+  if (os == NULL || os->is_large_data_section())
+    return false;
+
+  Relr_entry entry;
+  entry.u.relobj = relobj;
+  entry.shndx = shndx;
+  entry.address = address;
+  this->entries_.push_back(entry);
+  return true;
+}
+
+// Return the output address of ENTRY.
+
+template<int size, bool big_endian>
+typename Output_data_relr<size, big_endian>::Address
+Output_data_relr<size, big_endian>::entry_address(
+    const Relr_entry& entry) const
+{
+  if (entry.shndx == -1U)
+    return entry.u.od->address() + entry.address;
+
+  Sized_relobj<size, big_endian>* relobj = entry.u.relobj;
+  Output_section* os = relobj->output_section(entry.shndx);
+  return (os->address()
+	  + relobj->get_output_section_offset(entry.shndx)
+	  + entry.address);
+}
+
+// Encode the relocations.  We sort the addresses, and then emit an
+// address followed by as many bitmaps as cover the following
+// addresses.
+
+template<int size, bool big_endian>
+bool
+Output_data_relr<size, big_endian>::encode()
+{
+  const Address wsize = size / 8;
+  // The number of words covered by a bitmap.
+  const Address nbits = size - 1;
+
+  std::vector<Address> addresses;
+  addresses.reserve(this->entries_.size());
+  for (typename std::vector<Relr_entry>::const_iterator p =
+	 this->entries_.begin();
+       p != this->entries_.end();
+       ++p)
+    addresses.push_back(this->entry_address(*p));
+  std::sort(addresses.begin(), addresses.end());
+  addresses.erase(std::unique(addresses.begin(), addresses.end()),
+		  addresses.end());
+
+  this->encoded_.clear();
+  size_t i = 0;
+  while (i < addresses.size())
+    {
+      gold_assert(addresses[i] % wsize == 0);
+      this->encoded_.push_back(addresses[i]);
+      Address base = addresses[i] + wsize;
+      ++i;
+
+      while (true)
+	{
+	  Address bitmap = 0;
+	  for (; i < addresses.size(); ++i)
+	    {
+	      Address delta = addresses[i] - base;
+	      if (delta >= nbits * wsize)
+		break;
+	      gold_assert(delta % wsize == 0);
+	      bitmap |= static_cast<Address>(1) << (delta / wsize);
+	    }
+	  if (bitmap == 0)
+	    break;
+	  this->encoded_.push_back((bitmap << 1) | 1);
+	  base += nbits * wsize;
+	}
+    }
+
+  if (this->encoded_.size() <= this->word_count_)
+    return true;
+  this->word_count_ = this->encoded_.size();
+  return false;
+}
+
+// Set the entry size of the output section.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_adjust_output_section(
+    Output_section* os)
+{
+  os->set_entsize(size / 8);
+}
+
+// Write out the packed relocations.
+
+template<int size, bool big_endian>
+void
+Output_data_relr<size, big_endian>::do_write(Output_file* of)
+{
+  const off_t off = this->offset();
+  const off_t oview_size = this->data_size();
+  unsigned char* const oview = of->get_output_view(off, oview_size);
+
+  unsigned char* pov = oview;
+  for (typename std::vector<Address>::const_iterator p =
+	 this->encoded_.begin();
+       p != this->encoded_.end();
+       ++p)
+    {
+      elfcpp::Swap<size, big_endian>::writeval(pov, *p);
+      pov += size / 8;
+    }
+
+  // Fill any space left by a shorter encoding than the last one with
+  // empty bitmaps.
+  while (pov - oview < oview_size)
+    {
+      elfcpp::Swap<size, big_endian>::writeval(pov, 1);
+      pov += size / 8;
+    }
+
+  gold_assert(pov - oview == oview_size);
+
+  of->write_output_view(off, oview_size, oview);
+
+  this->entries_.clear();
+  this->encoded_.clear();
+}
+
 // Class Output_relocatable_relocs.
 
 template<int sh_type, int size, bool big_endian>
@@ -1762,6 +1935,7 @@ Output_section::Output_section(const char* name, elfcpp::Elf_Word type,
     may_sort_attached_input_sections_(false),
     must_sort_attached_input_sections_(false),
     attached_input_sections_are_sorted_(false),
+    input_section_order_specified_(false),
     is_relro_(false),
     is_relro_local_(false),
     is_small_section_(false),
@@ -1809,7 +1983,8 @@ Output_section::add_input_section(Sized_relobj<size, big_endian>* object,
 				  const char* secname,
 				  const elfcpp::Shdr<size, big_endian>& shdr,
 				  unsigned int reloc_shndx,
-				  bool have_sections_script)
+				  bool have_sections_script,
+				  unsigned int section_order_index)
 {
   elfcpp::Elf_Xword addralign = shdr.get_sh_addralign();
   if ((addralign & (addralign - 1)) != 0)
@@ -1822,6 +1997,13 @@ Output_section::add_input_section(Sized_relobj<size, big_endian>* object,
   if (addralign > this->addralign_)
     this->addralign_ = addralign;
 
+  // With a section ordering file the input sections may be reordered
+  // when we know their final offsets.  A SECTIONS clause in a linker
+  // script takes care of that itself.
+  if (parameters->options().section_ordering_file() != NULL
+      && !have_sections_script)
+    this->input_section_order_specified_ = true;
+
   typename elfcpp::Elf_types<size>::Elf_WXword sh_flags = shdr.get_sh_flags();
   this->update_flags_for_input_section(sh_flags);
 
@@ -1865,7 +2047,12 @@ Output_section::add_input_section(Sized_relobj<size, big_endian>* object,
       // possible is an optimization, since we will often have fill
       // sections without input sections.
       off_t fill_len = aligned_offset_in_section - offset_in_section;
-      if (this->input_sections_.empty())
+      if (this->input_section_order_specified_)
+	{
+	  // The input sections may be reordered, so the fill is
+	  // added when the final offsets are known.
+	}
+      else if (this->input_sections_.empty())
         this->fills_.push_back(Fill(offset_in_section, fill_len));
       else
         {
@@ -1883,16 +2070,21 @@ Output_section::add_input_section(Sized_relobj<size, big_endian>* object,
   // We need to keep track of this section if we are already keeping
   // track of sections, or if we are relaxing.  Also, if this is a
   // section which requires sorting, or which may require sorting in
-  // the future, we keep track of the sections.  FIXME: Add test for
+  // the future, we keep track of the sections.  With a section
+  // ordering file any section may need to move.  FIXME: Add test for
   // relaxing.
   if (have_sections_script
       || !this->input_sections_.empty()
       || this->may_sort_attached_input_sections()
       || this->must_sort_attached_input_sections()
-      || parameters->options().user_set_Map())
-    this->input_sections_.push_back(Input_section(object, shndx,
-						  shdr.get_sh_size(),
-						  addralign));
+      || parameters->options().user_set_Map()
+      || parameters->options().section_ordering_file() != NULL)
+    {
+      Input_section isec(object, shndx, shdr.get_sh_size(), addralign);
+      if (this->input_section_order_specified_)
+	isec.set_section_order_index(section_order_index);
+      this->input_sections_.push_back(isec);
+    }
 
   return aligned_offset_in_section;
 }
@@ -2136,8 +2328,18 @@ Output_section::set_final_data_size()
       return;
     }
 
+  // When the input sections are ordered by the section ordering
+  // file, the code fill between them depends on the final order.
+  bool add_code_fill = false;
   if (this->must_sort_attached_input_sections())
     this->sort_attached_input_sections();
+  else if (this->input_section_order_specified_)
+    {
+      this->order_attached_input_sections();
+      add_code_fill = ((this->flags_ & elfcpp::SHF_EXECINSTR) != 0
+		       && parameters->target().has_code_fill());
+      this->fills_.clear();
+    }
 
   uint64_t address = this->address();
   off_t startoff = this->offset();
@@ -2146,7 +2348,10 @@ Output_section::set_final_data_size()
        p != this->input_sections_.end();
        ++p)
     {
-      off = align_address(off, p->addralign());
+      off_t aligned_off = align_address(off, p->addralign());
+      if (add_code_fill && aligned_off > off)
+	this->fills_.push_back(Fill(off - startoff, aligned_off - off));
+      off = aligned_off;
       p->set_address_and_file_offset(address + (off - startoff), off,
 				     startoff);
       off += p->data_size();
@@ -2380,6 +2585,42 @@ Output_section::sort_attached_input_sections()
   this->attached_input_sections_are_sorted_ = true;
 }
 
+// Return true if S1 should come before S2 according to the section
+// ordering file.  Sections which are listed come first, in the order
+// in which they are listed.
+
+bool
+Output_section::Input_section_order_compare::operator()(
+    const Output_section::Input_section& s1,
+    const Output_section::Input_section& s2) const
+{
+  unsigned int i1 = s1.section_order_index();
+  unsigned int i2 = s2.section_order_index();
+  if (i1 == 0 || i2 == 0)
+    return i1 != 0 && i2 == 0;
+  return i1 < i2;
+}
+
+// Sort the input sections attached to an output section as specified
+// by --section-ordering-file.  The position of each listed section
+// was recorded when it was added, so unlike
+// sort_attached_input_sections we do not need to look at section
+// names here.  We use a stable sort so that sections which are not
+// listed keep their input order.
+
+void
+Output_section::order_attached_input_sections()
+{
+  if (this->attached_input_sections_are_sorted_)
+    return;
+
+  std::stable_sort(this->input_sections_.begin(),
+		   this->input_sections_.end(),
+		   Input_section_order_compare());
+
+  this->attached_input_sections_are_sorted_ = true;
+}
+
 // Write the section header to *OSHDR.
 
 template<int size, bool big_endian>
@@ -2618,6 +2859,18 @@ Output_section::print_merge_stats()
     p->print_merge_stats(this->name_);
 }
 
+// Queue tasks for merge sections.
+
+void
+Output_section::queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  Input_section_list::iterator p;
+  for (p = this->input_sections_.begin();
+       p != this->input_sections_.end();
+       ++p)
+    p->queue_merge_tasks(workqueue, blocker);
+}
+
 // Output segment methods.
 
 Output_segment::Output_segment(elfcpp::Elf_Word type, elfcpp::Elf_Word flags)
@@ -2820,25 +3073,23 @@ Output_segment::add_output_section(Output_section* os,
   pdl->push_back(os);
 }
 
-// Remove an Output_section from this segment.  It is an error if it
-// is not present.
+// Remove an Output_section from this segment, if it is there.
 
 void
 Output_segment::remove_output_section(Output_section* os)
 {
-  // We only need this for SHT_PROGBITS.
-  gold_assert(os->type() == elfcpp::SHT_PROGBITS);
-  for (Output_data_list::iterator p = this->output_data_.begin();
-       p != this->output_data_.end();
-       ++p)
+  gold_assert(!this->is_max_align_known_);
+  Output_data_list* pdl = (os->type() == elfcpp::SHT_NOBITS
+			   ? &this->output_bss_
+			   : &this->output_data_);
+  for (Output_data_list::iterator p = pdl->begin(); p != pdl->end(); ++p)
    {
      if (*p == os)
        {
-         this->output_data_.erase(p);
+         pdl->erase(p);
          return;
        }
    }
-  gold_unreachable();
 }
 
 // Add an Output_data (which is not an Output_section) to the start of
@@ -3110,6 +3361,25 @@ Output_segment::set_section_list_addresses(const Layout* layout, bool reset,
   return addr + (off - startoff);
 }
 
+// Reset the addresses and offsets of the segment and of the sections
+// it contains.
+
+void
+Output_segment::reset_addresses_and_offsets()
+{
+  this->are_addresses_set_ = false;
+
+  for (Output_data_list::iterator p = this->output_data_.begin();
+       p != this->output_data_.end();
+       ++p)
+    (*p)->reset_address_and_file_offset();
+
+  for (Output_data_list::iterator p = this->output_bss_.begin();
+       p != this->output_bss_.end();
+       ++p)
+    (*p)->reset_address_and_file_offset();
+}
+
 // For a non-PT_LOAD segment, set the offset from the sections, if
 // any.
 
@@ -3393,7 +3663,11 @@ Output_file::Output_file(const char* name)
     file_size_(0),
     base_(NULL),
     map_is_anonymous_(false),
-    is_temporary_(false)
+    is_temporary_(false),
+    is_streaming_(false),
+    page_size_(0),
+    stream_pages_(),
+    stream_lock_(NULL)
 {
 }
 
@@ -3434,10 +3708,20 @@ Output_file::open(off_t file_size)
 	  if (o < 0)
 	    gold_fatal(_("%s: open: %s"), this->name_, strerror(errno));
 	  this->o_ = o;
+
+	  // When streaming we only stream to a regular file; anything
+	  // else is written at the end as usual.
+	  struct stat statbuf;
+	  if (parameters->options().stream_output()
+	      && ::fstat(o, &statbuf) == 0
+	      && S_ISREG(statbuf.st_mode))
+	    this->is_streaming_ = true;
 	}
     }
 
   this->map();
+  if (this->is_streaming_)
+    this->start_streaming();
 }
 
 // Resize the output file.
@@ -3456,6 +3740,8 @@ Output_file::resize(off_t file_size)
         gold_fatal(_("%s: mremap: %s"), this->name_, strerror(errno));
       this->base_ = static_cast<unsigned char*>(base);
       this->file_size_ = file_size;
+      if (this->is_streaming_)
+	this->start_streaming();
     }
   else
     {
@@ -3472,8 +3758,13 @@ void*
 Output_file::map_anonymous()
 {
   this->map_is_anonymous_ = true;
-  return ::mmap(NULL, this->file_size_, PROT_READ | PROT_WRITE,
-		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+  // When streaming only the pages in use are ever resident.
+  if (this->is_streaming_)
+    flags |= MAP_NORESERVE;
+#endif
+  return ::mmap(NULL, this->file_size_, PROT_READ | PROT_WRITE, flags, -1, 0);
 }
 
 // Map the file into memory.
@@ -3491,7 +3782,8 @@ Output_file::map()
   if (o == STDOUT_FILENO || o == STDERR_FILENO
       || ::fstat(o, &statbuf) != 0
       || !S_ISREG(statbuf.st_mode)
-      || this->is_temporary_)
+      || this->is_temporary_
+      || this->is_streaming_)
     base = this->map_anonymous();
   else
     {
@@ -3503,8 +3795,9 @@ Output_file::map()
       // have already exited.  The alternative to fallocate would be
       // to use fdatasync, but that would be a more significant
       // performance hit.
-      if (::posix_fallocate(o, 0, this->file_size_) < 0)
-	gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+      int err = ::posix_fallocate(o, 0, this->file_size_);
+      if (err != 0)
+	gold_fatal(_("%s: %s"), this->name_, strerror(err));
 
       // Map the file into memory.
       this->map_is_anonymous_ = false;
@@ -3536,13 +3829,165 @@ Output_file::unmap()
   this->base_ = NULL;
 }
 
+// Set up for --stream-output, after the file has been opened or
+// resized.  The memory is an anonymous map used as a staging area;
+// each page is either in memory, holding everything written to it,
+// or has been dropped, in which case the file holds everything
+// written to it.
+
+void
+Output_file::start_streaming()
+{
+  // Make sure that we have disk space for the file, as in map.
+  if (::ftruncate(this->o_, this->file_size_) < 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(errno));
+  int err = ::posix_fallocate(this->o_, 0, this->file_size_);
+  if (err != 0)
+    gold_fatal(_("%s: %s"), this->name_, strerror(err));
+
+  if (this->stream_lock_ == NULL)
+    {
+      this->page_size_ = ::sysconf(_SC_PAGESIZE);
+      this->stream_lock_ = new Lock();
+    }
+
+  Hold_lock hl(*this->stream_lock_);
+  size_t page_count = ((this->file_size_ + this->page_size_ - 1)
+		       / this->page_size_);
+  this->stream_pages_.resize(page_count);
+}
+
+// Bring the pages covering START/SIZE into memory if necessary, and
+// note that a view is using them.  A dropped page is read back from
+// the file, so that a view sees everything written so far.
+
+void
+Output_file::acquire_pages(off_t start, size_t size)
+{
+  if (size == 0)
+    return;
+
+  size_t first = start / this->page_size_;
+  size_t last = (start + size - 1) / this->page_size_;
+
+  Hold_lock hl(*this->stream_lock_);
+  for (size_t i = first; i <= last; ++i)
+    {
+      Stream_page* sp = &this->stream_pages_[i];
+      if (sp->is_dropped)
+	{
+	  off_t off = static_cast<off_t>(i) * this->page_size_;
+	  size_t len = std::min(static_cast<off_t>(this->page_size_),
+				this->file_size_ - off);
+	  unsigned char* p = this->base_ + off;
+	  while (len > 0)
+	    {
+	      ssize_t bytes = ::pread(this->o_, p, len, off);
+	      if (bytes < 0)
+		{
+		  if (errno == EINTR)
+		    continue;
+		  gold_fatal(_("%s: pread: %s"), this->name_, strerror(errno));
+		}
+	      if (bytes == 0)
+		break;
+	      p += bytes;
+	      off += bytes;
+	      len -= bytes;
+	    }
+	  sp->is_dropped = false;
+	}
+      ++sp->users;
+    }
+}
+
+// Release the pages covering START/SIZE.  If WRITE is true, the view
+// is first written to the file; no other view can drop these pages
+// while we are writing, since we are still using them.  Runs of pages
+// which are no longer in use are then dropped from memory.
+
+void
+Output_file::release_pages(off_t start, size_t size, bool write)
+{
+  if (size == 0)
+    return;
+
+  if (write)
+    {
+      const unsigned char* p = this->base_ + start;
+      off_t off = start;
+      size_t len = size;
+      while (len > 0)
+	{
+	  ssize_t bytes = ::pwrite(this->o_, p, len, off);
+	  if (bytes < 0)
+	    {
+	      if (errno == EINTR)
+		continue;
+	      gold_fatal(_("%s: pwrite: %s"), this->name_, strerror(errno));
+	    }
+	  if (bytes == 0)
+	    gold_fatal(_("%s: pwrite: unexpected 0 return-value"),
+		       this->name_);
+	  p += bytes;
+	  off += bytes;
+	  len -= bytes;
+	}
+    }
+
+  size_t first = start / this->page_size_;
+  size_t last = (start + size - 1) / this->page_size_;
+
+  Hold_lock hl(*this->stream_lock_);
+  size_t run_start = first;
+  size_t run_count = 0;
+  for (size_t i = first; i <= last + 1; ++i)
+    {
+      if (i <= last)
+	{
+	  Stream_page* sp = &this->stream_pages_[i];
+	  gold_assert(sp->users > 0);
+	  --sp->users;
+	  if (sp->users == 0)
+	    {
+	      if (run_count == 0)
+		run_start = i;
+	      ++run_count;
+	      sp->is_dropped = true;
+	      continue;
+	    }
+	}
+      if (run_count > 0)
+	{
+#ifdef MADV_DONTNEED
+	  ::madvise(this->base_ + run_start * this->page_size_,
+		    run_count * this->page_size_, MADV_DONTNEED);
+#endif
+	  run_count = 0;
+	}
+    }
+}
+
+// Write data to the file when streaming.
+
+void
+Output_file::stream_write(off_t offset, const void* data, size_t len)
+{
+  unsigned char* view = this->get_output_view(offset, len);
+  memcpy(view, data, len);
+  this->write_output_view(offset, len, view);
+}
+
 // Close the output file.
 
 void
 Output_file::close()
 {
-  // If the map isn't file-backed, we need to write it now.
-  if (this->map_is_anonymous_ && !this->is_temporary_)
+  // If the map isn't file-backed, we need to write it now.  When
+  // streaming, everything was written as the views were released.
+  if (this->map_is_anonymous_
+      && !this->is_temporary_
+      && !this->is_streaming_)
     {
       size_t bytes_to_write = this->file_size_;
       size_t offset = 0;
@@ -3563,6 +4008,14 @@ Output_file::close()
     }
   this->unmap();
 
+  if (this->is_streaming_)
+    {
+      delete this->stream_lock_;
+      this->stream_lock_ = NULL;
+      this->stream_pages_.clear();
+      this->is_streaming_ = false;
+    }
+
   // We don't close stdout or stderr
   if (this->o_ != STDOUT_FILENO
       && this->o_ != STDERR_FILENO
@@ -3584,7 +4037,8 @@ Output_section::add_input_section<32, false>(
     const char* secname,
     const elfcpp::Shdr<32, false>& shdr,
     unsigned int reloc_shndx,
-    bool have_sections_script);
+    bool have_sections_script,
+    unsigned int section_order_index);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -3596,7 +4050,8 @@ Output_section::add_input_section<32, true>(
     const char* secname,
     const elfcpp::Shdr<32, true>& shdr,
     unsigned int reloc_shndx,
-    bool have_sections_script);
+    bool have_sections_script,
+    unsigned int section_order_index);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -3608,7 +4063,8 @@ Output_section::add_input_section<64, false>(
     const char* secname,
     const elfcpp::Shdr<64, false>& shdr,
     unsigned int reloc_shndx,
-    bool have_sections_script);
+    bool have_sections_script,
+    unsigned int section_order_index);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -3620,7 +4076,8 @@ Output_section::add_input_section<64, true>(
     const char* secname,
     const elfcpp::Shdr<64, true>& shdr,
     unsigned int reloc_shndx,
-    bool have_sections_script);
+    bool have_sections_script,
+    unsigned int section_order_index);
 #endif
 
 #ifdef HAVE_TARGET_32_LITTLE
@@ -3723,6 +4180,26 @@ template
 class Output_data_reloc<elfcpp::SHT_REL, false, 64, true>;
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+class Output_data_relr<32, false>;
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+class Output_data_relr<32, true>;
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+class Output_data_relr<64, false>;
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+class Output_data_relr<64, true>;
+#endif
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 class Output_data_reloc<elfcpp::SHT_REL, true, 32, false>;
@@ -35,6 +35,7 @@ namespace gold
 {
 
 class General_options;
+class Lock;
 class Object;
 class Symbol;
 class Output_file;
@@ -54,7 +55,7 @@ class Output_data
   explicit Output_data()
     : address_(0), data_size_(0), offset_(-1),
       is_address_valid_(false), is_data_size_valid_(false),
-      is_offset_valid_(false),
+      is_offset_valid_(false), is_data_size_fixed_(false),
       dynamic_reloc_count_(0)
   { }
 
@@ -90,14 +91,16 @@ class Output_data
     return this->offset_;
   }
 
-  // Reset the address and file offset.  This essentially disables the
-  // sanity testing about duplicate and unknown settings.
+  // Reset the address and file offset, and the data size unless it
+  // is fixed.  This essentially disables the sanity testing about
+  // duplicate and unknown settings.
   void
   reset_address_and_file_offset()
   {
     this->is_address_valid_ = false;
     this->is_offset_valid_ = false;
-    this->is_data_size_valid_ = false;
+    if (!this->is_data_size_fixed_)
+      this->is_data_size_valid_ = false;
     this->do_reset_address_and_file_offset();
   }
 
@@ -352,6 +355,16 @@ class Output_data
   current_data_size_for_child() const
   { return this->data_size_; }
 
+  // Fix the size of the data, which must already be set, so that it
+  // is not reset with the address.  This is for data whose size does
+  // not depend on its address.
+  void
+  fix_data_size()
+  {
+    gold_assert(this->is_data_size_valid_);
+    this->is_data_size_fixed_ = true;
+  }
+
   // Set the current data size--this is for the convenience of
   // sections which build up their size over time.
   void
@@ -390,6 +403,9 @@ class Output_data
   bool is_data_size_valid_;
   // Whether offset_ is valid.
   bool is_offset_valid_;
+  // Whether data_size_ is fixed, and so stays valid when the address
+  // is reset.
+  bool is_data_size_fixed_;
   // Count of dynamic relocations applied to this section.
   unsigned int dynamic_reloc_count_;
 };
@@ -525,7 +541,10 @@ class Output_section_data : public Output_data
  public:
   Output_section_data(off_t data_size, uint64_t addralign)
     : Output_data(), output_section_(NULL), addralign_(addralign)
-  { this->set_data_size(data_size); }
+  {
+    this->set_data_size(data_size);
+    this->fix_data_size();
+  }
 
   Output_section_data(uint64_t addralign)
     : Output_data(), output_section_(NULL), addralign_(addralign)
@@ -577,6 +596,13 @@ class Output_section_data : public Output_data
   print_merge_stats(const char* section_name)
   { this->do_print_merge_stats(section_name); }
 
+  // Queue tasks to finish processing the input sections added to an
+  // SHF_MERGE section, if there is any work which can be done in
+  // parallel.  The tasks unblock BLOCKER when they are done.
+  void
+  queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+  { this->do_queue_merge_tasks(workqueue, blocker); }
+
  protected:
   // The child class must implement do_write.
 
@@ -615,6 +641,11 @@ class Output_section_data : public Output_data
   do_print_merge_stats(const char*)
   { gold_unreachable(); }
 
+  // Queue merge tasks.
+  virtual void
+  do_queue_merge_tasks(Workqueue*, Task_token*)
+  { }
+
   // Return the required alignment.
   uint64_t
   do_addralign() const
@@ -1130,6 +1161,104 @@ class Output_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   Addend addend_;
 };
 
+// Output_data_relr holds RELATIVE relocations in the packed form
+// used by the SHT_RELR section type, for -z pack-relative-relocs.
+// The section is a sequence of words.  A word with the low bit clear
+// is the address of a location to relocate; it is followed by any
+// number of bitmap words, with the low bit set, each of which covers
+// the next 31 or 63 words after the last location.  The dynamic
+// linker adds the load address to each location, so the addend must
+// be stored in the contents, which the targets which use this do.
+
+// The encoding depends on the addresses of the relocations, which
+// are not known when the section, which goes with the other dynamic
+// relocs, is given its size.  So the section starts out empty; once
+// the addresses are set, the target calls encode, and if the encoding
+// does not fit the addresses are set again with the larger size.  A
+// shorter encoding is padded with bitmap words which have no bits
+// set, which relocate nothing.
+
+template<int size, bool big_endian>
+class Output_data_relr : public Output_section_data
+{
+ public:
+  typedef typename elfcpp::Elf_types<size>::Elf_Addr Address;
+
+  Output_data_relr()
+    : Output_section_data(Output_data::default_alignment_for_size(size)),
+      entries_(), encoded_(), word_count_(0)
+  { }
+
+  // Add a relocation at offset ADDRESS in OD.  This returns false if
+  // the relocation can not be packed because the location may not be
+  // aligned.
+  bool
+  add(Output_data* od, Address address);
+
+  // Add a relocation at offset ADDRESS in input section SHNDX of
+  // RELOBJ.  This returns false as above.
+  bool
+  add(Sized_relobj<size, big_endian>* relobj, unsigned int shndx,
+      Address address);
+
+  // Return whether there are no relocations.
+  bool
+  empty() const
+  { return this->entries_.empty(); }
+
+  // Encode the relocations, now that the addresses of all the
+  // sections are set.  Return false if the encoding does not fit in
+  // the section, in which case the size of the section is increased
+  // and the addresses must be set again.
+  bool
+  encode();
+
+ protected:
+  // Set the final data size, to the space kept for the encoding.
+  void
+  set_final_data_size()
+  { this->set_data_size(this->word_count_ * (size / 8)); }
+
+  // Write out the data.
+  void
+  do_write(Output_file*);
+
+  // Set the entry size.
+  void
+  do_adjust_output_section(Output_section* os);
+
+  // Write to a map file.
+  void
+  do_print_to_mapfile(Mapfile* mapfile) const
+  { mapfile->print_output_data(this, _("** packed relative relocs")); }
+
+ private:
+  // A relocation.  If SHNDX is -1U, it is at offset ADDRESS in U.OD;
+  // otherwise it is at offset ADDRESS in input section SHNDX of
+  // U.RELOBJ.
+  struct Relr_entry
+  {
+    union
+    {
+      Output_data* od;
+      Sized_relobj<size, big_endian>* relobj;
+    } u;
+    unsigned int shndx;
+    Address address;
+  };
+
+  // Return the output address of an entry.
+  Address
+  entry_address(const Relr_entry&) const;
+
+  // The relocations.
+  std::vector<Relr_entry> entries_;
+  // The contents of the section, built by encode.
+  std::vector<Address> encoded_;
+  // The number of words kept for the encoding.
+  size_t word_count_;
+};
+
 // Output_data_reloc is used to manage a section containing relocs.
 // SH_TYPE is either elfcpp::SHT_REL or elfcpp::SHT_RELA.  DYNAMIC
 // indicates whether this is a dynamic relocation or a normal
@@ -1149,9 +1278,22 @@ class Output_data_reloc_base : public Output_section_data_build
   // Construct the section.
   Output_data_reloc_base(bool sort_relocs)
     : Output_section_data_build(Output_data::default_alignment_for_size(size)),
-      sort_relocs_(sort_relocs)
+      sort_relocs_(sort_relocs), relr_(NULL), relr_type_(0)
   { }
 
+  // Put RELATIVE relocs of type RELATIVE_TYPE in RELR rather than in
+  // this section where possible.  This is used for the dynamic
+  // relocs with -z pack-relative-relocs.  If RELR is NULL, stop doing
+  // so.
+  void
+  set_relr(Output_data_relr<size, big_endian>* relr,
+	   unsigned int relative_type)
+  {
+    gold_assert(dynamic);
+    this->relr_ = relr;
+    this->relr_type_ = relative_type;
+  }
+
  protected:
   // Write out the data.
   void
@@ -1180,6 +1322,34 @@ class Output_data_reloc_base : public Output_section_data_build
     od->add_dynamic_reloc();
   }
 
+  // Try to add a relocation of type TYPE at ADDRESS in OD to the
+  // packed relocs.  Return true if it was added.
+  bool
+  add_relr(unsigned int type, Output_data* od, Address address)
+  {
+    if (this->relr_ == NULL
+	|| type != this->relr_type_
+	|| !this->relr_->add(od, address))
+      return false;
+    od->add_dynamic_reloc();
+    return true;
+  }
+
+  // Likewise, for a relocation at ADDRESS in input section SHNDX of
+  // RELOBJ.
+  bool
+  add_relr(unsigned int type, Output_data* od,
+	   Sized_relobj<size, big_endian>* relobj, unsigned int shndx,
+	   Address address)
+  {
+    if (this->relr_ == NULL
+	|| type != this->relr_type_
+	|| !this->relr_->add(relobj, shndx, address))
+      return false;
+    od->add_dynamic_reloc();
+    return true;
+  }
+
  private:
   typedef std::vector<Output_reloc_type> Relocs;
 
@@ -1196,6 +1366,10 @@ class Output_data_reloc_base : public Output_section_data_build
   // Whether to sort the relocations when writing them out, to make
   // the dynamic linker more efficient.
   bool sort_relocs_;
+  // If not NULL, where to put RELATIVE relocs.
+  Output_data_relr<size, big_endian>* relr_;
+  // The type of a RELATIVE reloc, if RELR_ is not NULL.
+  unsigned int relr_type_;
 };
 
 // The class which callers actually create.
@@ -1259,15 +1433,19 @@ class Output_data_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>
   void
   add_global_relative(Symbol* gsym, unsigned int type, Output_data* od,
                       Address address)
-  { this->add(od, Output_reloc_type(gsym, type, od, address, true)); }
+  {
+    if (!this->add_relr(type, od, address))
+      this->add(od, Output_reloc_type(gsym, type, od, address, true));
+  }
 
   void
   add_global_relative(Symbol* gsym, unsigned int type, Output_data* od,
                       Sized_relobj<size, big_endian>* relobj,
                       unsigned int shndx, Address address)
   {
-    this->add(od, Output_reloc_type(gsym, type, relobj, shndx, address,
-                                    true));
+    if (!this->add_relr(type, od, relobj, shndx, address))
+      this->add(od, Output_reloc_type(gsym, type, relobj, shndx, address,
+				      true));
   }
 
   // Add a reloc against a local symbol.
@@ -1297,8 +1475,9 @@ class Output_data_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>
 	             unsigned int local_sym_index, unsigned int type,
 	             Output_data* od, Address address)
   {
-    this->add(od, Output_reloc_type(relobj, local_sym_index, type, od,
-                                    address, true, false));
+    if (!this->add_relr(type, od, address))
+      this->add(od, Output_reloc_type(relobj, local_sym_index, type, od,
+				      address, true, false));
   }
 
   void
@@ -1306,8 +1485,9 @@ class Output_data_reloc<elfcpp::SHT_REL, dynamic, size, big_endian>
 	             unsigned int local_sym_index, unsigned int type,
 	             Output_data* od, unsigned int shndx, Address address)
   {
-    this->add(od, Output_reloc_type(relobj, local_sym_index, type, shndx,
-				    address, true, false));
+    if (!this->add_relr(type, od, relobj, shndx, address))
+      this->add(od, Output_reloc_type(relobj, local_sym_index, type, shndx,
+				      address, true, false));
   }
 
   // Add a reloc against a local section symbol.  This will be
@@ -1391,14 +1571,20 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
   void
   add_global_relative(Symbol* gsym, unsigned int type, Output_data* od,
 	              Address address, Addend addend)
-  { this->add(od, Output_reloc_type(gsym, type, od, address, addend, true)); }
+  {
+    if (!this->add_relr(type, od, address))
+      this->add(od, Output_reloc_type(gsym, type, od, address, addend, true));
+  }
 
   void
   add_global_relative(Symbol* gsym, unsigned int type, Output_data* od,
                       Sized_relobj<size, big_endian>* relobj,
                       unsigned int shndx, Address address, Addend addend)
-  { this->add(od, Output_reloc_type(gsym, type, relobj, shndx, address,
-                                    addend, true)); }
+  {
+    if (!this->add_relr(type, od, relobj, shndx, address))
+      this->add(od, Output_reloc_type(gsym, type, relobj, shndx, address,
+				      addend, true));
+  }
 
   // Add a reloc against a local symbol.
 
@@ -1428,8 +1614,9 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
 	             unsigned int local_sym_index, unsigned int type,
 	             Output_data* od, Address address, Addend addend)
   {
-    this->add(od, Output_reloc_type(relobj, local_sym_index, type, od, address,
-				    addend, true, false));
+    if (!this->add_relr(type, od, address))
+      this->add(od, Output_reloc_type(relobj, local_sym_index, type, od,
+				      address, addend, true, false));
   }
 
   void
@@ -1438,8 +1625,9 @@ class Output_data_reloc<elfcpp::SHT_RELA, dynamic, size, big_endian>
 	             Output_data* od, unsigned int shndx, Address address,
 	             Addend addend)
   {
-    this->add(od, Output_reloc_type(relobj, local_sym_index, type, shndx,
-                                    address, addend, true, false));
+    if (!this->add_relr(type, od, relobj, shndx, address))
+      this->add(od, Output_reloc_type(relobj, local_sym_index, type, shndx,
+				      address, addend, true, false));
   }
 
   // Add a reloc against a local section symbol.  This will be
@@ -1881,13 +2069,17 @@ class Output_symtab_xindex : public Output_section_data
  public:
   Output_symtab_xindex(size_t symcount)
     : Output_section_data(symcount * 4, 4),
-      entries_()
+      lock_(), entries_()
   { }
 
-  // Add an entry: symbol number SYMNDX has section SHNDX.
+  // Add an entry: symbol number SYMNDX has section SHNDX.  The global
+  // symbols may be written by several threads at once.
   void
   add(unsigned int symndx, unsigned int shndx)
-  { this->entries_.push_back(std::make_pair(symndx, shndx)); }
+  {
+    Hold_lock hl(this->lock_);
+    this->entries_.push_back(std::make_pair(symndx, shndx));
+  }
 
  protected:
   void
@@ -1908,6 +2100,8 @@ class Output_symtab_xindex : public Output_section_data
   // and section index.
   typedef std::vector<std::pair<unsigned int, unsigned int> > Xindex_entries;
 
+  // Lock for entries_.
+  Lock lock_;
   // The entries we need.
   Xindex_entries entries_;
 };
@@ -1927,14 +2121,17 @@ class Output_section : public Output_data
   // which applies to this section, or 0 if none, or -1 if more than
   // one.  HAVE_SECTIONS_SCRIPT is true if we have a SECTIONS clause
   // in a linker script; in that case we need to keep track of input
-  // sections associated with an output section.  Return the offset
-  // within the output section.
+  // sections associated with an output section.  SECTION_ORDER_INDEX
+  // is the position of the section in --section-ordering-file, or 0
+  // if it is not listed there.  Return the offset within the output
+  // section.
   template<int size, bool big_endian>
   off_t
   add_input_section(Sized_relobj<size, big_endian>* object, unsigned int shndx,
 		    const char *name,
 		    const elfcpp::Shdr<size, big_endian>& shdr,
-		    unsigned int reloc_shndx, bool have_sections_script);
+		    unsigned int reloc_shndx, bool have_sections_script,
+		    unsigned int section_order_index);
 
   // Add generated data POSD to this output section.
   void
@@ -2341,6 +2538,11 @@ class Output_section : public Output_data
   void
   print_merge_stats();
 
+  // Queue tasks to finish processing the input sections of merge
+  // sections.  The tasks unblock BLOCKER when they are done.
+  void
+  queue_merge_tasks(Workqueue*, Task_token* blocker);
+
  protected:
   // Return the output section--i.e., the object itself.
   Output_section*
@@ -2462,7 +2664,7 @@ class Output_section : public Output_data
   {
    public:
     Input_section()
-      : shndx_(0), p2align_(0)
+      : shndx_(0), p2align_(0), section_order_index_(0)
     {
       this->u1_.data_size = 0;
       this->u2_.object = NULL;
@@ -2472,7 +2674,8 @@ class Output_section : public Output_data
     Input_section(Relobj* object, unsigned int shndx, off_t data_size,
 		  uint64_t addralign)
       : shndx_(shndx),
-	p2align_(ffsll(static_cast<long long>(addralign)))
+	p2align_(ffsll(static_cast<long long>(addralign))),
+	section_order_index_(0)
     {
       gold_assert(shndx != OUTPUT_SECTION_CODE
 		  && shndx != MERGE_DATA_SECTION_CODE
@@ -2483,7 +2686,7 @@ class Output_section : public Output_data
 
     // For a non-merge output section.
     Input_section(Output_section_data* posd)
-      : shndx_(OUTPUT_SECTION_CODE), p2align_(0)
+      : shndx_(OUTPUT_SECTION_CODE), p2align_(0), section_order_index_(0)
     {
       this->u1_.data_size = 0;
       this->u2_.posd = posd;
@@ -2494,7 +2697,7 @@ class Output_section : public Output_data
       : shndx_(is_string
 	       ? MERGE_STRING_SECTION_CODE
 	       : MERGE_DATA_SECTION_CODE),
-	p2align_(0)
+	p2align_(0), section_order_index_(0)
     {
       this->u1_.entsize = entsize;
       this->u2_.posd = posd;
@@ -2553,6 +2756,18 @@ class Output_section : public Output_data
       return this->shndx_;
     }
 
+    // Return the position of the input section in the section
+    // ordering file, or 0 if it is not listed there.
+    unsigned int
+    section_order_index() const
+    { return this->section_order_index_; }
+
+    // Set the position of the input section in the section ordering
+    // file.
+    void
+    set_section_order_index(unsigned int section_order_index)
+    { this->section_order_index_ = section_order_index; }
+
     // Set the output section.
     void
     set_output_section(Output_section* os)
@@ -2624,6 +2839,15 @@ class Output_section : public Output_data
 	this->u2_.posd->print_merge_stats(section_name);
     }
 
+    // Queue tasks for merge sections.
+    void
+    queue_merge_tasks(Workqueue* workqueue, Task_token* blocker)
+    {
+      if (this->shndx_ == MERGE_DATA_SECTION_CODE
+	  || this->shndx_ == MERGE_STRING_SECTION_CODE)
+	this->u2_.posd->queue_merge_tasks(workqueue, blocker);
+    }
+
    private:
     // Code values which appear in shndx_.  If the value is not one of
     // these codes, it is the input section index in the object file.
@@ -2646,6 +2870,9 @@ class Output_section : public Output_data
     unsigned int shndx_;
     // The required alignment, stored as a power of 2.
     unsigned int p2align_;
+    // For an ordinary input section, the position in the section
+    // ordering file, or 0.
+    unsigned int section_order_index_;
     union
     {
       // For an ordinary input section, the section size.
@@ -2679,6 +2906,14 @@ class Output_section : public Output_data
 	       const Input_section_sort_entry&) const;
   };
 
+  // This is the comparison function for sorting by the section
+  // ordering file.
+  struct Input_section_order_compare
+  {
+    bool
+    operator()(const Input_section&, const Input_section&) const;
+  };
+
   // Fill data.  This is used to fill in data between input sections.
   // It is also used for data statements (BYTE, WORD, etc.) in linker
   // scripts.  When we have to keep track of the input sections, we
@@ -2733,6 +2968,11 @@ class Output_section : public Output_data
   void
   sort_attached_input_sections();
 
+  // Sort the attached input sections as specified by
+  // --section-ordering-file.
+  void
+  order_attached_input_sections();
+
   // Most of these fields are only valid after layout.
 
   // The name of the section.  This will point into a Stringpool.
@@ -2825,6 +3065,9 @@ class Output_section : public Output_data
   // True if the input sections attached to this output section have
   // already been sorted.
   bool attached_input_sections_are_sorted_ : 1;
+  // True if the input sections attached to this output section are
+  // to be sorted as specified by --section-ordering-file.
+  bool input_section_order_specified_ : 1;
   // True if this section holds relro data.
   bool is_relro_ : 1;
   // True if this section holds relro local data.
@@ -2902,8 +3145,7 @@ class Output_segment
   void
   add_output_section(Output_section* os, elfcpp::Elf_Word seg_flags);
 
-  // Remove an Output_section from this segment.  It is an error if it
-  // is not present.
+  // Remove an Output_section from this segment, if it is there.
   void
   remove_output_section(Output_section* os);
 
@@ -2957,6 +3199,11 @@ class Output_segment
   set_section_addresses(const Layout*, bool reset, uint64_t addr, off_t* poff,
 			unsigned int* pshndx);
 
+  // Reset the addresses and offsets of this segment and of the
+  // sections it contains, so that they can be set again.
+  void
+  reset_addresses_and_offsets();
+
   // Set the minimum alignment of this segment.  This may be adjusted
   // upward based on the section alignments.
   void
@@ -3107,12 +3354,19 @@ class Output_file
   close();
 
   // We currently always use mmap which makes the view handling quite
-  // simple.  In the future we may support other approaches.
+  // simple.  With --stream-output the memory is only a staging area:
+  // each view is written to the file with pwrite when it is released,
+  // and pages which no view is using are given back to the system.
 
   // Write data to the output file.
   void
   write(off_t offset, const void* data, size_t len)
-  { memcpy(this->base_ + offset, data, len); }
+  {
+    if (!this->is_streaming_)
+      memcpy(this->base_ + offset, data, len);
+    else
+      this->stream_write(offset, data, len);
+  }
 
   // Get a buffer to use to write to the file, given the offset into
   // the file and the size.
@@ -3121,14 +3375,19 @@ class Output_file
   {
     gold_assert(start >= 0
                 && start + static_cast<off_t>(size) <= this->file_size_);
+    if (this->is_streaming_)
+      this->acquire_pages(start, size);
     return this->base_ + start;
   }
 
   // VIEW must have been returned by get_output_view.  Write the
   // buffer to the file, passing in the offset and the size.
   void
-  write_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_output_view(off_t start, size_t size, unsigned char*)
+  {
+    if (this->is_streaming_)
+      this->release_pages(start, size, true);
+  }
 
   // Get a read/write buffer.  This is used when we want to write part
   // of the file, read it in, and write it again.
@@ -3138,8 +3397,8 @@ class Output_file
 
   // Write a read/write buffer back to the file.
   void
-  write_input_output_view(off_t, size_t, unsigned char*)
-  { }
+  write_input_output_view(off_t start, size_t size, unsigned char* view)
+  { this->write_output_view(start, size, view); }
 
   // Get a read buffer.  This is used when we just want to read part
   // of the file back it in.
@@ -3149,8 +3408,11 @@ class Output_file
 
   // Release a read bfufer.
   void
-  free_input_view(off_t, size_t, const unsigned char*)
-  { }
+  free_input_view(off_t start, size_t size, const unsigned char*)
+  {
+    if (this->is_streaming_)
+      this->release_pages(start, size, false);
+  }
 
  private:
   // Map the file into memory.
@@ -3165,6 +3427,39 @@ class Output_file
   void
   unmap();
 
+  // Set up the page table used by --stream-output.
+  void
+  start_streaming();
+
+  // Make sure the pages covering a view are in memory, and note that
+  // one more view is using them.
+  void
+  acquire_pages(off_t start, size_t size);
+
+  // Release the pages covering a view.  If WRITE is true, first write
+  // the view to the file.  Pages no longer used by any view are
+  // dropped from memory.
+  void
+  release_pages(off_t start, size_t size, bool write);
+
+  // Write data to the file when streaming.
+  void
+  stream_write(off_t offset, const void* data, size_t len);
+
+  // Per page state when streaming.
+  struct Stream_page
+  {
+    Stream_page()
+      : users(0), is_dropped(false)
+    { }
+
+    // The number of views using the page.
+    unsigned int users;
+    // Whether the page has been dropped from memory, in which case
+    // its contents are only in the file.
+    bool is_dropped;
+  };
+
   // File name.
   const char* name_;
   // File descriptor.
@@ -3177,6 +3472,14 @@ class Output_file
   bool map_is_anonymous_;
   // True if this is a temporary file which should not be output.
   bool is_temporary_;
+  // True if views are written to the file as they are released.
+  bool is_streaming_;
+  // The system page size, when streaming.
+  size_t page_size_;
+  // The state of each page, when streaming.
+  std::vector<Stream_page> stream_pages_;
+  // Lock for stream_pages_.
+  Lock* stream_lock_;
 };
 
 } // End namespace gold.
@@ -55,6 +55,9 @@ register_claim_file(ld_plugin_claim_file_handler handler);
 static enum ld_plugin_status
 register_all_symbols_read(ld_plugin_all_symbols_read_handler handler);
 
+static enum ld_plugin_status
+register_compile_partition(ld_plugin_compile_partition_handler handler);
+
 static enum ld_plugin_status
 register_cleanup(ld_plugin_cleanup_handler handler);
 
@@ -73,6 +76,12 @@ get_symbols(const void *handle, int nsyms, struct ld_plugin_symbol *syms);
 static enum ld_plugin_status
 add_input_file(char *pathname);
 
+static enum ld_plugin_status
+set_partition_count(int count);
+
+static enum ld_plugin_status
+add_partition_input_file(void *handle, char *pathname);
+
 static enum ld_plugin_status
 message(int level, const char *format, ...);
 
@@ -118,7 +127,7 @@ Plugin::load()
   sscanf(ver, "%d.%d", &major, &minor);
 
   // Allocate and populate a transfer vector.
-  const int tv_fixed_size = 13;
+  const int tv_fixed_size = 16;
   int tv_size = this->args_.size() + tv_fixed_size;
   ld_plugin_tv *tv = new ld_plugin_tv[tv_size];
 
@@ -160,6 +169,10 @@ Plugin::load()
   tv[i].tv_tag = LDPT_REGISTER_ALL_SYMBOLS_READ_HOOK;
   tv[i].tv_u.tv_register_all_symbols_read = register_all_symbols_read;
 
+  ++i;
+  tv[i].tv_tag = LDPT_REGISTER_COMPILE_PARTITION_HOOK;
+  tv[i].tv_u.tv_register_compile_partition = register_compile_partition;
+
   ++i;
   tv[i].tv_tag = LDPT_REGISTER_CLEANUP_HOOK;
   tv[i].tv_u.tv_register_cleanup = register_cleanup;
@@ -184,6 +197,14 @@ Plugin::load()
   tv[i].tv_tag = LDPT_ADD_INPUT_FILE;
   tv[i].tv_u.tv_add_input_file = add_input_file;
 
+  ++i;
+  tv[i].tv_tag = LDPT_SET_PARTITION_COUNT;
+  tv[i].tv_u.tv_set_partition_count = gold::set_partition_count;
+
+  ++i;
+  tv[i].tv_tag = LDPT_ADD_PARTITION_INPUT_FILE;
+  tv[i].tv_u.tv_add_partition_input_file = add_partition_input_file;
+
   ++i;
   tv[i].tv_tag = LDPT_NULL;
   tv[i].tv_u.tv_val = 0;
@@ -222,6 +243,15 @@ Plugin::all_symbols_read()
     (*this->all_symbols_read_handler_)();
 }
 
+// Call the compile-partition handler.
+
+inline void
+Plugin::compile_partition(int partition, void* handle)
+{
+  if (this->compile_partition_handler_ != NULL)
+    (*this->compile_partition_handler_)(partition, handle);
+}
+
 // Call the cleanup handler.
 
 inline void
@@ -318,9 +348,59 @@ Plugin_manager::all_symbols_read(Workqueue* workqueue, Task* task,
        ++this->current_)
     (*this->current_)->all_symbols_read();
 
+  this->in_partition_phase_ = true;
+  this->queue_partitions();
+
   *last_blocker = this->this_blocker_;
 }
 
+// Queue a task for each partition requested by an all-symbols-read
+// handler.  The partitions are compiled independently, and the files
+// they add are read as soon as they are added.  We chain the input
+// files of each partition after those of the previous partition, so
+// that symbols are still added in a predictable order.
+
+void
+Plugin_manager::queue_partitions()
+{
+  for (Plugin_list::iterator p = this->plugins_.begin();
+       p != this->plugins_.end();
+       ++p)
+    {
+      for (int i = 0; i < (*p)->partition_count(); ++i)
+        {
+          Partition partition;
+          partition.plugin = *p;
+          partition.partition = i;
+          partition.this_blocker = NULL;
+          this->partitions_.push_back(partition);
+        }
+    }
+
+  // The list must be complete before we queue any tasks, since the
+  // tasks may run in other threads.
+  for (unsigned int handle = 0; handle < this->partitions_.size(); ++handle)
+    {
+      Task_token* next_blocker = new Task_token(true);
+      next_blocker->add_blocker();
+      this->partitions_[handle].this_blocker = this->this_blocker_;
+      this->workqueue_->queue(new Plugin_compile_partition(handle,
+                                                           next_blocker));
+      this->this_blocker_ = next_blocker;
+    }
+}
+
+// Call the compile-partition handler for the partition HANDLE.
+
+void
+Plugin_manager::compile_partition(unsigned int handle)
+{
+  gold_assert(handle < this->partitions_.size());
+  const Partition& partition(this->partitions_[handle]);
+  partition.plugin->compile_partition(partition.partition,
+                                      reinterpret_cast<void*>(handle));
+}
+
 // Layout deferred objects.
 
 void
@@ -365,6 +445,20 @@ Plugin_manager::make_plugin_object(unsigned int handle)
   return obj;
 }
 
+// Set the number of partitions for the current plugin.
+
+ld_plugin_status
+Plugin_manager::set_partition_count(int count)
+{
+  if (!this->in_replacement_phase_
+      || this->in_partition_phase_
+      || this->current_ == this->plugins_.end()
+      || count < 0)
+    return LDPS_ERR;
+  (*this->current_)->set_partition_count(count);
+  return LDPS_OK;
+}
+
 // Get the input file information with an open (possibly re-opened)
 // file descriptor.
 
@@ -402,6 +496,36 @@ Plugin_manager::release_input_file(unsigned int handle)
 
 ld_plugin_status
 Plugin_manager::add_input_file(char *pathname)
+{
+  if (this->in_partition_phase_)
+    {
+      gold_error(_("%s: input files may not be added after the "
+                   "all-symbols-read handler returns"), pathname);
+      return LDPS_ERR;
+    }
+  this->this_blocker_ = this->queue_input_file(pathname, this->this_blocker_);
+  return LDPS_OK;
+}
+
+// Add a new input file for the partition HANDLE.  This is only called
+// by the task compiling that partition, so we don't need a lock.
+
+ld_plugin_status
+Plugin_manager::add_partition_input_file(unsigned int handle, char *pathname)
+{
+  if (handle >= this->partitions_.size())
+    return LDPS_BAD_HANDLE;
+  Partition* partition = &this->partitions_[handle];
+  partition->this_blocker = this->queue_input_file(pathname,
+                                                   partition->this_blocker);
+  return LDPS_OK;
+}
+
+// Queue a Read_symbols task for PATHNAME.
+
+Task_token*
+Plugin_manager::queue_input_file(const char* pathname,
+                                 Task_token* this_blocker)
 {
   Input_file_argument file(pathname, false, "", false, this->options_);
   Input_argument* input_argument = new Input_argument(file);
@@ -418,10 +542,9 @@ Plugin_manager::add_input_file(char *pathname)
                                                 this->mapfile_,
                                                 input_argument,
                                                 NULL,
-                                                this->this_blocker_,
+                                                this_blocker,
                                                 next_blocker));
-  this->this_blocker_ = next_blocker;
-  return LDPS_OK;
+  return next_blocker;
 }
 
 // Class Pluginobj.
@@ -809,6 +932,65 @@ class Plugin_finish : public Task
   Task_token* next_blocker_;
 };
 
+// Class Plugin_partition_finish.  This task runs after the
+// compile-partition handler for a partition returns, and after the
+// input files it added have been read.  It does no work itself; it
+// just unblocks the input files of the next partition.
+
+class Plugin_partition_finish : public Task
+{
+ public:
+  Plugin_partition_finish(Task_token* this_blocker, Task_token* next_blocker)
+    : this_blocker_(this_blocker), next_blocker_(next_blocker)
+  { }
+
+  ~Plugin_partition_finish()
+  {
+    if (this->this_blocker_ != NULL)
+      delete this->this_blocker_;
+  }
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->this_blocker_ != NULL && this->this_blocker_->is_blocked())
+      return this->this_blocker_;
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->next_blocker_); }
+
+  void
+  run(Workqueue*)
+  { }
+
+  std::string
+  get_name() const
+  { return "Plugin_partition_finish"; }
+
+ private:
+  Task_token* this_blocker_;
+  Task_token* next_blocker_;
+};
+
+// Class Plugin_compile_partition.
+
+// Run the compile-partition handler.  It may add input files, which
+// are queued for reading as they arrive.  When it returns, no more
+// files can be added to the partition.
+
+void
+Plugin_compile_partition::run(Workqueue* workqueue)
+{
+  Plugin_manager* plugins = parameters->options().plugins();
+  gold_assert(plugins != NULL);
+  plugins->compile_partition(this->handle_);
+  workqueue->queue_soon(new Plugin_partition_finish(
+      plugins->partition_blocker(this->handle_), this->next_blocker_));
+}
+
 // Class Plugin_hook.
 
 Plugin_hook::~Plugin_hook()
@@ -875,6 +1057,16 @@ register_all_symbols_read(ld_plugin_all_symbols_read_handler handler)
   return LDPS_OK;
 }
 
+// Register a compile-partition handler.
+
+static enum ld_plugin_status
+register_compile_partition(ld_plugin_compile_partition_handler handler)
+{
+  gold_assert(parameters->options().has_plugins());
+  parameters->options().plugins()->set_compile_partition_handler(handler);
+  return LDPS_OK;
+}
+
 // Register a cleanup handler.
 
 static enum ld_plugin_status
@@ -944,6 +1136,27 @@ add_input_file(char *pathname)
   return parameters->options().plugins()->add_input_file(pathname);
 }
 
+// Set the number of partitions to compile.
+
+static enum ld_plugin_status
+set_partition_count(int count)
+{
+  gold_assert(parameters->options().has_plugins());
+  return parameters->options().plugins()->set_partition_count(count);
+}
+
+// Add a new (real) input file generated by a compile-partition handler.
+
+static enum ld_plugin_status
+add_partition_input_file(void *handle, char *pathname)
+{
+  gold_assert(parameters->options().has_plugins());
+  unsigned int partition_index =
+      static_cast<unsigned int>(reinterpret_cast<intptr_t>(handle));
+  return parameters->options().plugins()->add_partition_input_file(
+      partition_index, pathname);
+}
+
 // Issue a diagnostic message from a plugin.
 
 static enum ld_plugin_status
@@ -54,7 +54,9 @@ class Plugin
       args_(),
       claim_file_handler_(NULL),
       all_symbols_read_handler_(NULL),
-      cleanup_handler_(NULL)      
+      compile_partition_handler_(NULL),
+      cleanup_handler_(NULL),
+      partition_count_(0)
   { }
 
   ~Plugin()
@@ -72,6 +74,10 @@ class Plugin
   void
   all_symbols_read();
 
+  // Call the compile-partition handler for PARTITION.
+  void
+  compile_partition(int partition, void* handle);
+
   // Call the cleanup handler.
   void
   cleanup();
@@ -86,11 +92,27 @@ class Plugin
   set_all_symbols_read_handler(ld_plugin_all_symbols_read_handler handler)
   { this->all_symbols_read_handler_ = handler; }
 
+  // Register a compile-partition handler.
+  void
+  set_compile_partition_handler(ld_plugin_compile_partition_handler handler)
+  { this->compile_partition_handler_ = handler; }
+
   // Register a claim-file handler.
   void
   set_cleanup_handler(ld_plugin_cleanup_handler handler)
   { this->cleanup_handler_ = handler; }
 
+  // Return the number of partitions requested by the all-symbols-read
+  // handler.
+  int
+  partition_count() const
+  { return this->partition_count_; }
+
+  // Set the number of partitions.
+  void
+  set_partition_count(int count)
+  { this->partition_count_ = count; }
+
   // Add an argument
   void
   add_option(const char *arg)
@@ -111,7 +133,10 @@ class Plugin
   // The plugin's event handlers.
   ld_plugin_claim_file_handler claim_file_handler_;
   ld_plugin_all_symbols_read_handler all_symbols_read_handler_;
+  ld_plugin_compile_partition_handler compile_partition_handler_;
   ld_plugin_cleanup_handler cleanup_handler_;
+  // The number of times to call the compile-partition handler.
+  int partition_count_;
 };
 
 // A manager class for plugins.
@@ -121,7 +146,8 @@ class Plugin_manager
  public:
   Plugin_manager(const General_options& options)
     : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
-      plugin_input_file_(), in_replacement_phase_(false), cleanup_done_(false),
+      plugin_input_file_(), partitions_(), in_replacement_phase_(false),
+      in_partition_phase_(false), cleanup_done_(false),
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
       this_blocker_(NULL)
@@ -181,6 +207,14 @@ class Plugin_manager
     (*this->current_)->set_all_symbols_read_handler(handler);
   }
 
+  // Register a compile-partition handler.
+  void
+  set_compile_partition_handler(ld_plugin_compile_partition_handler handler)
+  {
+    gold_assert(this->current_ != plugins_.end());
+    (*this->current_)->set_compile_partition_handler(handler);
+  }
+
   // Register a claim-file handler.
   void
   set_cleanup_handler(ld_plugin_cleanup_handler handler)
@@ -189,6 +223,11 @@ class Plugin_manager
     (*this->current_)->set_cleanup_handler(handler);
   }
 
+  // Set the number of partitions for the current plugin.  This is
+  // called when the plugin calls the set_partition_count API.
+  ld_plugin_status
+  set_partition_count(int count);
+
   // Make a new Pluginobj object.  This is called when the plugin calls
   // the add_symbols API.
   Pluginobj*
@@ -229,6 +268,24 @@ class Plugin_manager
   ld_plugin_status
   add_input_file(char *pathname);
 
+  // Add a new input file from the compile-partition handler for the
+  // partition HANDLE.
+  ld_plugin_status
+  add_partition_input_file(unsigned int handle, char *pathname);
+
+  // Call the compile-partition handler for the partition HANDLE.
+  void
+  compile_partition(unsigned int handle);
+
+  // Return the end of the input file chain for the partition HANDLE.
+  // This is called after the compile-partition handler returns.
+  Task_token*
+  partition_blocker(unsigned int handle) const
+  {
+    gold_assert(handle < this->partitions_.size());
+    return this->partitions_[handle].this_blocker;
+  }
+
   // Return TRUE if we are in the replacement phase.
   bool
   in_replacement_phase() const
@@ -242,6 +299,30 @@ class Plugin_manager
   typedef std::vector<Pluginobj*> Object_list;
   typedef std::vector<Relobj*> Deferred_layout_list;
 
+  // A partition to be compiled by a plugin.  The index of an item in
+  // the list of partitions is the handle that we pass to the plugin.
+  struct Partition
+  {
+    // The plugin which requested the partition.
+    Plugin* plugin;
+    // The partition number to pass to the plugin.
+    int partition;
+    // The blocker for the next file added for this partition.  This
+    // is only used by the task compiling the partition.
+    Task_token* this_blocker;
+  };
+  typedef std::vector<Partition> Partition_list;
+
+  // Queue a Read_symbols task for PATHNAME after THIS_BLOCKER, and
+  // return the token which blocks the next input file.
+  Task_token*
+  queue_input_file(const char* pathname, Task_token* this_blocker);
+
+  // Queue the tasks to compile the partitions requested by the
+  // all-symbols-read handlers.
+  void
+  queue_partitions();
+
   // The list of plugin libraries.
   Plugin_list plugins_;
   // A pointer to the current plugin.  Used while loading plugins.
@@ -258,11 +339,18 @@ class Plugin_manager
   Input_file* input_file_;
   struct ld_plugin_input_file plugin_input_file_;
 
+  // The partitions to compile.
+  Partition_list partitions_;
+
   // TRUE after the all symbols read event; indicates that we are
   // processing replacement files whose symbols should replace the
   // placeholder symbols from the Pluginobj objects.
   bool in_replacement_phase_;
 
+  // TRUE after the all symbols read handlers have returned; input
+  // files may then only be added through add_partition_input_file.
+  bool in_partition_phase_;
+
   // TRUE if the cleanup handlers have been called.
   bool cleanup_done_;
 
@@ -424,6 +512,41 @@ class Sized_pluginobj : public Pluginobj
  private:
 };
 
+// This Task calls the compile-partition handler for one partition
+// requested by a plugin.  The tasks for different partitions may run
+// at the same time.
+
+class Plugin_compile_partition : public Task
+{
+ public:
+  Plugin_compile_partition(unsigned int handle, Task_token* next_blocker)
+    : handle_(handle), next_blocker_(next_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Plugin_compile_partition"; }
+
+ private:
+  // The partition handle.
+  unsigned int handle_;
+  // The blocker for the input files of the next partition.
+  Task_token* next_blocker_;
+};
+
 // This Task handles handles the "all symbols read" event hook.
 // The plugin may add additional input files at this time, which must
 // be queued for reading.
@@ -478,13 +478,113 @@ Add_symbols::run(Workqueue* workqueue)
   else
     {
       this->object_->layout(this->symtab_, this->layout_, this->sd_);
+
+      // With threads, a large relocatable object may hand back the
+      // work of adding its symbols, so that we can add them one
+      // shard of the symbol table at a time, in parallel.
+      this->sd_->allow_shard_adder = parameters->options().threads();
+
       this->object_->add_symbols(this->symtab_, this->sd_, this->layout_);
       this->object_->release();
+
+      Symbol_shard_adder* adder = this->sd_->shard_adder;
+      if (adder != NULL)
+	{
+	  // The next input file must wait until all the shards are
+	  // done.  The new blockers are added before the tasks are
+	  // visible to any other thread.
+	  Task_token* shards_blocker = new Task_token(true);
+	  for (unsigned int i = 0; i < Symbol_table::shard_count; ++i)
+	    shards_blocker->add_blocker();
+	  workqueue->add_blocker(this->next_blocker_);
+	  workqueue->queue_soon(new Finish_add_symbols_shards(this->object_,
+							      adder,
+							      shards_blocker,
+							      this->next_blocker_));
+	  for (unsigned int i = 0; i < Symbol_table::shard_count; ++i)
+	    workqueue->queue_soon(new Add_symbols_shard(this->object_, adder,
+							i, shards_blocker));
+	}
     }
   delete this->sd_;
   this->sd_ = NULL;
 }
 
+// Class Add_symbols_shard.
+
+// We only need to wait for Add_symbols, which queued us.
+
+Task_token*
+Add_symbols_shard::is_runnable()
+{
+  return NULL;
+}
+
+// We unblock Finish_add_symbols_shards.
+
+void
+Add_symbols_shard::locks(Task_locker* tl)
+{
+  tl->add(this, this->shards_blocker_);
+}
+
+// Add the symbols in our shard.
+
+void
+Add_symbols_shard::run(Workqueue*)
+{
+  this->adder_->add_shard(this->shard_);
+}
+
+// Return a name for the task.
+
+std::string
+Add_symbols_shard::get_name() const
+{
+  char buf[30];
+  snprintf(buf, sizeof buf, " shard %u", this->shard_);
+  return "Add_symbols " + this->object_->name() + buf;
+}
+
+// Class Finish_add_symbols_shards.
+
+Finish_add_symbols_shards::~Finish_add_symbols_shards()
+{
+  delete this->shards_blocker_;
+  // next_blocker_ is deleted by the task associated with the next
+  // input file.
+}
+
+// We need to wait for all the shards, and for the object file, which
+// we need to lock to free the views of the symbols.
+
+Task_token*
+Finish_add_symbols_shards::is_runnable()
+{
+  if (this->shards_blocker_->is_blocked())
+    return this->shards_blocker_;
+  if (this->object_->is_locked())
+    return this->object_->token();
+  return NULL;
+}
+
+void
+Finish_add_symbols_shards::locks(Task_locker* tl)
+{
+  tl->add(this, this->next_blocker_);
+  tl->add(this, this->object_->token());
+}
+
+// Free the symbol data.
+
+void
+Finish_add_symbols_shards::run(Workqueue*)
+{
+  delete this->adder_;
+  this->adder_ = NULL;
+  this->object_->release();
+}
+
 // Class Finish_group.
 
 Finish_group::~Finish_group()
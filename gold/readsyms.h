@@ -33,6 +33,7 @@ namespace gold
 
 class Input_objects;
 class Symbol_table;
+class Symbol_shard_adder;
 class Input_group;
 class Archive;
 
@@ -169,6 +170,82 @@ private:
   Task_token* next_blocker_;
 };
 
+// This Task adds the symbols of a large relocatable object which
+// belong to one shard of the symbol table.  Add_symbols queues one of
+// these for each shard, so the shards are filled in parallel.
+
+class Add_symbols_shard : public Task
+{
+ public:
+  // ADDER holds the symbols to add.  SHARDS_BLOCKER is used to
+  // prevent the Finish_add_symbols_shards task from running until all
+  // the shards are done.
+  Add_symbols_shard(Object* object, Symbol_shard_adder* adder,
+		    unsigned int shard, Task_token* shards_blocker)
+    : object_(object), adder_(adder), shard_(shard),
+      shards_blocker_(shards_blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  Object* object_;
+  Symbol_shard_adder* adder_;
+  unsigned int shard_;
+  Task_token* shards_blocker_;
+};
+
+// This Task runs after all the Add_symbols_shard tasks for an object.
+// It frees the symbol data and unblocks the next input file.
+
+class Finish_add_symbols_shards : public Task
+{
+ public:
+  // SHARDS_BLOCKER is unblocked when all the shards are done.  We
+  // block NEXT_BLOCKER, which Add_symbols was blocking.
+  Finish_add_symbols_shards(Object* object, Symbol_shard_adder* adder,
+			    Task_token* shards_blocker,
+			    Task_token* next_blocker)
+    : object_(object), adder_(adder), shards_blocker_(shards_blocker),
+      next_blocker_(next_blocker)
+  { }
+
+  ~Finish_add_symbols_shards();
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const
+  { return "Finish_add_symbols_shards " + this->object_->name(); }
+
+ private:
+  Object* object_;
+  Symbol_shard_adder* adder_;
+  Task_token* shards_blocker_;
+  Task_token* next_blocker_;
+};
+
 // This class is used to track the archives in a group.
 
 class Input_group
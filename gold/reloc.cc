@@ -103,15 +103,25 @@ Read_relocs::get_name() const
 Task_token*
 Gc_process_relocs::is_runnable()
 {
+  if (parameters->options().icf() && !this->symtab_lock_->is_writable())
+    return this->symtab_lock_;
   if (this->object_->is_locked())
     return this->object_->token();
   return NULL;
 }
 
+// Return the locks we hold: one on the file, one on the symbol table
+// and one blocker.  For --icf the symbol table lock is needed because
+// the relocs are recorded in maps shared by all the objects.  For
+// --gc-sections each object records the references of its own
+// sections, so the objects can be processed in parallel.
+
 void
 Gc_process_relocs::locks(Task_locker* tl)
 {
   tl->add(this, this->object_->token());
+  if (parameters->options().icf())
+    tl->add(this, this->symtab_lock_);
   tl->add(this, this->blocker_);
 }
 
@@ -209,17 +219,53 @@ Relocate_task::locks(Task_locker* tl)
   tl->add(this, this->object_->token());
 }
 
-// Run the task.
+// Run the task.  When using threads, the relocations of a large
+// object are split into groups which are applied by separate tasks;
+// a Relocate_finish_task then takes over our blockers.
 
 void
-Relocate_task::run(Workqueue*)
+Relocate_task::run(Workqueue* workqueue)
 {
-  this->object_->relocate(this->options_, this->symtab_, this->layout_,
-			  this->of_);
+  unsigned int groups = 0;
+  if (parameters->options().threads())
+    groups = this->object_->relocate_split(this->options_, this->symtab_,
+					   this->layout_, this->of_);
+  if (groups == 0)
+    {
+      this->object_->relocate(this->options_, this->symtab_, this->layout_,
+			      this->of_);
 
-  // This is normally the last thing we will do with an object, so
-  // uncache all views.
-  this->object_->clear_view_cache_marks();
+      // This is normally the last thing we will do with an object, so
+      // uncache all views.
+      this->object_->clear_view_cache_marks();
+    }
+  else
+    {
+      Task_token* groups_blocker = new Task_token(true);
+      for (unsigned int i = 0; i < groups; ++i)
+	groups_blocker->add_blocker();
+
+      if (this->input_sections_blocker_ != NULL)
+	workqueue->add_blocker(this->input_sections_blocker_);
+      workqueue->add_blocker(this->final_blocker_);
+
+      for (unsigned int i = 0; i < groups; ++i)
+	workqueue->queue_soon(new Relocate_group_task(this->options_,
+						      this->symtab_,
+						      this->layout_,
+						      this->object_, i,
+						      groups_blocker));
+
+      workqueue->queue(new Relocate_finish_task(this->layout_, this->object_,
+						this->of_,
+						this->input_sections_blocker_,
+						this->final_blocker_,
+						groups_blocker));
+    }
+
+  // If the relocation was split, Relocate_finish_task does this.
+  if (groups == 0)
+    this->object_->release_input_pages();
 
   this->object_->release();
 }
@@ -232,6 +278,95 @@ Relocate_task::get_name() const
   return "Relocate_task " + this->object_->name();
 }
 
+// Relocate_group_task methods.
+
+// A group may always run.
+
+Task_token*
+Relocate_group_task::is_runnable()
+{
+  return NULL;
+}
+
+// We unblock BLOCKER when we are done.  We do not lock the object.
+
+void
+Relocate_group_task::locks(Task_locker* tl)
+{
+  tl->add(this, this->blocker_);
+}
+
+// Run the task.
+
+void
+Relocate_group_task::run(Workqueue*)
+{
+  this->object_->relocate_group(this->options_, this->symtab_, this->layout_,
+				this->group_);
+}
+
+// Return a debugging name for the task.
+
+std::string
+Relocate_group_task::get_name() const
+{
+  char buf[30];
+  snprintf(buf, sizeof buf, " group %u", this->group_);
+  return "Relocate_group_task " + this->object_->name() + buf;
+}
+
+// Relocate_finish_task methods.
+
+Relocate_finish_task::~Relocate_finish_task()
+{
+  delete this->groups_blocker_;
+}
+
+// We have to wait for all the groups, and for the object.
+
+Task_token*
+Relocate_finish_task::is_runnable()
+{
+  if (this->groups_blocker_->is_blocked())
+    return this->groups_blocker_;
+
+  if (this->object_->is_locked())
+    return this->object_->token();
+
+  return NULL;
+}
+
+// We lock the object, and unblock the blockers of the original
+// Relocate_task.
+
+void
+Relocate_finish_task::locks(Task_locker* tl)
+{
+  if (this->input_sections_blocker_ != NULL)
+    tl->add(this, this->input_sections_blocker_);
+  tl->add(this, this->final_blocker_);
+  tl->add(this, this->object_->token());
+}
+
+// Run the task.
+
+void
+Relocate_finish_task::run(Workqueue*)
+{
+  this->object_->relocate_finish(this->layout_, this->of_);
+  this->object_->clear_view_cache_marks();
+  this->object_->release_input_pages();
+  this->object_->release();
+}
+
+// Return a debugging name for the task.
+
+std::string
+Relocate_finish_task::get_name() const
+{
+  return "Relocate_finish_task " + this->object_->name();
+}
+
 // Read the relocs and local symbols from the object file and store
 // the information in RD.
 
@@ -588,13 +723,241 @@ Sized_relobj<size, big_endian>::do_relocate(const General_options& options,
 
   // Apply relocations.
 
-  this->relocate_sections(options, symtab, layout, pshdrs, &views);
+  this->relocate_sections(options, symtab, layout, pshdrs, &views, 1, shnum,
+			  NULL, NULL);
 
   // After we've done the relocations, we release the hash tables,
   // since we no longer need them.
   this->free_input_to_output_maps();
 
   // Write out the accumulated views.
+  this->write_views(of, views);
+
+  // Write out the local symbols.
+  this->write_local_symbols(of, layout->sympool(), layout->dynpool(),
+			    layout->symtab_xindex(), layout->dynsym_xindex());
+
+  // The local symbol values are not cleared here.  Dynamic relocs
+  // against local symbols look them up when they are written, and
+  // unless relocs_must_follow_section_writes is set that may happen
+  // after this task has finished.
+}
+
+// The number of relocations we try to put in each group when
+// splitting the relocation of an object among several tasks.  An
+// object is only split if it has at least two groups.
+
+static const size_t relocs_per_group = 32768;
+
+// Prepare to split the relocation of the object among several tasks.
+// This is called with the object locked.  We copy the section data
+// to the output file, and read all the relocation sections and the
+// section names, so that the groups do not need to read the input
+// file, which they may not lock.  Return the number of groups, or 0
+// if the object should not be split.
+
+template<int size, bool big_endian>
+unsigned int
+Sized_relobj<size, big_endian>::do_relocate_split(const General_options&,
+						  const Symbol_table*,
+						  const Layout*,
+						  Output_file* of)
+{
+  // A relocatable link or --emit-relocs writes out relocation
+  // sections as well, which we don't try to do in parallel.
+  if (parameters->options().relocatable()
+      || parameters->options().emit_relocs())
+    return 0;
+
+  unsigned int shnum = this->shnum();
+  if (shnum == 0)
+    return 0;
+
+  File_view* shdrs_view = this->get_lasting_view(this->elf_file_.shoff(),
+						 shnum * This::shdr_size,
+						 true, true);
+  const unsigned char* pshdrs = shdrs_view->data();
+  const Output_sections& out_sections(this->output_sections());
+
+  // Divide the relocation sections into groups of consecutive
+  // sections.
+  std::vector<unsigned int> group_starts;
+  group_starts.push_back(1);
+  size_t count = 0;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type != elfcpp::SHT_REL && sh_type != elfcpp::SHT_RELA)
+	continue;
+      unsigned int index = this->adjust_shndx(shdr.get_sh_info());
+      if (index >= shnum || out_sections[index] == NULL)
+	continue;
+      count += (shdr.get_sh_size()
+		/ (sh_type == elfcpp::SHT_REL
+		   ? elfcpp::Elf_sizes<size>::rel_size
+		   : elfcpp::Elf_sizes<size>::rela_size));
+      if (count >= relocs_per_group)
+	{
+	  group_starts.push_back(i + 1);
+	  count = 0;
+	}
+    }
+  if (count > 0 || group_starts.back() < shnum)
+    group_starts.push_back(shnum);
+  if (group_starts.size() < 3)
+    {
+      delete shdrs_view;
+      return 0;
+    }
+
+  Split_relocate* sr = new Split_relocate();
+  sr->pshdrs = pshdrs;
+  sr->file_views.push_back(shdrs_view);
+  sr->views.resize(shnum);
+  sr->prelocs.resize(shnum);
+  sr->group_starts.swap(group_starts);
+  sr->diagnostics.resize(sr->group_starts.size() - 1);
+
+  this->write_sections(pshdrs, of, &sr->views);
+
+  this->initialize_input_to_output_maps();
+
+  // Read the relocation sections now, while the object is locked.
+  // We use lasting views, so that they survive releasing the object.
+  // The section names are needed when a relocation refers to a
+  // discarded section.
+  sr->section_names.resize(shnum);
+  p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      sr->section_names[i] = this->elf_file_.section_name(i);
+      unsigned int sh_type = shdr.get_sh_type();
+      if ((sh_type == elfcpp::SHT_REL || sh_type == elfcpp::SHT_RELA)
+	  && shdr.get_sh_size() > 0)
+	{
+	  File_view* fv = this->get_lasting_view(shdr.get_sh_offset(),
+						 shdr.get_sh_size(),
+						 true, false);
+	  sr->file_views.push_back(fv);
+	  sr->prelocs[i] = fv->data();
+	}
+    }
+
+  this->split_relocate_ = sr;
+  return sr->group_starts.size() - 1;
+}
+
+// Apply the relocations of group GROUP.  This runs without the object
+// being locked, so it does not read the input file.  Errors and
+// warnings are saved, to be reported by do_relocate_finish.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::do_relocate_group(
+    const General_options& options,
+    const Symbol_table* symtab,
+    const Layout* layout,
+    unsigned int group)
+{
+  Split_relocate* sr = this->split_relocate_;
+  gold_assert(sr != NULL && group + 1 < sr->group_starts.size());
+  this->relocate_sections(options, symtab, layout, sr->pshdrs, &sr->views,
+			  sr->group_starts[group],
+			  sr->group_starts[group + 1],
+			  &sr->prelocs, &sr->diagnostics[group]);
+}
+
+// Finish a split relocation, once all the groups are done.  This is
+// called with the object locked.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::do_relocate_finish(const Layout* layout,
+						   Output_file* of)
+{
+  Split_relocate* sr = this->split_relocate_;
+  gold_assert(sr != NULL);
+
+  this->free_input_to_output_maps();
+
+  this->report_deferred_diagnostics(layout);
+
+  this->write_views(of, sr->views);
+
+  this->write_local_symbols(of, layout->sympool(), layout->dynpool(),
+			    layout->symtab_xindex(), layout->dynsym_xindex());
+
+  for (std::vector<File_view*>::iterator p = sr->file_views.begin();
+       p != sr->file_views.end();
+       ++p)
+    delete *p;
+  delete sr;
+  this->split_relocate_ = NULL;
+}
+
+// Report the errors and warnings which the groups of a split
+// relocation saved, in the order in which they would have been
+// reported had the relocation not been split.  This is called with
+// the object locked, so the locations may be read from the input
+// file.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::report_deferred_diagnostics(
+    const Layout* layout)
+{
+  Split_relocate* sr = this->split_relocate_;
+
+  Relocate_info<size, big_endian> relinfo;
+  relinfo.options = &parameters->options();
+  relinfo.symtab = NULL;
+  relinfo.layout = layout;
+  relinfo.object = this;
+  relinfo.deferred = NULL;
+
+  for (std::vector<Deferred_reloc_diagnostics>::const_iterator p =
+	 sr->diagnostics.begin();
+       p != sr->diagnostics.end();
+       ++p)
+    {
+      for (Deferred_reloc_diagnostics::const_iterator q = p->begin();
+	   q != p->end();
+	   ++q)
+	{
+	  relinfo.reloc_shndx = q->reloc_shndx;
+	  relinfo.data_shndx = q->data_shndx;
+	  switch (q->kind)
+	    {
+	    case Deferred_reloc_diagnostic::DEFERRED_ERROR:
+	      gold_error_at_location(&relinfo, q->relnum, q->reloffset, "%s",
+				     q->message.c_str());
+	      break;
+	    case Deferred_reloc_diagnostic::DEFERRED_WARNING:
+	      gold_warning_at_location(&relinfo, q->relnum, q->reloffset, "%s",
+				       q->message.c_str());
+	      break;
+	    case Deferred_reloc_diagnostic::DEFERRED_UNDEFINED_SYMBOL:
+	      gold_undefined_symbol_at_location(q->sym, &relinfo, q->relnum,
+						q->reloffset);
+	      break;
+	    default:
+	      gold_unreachable();
+	    }
+	}
+    }
+}
+
+// Write out the views after relocation.
+
+template<int size, bool big_endian>
+void
+Sized_relobj<size, big_endian>::write_views(Output_file* of,
+					    const Views& views)
+{
+  unsigned int shnum = this->shnum();
   for (unsigned int i = 1; i < shnum; ++i)
     {
       if (views[i].view != NULL)
@@ -611,13 +974,6 @@ Sized_relobj<size, big_endian>::do_relocate(const General_options& options,
 	    }
 	}
     }
-
-  // Write out the local symbols.
-  this->write_local_symbols(of, layout->sympool(), layout->dynpool(),
-			    layout->symtab_xindex(), layout->dynsym_xindex());
-
-  // We should no longer need the local symbol values.
-  this->clear_local_symbols();
 }
 
 // Sort a Read_multiple vector by file offset.
@@ -790,7 +1146,8 @@ Sized_relobj<size, big_endian>::write_sections(const unsigned char* pshdrs,
 }
 
 // Relocate section data.  VIEWS points to the section data as views
-// in the output file.
+// in the output file.  We handle the relocation sections from FIRST
+// up to LAST.
 
 template<int size, bool big_endian>
 void
@@ -799,9 +1156,12 @@ Sized_relobj<size, big_endian>::relocate_sections(
     const Symbol_table* symtab,
     const Layout* layout,
     const unsigned char* pshdrs,
-    Views* pviews)
+    Views* pviews,
+    unsigned int first,
+    unsigned int last,
+    const std::vector<const unsigned char*>* prelocs_vector,
+    Deferred_reloc_diagnostics* deferred)
 {
-  unsigned int shnum = this->shnum();
   Sized_target<size, big_endian>* target = this->sized_target();
 
   const Output_sections& out_sections(this->output_sections());
@@ -812,9 +1172,10 @@ Sized_relobj<size, big_endian>::relocate_sections(
   relinfo.symtab = symtab;
   relinfo.layout = layout;
   relinfo.object = this;
+  relinfo.deferred = deferred;
 
-  const unsigned char* p = pshdrs + This::shdr_size;
-  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+  const unsigned char* p = pshdrs + first * This::shdr_size;
+  for (unsigned int i = first; i < last; ++i, p += This::shdr_size)
     {
       typename This::Shdr shdr(p);
 
@@ -855,8 +1216,11 @@ Sized_relobj<size, big_endian>::relocate_sections(
 	  continue;
 	}
 
-      const unsigned char* prelocs = this->get_view(shdr.get_sh_offset(),
-						    sh_size, true, false);
+      const unsigned char* prelocs;
+      if (prelocs_vector != NULL)
+	prelocs = (*prelocs_vector)[i];
+      else
+	prelocs = this->get_view(shdr.get_sh_offset(), sh_size, true, false);
 
       unsigned int reloc_size;
       if (sh_type == elfcpp::SHT_REL)
@@ -993,8 +1357,8 @@ Sized_relobj<size, big_endian>::emit_relocs_reltype(
     reloc_view_size);
 }
 
-// Create merge hash tables for the local symbols.  These are used to
-// speed up relocations.
+// Look up the final merge mappings for the local symbols.  These are
+// used to speed up relocations.
 
 template<int size, bool big_endian>
 void
@@ -1008,7 +1372,7 @@ Sized_relobj<size, big_endian>::initialize_input_to_output_maps()
     }
 }
 
-// Free merge hash tables for the local symbols.
+// Forget the merge mappings for the local symbols.
 
 template<int size, bool big_endian>
 void
@@ -1031,13 +1395,10 @@ Merged_symbol_value<size>::initialize_input_to_output_map(
     unsigned int input_shndx)
 {
   Object_merge_map* map = object->merge_map();
-  map->initialize_input_to_output_map<size>(input_shndx,
-					    this->output_start_address_,
-					    &this->output_addresses_);
+  this->offset_table_ = map->offset_table(input_shndx);
 }
 
-// Get the output value corresponding to an input offset if we
-// couldn't find it in the hash table.
+// Get the output value corresponding to an input offset.
 
 template<int size>
 typename elfcpp::Elf_types<size>::Elf_Addr
@@ -1047,9 +1408,14 @@ Merged_symbol_value<size>::value_from_output_section(
     typename elfcpp::Elf_types<size>::Elf_Addr input_offset) const
 {
   section_offset_type output_offset;
-  bool found = object->merge_map()->get_output_offset(NULL, input_shndx,
-						      input_offset,
-						      &output_offset);
+  bool found;
+  if (this->offset_table_ != NULL)
+    found = this->offset_table_->get_output_offset(input_offset,
+						   &output_offset);
+  else
+    found = object->merge_map()->get_output_offset(NULL, input_shndx,
+						   input_offset,
+						   &output_offset);
 
   // If this assertion fails, it means that some relocation was
   // against a portion of an input merge section which we didn't map
@@ -1266,6 +1632,31 @@ Sized_relobj<32, false>::do_relocate(const General_options& options,
 				     Output_file* of);
 #endif
 
+#ifdef HAVE_TARGET_32_LITTLE
+template
+unsigned int
+Sized_relobj<32, false>::do_relocate_split(const General_options& options,
+					   const Symbol_table* symtab,
+					   const Layout* layout,
+					   Output_file* of);
+#endif
+
+#ifdef HAVE_TARGET_32_LITTLE
+template
+void
+Sized_relobj<32, false>::do_relocate_group(const General_options& options,
+					   const Symbol_table* symtab,
+					   const Layout* layout,
+					   unsigned int group);
+#endif
+
+#ifdef HAVE_TARGET_32_LITTLE
+template
+void
+Sized_relobj<32, false>::do_relocate_finish(const Layout* layout,
+					    Output_file* of);
+#endif
+
 #ifdef HAVE_TARGET_32_BIG
 template
 void
@@ -1275,6 +1666,31 @@ Sized_relobj<32, true>::do_relocate(const General_options& options,
 				    Output_file* of);
 #endif
 
+#ifdef HAVE_TARGET_32_BIG
+template
+unsigned int
+Sized_relobj<32, true>::do_relocate_split(const General_options& options,
+					  const Symbol_table* symtab,
+					  const Layout* layout,
+					  Output_file* of);
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+void
+Sized_relobj<32, true>::do_relocate_group(const General_options& options,
+					  const Symbol_table* symtab,
+					  const Layout* layout,
+					  unsigned int group);
+#endif
+
+#ifdef HAVE_TARGET_32_BIG
+template
+void
+Sized_relobj<32, true>::do_relocate_finish(const Layout* layout,
+					   Output_file* of);
+#endif
+
 #ifdef HAVE_TARGET_64_LITTLE
 template
 void
@@ -1284,6 +1700,31 @@ Sized_relobj<64, false>::do_relocate(const General_options& options,
 				     Output_file* of);
 #endif
 
+#ifdef HAVE_TARGET_64_LITTLE
+template
+unsigned int
+Sized_relobj<64, false>::do_relocate_split(const General_options& options,
+					   const Symbol_table* symtab,
+					   const Layout* layout,
+					   Output_file* of);
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+void
+Sized_relobj<64, false>::do_relocate_group(const General_options& options,
+					   const Symbol_table* symtab,
+					   const Layout* layout,
+					   unsigned int group);
+#endif
+
+#ifdef HAVE_TARGET_64_LITTLE
+template
+void
+Sized_relobj<64, false>::do_relocate_finish(const Layout* layout,
+					    Output_file* of);
+#endif
+
 #ifdef HAVE_TARGET_64_BIG
 template
 void
@@ -1293,6 +1734,31 @@ Sized_relobj<64, true>::do_relocate(const General_options& options,
 				    Output_file* of);
 #endif
 
+#ifdef HAVE_TARGET_64_BIG
+template
+unsigned int
+Sized_relobj<64, true>::do_relocate_split(const General_options& options,
+					  const Symbol_table* symtab,
+					  const Layout* layout,
+					  Output_file* of);
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+void
+Sized_relobj<64, true>::do_relocate_group(const General_options& options,
+					  const Symbol_table* symtab,
+					  const Layout* layout,
+					  unsigned int group);
+#endif
+
+#ifdef HAVE_TARGET_64_BIG
+template
+void
+Sized_relobj<64, true>::do_relocate_finish(const Layout* layout,
+					   Output_file* of);
+#endif
+
 #if defined(HAVE_TARGET_32_LITTLE) || defined(HAVE_TARGET_32_BIG)
 template
 class Merged_symbol_value<32>;
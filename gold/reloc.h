@@ -212,6 +212,87 @@ class Relocate_task : public Task
   Task_token* final_blocker_;
 };
 
+// When --threads is used, the relocations of a large object are split
+// into groups by Relocate_task.  This class applies the relocations
+// of one group.  It does not lock the object, so several groups of
+// the same object may run at once.
+
+class Relocate_group_task : public Task
+{
+ public:
+  Relocate_group_task(const General_options& options,
+		      const Symbol_table* symtab, const Layout* layout,
+		      Relobj* object, unsigned int group, Task_token* blocker)
+    : options_(options), symtab_(symtab), layout_(layout), object_(object),
+      group_(group), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  const General_options& options_;
+  const Symbol_table* symtab_;
+  const Layout* layout_;
+  Relobj* object_;
+  unsigned int group_;
+  Task_token* blocker_;
+};
+
+// This class finishes relocating an object whose relocations were
+// split into groups, once all the groups are done.  It writes out the
+// sections and the local symbols.  It unblocks the blockers which
+// Relocate_task would have unblocked.
+
+class Relocate_finish_task : public Task
+{
+ public:
+  Relocate_finish_task(const Layout* layout, Relobj* object, Output_file* of,
+		       Task_token* input_sections_blocker,
+		       Task_token* final_blocker, Task_token* groups_blocker)
+    : layout_(layout), object_(object), of_(of),
+      input_sections_blocker_(input_sections_blocker),
+      final_blocker_(final_blocker), groups_blocker_(groups_blocker)
+  { }
+
+  ~Relocate_finish_task();
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable();
+
+  void
+  locks(Task_locker*);
+
+  void
+  run(Workqueue*);
+
+  std::string
+  get_name() const;
+
+ private:
+  const Layout* layout_;
+  Relobj* object_;
+  Output_file* of_;
+  Task_token* input_sections_blocker_;
+  Task_token* final_blocker_;
+  // Blocked until all the groups are done.  This is owned by this
+  // task.
+  Task_token* groups_blocker_;
+};
+
 // During a relocatable link, this class records how relocations
 // should be handled for a single input reloc section.  An instance of
 // this class is created while scanning relocs, and it is used while
@@ -26,6 +26,7 @@
 #include "target.h"
 #include "object.h"
 #include "symtab.h"
+#include "gold-threads.h"
 #include "plugin.h"
 
 namespace gold
@@ -332,6 +333,7 @@ Symbol_table::resolve(Sized_symbol<size>* to,
           = { object, orig_st_shndx, sym.get_st_value() };
       Symbol_location toloc = { to->object(), to->shndx(&to_is_ordinary),
 				to->value() };
+      Hold_lock hl(*this->lock_);
       this->candidate_odr_violations_[to->name()].insert(fromloc);
       this->candidate_odr_violations_[to->name()].insert(toloc);
     }
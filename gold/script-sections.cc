@@ -1176,6 +1176,8 @@ struct Input_section_info
   std::string section_name;
   uint64_t size;
   uint64_t addralign;
+  // The position in --section-ordering-file, or 0.
+  unsigned int section_order_index;
 };
 
 // A class to sort the input sections.
@@ -1224,6 +1226,23 @@ Input_section_sorter::operator()(const Input_section_info& isi1,
   return false;
 }
 
+// A class to sort the input sections as specified by
+// --section-ordering-file.  Sections which are listed come first, in
+// the order in which they are listed.
+
+class Input_section_order_sorter
+{
+ public:
+  bool
+  operator()(const Input_section_info& isi1,
+	     const Input_section_info& isi2) const
+  {
+    if (isi1.section_order_index == 0 || isi2.section_order_index == 0)
+      return isi1.section_order_index != 0 && isi2.section_order_index == 0;
+    return isi1.section_order_index < isi2.section_order_index;
+  }
+};
+
 // Set the section address.  Look in INPUT_SECTIONS for sections which
 // match this spec, sort them as specified, and add them to the output
 // section.
@@ -1231,7 +1250,7 @@ Input_section_sorter::operator()(const Input_section_info& isi1,
 void
 Output_section_element_input::set_section_addresses(
     Symbol_table*,
-    Layout*,
+    Layout* layout,
     Output_section* output_section,
     uint64_t subalign,
     uint64_t* dot_value,
@@ -1273,6 +1292,11 @@ Output_section_element_input::set_section_addresses(
 	isi.addralign = p->first->section_addralign(p->second);
       }
 
+      isi.section_order_index = 0;
+      if (layout->has_section_ordering())
+	isi.section_order_index =
+	  layout->find_section_order_index(isi.section_name.c_str());
+
       if (!this->match_file_name(isi.relobj->name().c_str()))
 	++p;
       else if (this->input_section_patterns_.empty())
@@ -1304,8 +1328,9 @@ Output_section_element_input::set_section_addresses(
 
   // Look through MATCHING_SECTIONS.  Sort each one as specified,
   // using a stable sort so that we get the default order when
-  // sections are otherwise equal.  Add each input section to the
-  // output section.
+  // sections are otherwise equal.  If the script does not ask for
+  // sorting, use the order given by --section-ordering-file, if any.
+  // Add each input section to the output section.
 
   for (size_t i = 0; i < input_pattern_count; ++i)
     {
@@ -1321,6 +1346,10 @@ Output_section_element_input::set_section_addresses(
 			 matching_sections[i].end(),
 			 Input_section_sorter(this->filename_sort_,
 					      isp.sort));
+      else if (layout->has_section_ordering())
+	std::stable_sort(matching_sections[i].begin(),
+			 matching_sections[i].end(),
+			 Input_section_order_sorter());
 
       for (std::vector<Input_section_info>::const_iterator p =
 	     matching_sections[i].begin();
@@ -1420,10 +1420,8 @@ read_input_script(Workqueue* workqueue, Symbol_table* symtab, Layout* layout,
       // Like new Read_symbols(...) above, we rely on close.inputs()
       // getting leaked by closure.
       Script_info* info = new Script_info(closure.inputs());
-      layout->incremental_inputs()->report_script(
-          input_argument,
-          input_file->file().get_mtime(),
-          info);
+      layout->incremental_inputs()->report_script(input_argument,
+                                                  input_file, info);
     }
   *used_next_blocker = true;
 
@@ -1458,6 +1456,13 @@ read_script_file(const char* filename, Command_line* cmdline,
   if (!input_file.open(dirsearch, task, &dummy))
     return false;
 
+  // An incremental link must check this file for changes.  Get its
+  // modification time before reading it, so that a change made while
+  // we read it is noticed.
+  cmdline->add_option_file(input_file.filename(),
+                           input_file.file().get_mtime(),
+                           input_file.file().filesize());
+
   std::string input_string;
   Lex::read_file(&input_file, &input_string);
 
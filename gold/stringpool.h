@@ -194,12 +194,31 @@ class Stringpool_template
   const Stringpool_char*
   add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey);
 
+  // Like add_with_length, but HASH_CODE is the hash code of S as
+  // returned by hash_string.  This may be used when the hash code
+  // was computed earlier, perhaps in a different thread.
+  const Stringpool_char*
+  add_with_length_and_hash(const Stringpool_char* s, size_t len,
+			   size_t hash_code, bool copy, Key* pkey);
+
   // If the string S is present in the pool, return the canonical
   // string pointer.  Otherwise, return NULL.  If PKEY is not NULL,
   // set *PKEY to the key.
   const Stringpool_char*
   find(const Stringpool_char* s, Key* pkey) const;
 
+  // Like find, for the string S of length LEN characters whose hash
+  // code, as returned by hash_string, is HASH_CODE.
+  const Stringpool_char*
+  find_with_length_and_hash(const Stringpool_char* s, size_t len,
+			    size_t hash_code, Key* pkey) const;
+
+  // Return the hash code which the pool uses for the string S of
+  // length LEN characters.
+  static size_t
+  hash_string(const Stringpool_char* s, size_t len)
+  { return string_hash(s, len); }
+
   // Turn the stringpool into a string table: determine the offsets of
   // all the strings.  After this is called, no more strings may be
   // added to the stringpool.
@@ -318,6 +337,10 @@ class Stringpool_template
     Hashkey(const Stringpool_char* s, size_t len)
       : string(s), length(len), hash_code(string_hash(s, len))
     { }
+
+    Hashkey(const Stringpool_char* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
   };
 
   // Hash function.  This is trivial, since we have already computed
@@ -37,6 +37,7 @@
 #include "output.h"
 #include "target.h"
 #include "workqueue.h"
+#include "gold-threads.h"
 #include "symtab.h"
 #include "demangle.h"   // needed for --dynamic-list-cpp-new
 #include "plugin.h"
@@ -486,16 +487,84 @@ Symbol::set_output_section(Output_section* os)
 
 Symbol_table::Symbol_table(unsigned int count,
                            const Version_script_info& version_script)
-  : saw_undefined_(0), offset_(0), table_(count), namepool_(),
-    forwarders_(), commons_(), tls_commons_(), small_commons_(),
-    large_commons_(), forced_locals_(), warnings_(),
-    version_script_(version_script), gc_(NULL), icf_(NULL)
+  : offset_(0), log_undefined_(false), lock_(new Lock()), forwarders_(),
+    warnings_(), version_script_(version_script), gc_(NULL), icf_(NULL)
 {
-  namepool_.reserve(count);
+  unsigned int shard_size = count / shard_count;
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      Symbol_table_type table(shard_size);
+      this->shards_[i].table.swap(table);
+      this->shards_[i].namepool.reserve(shard_size);
+    }
 }
 
 Symbol_table::~Symbol_table()
 {
+  delete this->lock_;
+}
+
+const unsigned int Symbol_table::shard_count;
+
+// Return the shard for NAME.
+
+unsigned int
+Symbol_table::name_shard(const char* name, size_t* plen, size_t* phash_code)
+{
+  *plen = strlen(name);
+  *phash_code = Stringpool::hash_string(name, *plen);
+  return Symbol_table::shard_index(*phash_code);
+}
+
+// Return the count of undefined symbols seen, summed over all the
+// shards.
+
+int
+Symbol_table::saw_undefined() const
+{
+  int ret = 0;
+  for (unsigned int i = 0; i < shard_count; ++i)
+    ret += this->shards_[i].saw_undefined;
+  return ret;
+}
+
+// Start or stop recording strong undefined references.  Anything
+// left over from before is discarded.
+
+void
+Symbol_table::set_log_undefined(bool log)
+{
+  this->log_undefined_ = log;
+  for (unsigned int i = 0; i < shard_count; ++i)
+    this->shards_[i].undefined_log.clear();
+}
+
+// Move the recorded strong undefined references to *SYMS.
+
+void
+Symbol_table::take_undefined_log(std::vector<Symbol*>* syms)
+{
+  syms->clear();
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      std::vector<Symbol*>& log(this->shards_[i].undefined_log);
+      syms->insert(syms->end(), log.begin(), log.end());
+      log.clear();
+    }
+}
+
+// Canonicalize a symbol name.  The name is stored in the pool of the
+// shard which holds symbols with that name.
+
+const char*
+Symbol_table::canonicalize_name(const char* name)
+{
+  size_t len;
+  size_t hash_code;
+  unsigned int shard = Symbol_table::name_shard(name, &len, &hash_code);
+  return this->shards_[shard].namepool.add_with_length_and_hash(name, len,
+								hash_code,
+								true, NULL);
 }
 
 // The hash function.  The key values are Stringpool keys.
@@ -565,6 +634,7 @@ Symbol_table::gc_mark_symbol_for_shlib(Symbol* sym)
       if (is_ordinary && shndx != elfcpp::SHN_UNDEF)
         {
           gold_assert(this->gc_!= NULL);
+          Hold_lock hl(*this->lock_);
           this->gc_->worklist().push(Section_id(obj, shndx));
         }
     }
@@ -584,6 +654,7 @@ Symbol_table::gc_mark_dyn_syms(Symbol* sym)
       if (is_ordinary && shndx != elfcpp::SHN_UNDEF)
         {
           gold_assert(this->gc_ != NULL);
+          Hold_lock hl(*this->lock_);
           this->gc_->worklist().push(Section_id(obj, shndx));
         }
     }
@@ -596,7 +667,10 @@ Symbol_table::make_forwarder(Symbol* from, Symbol* to)
 {
   gold_assert(from != to);
   gold_assert(!from->is_forwarder() && !to->is_forwarder());
-  this->forwarders_[from] = to;
+  {
+    Hold_lock hl(*this->lock_);
+    this->forwarders_[from] = to;
+  }
   from->set_forwarder();
 }
 
@@ -617,22 +691,28 @@ Symbol_table::resolve_forwards(const Symbol* from) const
 Symbol*
 Symbol_table::lookup(const char* name, const char* version) const
 {
+  size_t len;
+  size_t hash_code;
+  unsigned int shard = Symbol_table::name_shard(name, &len, &hash_code);
+  const Symbol_table_shard& sh(this->shards_[shard]);
+
   Stringpool::Key name_key;
-  name = this->namepool_.find(name, &name_key);
+  name = sh.namepool.find_with_length_and_hash(name, len, hash_code,
+					       &name_key);
   if (name == NULL)
     return NULL;
 
   Stringpool::Key version_key = 0;
   if (version != NULL)
     {
-      version = this->namepool_.find(version, &version_key);
+      version = sh.namepool.find(version, &version_key);
       if (version == NULL)
 	return NULL;
     }
 
   Symbol_table_key key(name_key, version_key);
-  Symbol_table::Symbol_table_type::const_iterator p = this->table_.find(key);
-  if (p == this->table_.end())
+  Symbol_table::Symbol_table_type::const_iterator p = sh.table.find(key);
+  if (p == sh.table.end())
     return NULL;
   return p->second;
 }
@@ -671,6 +751,18 @@ Symbol_table::resolve(Sized_symbol<size>* to, const Sized_symbol<size>* from)
 
 void
 Symbol_table::force_local(Symbol* sym)
+{
+  size_t len;
+  size_t hash_code;
+  unsigned int shard = Symbol_table::name_shard(sym->name(), &len,
+						&hash_code);
+  this->force_local_in_shard(sym, shard);
+}
+
+// Record that SYM, which is in shard SHARD, is forced to be local.
+
+void
+Symbol_table::force_local_in_shard(Symbol* sym, unsigned int shard)
 {
   if (!sym->is_defined() && !sym->is_common())
     return;
@@ -680,16 +772,16 @@ Symbol_table::force_local(Symbol* sym)
       return;
     }
   sym->set_is_forced_local();
-  this->forced_locals_.push_back(sym);
+  this->shards_[shard].forced_locals.push_back(sym);
 }
 
-// Adjust NAME for wrapping, and update *NAME_KEY if necessary.  This
-// is only called for undefined symbols, when at least one --wrap
-// option was used.
+// Adjust NAME for wrapping, and update *NAME_KEY and *PSHARD if
+// necessary.  This is only called for undefined symbols, when at
+// least one --wrap option was used.
 
 const char*
 Symbol_table::wrap_symbol(Object* object, const char* name,
-			  Stringpool::Key* name_key)
+			  Stringpool::Key* name_key, unsigned int* pshard)
 {
   // For some targets, we need to ignore a specific character when
   // wrapping, and add it back later.
@@ -709,10 +801,14 @@ Symbol_table::wrap_symbol(Object* object, const char* name,
       s += "__wrap_";
       s += name;
 
-      // This will give us both the old and new name in NAMEPOOL_, but
-      // that is OK.  Only the versions we need will wind up in the
-      // real string table in the output file.
-      return this->namepool_.add(s.c_str(), true, name_key);
+      // This will give us both the old and new name in the symbol
+      // name pools, but that is OK.  Only the versions we need will
+      // wind up in the real string table in the output file.
+      size_t len;
+      size_t hash_code;
+      *pshard = Symbol_table::name_shard(s.c_str(), &len, &hash_code);
+      return this->shards_[*pshard].namepool.add_with_length_and_hash(
+	  s.c_str(), len, hash_code, true, name_key);
     }
 
   const char* const real_prefix = "__real_";
@@ -725,7 +821,11 @@ Symbol_table::wrap_symbol(Object* object, const char* name,
       if (prefix != '\0')
 	s += prefix;
       s += name + real_prefix_length;
-      return this->namepool_.add(s.c_str(), true, name_key);
+      size_t len;
+      size_t hash_code;
+      *pshard = Symbol_table::name_shard(s.c_str(), &len, &hash_code);
+      return this->shards_[*pshard].namepool.add_with_length_and_hash(
+	  s.c_str(), len, hash_code, true, name_key);
     }
 
   return name;
@@ -807,8 +907,9 @@ Symbol_table::define_default_version(Sized_symbol<size>* sym,
     }
 }
 
-// Add one symbol from OBJECT to the symbol table.  NAME is symbol
-// name and VERSION is the version; both are canonicalized.  DEF is
+// Add one symbol from OBJECT to shard SHARD of the symbol table.
+// NAME is symbol name and VERSION is the version; both are
+// canonicalized in the name pool of SHARD.  DEF is
 // whether this is the default version.  ST_SHNDX is the symbol's
 // section index; IS_ORDINARY is whether this is a normal section
 // rather than a special code.
@@ -840,6 +941,7 @@ Symbol_table::define_default_version(Sized_symbol<size>* sym,
 template<int size, bool big_endian>
 Sized_symbol<size>*
 Symbol_table::add_from_object(Object* object,
+			      unsigned int shard,
 			      const char *name,
 			      Stringpool::Key name_key,
 			      const char *version,
@@ -864,7 +966,8 @@ Symbol_table::add_from_object(Object* object,
   if (orig_st_shndx == elfcpp::SHN_UNDEF
       && parameters->options().any_wrap())
     {
-      const char* wrap_name = this->wrap_symbol(object, name, &name_key);
+      const char* wrap_name = this->wrap_symbol(object, name, &name_key,
+						&shard);
       if (wrap_name != name)
 	{
 	  // If we see a reference to malloc with version GLIBC_2.0,
@@ -878,19 +981,21 @@ Symbol_table::add_from_object(Object* object,
 	}
     }
 
+  Symbol_table_shard* sh = &this->shards_[shard];
+
   Symbol* const snull = NULL;
   std::pair<typename Symbol_table_type::iterator, bool> ins =
-    this->table_.insert(std::make_pair(std::make_pair(name_key, version_key),
-				       snull));
+    sh->table.insert(std::make_pair(std::make_pair(name_key, version_key),
+				    snull));
 
   std::pair<typename Symbol_table_type::iterator, bool> insdef =
-    std::make_pair(this->table_.end(), false);
+    std::make_pair(sh->table.end(), false);
   if (def)
     {
       const Stringpool::Key vnull_key = 0;
-      insdef = this->table_.insert(std::make_pair(std::make_pair(name_key,
-								 vnull_key),
-						  snull));
+      insdef = sh->table.insert(std::make_pair(std::make_pair(name_key,
+							      vnull_key),
+					       snull));
     }
 
   // ins.first: an iterator, which is a pointer to a pair.
@@ -956,13 +1061,12 @@ Symbol_table::add_from_object(Object* object,
 		  // This means that we don't want a symbol table
 		  // entry after all.
 		  if (!def)
-		    this->table_.erase(ins.first);
+		    sh->table.erase(ins.first);
 		  else
 		    {
-		      this->table_.erase(insdef.first);
+		      sh->table.erase(insdef.first);
 		      // Inserting insdef invalidated ins.
-		      this->table_.erase(std::make_pair(name_key,
-							version_key));
+		      sh->table.erase(std::make_pair(name_key, version_key));
 		    }
 		  return NULL;
 		}
@@ -987,22 +1091,29 @@ Symbol_table::add_from_object(Object* object,
   // Record every time we see a new undefined symbol, to speed up
   // archive groups.
   if (!was_undefined && ret->is_undefined())
-    ++this->saw_undefined_;
+    ++sh->saw_undefined;
+
+  // Record strong undefined references for Archive::add_symbols.
+  if (this->log_undefined_
+      && orig_st_shndx == elfcpp::SHN_UNDEF
+      && sym.get_st_bind() != elfcpp::STB_WEAK
+      && ret->is_undefined())
+    sh->undefined_log.push_back(ret);
 
   // Keep track of common symbols, to speed up common symbol
   // allocation.
   if (!was_common && ret->is_common())
     {
       if (ret->type() == elfcpp::STT_TLS)
-	this->tls_commons_.push_back(ret);
+	sh->tls_commons.push_back(ret);
       else if (!is_ordinary
 	       && st_shndx == parameters->target().small_common_shndx())
-	this->small_commons_.push_back(ret);
+	sh->small_commons.push_back(ret);
       else if (!is_ordinary
 	       && st_shndx == parameters->target().large_common_shndx())
-	this->large_commons_.push_back(ret);
+	sh->large_commons.push_back(ret);
       else
-	this->commons_.push_back(ret);
+	sh->commons.push_back(ret);
     }
 
   // If we're not doing a relocatable link, then any symbol with
@@ -1012,11 +1123,10 @@ Symbol_table::add_from_object(Object* object,
       && (ret->binding() == elfcpp::STB_GLOBAL
 	  || ret->binding() == elfcpp::STB_WEAK)
       && !parameters->options().relocatable())
-    this->force_local(ret);
+    this->force_local_in_shard(ret, shard);
 
   return ret;
 }
-
 // Add all the symbols in a relocatable object to the hash table.
 
 template<int size, bool big_endian>
@@ -1028,6 +1138,7 @@ Symbol_table::add_from_relobj(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     typename Sized_relobj<size, big_endian>::Symbols* sympointers,
     size_t *defined)
 {
@@ -1038,8 +1149,6 @@ Symbol_table::add_from_relobj(
 
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
 
-  const bool just_symbols = relobj->just_symbols();
-
   const unsigned char* p = syms;
   for (size_t i = 0; i < count; ++i, p += sym_size)
     {
@@ -1057,139 +1166,339 @@ Symbol_table::add_from_relobj(
 
       const char* name = sym_names + st_name;
 
-      bool is_ordinary;
-      unsigned int st_shndx = relobj->adjust_sym_shndx(i + symndx_offset,
-						       sym.get_st_shndx(),
-						       &is_ordinary);
-      unsigned int orig_st_shndx = st_shndx;
-      if (!is_ordinary)
-	orig_st_shndx = elfcpp::SHN_UNDEF;
+      Symbol_name_hash name_hash;
+      if (name_hashes != NULL)
+	name_hash = name_hashes[i];
+      else
+	{
+	  const char* ver = strchr(name, '@');
+	  name_hash.length = ver != NULL ? ver - name : strlen(name);
+	  name_hash.hash_code = Stringpool::hash_string(name,
+							name_hash.length);
+	}
 
-      if (st_shndx != elfcpp::SHN_UNDEF)
-	++*defined;
+      this->add_relobj_symbol(relobj, p, i, symndx_offset, name, name_hash,
+			      Symbol_table::shard_index(name_hash.hash_code),
+			      sympointers, defined);
+    }
+}
 
-      // A symbol defined in a section which we are not including must
-      // be treated as an undefined symbol.
-      if (st_shndx != elfcpp::SHN_UNDEF
-	  && is_ordinary
-	  && !relobj->is_section_included(st_shndx))
-	st_shndx = elfcpp::SHN_UNDEF;
-
-      // In an object file, an '@' in the name separates the symbol
-      // name from the version name.  If there are two '@' characters,
-      // this is the default version.
-      const char* ver = strchr(name, '@');
-      Stringpool::Key ver_key = 0;
-      int namelen = 0;
-      // DEF: is the version default?  LOCAL: is the symbol forced local?
-      bool def = false;
-      bool local = false;
-
-      if (ver != NULL)
-        {
-          // The symbol name is of the form foo@VERSION or foo@@VERSION
-          namelen = ver - name;
-          ++ver;
-	  if (*ver == '@')
-	    {
-	      def = true;
-	      ++ver;
-	    }
-	  ver = this->namepool_.add(ver, true, &ver_key);
-        }
-      // We don't want to assign a version to an undefined symbol,
-      // even if it is listed in the version script.  FIXME: What
-      // about a common symbol?
-      else
+// Add the external symbols of a relocatable object which belong to
+// one shard of the symbol table.  This is the work done by a
+// Relobj_shard_adder.  Each symbol is examined by every shard, but
+// this is cheap compared to adding it, since the hash codes of the
+// names were computed when the symbols were read.
+
+template<int size, bool big_endian>
+void
+Symbol_table::add_relobj_shard(
+    Sized_relobj<size, big_endian>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
+    typename Sized_relobj<size, big_endian>::Symbols* sympointers,
+    unsigned int shard)
+{
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+
+  for (size_t i = 0; i < count; ++i)
+    {
+      const Symbol_name_hash& name_hash(name_hashes[i]);
+      if (Symbol_table::shard_index(name_hash.hash_code) != shard)
+	continue;
+
+      const unsigned char* p = syms + i * sym_size;
+      elfcpp::Sym<size, big_endian> sym(p);
+
+      unsigned int st_name = sym.get_st_name();
+      if (st_name >= sym_name_size)
 	{
-	  namelen = strlen(name);
-	  if (!this->version_script_.empty()
-	      && st_shndx != elfcpp::SHN_UNDEF)
+	  relobj->error(_("bad global symbol name offset %u at %zu"),
+			st_name, i);
+	  continue;
+	}
+
+      this->add_relobj_symbol(relobj, p, i, symndx_offset,
+			      sym_names + st_name, name_hash, shard,
+			      sympointers, NULL);
+    }
+}
+
+// Add external symbol I, which is at P, from the relocatable object
+// RELOBJ to shard SHARD of the symbol table.  NAME is the name of the
+// symbol, which may include a version; NAME_HASH gives the length and
+// hash code of the part before the version.  If DEFINED is not NULL,
+// increment *DEFINED if the symbol is defined in RELOBJ.
+
+template<int size, bool big_endian>
+void
+Symbol_table::add_relobj_symbol(
+    Sized_relobj<size, big_endian>* relobj,
+    const unsigned char* p,
+    size_t i,
+    size_t symndx_offset,
+    const char* name,
+    const Symbol_name_hash& name_hash,
+    unsigned int shard,
+    typename Sized_relobj<size, big_endian>::Symbols* sympointers,
+    size_t* defined)
+{
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+
+  Stringpool* namepool = &this->shards_[shard].namepool;
+
+  elfcpp::Sym<size, big_endian> sym(p);
+
+  bool is_ordinary;
+  unsigned int st_shndx = relobj->adjust_sym_shndx(i + symndx_offset,
+						   sym.get_st_shndx(),
+						   &is_ordinary);
+  unsigned int orig_st_shndx = st_shndx;
+  if (!is_ordinary)
+    orig_st_shndx = elfcpp::SHN_UNDEF;
+
+  if (defined != NULL && st_shndx != elfcpp::SHN_UNDEF)
+    ++*defined;
+
+  // A symbol defined in a section which we are not including must
+  // be treated as an undefined symbol.
+  if (st_shndx != elfcpp::SHN_UNDEF
+      && is_ordinary
+      && !relobj->is_section_included(st_shndx))
+    st_shndx = elfcpp::SHN_UNDEF;
+
+  // In an object file, an '@' in the name separates the symbol
+  // name from the version name.  If there are two '@' characters,
+  // this is the default version.
+  const char* ver = NULL;
+  Stringpool::Key ver_key = 0;
+  // DEF: is the version default?  LOCAL: is the symbol forced local?
+  bool def = false;
+  bool local = false;
+
+  if (name[name_hash.length] == '@')
+    {
+      // The symbol name is of the form foo@VERSION or foo@@VERSION
+      ver = name + name_hash.length + 1;
+      if (*ver == '@')
+	{
+	  def = true;
+	  ++ver;
+	}
+      ver = namepool->add(ver, true, &ver_key);
+    }
+  // We don't want to assign a version to an undefined symbol,
+  // even if it is listed in the version script.  FIXME: What
+  // about a common symbol?
+  else
+    {
+      if (!this->version_script_.empty()
+	  && st_shndx != elfcpp::SHN_UNDEF)
+	{
+	  // The symbol name did not have a version, but the
+	  // version script may assign a version anyway.
+	  std::string version;
+	  if (this->version_script_.get_symbol_version(name, &version))
 	    {
-	      // The symbol name did not have a version, but the
-	      // version script may assign a version anyway.
-	      std::string version;
-	      if (this->version_script_.get_symbol_version(name, &version))
+	      // The version can be empty if the version script is
+	      // only used to force some symbols to be local.
+	      if (!version.empty())
 		{
-		  // The version can be empty if the version script is
-		  // only used to force some symbols to be local.
-		  if (!version.empty())
-		    {
-		      ver = this->namepool_.add_with_length(version.c_str(),
-							    version.length(),
-							    true,
-							    &ver_key);
-		      def = true;
-		    }
+		  ver = namepool->add_with_length(version.c_str(),
+						  version.length(),
+						  true,
+						  &ver_key);
+		  def = true;
 		}
-	      else if (this->version_script_.symbol_is_local(name))
-		local = true;
 	    }
+	  else if (this->version_script_.symbol_is_local(name))
+	    local = true;
 	}
+    }
 
-      elfcpp::Sym<size, big_endian>* psym = &sym;
-      unsigned char symbuf[sym_size];
-      elfcpp::Sym<size, big_endian> sym2(symbuf);
-      if (just_symbols)
+  elfcpp::Sym<size, big_endian>* psym = &sym;
+  unsigned char symbuf[sym_size];
+  elfcpp::Sym<size, big_endian> sym2(symbuf);
+  if (relobj->just_symbols())
+    {
+      memcpy(symbuf, p, sym_size);
+      elfcpp::Sym_write<size, big_endian> sw(symbuf);
+      if (orig_st_shndx != elfcpp::SHN_UNDEF && is_ordinary)
+	{
+	  // Symbol values in object files are section relative.
+	  // This is normally what we want, but since here we are
+	  // converting the symbol to absolute we need to add the
+	  // section address.  The section address in an object
+	  // file is normally zero, but people can use a linker
+	  // script to change it.
+	  sw.put_st_value(sym.get_st_value()
+			  + relobj->section_address(orig_st_shndx));
+	}
+      st_shndx = elfcpp::SHN_ABS;
+      is_ordinary = false;
+      psym = &sym2;
+    }
+
+  // Fix up visibility if object has no-export set.
+  if (relobj->no_export())
+    {
+      // We may have copied symbol already above.
+      if (psym != &sym2)
 	{
 	  memcpy(symbuf, p, sym_size);
-	  elfcpp::Sym_write<size, big_endian> sw(symbuf);
-	  if (orig_st_shndx != elfcpp::SHN_UNDEF && is_ordinary)
-	    {
-	      // Symbol values in object files are section relative.
-	      // This is normally what we want, but since here we are
-	      // converting the symbol to absolute we need to add the
-	      // section address.  The section address in an object
-	      // file is normally zero, but people can use a linker
-	      // script to change it.
-	      sw.put_st_value(sym.get_st_value()
-			      + relobj->section_address(orig_st_shndx));
-	    }
-	  st_shndx = elfcpp::SHN_ABS;
-	  is_ordinary = false;
 	  psym = &sym2;
 	}
 
-      // Fix up visibility if object has no-export set.
-      if (relobj->no_export())
-        {
-	  // We may have copied symbol already above.
-	  if (psym != &sym2)
-	    {
-	      memcpy(symbuf, p, sym_size);
-	      psym = &sym2;
-	    }
+      elfcpp::STV visibility = sym2.get_st_visibility();
+      if (visibility == elfcpp::STV_DEFAULT
+	  || visibility == elfcpp::STV_PROTECTED)
+	{
+	  elfcpp::Sym_write<size, big_endian> sw(symbuf);
+	  unsigned char nonvis = sym2.get_st_nonvis();
+	  sw.put_st_other(elfcpp::STV_HIDDEN, nonvis);
+	}
+    }
 
-	  elfcpp::STV visibility = sym2.get_st_visibility();
-	  if (visibility == elfcpp::STV_DEFAULT
-	      || visibility == elfcpp::STV_PROTECTED)
-	    {
-	      elfcpp::Sym_write<size, big_endian> sw(symbuf);
-	      unsigned char nonvis = sym2.get_st_nonvis();
-	      sw.put_st_other(elfcpp::STV_HIDDEN, nonvis);
-	    }
-        }
+  Stringpool::Key name_key;
+  name = namepool->add_with_length_and_hash(name, name_hash.length,
+					    name_hash.hash_code, true,
+					    &name_key);
 
-      Stringpool::Key name_key;
-      name = this->namepool_.add_with_length(name, namelen, true,
-					     &name_key);
+  Sized_symbol<size>* res;
+  res = this->add_from_object(relobj, shard, name, name_key, ver, ver_key,
+			      def, *psym, st_shndx, is_ordinary,
+			      orig_st_shndx);
 
-      Sized_symbol<size>* res;
-      res = this->add_from_object(relobj, name, name_key, ver, ver_key,
-				  def, *psym, st_shndx, is_ordinary,
-				  orig_st_shndx);
-      
-      // If building a shared library using garbage collection, do not 
-      // treat externally visible symbols as garbage.
-      if (parameters->options().gc_sections() 
-          && parameters->options().shared())
-        this->gc_mark_symbol_for_shlib(res);
+  // If building a shared library using garbage collection, do not
+  // treat externally visible symbols as garbage.
+  if (parameters->options().gc_sections()
+      && parameters->options().shared())
+    this->gc_mark_symbol_for_shlib(res);
+
+  if (local)
+    this->force_local_in_shard(res, shard);
+
+  (*sympointers)[i] = res;
+}
+
+// A Symbol_shard_adder for a relocatable object.
+
+template<int size, bool big_endian>
+class Relobj_shard_adder : public Symbol_shard_adder
+{
+ public:
+  Relobj_shard_adder(Symbol_table* symtab,
+		     Sized_relobj<size, big_endian>* relobj,
+		     const unsigned char* syms, size_t count,
+		     size_t symndx_offset, const char* sym_names,
+		     size_t sym_name_size,
+		     std::vector<Symbol_name_hash>* name_hashes,
+		     typename Sized_relobj<size, big_endian>::Symbols* sympointers)
+    : symtab_(symtab), relobj_(relobj), syms_(syms), count_(count),
+      symndx_offset_(symndx_offset), sym_names_(sym_names),
+      sym_name_size_(sym_name_size), name_hashes_(),
+      sympointers_(sympointers)
+  { this->name_hashes_.swap(*name_hashes); }
+
+ protected:
+  void
+  do_add_shard(unsigned int shard)
+  {
+    this->symtab_->add_relobj_shard(this->relobj_, this->syms_, this->count_,
+				    this->symndx_offset_, this->sym_names_,
+				    this->sym_name_size_,
+				    &this->name_hashes_[0],
+				    this->sympointers_, shard);
+  }
+
+ private:
+  Symbol_table* symtab_;
+  Sized_relobj<size, big_endian>* relobj_;
+  const unsigned char* syms_;
+  size_t count_;
+  size_t symndx_offset_;
+  const char* sym_names_;
+  size_t sym_name_size_;
+  std::vector<Symbol_name_hash> name_hashes_;
+  typename Sized_relobj<size, big_endian>::Symbols* sympointers_;
+};
+
+// The minimum number of external symbols a relocatable object must
+// have before we add them to the symbol table a shard at a time.
+// For smaller objects the cost of the extra tasks is more than the
+// time saved.
 
-      if (local)
-	this->force_local(res);
+static const size_t shard_adder_min_symbols = 1024;
 
-      (*sympointers)[i] = res;
+// Return a Symbol_shard_adder to add the symbols of a relocatable
+// object, or NULL if they should be added by add_from_relobj.
+
+template<int size, bool big_endian>
+Symbol_shard_adder*
+Symbol_table::make_relobj_shard_adder(
+    Sized_relobj<size, big_endian>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    std::vector<Symbol_name_hash>* name_hashes,
+    typename Sized_relobj<size, big_endian>::Symbols* sympointers,
+    size_t* defined)
+{
+  // Wrapping may move a symbol to a different shard.  Symbols in an
+  // object with --just-symbols need to read section addresses from
+  // the file.  Overriding a symbol defined in a dynamic object also
+  // overrides its weak aliases, which may be in other shards.
+  if (!parameters->options().threads()
+      || count < shard_adder_min_symbols
+      || name_hashes->size() != count
+      || parameters->options().any_wrap()
+      || relobj->just_symbols()
+      || !this->weak_aliases_.empty())
+    return NULL;
+
+  gold_assert(size == relobj->target()->get_size());
+  gold_assert(size == parameters->target().get_size());
+
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+
+  size_t ndefined = 0;
+  const unsigned char* p = syms;
+  for (size_t i = 0; i < count; ++i, p += sym_size)
+    {
+      elfcpp::Sym<size, big_endian> sym(p);
+      unsigned int st_shndx = sym.get_st_shndx();
+      // Looking up an extended section index may need to read the
+      // file, so leave those rare objects to add_from_relobj.
+      if (st_shndx == elfcpp::SHN_XINDEX)
+	return NULL;
+      if (st_shndx != elfcpp::SHN_UNDEF && sym.get_st_name() < sym_name_size)
+	++ndefined;
     }
+
+  for (size_t i = 0; i < count; ++i)
+    (*sympointers)[i] = NULL;
+
+  *defined = ndefined;
+
+  return new Relobj_shard_adder<size, big_endian>(this, relobj, syms, count,
+						  symndx_offset, sym_names,
+						  sym_name_size, name_hashes,
+						  sympointers);
+}
+
+// Class Symbol_shard_adder.
+
+Symbol_shard_adder::~Symbol_shard_adder()
+{
+  for (std::vector<File_view*>::iterator p = this->views_.begin();
+       p != this->views_.end();
+       ++p)
+    delete *p;
 }
 
 // Add a symbol from a plugin-claimed file.
@@ -1204,13 +1513,18 @@ Symbol_table::add_from_pluginobj(
 {
   unsigned int st_shndx = sym->get_st_shndx();
 
+  size_t namelen;
+  size_t hash_code;
+  unsigned int shard = Symbol_table::name_shard(name, &namelen, &hash_code);
+  Stringpool* namepool = &this->shards_[shard].namepool;
+
   Stringpool::Key ver_key = 0;
   bool def = false;
   bool local = false;
 
   if (ver != NULL)
     {
-      ver = this->namepool_.add(ver, true, &ver_key);
+      ver = namepool->add(ver, true, &ver_key);
     }
   // We don't want to assign a version to an undefined symbol,
   // even if it is listed in the version script.  FIXME: What
@@ -1229,10 +1543,10 @@ Symbol_table::add_from_pluginobj(
               // only used to force some symbols to be local.
               if (!version.empty())
                 {
-                  ver = this->namepool_.add_with_length(version.c_str(),
-                                                        version.length(),
-                                                        true,
-                                                        &ver_key);
+                  ver = namepool->add_with_length(version.c_str(),
+                                                  version.length(),
+                                                  true,
+                                                  &ver_key);
                   def = true;
                 }
             }
@@ -1242,14 +1556,15 @@ Symbol_table::add_from_pluginobj(
     }
 
   Stringpool::Key name_key;
-  name = this->namepool_.add(name, true, &name_key);
+  name = namepool->add_with_length_and_hash(name, namelen, hash_code, true,
+					    &name_key);
 
   Sized_symbol<size>* res;
-  res = this->add_from_object(obj, name, name_key, ver, ver_key,
+  res = this->add_from_object(obj, shard, name, name_key, ver, ver_key,
 		              def, *sym, st_shndx, true, st_shndx);
 
   if (local)
-    this->force_local(res);
+    this->force_local_in_shard(res, shard);
 
   return res;
 }
@@ -1339,6 +1654,12 @@ Symbol_table::add_from_dynobj(
 
       const char* name = sym_names + st_name;
 
+      size_t namelen;
+      size_t hash_code;
+      unsigned int shard = Symbol_table::name_shard(name, &namelen,
+						    &hash_code);
+      Stringpool* namepool = &this->shards_[shard].namepool;
+
       bool is_ordinary;
       unsigned int st_shndx = dynobj->adjust_sym_shndx(i, psym->get_st_shndx(),
 						       &is_ordinary);
@@ -1351,8 +1672,9 @@ Symbol_table::add_from_dynobj(
       if (versym == NULL)
 	{
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
-	  res = this->add_from_object(dynobj, name, name_key, NULL, 0,
+	  name = namepool->add_with_length_and_hash(name, namelen, hash_code,
+						    true, &name_key);
+	  res = this->add_from_object(dynobj, shard, name, name_key, NULL, 0,
 				      false, *psym, st_shndx, is_ordinary,
 				      st_shndx);
 	}
@@ -1381,14 +1703,15 @@ Symbol_table::add_from_dynobj(
 
 	  // At this point we are definitely going to add this symbol.
 	  Stringpool::Key name_key;
-	  name = this->namepool_.add(name, true, &name_key);
+	  name = namepool->add_with_length_and_hash(name, namelen, hash_code,
+						    true, &name_key);
 
 	  if (v == static_cast<unsigned int>(elfcpp::VER_NDX_LOCAL)
 	      || v == static_cast<unsigned int>(elfcpp::VER_NDX_GLOBAL))
 	    {
 	      // This symbol does not have a version.
-	      res = this->add_from_object(dynobj, name, name_key, NULL, 0,
-					  false, *psym, st_shndx, is_ordinary,
+	      res = this->add_from_object(dynobj, shard, name, name_key,
+					  NULL, 0, false, *psym, st_shndx, is_ordinary,
 					  st_shndx);
 	    }
 	  else
@@ -1409,7 +1732,7 @@ Symbol_table::add_from_dynobj(
 		}
 
 	      Stringpool::Key version_key;
-	      version = this->namepool_.add(version, true, &version_key);
+	      version = namepool->add(version, true, &version_key);
 
 	      // If this is an absolute symbol, and the version name
 	      // and symbol name are the same, then this is the
@@ -1419,16 +1742,17 @@ Symbol_table::add_from_dynobj(
 	      if (st_shndx == elfcpp::SHN_ABS
 		  && !is_ordinary
 		  && name_key == version_key)
-		res = this->add_from_object(dynobj, name, name_key, NULL, 0,
-					    false, *psym, st_shndx, is_ordinary,
-					    st_shndx);
+		res = this->add_from_object(dynobj, shard, name, name_key,
+					    NULL, 0, false, *psym, st_shndx,
+					    is_ordinary, st_shndx);
 	      else
 		{
 		  const bool def = (!hidden
 				    && st_shndx != elfcpp::SHN_UNDEF);
-		  res = this->add_from_object(dynobj, name, name_key, version,
-					      version_key, def, *psym, st_shndx,
-					      is_ordinary, st_shndx);
+		  res = this->add_from_object(dynobj, shard, name, name_key,
+					      version, version_key, def, *psym,
+					      st_shndx, is_ordinary,
+					      st_shndx);
 		}
 	    }
 	}
@@ -1570,10 +1894,15 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
   Symbol* oldsym;
   Sized_symbol<size>* sym;
 
+  size_t namelen;
+  size_t hash_code;
+  unsigned int shard = Symbol_table::name_shard(*pname, &namelen, &hash_code);
+  Symbol_table_shard* sh = &this->shards_[shard];
+
   bool add_to_table = false;
-  typename Symbol_table_type::iterator add_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_loc = sh->table.end();
   bool add_def_to_table = false;
-  typename Symbol_table_type::iterator add_def_loc = this->table_.end();
+  typename Symbol_table_type::iterator add_def_loc = sh->table.end();
 
   if (only_if_ref)
     {
@@ -1591,26 +1920,28 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
     {
       // Canonicalize NAME and VERSION.
       Stringpool::Key name_key;
-      *pname = this->namepool_.add(*pname, true, &name_key);
+      *pname = sh->namepool.add_with_length_and_hash(*pname, namelen,
+						     hash_code, true,
+						     &name_key);
 
       Stringpool::Key version_key = 0;
       if (*pversion != NULL)
-	*pversion = this->namepool_.add(*pversion, true, &version_key);
+	*pversion = sh->namepool.add(*pversion, true, &version_key);
 
       Symbol* const snull = NULL;
       std::pair<typename Symbol_table_type::iterator, bool> ins =
-	this->table_.insert(std::make_pair(std::make_pair(name_key,
-							  version_key),
-					   snull));
+	sh->table.insert(std::make_pair(std::make_pair(name_key,
+						       version_key),
+					snull));
 
       std::pair<typename Symbol_table_type::iterator, bool> insdef =
-	std::make_pair(this->table_.end(), false);
+	std::make_pair(sh->table.end(), false);
       if (is_default_version)
 	{
 	  const Stringpool::Key vnull = 0;
-	  insdef = this->table_.insert(std::make_pair(std::make_pair(name_key,
-								     vnull),
-						      snull));
+	  insdef = sh->table.insert(std::make_pair(std::make_pair(name_key,
+								  vnull),
+						   snull));
 	}
 
       if (!ins.second)
@@ -2210,7 +2541,11 @@ Symbol_table::do_add_undefined_symbols_from_command_line()
 
       sym->init_undefined(name, version, elfcpp::STT_NOTYPE, elfcpp::STB_GLOBAL,
 			  elfcpp::STV_DEFAULT, 0);
-      ++this->saw_undefined_;
+
+      size_t len;
+      size_t hash_code;
+      unsigned int shard = Symbol_table::name_shard(name, &len, &hash_code);
+      ++this->shards_[shard].saw_undefined;
     }
 }
 
@@ -2225,28 +2560,32 @@ Symbol_table::set_dynsym_indexes(unsigned int index,
 				 Stringpool* dynpool,
 				 Versions* versions)
 {
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (unsigned int i = 0; i < shard_count; ++i)
     {
-      Symbol* sym = p->second;
+      Symbol_table_type& table(this->shards_[i].table);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
 
-      // Note that SYM may already have a dynamic symbol index, since
-      // some symbols appear more than once in the symbol table, with
-      // and without a version.
+	  // Note that SYM may already have a dynamic symbol index, since
+	  // some symbols appear more than once in the symbol table, with
+	  // and without a version.
 
-      if (!sym->should_add_dynsym_entry())
-	sym->set_dynsym_index(-1U);
-      else if (!sym->has_dynsym_index())
-	{
-	  sym->set_dynsym_index(index);
-	  ++index;
-	  syms->push_back(sym);
-	  dynpool->add(sym->name(), false, NULL);
-
-	  // Record any version information.
-          if (sym->version() != NULL)
-            versions->record_version(this, dynpool, sym);
+	  if (!sym->should_add_dynsym_entry())
+	    sym->set_dynsym_index(-1U);
+	  else if (!sym->has_dynsym_index())
+	    {
+	      sym->set_dynsym_index(index);
+	      ++index;
+	      syms->push_back(sym);
+	      dynpool->add(sym->name(), false, NULL);
+
+	      // Record any version information.
+              if (sym->version() != NULL)
+                versions->record_version(this, dynpool, sym);
+	    }
 	}
     }
 
@@ -2333,27 +2672,35 @@ Symbol_table::sized_finalize(off_t off, Stringpool* pool,
 
   // First do all the symbols which have been forced to be local, as
   // they must appear before all global symbols.
-  for (Forced_locals::iterator p = this->forced_locals_.begin();
-       p != this->forced_locals_.end();
-       ++p)
+  for (unsigned int i = 0; i < shard_count; ++i)
     {
-      Symbol* sym = *p;
-      gold_assert(sym->is_forced_local());
-      if (this->sized_finalize_symbol<size>(sym))
+      Forced_locals& forced_locals(this->shards_[i].forced_locals);
+      for (Forced_locals::iterator p = forced_locals.begin();
+	   p != forced_locals.end();
+	   ++p)
 	{
-	  this->add_to_final_symtab<size>(sym, pool, &index, &off);
-	  ++*plocal_symcount;
+	  Symbol* sym = *p;
+	  gold_assert(sym->is_forced_local());
+	  if (this->sized_finalize_symbol<size>(sym))
+	    {
+	      this->add_to_final_symtab<size>(sym, pool, &index, &off);
+	      ++*plocal_symcount;
+	    }
 	}
     }
 
   // Now do all the remaining symbols.
-  for (Symbol_table_type::iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
+  for (unsigned int i = 0; i < shard_count; ++i)
     {
-      Symbol* sym = p->second;
-      if (this->sized_finalize_symbol<size>(sym))
-	this->add_to_final_symtab<size>(sym, pool, &index, &off);
+      Symbol_table_type& table(this->shards_[i].table);
+      for (Symbol_table_type::iterator p = table.begin();
+	   p != table.end();
+	   ++p)
+	{
+	  Symbol* sym = p->second;
+	  if (this->sized_finalize_symbol<size>(sym))
+	    this->add_to_final_symtab<size>(sym, pool, &index, &off);
+	}
     }
 
   this->output_count_ = index - orig_index;
@@ -2537,32 +2884,33 @@ Symbol_table::write_globals(const Stringpool* sympool,
 			    const Stringpool* dynpool,
 			    Output_symtab_xindex* symtab_xindex,
 			    Output_symtab_xindex* dynsym_xindex,
-			    Output_file* of) const
+			    Output_file* of,
+			    Workqueue* workqueue) const
 {
   switch (parameters->size_and_endianness())
     {
 #ifdef HAVE_TARGET_32_LITTLE
     case Parameters::TARGET_32_LITTLE:
       this->sized_write_globals<32, false>(sympool, dynpool, symtab_xindex,
-					   dynsym_xindex, of);
+					   dynsym_xindex, of, workqueue);
       break;
 #endif
 #ifdef HAVE_TARGET_32_BIG
     case Parameters::TARGET_32_BIG:
       this->sized_write_globals<32, true>(sympool, dynpool, symtab_xindex,
-					  dynsym_xindex, of);
+					  dynsym_xindex, of, workqueue);
       break;
 #endif
 #ifdef HAVE_TARGET_64_LITTLE
     case Parameters::TARGET_64_LITTLE:
       this->sized_write_globals<64, false>(sympool, dynpool, symtab_xindex,
-					   dynsym_xindex, of);
+					   dynsym_xindex, of, workqueue);
       break;
 #endif
 #ifdef HAVE_TARGET_64_BIG
     case Parameters::TARGET_64_BIG:
       this->sized_write_globals<64, true>(sympool, dynpool, symtab_xindex,
-					  dynsym_xindex, of);
+					  dynsym_xindex, of, workqueue);
       break;
 #endif
     default:
@@ -2570,7 +2918,44 @@ Symbol_table::write_globals(const Stringpool* sympool,
     }
 }
 
-// Write out the global symbols.
+// Write out the global symbols, a range of shards of the symbol table
+// at a time.
+
+template<int size, bool big_endian>
+class Write_globals_work : public Parallel_work
+{
+ public:
+  Write_globals_work(const Symbol_table* symtab, const Stringpool* sympool,
+		     const Stringpool* dynpool,
+		     Output_symtab_xindex* symtab_xindex,
+		     Output_symtab_xindex* dynsym_xindex,
+		     unsigned char* psyms, unsigned char* dynamic_view)
+    : symtab_(symtab), sympool_(sympool), dynpool_(dynpool),
+      symtab_xindex_(symtab_xindex), dynsym_xindex_(dynsym_xindex),
+      psyms_(psyms), dynamic_view_(dynamic_view)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last)
+  {
+    this->symtab_->sized_write_global_shards<size, big_endian>(
+	first, last, this->sympool_, this->dynpool_, this->symtab_xindex_,
+	this->dynsym_xindex_, this->psyms_, this->dynamic_view_);
+  }
+
+ private:
+  const Symbol_table* symtab_;
+  const Stringpool* sympool_;
+  const Stringpool* dynpool_;
+  Output_symtab_xindex* symtab_xindex_;
+  Output_symtab_xindex* dynsym_xindex_;
+  unsigned char* psyms_;
+  unsigned char* dynamic_view_;
+};
+
+// Write out the global symbols.  With threads, the shards of the
+// symbol table are written in parallel.
 
 template<int size, bool big_endian>
 void
@@ -2578,15 +2963,13 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
 				  const Stringpool* dynpool,
 				  Output_symtab_xindex* symtab_xindex,
 				  Output_symtab_xindex* dynsym_xindex,
-				  Output_file* of) const
+				  Output_file* of,
+				  Workqueue* workqueue) const
 {
-  const Target& target = parameters->target();
-
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
 
   const unsigned int output_count = this->output_count_;
   const section_size_type oview_size = output_count * sym_size;
-  const unsigned int first_global_index = this->first_global_index_;
   unsigned char* psyms;
   if (this->offset_ == 0 || output_count == 0)
     psyms = NULL;
@@ -2595,158 +2978,193 @@ Symbol_table::sized_write_globals(const Stringpool* sympool,
 
   const unsigned int dynamic_count = this->dynamic_count_;
   const section_size_type dynamic_size = dynamic_count * sym_size;
-  const unsigned int first_dynamic_global_index =
-    this->first_dynamic_global_index_;
   unsigned char* dynamic_view;
   if (this->dynamic_offset_ == 0 || dynamic_count == 0)
     dynamic_view = NULL;
   else
     dynamic_view = of->get_output_view(this->dynamic_offset_, dynamic_size);
 
-  for (Symbol_table_type::const_iterator p = this->table_.begin();
-       p != this->table_.end();
-       ++p)
-    {
-      Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
+  Write_globals_work<size, big_endian> work(this, sympool, dynpool,
+					     symtab_xindex, dynsym_xindex,
+					     psyms, dynamic_view);
+  work.run(workqueue, shard_count, 1);
 
-      // Possibly warn about unresolved symbols in shared libraries.
-      this->warn_about_undefined_dynobj_symbol(sym);
+  of->write_output_view(this->offset_, oview_size, psyms);
+  if (dynamic_view != NULL)
+    of->write_output_view(this->dynamic_offset_, dynamic_size, dynamic_view);
+}
 
-      unsigned int sym_index = sym->symtab_index();
-      unsigned int dynsym_index;
-      if (dynamic_view == NULL)
-	dynsym_index = -1U;
-      else
-	dynsym_index = sym->dynsym_index();
+// Write out the global symbols in the shards from FIRST up to LAST.
+// PSYMS and DYNAMIC_VIEW are the views of the symbol table and the
+// dynamic symbol table, either of which may be NULL.  This may be
+// called for different shards at the same time.
 
-      if (sym_index == -1U && dynsym_index == -1U)
-	{
-	  // This symbol is not included in the output file.
-	  continue;
-	}
+template<int size, bool big_endian>
+void
+Symbol_table::sized_write_global_shards(unsigned int first,
+					unsigned int last,
+					const Stringpool* sympool,
+					const Stringpool* dynpool,
+					Output_symtab_xindex* symtab_xindex,
+					Output_symtab_xindex* dynsym_xindex,
+					unsigned char* psyms,
+					unsigned char* dynamic_view) const
+{
+  const Target& target = parameters->target();
+
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
 
-      unsigned int shndx;
-      typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
-      typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
-      switch (sym->source())
+  const unsigned int output_count = this->output_count_;
+  const unsigned int first_global_index = this->first_global_index_;
+  const unsigned int dynamic_count = this->dynamic_count_;
+  const unsigned int first_dynamic_global_index =
+    this->first_dynamic_global_index_;
+
+  for (unsigned int i = first; i < last; ++i)
+    {
+      const Symbol_table_type& table(this->shards_[i].table);
+      for (Symbol_table_type::const_iterator p = table.begin();
+	   p != table.end();
+	   ++p)
 	{
-	case Symbol::FROM_OBJECT:
-	  {
-	    bool is_ordinary;
-	    unsigned int in_shndx = sym->shndx(&is_ordinary);
+	  Sized_symbol<size>* sym = static_cast<Sized_symbol<size>*>(p->second);
 
-	    if (!is_ordinary
-		&& in_shndx != elfcpp::SHN_ABS
-		&& !Symbol::is_common_shndx(in_shndx))
-	      {
-		gold_error(_("%s: unsupported symbol section 0x%x"),
-			   sym->demangled_name().c_str(), in_shndx);
-		shndx = in_shndx;
-	      }
-	    else
+	  // Possibly warn about unresolved symbols in shared libraries.
+	  this->warn_about_undefined_dynobj_symbol(sym);
+
+	  unsigned int sym_index = sym->symtab_index();
+	  unsigned int dynsym_index;
+	  if (dynamic_view == NULL)
+	    dynsym_index = -1U;
+	  else
+	    dynsym_index = sym->dynsym_index();
+
+	  if (sym_index == -1U && dynsym_index == -1U)
+	    {
+	      // This symbol is not included in the output file.
+	      continue;
+	    }
+
+	  unsigned int shndx;
+	  typename elfcpp::Elf_types<size>::Elf_Addr sym_value = sym->value();
+	  typename elfcpp::Elf_types<size>::Elf_Addr dynsym_value = sym_value;
+	  switch (sym->source())
+	    {
+	    case Symbol::FROM_OBJECT:
 	      {
-		Object* symobj = sym->object();
-		if (symobj->is_dynamic())
+		bool is_ordinary;
+		unsigned int in_shndx = sym->shndx(&is_ordinary);
+
+		if (!is_ordinary
+		    && in_shndx != elfcpp::SHN_ABS
+		    && !Symbol::is_common_shndx(in_shndx))
 		  {
-		    if (sym->needs_dynsym_value())
-		      dynsym_value = target.dynsym_value(sym);
-		    shndx = elfcpp::SHN_UNDEF;
+		    gold_error(_("%s: unsupported symbol section 0x%x"),
+			       sym->demangled_name().c_str(), in_shndx);
+		    shndx = in_shndx;
 		  }
-		else if (symobj->pluginobj() != NULL)
-		  shndx = elfcpp::SHN_UNDEF;
-		else if (in_shndx == elfcpp::SHN_UNDEF
-			 || (!is_ordinary
-			     && (in_shndx == elfcpp::SHN_ABS
-				 || Symbol::is_common_shndx(in_shndx))))
-		  shndx = in_shndx;
 		else
 		  {
-		    Relobj* relobj = static_cast<Relobj*>(symobj);
-		    Output_section* os = relobj->output_section(in_shndx);
-                    if (this->is_section_folded(relobj, in_shndx))
-                      {
-                        // This global symbol must be written out even though
-                        // it is folded.
-                        // Get the os of the section it is folded onto.
-                        Section_id folded =
-                             this->icf_->get_folded_section(relobj, in_shndx);
-                        gold_assert(folded.first !=NULL);
-                        Relobj* folded_obj = 
-                          reinterpret_cast<Relobj*>(folded.first);
-                        os = folded_obj->output_section(folded.second);  
-                        gold_assert(os != NULL);
-                      }
-		    gold_assert(os != NULL);
-		    shndx = os->out_shndx();
-
-		    if (shndx >= elfcpp::SHN_LORESERVE)
+		    Object* symobj = sym->object();
+		    if (symobj->is_dynamic())
 		      {
-			if (sym_index != -1U)
-			  symtab_xindex->add(sym_index, shndx);
-			if (dynsym_index != -1U)
-			  dynsym_xindex->add(dynsym_index, shndx);
-			shndx = elfcpp::SHN_XINDEX;
+			if (sym->needs_dynsym_value())
+			  dynsym_value = target.dynsym_value(sym);
+			shndx = elfcpp::SHN_UNDEF;
+		      }
+		    else if (symobj->pluginobj() != NULL)
+		      shndx = elfcpp::SHN_UNDEF;
+		    else if (in_shndx == elfcpp::SHN_UNDEF
+			     || (!is_ordinary
+				 && (in_shndx == elfcpp::SHN_ABS
+				     || Symbol::is_common_shndx(in_shndx))))
+		      shndx = in_shndx;
+		    else
+		      {
+			Relobj* relobj = static_cast<Relobj*>(symobj);
+			Output_section* os = relobj->output_section(in_shndx);
+                        if (this->is_section_folded(relobj, in_shndx))
+                          {
+                            // This global symbol must be written out even though
+                            // it is folded.
+                            // Get the os of the section it is folded onto.
+                            Section_id folded =
+                                 this->icf_->get_folded_section(relobj, in_shndx);
+                            gold_assert(folded.first !=NULL);
+                            Relobj* folded_obj = 
+                              reinterpret_cast<Relobj*>(folded.first);
+                            os = folded_obj->output_section(folded.second);  
+                            gold_assert(os != NULL);
+                          }
+			gold_assert(os != NULL);
+			shndx = os->out_shndx();
+
+			if (shndx >= elfcpp::SHN_LORESERVE)
+			  {
+			    if (sym_index != -1U)
+			      symtab_xindex->add(sym_index, shndx);
+			    if (dynsym_index != -1U)
+			      dynsym_xindex->add(dynsym_index, shndx);
+			    shndx = elfcpp::SHN_XINDEX;
+			  }
+
+			// In object files symbol values are section
+			// relative.
+			if (parameters->options().relocatable())
+			  sym_value -= os->address();
 		      }
-
-		    // In object files symbol values are section
-		    // relative.
-		    if (parameters->options().relocatable())
-		      sym_value -= os->address();
 		  }
 	      }
-	  }
-	  break;
+	      break;
 
-	case Symbol::IN_OUTPUT_DATA:
-	  shndx = sym->output_data()->out_shndx();
-	  if (shndx >= elfcpp::SHN_LORESERVE)
-	    {
-	      if (sym_index != -1U)
-		symtab_xindex->add(sym_index, shndx);
-	      if (dynsym_index != -1U)
-		dynsym_xindex->add(dynsym_index, shndx);
-	      shndx = elfcpp::SHN_XINDEX;
-	    }
-	  break;
+	    case Symbol::IN_OUTPUT_DATA:
+	      shndx = sym->output_data()->out_shndx();
+	      if (shndx >= elfcpp::SHN_LORESERVE)
+		{
+		  if (sym_index != -1U)
+		    symtab_xindex->add(sym_index, shndx);
+		  if (dynsym_index != -1U)
+		    dynsym_xindex->add(dynsym_index, shndx);
+		  shndx = elfcpp::SHN_XINDEX;
+		}
+	      break;
 
-	case Symbol::IN_OUTPUT_SEGMENT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
+	    case Symbol::IN_OUTPUT_SEGMENT:
+	      shndx = elfcpp::SHN_ABS;
+	      break;
 
-	case Symbol::IS_CONSTANT:
-	  shndx = elfcpp::SHN_ABS;
-	  break;
+	    case Symbol::IS_CONSTANT:
+	      shndx = elfcpp::SHN_ABS;
+	      break;
 
-	case Symbol::IS_UNDEFINED:
-	  shndx = elfcpp::SHN_UNDEF;
-	  break;
+	    case Symbol::IS_UNDEFINED:
+	      shndx = elfcpp::SHN_UNDEF;
+	      break;
 
-	default:
-	  gold_unreachable();
-	}
+	    default:
+	      gold_unreachable();
+	    }
 
-      if (sym_index != -1U)
-	{
-	  sym_index -= first_global_index;
-	  gold_assert(sym_index < output_count);
-	  unsigned char* ps = psyms + (sym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
-						     sympool, ps);
-	}
+	  if (sym_index != -1U)
+	    {
+	      sym_index -= first_global_index;
+	      gold_assert(sym_index < output_count);
+	      unsigned char* ps = psyms + (sym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, sym_value, shndx,
+							 sympool, ps);
+	    }
 
-      if (dynsym_index != -1U)
-	{
-	  dynsym_index -= first_dynamic_global_index;
-	  gold_assert(dynsym_index < dynamic_count);
-	  unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
-	  this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
-						     dynpool, pd);
+	  if (dynsym_index != -1U)
+	    {
+	      dynsym_index -= first_dynamic_global_index;
+	      gold_assert(dynsym_index < dynamic_count);
+	      unsigned char* pd = dynamic_view + (dynsym_index * sym_size);
+	      this->sized_write_symbol<size, big_endian>(sym, dynsym_value, shndx,
+							 dynpool, pd);
+	    }
 	}
     }
 
-  of->write_output_view(this->offset_, oview_size, psyms);
-  if (dynamic_view != NULL)
-    of->write_output_view(this->dynamic_offset_, dynamic_size, dynamic_view);
 }
 
 // Write out the symbol SYM, in section SHNDX, to P.  POOL is the
@@ -2890,14 +3308,28 @@ Symbol_table::sized_write_section_symbol(const Output_section* os,
 void
 Symbol_table::print_stats() const
 {
+  size_t entries = 0;
+  size_t buckets = 0;
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      entries += this->shards_[i].table.size();
+#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
+      buckets += this->shards_[i].table.bucket_count();
+#endif
+    }
 #if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
   fprintf(stderr, _("%s: symbol table entries: %zu; buckets: %zu\n"),
-	  program_name, this->table_.size(), this->table_.bucket_count());
+	  program_name, entries, buckets);
 #else
   fprintf(stderr, _("%s: symbol table entries: %zu\n"),
-	  program_name, this->table_.size());
+	  program_name, entries);
 #endif
-  this->namepool_.print_stats("symbol table stringpool");
+  for (unsigned int i = 0; i < shard_count; ++i)
+    {
+      char name[50];
+      snprintf(name, sizeof name, "symbol table shard %u stringpool", i);
+      this->shards_[i].namepool.print_stats(name);
+    }
 }
 
 // We check for ODR violations by looking for symbols with the same
@@ -2910,7 +3342,7 @@ Symbol_table::print_stats() const
 // that case.
 
 // This struct is used to compare line information, as returned by
-// Dwarf_line_info::one_addr2line.  It implements a < comparison
+// Dwarf_line_info::addr2line.  It implements a < comparison
 // operator used with std::set.
 
 struct Odr_violation_compare
@@ -2928,13 +3360,127 @@ struct Odr_violation_compare
   }
 };
 
+// A location for which we want the source file and line number, and
+// where to store it.
+
+struct Odr_line_request
+{
+  unsigned int shndx;
+  off_t offset;
+  std::string* lineno;
+};
+
+// The line table of an object, and the locations to look up in it.
+
+struct Odr_line_object
+{
+  Object* object;
+  Dwarf_line_info* lineinfo;
+  std::vector<Odr_line_request> requests;
+};
+
+// Parse the line tables of the objects with candidate ODR violations,
+// and look up the source lines, in parallel.  Each index is an object.
+// The line tables have already been read from the files, so this does
+// not lock any objects.  The line table of each object is parsed
+// once, for all of its sections, however many requests there are for
+// it.
+
+class Odr_line_work : public Parallel_work
+{
+ public:
+  Odr_line_work(std::vector<Odr_line_object>* objects)
+    : objects_(objects)
+  { }
+
+ protected:
+  void
+  do_range(unsigned int first, unsigned int last);
+
+ private:
+  std::vector<Odr_line_object>* objects_;
+};
+
+void
+Odr_line_work::do_range(unsigned int first, unsigned int last)
+{
+  for (unsigned int i = first; i < last; ++i)
+    {
+      Odr_line_object* obj = &(*this->objects_)[i];
+      obj->lineinfo->parse();
+      for (std::vector<Odr_line_request>::const_iterator p =
+	     obj->requests.begin();
+	   p != obj->requests.end();
+	   ++p)
+	*p->lineno = obj->lineinfo->addr2line(p->shndx, p->offset);
+      delete obj->lineinfo;
+      obj->lineinfo = NULL;
+    }
+}
+
 // Check candidate_odr_violations_ to find symbols with the same name
 // but apparently different definitions (different source-file/line-no).
 
 void
 Symbol_table::detect_odr_violations(const Task* task,
+				    Workqueue* workqueue,
 				    const char* output_file_name) const
 {
+  if (candidate_odr_violations_.empty())
+    return;
+
+  // Find each distinct location, and group them by object.
+  typedef Unordered_map<Symbol_location, std::string, Symbol_location_hash>
+    Linenos;
+  Linenos linenos;
+  Unordered_map<const Object*, unsigned int> object_indexes;
+  std::vector<Odr_line_object> objects;
+  for (Odr_map::const_iterator it = candidate_odr_violations_.begin();
+       it != candidate_odr_violations_.end();
+       ++it)
+    {
+      for (Unordered_set<Symbol_location, Symbol_location_hash>::const_iterator
+	     locs = it->second.begin();
+	   locs != it->second.end();
+	   ++locs)
+	{
+	  std::pair<Linenos::iterator, bool> ins =
+	    linenos.insert(std::make_pair(*locs, std::string()));
+	  if (!ins.second)
+	    continue;
+
+	  std::pair<Unordered_map<const Object*, unsigned int>::iterator,
+		    bool> oins =
+	    object_indexes.insert(std::make_pair(locs->object,
+						 objects.size()));
+	  if (oins.second)
+	    {
+	      objects.push_back(Odr_line_object());
+	      objects.back().object = locs->object;
+	      objects.back().lineinfo = NULL;
+	    }
+
+	  Odr_line_request request;
+	  request.shndx = locs->shndx;
+	  request.offset = locs->offset;
+	  request.lineno = &ins.first->second;
+	  objects[oins.first->second].requests.push_back(request);
+	}
+    }
+
+  // Read the line tables here, since only this task may lock the
+  // objects.
+  for (std::vector<Odr_line_object>::iterator p = objects.begin();
+       p != objects.end();
+       ++p)
+    {
+      Task_lock_obj<Object> tl(task, p->object);
+      p->lineinfo = Dwarf_line_info::create_unparsed(p->object);
+    }
+
+  Odr_line_work work(&objects);
+  work.run(workqueue, objects.size(), 1);
+
   for (Odr_map::const_iterator it = candidate_odr_violations_.begin();
        it != candidate_odr_violations_.end();
        ++it)
@@ -2948,19 +3494,10 @@ Symbol_table::detect_odr_violations(const Task* task,
            locs != it->second.end();
            ++locs)
         {
-	  // We need to lock the object in order to read it.  This
-	  // means that we have to run in a singleton Task.  If we
-	  // want to run this in a general Task for better
-	  // performance, we will need one Task for object, plus
-	  // appropriate locking to ensure that we don't conflict with
-	  // other uses of the object.  Also note, one_addr2line is not
-          // currently thread-safe.
-	  Task_lock_obj<Object> tl(task, locs->object);
-          // 16 is the size of the object-cache that one_addr2line should use.
-          std::string lineno = Dwarf_line_info::one_addr2line(
-              locs->object, locs->shndx, locs->offset, 16);
-          if (!lineno.empty())
-            line_nums.insert(lineno);
+	  Linenos::const_iterator p = linenos.find(*locs);
+	  gold_assert(p != linenos.end());
+          if (!p->second.empty())
+            line_nums.insert(p->second);
         }
 
       if (line_nums.size() > 1)
@@ -2974,8 +3511,6 @@ Symbol_table::detect_odr_violations(const Task* task,
             fprintf(stderr, "  %s\n", it2->c_str());
         }
     }
-  // We only call one_addr2line() in this function, so we can clear its cache.
-  Dwarf_line_info::clear_addr2line_cache();
 }
 
 // Warnings functions.
@@ -3051,6 +3586,20 @@ Symbol_table::add_from_relobj<32, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
+    Sized_relobj<32, false>::Symbols* sympointers,
+    size_t* defined);
+
+template
+Symbol_shard_adder*
+Symbol_table::make_relobj_shard_adder<32, false>(
+    Sized_relobj<32, false>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    std::vector<Symbol_name_hash>* name_hashes,
     Sized_relobj<32, false>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3065,6 +3614,20 @@ Symbol_table::add_from_relobj<32, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
+    Sized_relobj<32, true>::Symbols* sympointers,
+    size_t* defined);
+
+template
+Symbol_shard_adder*
+Symbol_table::make_relobj_shard_adder<32, true>(
+    Sized_relobj<32, true>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    std::vector<Symbol_name_hash>* name_hashes,
     Sized_relobj<32, true>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3079,6 +3642,20 @@ Symbol_table::add_from_relobj<64, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
+    Sized_relobj<64, false>::Symbols* sympointers,
+    size_t* defined);
+
+template
+Symbol_shard_adder*
+Symbol_table::make_relobj_shard_adder<64, false>(
+    Sized_relobj<64, false>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    std::vector<Symbol_name_hash>* name_hashes,
     Sized_relobj<64, false>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3093,6 +3670,20 @@ Symbol_table::add_from_relobj<64, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
+    Sized_relobj<64, true>::Symbols* sympointers,
+    size_t* defined);
+
+template
+Symbol_shard_adder*
+Symbol_table::make_relobj_shard_adder<64, true>(
+    Sized_relobj<64, true>* relobj,
+    const unsigned char* syms,
+    size_t count,
+    size_t symndx_offset,
+    const char* sym_names,
+    size_t sym_name_size,
+    std::vector<Symbol_name_hash>* name_hashes,
     Sized_relobj<64, true>::Symbols* sympointers,
     size_t* defined);
 #endif
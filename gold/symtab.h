@@ -60,6 +60,8 @@ class Output_file;
 class Output_symtab_xindex;
 class Garbage_collection;
 class Icf;
+class Lock;
+class Workqueue;
 
 // The base class of an entry in the symbol table.  The symbol table
 // can have a lot of entries, so we don't want this class to big.
@@ -1145,15 +1147,64 @@ class Warnings
     }
   };
 
-  // A mapping from warning symbol names (canonicalized in
-  // Symbol_table's namepool_ field) to warning information.
+  // A mapping from warning symbol names (canonicalized in the
+  // Symbol_table's name pools) to warning information.
   typedef Unordered_map<const char*, Warning_location> Warning_table;
 
   Warning_table warnings_;
 };
 
+// When running with threads, the external symbols of a large
+// relocatable object are added to the symbol table one shard at a
+// time, with the shards handled in parallel.  An object of this type
+// holds the symbols of an object which are waiting to be added.
+
+class Symbol_shard_adder
+{
+ public:
+  Symbol_shard_adder()
+    : views_()
+  { }
+
+  virtual
+  ~Symbol_shard_adder();
+
+  // Add the symbols which belong in shard SHARD of the symbol table.
+  // This may be called for different shards at the same time, and
+  // must be called exactly once for each shard.
+  void
+  add_shard(unsigned int shard)
+  { this->do_add_shard(shard); }
+
+  // Take ownership of VIEW, which holds symbol data used by
+  // add_shard.  The views are deleted along with this object, which
+  // must only happen when the file is locked.
+  void
+  hold_view(File_view* view)
+  { this->views_.push_back(view); }
+
+ protected:
+  // Add the symbols in a shard.
+  virtual void
+  do_add_shard(unsigned int shard) = 0;
+
+ private:
+  Symbol_shard_adder(const Symbol_shard_adder&);
+  Symbol_shard_adder& operator=(const Symbol_shard_adder&);
+
+  std::vector<File_view*> views_;
+};
+
 // The main linker symbol table.
 
+// The global symbols are divided into a fixed number of shards by
+// the hash code of their names.  Each shard has its own hash table
+// and its own pool of names.  A name, all of its versions, and the
+// names of those versions, are always found in the same shard.
+// Within a shard, symbols are always added in the order of the input
+// files, so the final symbol table does not depend on how the work
+// was divided among threads.
+
 class Symbol_table
 {
  public:
@@ -1198,21 +1249,54 @@ class Symbol_table
   inline void
   gc_mark_dyn_syms(Symbol* sym);
 
+  // The number of shards in the symbol table.
+  static const unsigned int shard_count = 16;
+
   // Add COUNT external symbols from the relocatable object RELOBJ to
   // the symbol table.  SYMS is the symbols, SYMNDX_OFFSET is the
   // offset in the symbol table of the first symbol, SYM_NAMES is
-  // their names, SYM_NAME_SIZE is the size of SYM_NAMES.  This sets
-  // SYMPOINTERS to point to the symbols in the symbol table.  It sets
-  // *DEFINED to the number of defined symbols.
+  // their names, SYM_NAME_SIZE is the size of SYM_NAMES.  NAME_HASHES
+  // is the hash codes of the names, or NULL if they have not been
+  // computed.  This sets SYMPOINTERS to point to the symbols in the
+  // symbol table.  It sets *DEFINED to the number of defined symbols.
   template<int size, bool big_endian>
   void
   add_from_relobj(Sized_relobj<size, big_endian>* relobj,
 		  const unsigned char* syms, size_t count,
 		  size_t symndx_offset, const char* sym_names,
-		  size_t sym_name_size,
+		  size_t sym_name_size, const Symbol_name_hash* name_hashes,
 		  typename Sized_relobj<size, big_endian>::Symbols*,
 		  size_t* defined);
 
+  // Like add_from_relobj, but rather than adding the symbols, return
+  // a Symbol_shard_adder which will add them one shard at a time.
+  // This sets *DEFINED.  The Symbol_shard_adder takes over the
+  // contents of NAME_HASHES.  The symbol data must remain valid until
+  // the Symbol_shard_adder is deleted.  This returns NULL, and does
+  // nothing, if it is not worth adding the symbols this way; the
+  // caller should then call add_from_relobj.
+  template<int size, bool big_endian>
+  Symbol_shard_adder*
+  make_relobj_shard_adder(Sized_relobj<size, big_endian>* relobj,
+			  const unsigned char* syms, size_t count,
+			  size_t symndx_offset, const char* sym_names,
+			  size_t sym_name_size,
+			  std::vector<Symbol_name_hash>* name_hashes,
+			  typename Sized_relobj<size, big_endian>::Symbols*,
+			  size_t* defined);
+
+  // Add the symbols from RELOBJ which belong in shard SHARD.  This is
+  // the work done by a Symbol_shard_adder.  The arguments are as for
+  // add_from_relobj.
+  template<int size, bool big_endian>
+  void
+  add_relobj_shard(Sized_relobj<size, big_endian>* relobj,
+		   const unsigned char* syms, size_t count,
+		   size_t symndx_offset, const char* sym_names,
+		   size_t sym_name_size, const Symbol_name_hash* name_hashes,
+		   typename Sized_relobj<size, big_endian>::Symbols*,
+		   unsigned int shard);
+
   // Add one external symbol from the plugin object OBJ to the symbol table.
   // Returns a pointer to the resolved symbol in the symbol table.
   template<int size, bool big_endian>
@@ -1301,8 +1385,19 @@ class Symbol_table
 
   // Return the count of undefined symbols seen.
   int
-  saw_undefined() const
-  { return this->saw_undefined_; }
+  saw_undefined() const;
+
+  // Start or stop recording strong undefined references.  While
+  // recording, each symbol which is still undefined after a strong
+  // undefined reference is added is remembered.  This is used by
+  // Archive::add_symbols to find the archive members which may be
+  // needed after it adds a member.
+  void
+  set_log_undefined(bool);
+
+  // Move the symbols recorded since the last call to *SYMS.
+  void
+  take_undefined_log(std::vector<Symbol*>* syms);
 
   // Allocate the common symbols
   void
@@ -1316,8 +1411,7 @@ class Symbol_table
 
   // Canonicalize a symbol name for use in the hash table.
   const char*
-  canonicalize_name(const char* name)
-  { return this->namepool_.add(name, true, NULL); }
+  canonicalize_name(const char* name);
 
   // Possibly issue a warning for a reference to SYM at LOCATION which
   // is in OBJ.
@@ -1331,7 +1425,8 @@ class Symbol_table
   // Check candidate_odr_violations_ to find symbols with the same name
   // but apparently different definitions (different source-file/line-no).
   void
-  detect_odr_violations(const Task*, const char* output_file_name) const;
+  detect_odr_violations(const Task*, Workqueue*,
+			const char* output_file_name) const;
 
   // Add any undefined symbols named on the command line to the symbol
   // table.
@@ -1365,11 +1460,12 @@ class Symbol_table
   finalize(off_t off, off_t dynoff, size_t dyn_global_index, size_t dyncount,
 	   Stringpool* pool, unsigned int *plocal_symcount);
 
-  // Write out the global symbols.
+  // Write out the global symbols.  WORKQUEUE is used to share the
+  // work with other threads.
   void
   write_globals(const Stringpool*, const Stringpool*,
 		Output_symtab_xindex*, Output_symtab_xindex*,
-		Output_file*) const;
+		Output_file*, Workqueue*) const;
 
   // Write out a section symbol.  Return the updated offset.
   void
@@ -1411,19 +1507,95 @@ class Symbol_table
   typedef Unordered_map<Symbol_table_key, Symbol*, Symbol_table_hash,
 			Symbol_table_eq> Symbol_table_type;
 
+  // The type of the list of symbols which have been forced local.
+  typedef std::vector<Symbol*> Forced_locals;
+
+  // One shard of the symbol table.
+  struct Symbol_table_shard
+  {
+    Symbol_table_shard()
+      : table(), namepool(), saw_undefined(0), undefined_log(), commons(),
+	tls_commons(), small_commons(), large_commons(), forced_locals()
+    { }
+
+    // The symbol hash table.
+    Symbol_table_type table;
+    // A pool of symbol names and versions.  Entries in the hash
+    // table point into this pool.
+    Stringpool namepool;
+    // We increment this every time we see a new undefined symbol,
+    // for use in archive groups.
+    int saw_undefined;
+    // When log_undefined_ is set, the symbols which got strong
+    // undefined references.
+    std::vector<Symbol*> undefined_log;
+    // We don't expect there to be very many common symbols, so we
+    // keep a list of them.  When we find a common symbol we add it
+    // to this list.  It is possible that by the time we process the
+    // list the symbol is no longer a common symbol.  It may also
+    // have become a forwarder.
+    Commons_type commons;
+    // This is like the commons field, except that it holds TLS
+    // common symbols.
+    Commons_type tls_commons;
+    // This is for small common symbols.
+    Commons_type small_commons;
+    // This is for large common symbols.
+    Commons_type large_commons;
+    // A list of symbols which have been forced to be local.  We don't
+    // expect there to be very many of them, so we keep a list of them
+    // rather than walking the whole table to find them.
+    Forced_locals forced_locals;
+  };
+
+  // Return the shard for a name with hash code HASH_CODE, as computed
+  // by Stringpool::hash_string.
+  static unsigned int
+  shard_index(size_t hash_code)
+  { return (hash_code ^ (hash_code >> 16)) % shard_count; }
+
+  // Return the shard for NAME, and set *PLEN and *PHASH_CODE to the
+  // length and hash code of NAME.
+  static unsigned int
+  name_shard(const char* name, size_t* plen, size_t* phash_code);
+
   // Make FROM a forwarder symbol to TO.
   void
   make_forwarder(Symbol* from, Symbol* to);
 
-  // Add a symbol.
+  // Add a symbol to shard SHARD.
   template<int size, bool big_endian>
   Sized_symbol<size>*
-  add_from_object(Object*, const char *name, Stringpool::Key name_key,
-		  const char *version, Stringpool::Key version_key,
-		  bool def, const elfcpp::Sym<size, big_endian>& sym,
+  add_from_object(Object*, unsigned int shard, const char *name,
+		  Stringpool::Key name_key, const char *version,
+		  Stringpool::Key version_key, bool def,
+		  const elfcpp::Sym<size, big_endian>& sym,
 		  unsigned int st_shndx, bool is_ordinary,
 		  unsigned int orig_st_shndx);
 
+  // Add external symbol I from a relocatable object to the symbol
+  // table.  SHARD is its shard, and NAME_HASH is the hash code and
+  // length of its name.  If DEFINED is not NULL, this increments
+  // *DEFINED for a defined symbol.
+  template<int size, bool big_endian>
+  void
+  add_relobj_symbol(Sized_relobj<size, big_endian>* relobj,
+		    const unsigned char* p, size_t i, size_t symndx_offset,
+		    const char* name, const Symbol_name_hash& name_hash,
+		    unsigned int shard,
+		    typename Sized_relobj<size, big_endian>::Symbols*,
+		    size_t* defined);
+
+  // Record that a symbol in shard SHARD is forced to be local.
+  void
+  force_local_in_shard(Symbol*, unsigned int shard);
+
+  // Collect the common symbols of one type from all the shards into
+  // COMMONS.  WHICH points to the list in a shard.
+  void
+  collect_commons(Commons_type Symbol_table_shard::* which,
+		  Commons_type* commons) const;
+
   // Define a default symbol.
   template<int size, bool big_endian>
   void
@@ -1448,9 +1620,11 @@ class Symbol_table
   void
   force_local(Symbol*);
 
-  // Adjust NAME and *NAME_KEY for wrapping.
+  // Adjust NAME and *NAME_KEY for wrapping.  This sets *PSHARD to
+  // the shard of the returned name.
   const char*
-  wrap_symbol(Object* object, const char*, Stringpool::Key* name_key);
+  wrap_symbol(Object* object, const char*, Stringpool::Key* name_key,
+	      unsigned int* pshard);
 
   // Whether we should override a symbol, based on flags in
   // resolve.cc.
@@ -1573,7 +1747,19 @@ class Symbol_table
   void
   sized_write_globals(const Stringpool*, const Stringpool*,
 		      Output_symtab_xindex*, Output_symtab_xindex*,
-		      Output_file*) const;
+		      Output_file*, Workqueue*) const;
+
+  // Write the globals in a range of shards.
+  template<int size, bool big_endian>
+  void
+  sized_write_global_shards(unsigned int first, unsigned int last,
+			    const Stringpool*, const Stringpool*,
+			    Output_symtab_xindex*, Output_symtab_xindex*,
+			    unsigned char* psyms,
+			    unsigned char* dynamic_view) const;
+
+  template<int size, bool big_endian>
+  friend class Write_globals_work;
 
   // Write out a symbol to P.
   template<int size, bool big_endian>
@@ -1593,9 +1779,6 @@ class Symbol_table
   sized_write_section_symbol(const Output_section*, Output_symtab_xindex*,
 			     Output_file*, off_t) const;
 
-  // The type of the list of symbols which have been forced local.
-  typedef std::vector<Symbol*> Forced_locals;
-
   // A map from symbols with COPY relocs to the dynamic objects where
   // they are defined.
   typedef Unordered_map<const Symbol*, Dynobj*> Copied_symbol_dynobjs;
@@ -1627,9 +1810,6 @@ class Symbol_table
                         Unordered_set<Symbol_location, Symbol_location_hash> >
   Odr_map;
 
-  // We increment this every time we see a new undefined symbol, for
-  // use in archive groups.
-  int saw_undefined_;
   // The index of the first global symbol in the output file.
   unsigned int first_global_index_;
   // The file offset within the output symtab section where we should
@@ -1643,33 +1823,20 @@ class Symbol_table
   unsigned int first_dynamic_global_index_;
   // The number of global dynamic symbols, or 0 if none.
   unsigned int dynamic_count_;
-  // The symbol hash table.
-  Symbol_table_type table_;
-  // A pool of symbol names.  This is used for all global symbols.
-  // Entries in the hash table point into this pool.
-  Stringpool namepool_;
+  // The shards of the symbol table.
+  Symbol_table_shard shards_[shard_count];
+  // Whether to record strong undefined references in the
+  // undefined_log of each shard.
+  bool log_undefined_;
+  // Protects the fields below which may be changed while more than
+  // one shard is being updated: forwarders_,
+  // candidate_odr_violations_, and the garbage collection worklist.
+  Lock* lock_;
   // Forwarding symbols.
   Unordered_map<const Symbol*, Symbol*> forwarders_;
   // Weak aliases.  A symbol in this list points to the next alias.
   // The aliases point to each other in a circular list.
   Unordered_map<Symbol*, Symbol*> weak_aliases_;
-  // We don't expect there to be very many common symbols, so we keep
-  // a list of them.  When we find a common symbol we add it to this
-  // list.  It is possible that by the time we process the list the
-  // symbol is no longer a common symbol.  It may also have become a
-  // forwarder.
-  Commons_type commons_;
-  // This is like the commons_ field, except that it holds TLS common
-  // symbols.
-  Commons_type tls_commons_;
-  // This is for small common symbols.
-  Commons_type small_commons_;
-  // This is for large common symbols.
-  Commons_type large_commons_;
-  // A list of symbols which have been forced to be local.  We don't
-  // expect there to be very many of them, so we keep a list of them
-  // rather than walking the whole table to find them.
-  Forced_locals forced_locals_;
   // Manage symbol warnings.
   Warnings warnings_;
   // Manage potential One Definition Rule (ODR) violations.
@@ -184,6 +184,14 @@ class Target
   finalize_sections(Layout* layout)
   { return this->do_finalize_sections(layout); }
 
+  // This is called after the addresses of the sections have been
+  // set, to complete any sections whose contents depend on them.
+  // Return true if such a section grew, in which case the addresses
+  // are set again and this is called again.
+  bool
+  finalize_address_dependent_sections()
+  { return this->do_finalize_address_dependent_sections(); }
+
   // Return the value to use for a global symbol which needs a special
   // value in the dynamic symbol table.  This will only be called if
   // the backend first calls symbol->set_needs_dynsym_value().
@@ -273,6 +281,11 @@ class Target
   do_finalize_sections(Layout*)
   { }
 
+  // Virtual function which may be implemented by the child class.
+  virtual bool
+  do_finalize_address_dependent_sections()
+  { return false; }
+
   // Virtual function which may be implemented by the child class.
   virtual uint64_t
   do_dynsym_value(const Symbol*) const
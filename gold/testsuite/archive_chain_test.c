@@ -0,0 +1,79 @@
+/* archive_chain_test.c -- test selecting archive members with threads.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled with ARCHIVE_CHAIN_TEST_N defined as 0 to 7.
+   Object 0 is linked directly; the others are put in an archive in
+   reverse order.  Each object refers to the next one, so gold pulls
+   in one member at a time, from the end of the archive to the start.
+   Object 2 also refers to object 5, which is pulled in before object
+   3.  Object 3 has a weak reference to object 7, which is not pulled
+   in.  Each object defines more than a thousand symbols, so that the
+   archive map is large.  The output must be the same with and
+   without --threads.  */
+
+#define CAT(a, b) a##b
+#define XCAT(a, b) CAT(a, b)
+
+#define N ARCHIVE_CHAIN_TEST_N
+#define SYM(n) XCAT(archive_chain_test_, n)
+
+#if N < 6
+#if N == 0
+#define NEXT 1
+#elif N == 1
+#define NEXT 2
+#elif N == 2
+#define NEXT 3
+#elif N == 3
+#define NEXT 4
+#elif N == 4
+#define NEXT 5
+#else
+#define NEXT 6
+#endif
+extern int SYM(NEXT);
+int *XCAT(SYM(N), _next) = &SYM(NEXT);
+#endif
+
+#if N == 2
+extern int archive_chain_test_5;
+int *archive_chain_test_2_other = &archive_chain_test_5;
+#endif
+
+#if N == 3
+extern int archive_chain_test_7 __attribute__ ((weak));
+int *archive_chain_test_3_weak = &archive_chain_test_7;
+#endif
+
+#if N > 0
+
+int SYM(N) = N;
+
+#define DEF1(v) int XCAT(SYM(N), _##v) = N;
+#define DEF10(v) DEF1(v##0) DEF1(v##1) DEF1(v##2) DEF1(v##3) DEF1(v##4) \
+  DEF1(v##5) DEF1(v##6) DEF1(v##7) DEF1(v##8) DEF1(v##9)
+#define DEF100(v) DEF10(v##0) DEF10(v##1) DEF10(v##2) DEF10(v##3) \
+  DEF10(v##4) DEF10(v##5) DEF10(v##6) DEF10(v##7) DEF10(v##8) DEF10(v##9)
+
+DEF100(v0) DEF100(v1) DEF100(v2) DEF100(v3) DEF100(v4) DEF100(v5)
+DEF100(v6) DEF100(v7) DEF100(v8) DEF100(v9) DEF100(va) DEF100(vb)
+
+#endif
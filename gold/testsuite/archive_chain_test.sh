@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# archive_chain_test.sh -- test selecting archive members
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with archive_chain_test.c.  Object 0 is linked with an
+# archive of the other objects into a shared library, with and
+# without --threads.  The outputs must be the same.  The .stdout file
+# has the output of nm on the shared library.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same archive_chain_test.so archive_chain_test_threads.so
+
+for n in 1 2 3 4 5 6
+do
+    check archive_chain_test.stdout " D archive_chain_test_${n}$"
+done
+check archive_chain_test.stdout " w archive_chain_test_7$"
+
+exit 0
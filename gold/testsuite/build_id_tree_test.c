@@ -0,0 +1,29 @@
+/* build_id_tree_test.c -- test --build-id=tree.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is linked into a shared library with --build-id=tree, once
+   without and once with --threads.  The build ID is computed from
+   4 megabyte chunks of the output file, so the data below is large
+   enough to give several chunks, the last one short.  */
+
+char build_id_tree_test_data[9 * 1024 * 1024 + 1000] = { 1 };
+
+int build_id_tree_test_value = 2;
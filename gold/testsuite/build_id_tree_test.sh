@@ -0,0 +1,54 @@
+#!/bin/sh
+
+# build_id_tree_test.sh -- test --build-id=tree.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with build_id_tree_test.c, which is linked into a
+# shared library with --build-id=tree, once serially and once with
+# --threads.  The chunk digests are computed in parallel with
+# --threads, but the build ID must not depend on that.  We check that
+# both outputs have a build ID note and that the notes are the same.
+
+check()
+{
+    if ! grep -q "$2" $1
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check build_id_tree_test.stdout "NT_GNU_BUILD_ID"
+check build_id_tree_test_threads.stdout "NT_GNU_BUILD_ID"
+
+# The output includes a hex dump of the note, which has the build ID.
+if ! cmp -s build_id_tree_test.stdout build_id_tree_test_threads.stdout
+then
+    echo "Build ID differs between serial and --threads links:"
+    cat build_id_tree_test.stdout build_id_tree_test_threads.stdout
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,38 @@
+/* compress_debug_test.c -- test --compress-debug-sections.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This has a .debug_str section of more than a megabyte, which gold
+   compresses in two chunks, and an empty .debug_ranges section, which
+   gold should leave alone.  The strings are not all the same, so that
+   the compressed data is not trivial.  */
+
+__asm__ (".section .debug_str,\"\",@progbits\n"
+	 "\t.set compress_debug_test_n, 0\n"
+	 "\t.rept 300000\n"
+	 "\t.long ((compress_debug_test_n * 2654435761) & 0xffffffff)"
+	 " | 0x01010101\n"
+	 "\t.byte 0\n"
+	 "\t.set compress_debug_test_n, compress_debug_test_n + 1\n"
+	 "\t.endr\n"
+	 "\t.section .debug_ranges,\"\",@progbits\n"
+	 "\t.previous\n");
+
+int compress_debug_test_v = 1;
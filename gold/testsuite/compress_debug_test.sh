@@ -0,0 +1,64 @@
+#!/bin/sh
+
+# compress_debug_test.sh -- test --compress-debug-sections.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with compress_debug_test.c, which is linked into a
+# shared library with --compress-debug-sections=none, zlib and
+# zlib-fast, using --fatal-warnings.  Its .debug_str section is
+# compressed in more than one chunk.  We check that the section is
+# compressed, and that readelf, which uses zlib to decompress it,
+# finds the same contents as in the uncompressed library.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+contents()
+{
+    sed -e '1,/^Contents of the/d' "$1"
+}
+
+check compress_debug_test.stdout ' \.debug_str '
+for f in compress_debug_test_zlib.stdout compress_debug_test_zlib_fast.stdout
+do
+    check $f ' \.zdebug_str '
+    check $f ' \.debug_ranges '
+    contents compress_debug_test.stdout > compress_debug_test.tmp
+    if ! contents $f | cmp -s - compress_debug_test.tmp
+    then
+	echo "Contents of .zdebug_str in $f differ from .debug_str"
+	rm -f compress_debug_test.tmp
+	exit 1
+    fi
+    rm -f compress_debug_test.tmp
+done
+
+exit 0
@@ -0,0 +1,168 @@
+// eh_frame_hdr_test.cc -- test a large .eh_frame_hdr for gold
+
+// Copyright 2009 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This program has 140,000 FDEs.  gold sorts the .eh_frame_hdr table
+// in runs of 65,536 FDEs and then merges the runs.  The FDEs for two
+// sections are interleaved in .eh_frame, so each run is out of order
+// before it is sorted.  The program checks that the table in its own
+// PT_GNU_EH_FRAME segment is sorted, and throws exceptions through
+// functions which the unwinder must find by searching the table.
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <link.h>
+#include <stdint.h>
+
+// Alternate between two sections, so that gold sees the FDEs out of
+// address order.
+
+asm(".rept 70000\n"
+    "\t.pushsection .text.eh_frame_hdr_test_a,\"ax\"\n"
+    "\t.cfi_startproc\n"
+    "\tnop\n"
+    "\t.cfi_endproc\n"
+    "\t.popsection\n"
+    "\t.pushsection .text.eh_frame_hdr_test_b,\"ax\"\n"
+    "\t.cfi_startproc\n"
+    "\tnop\n"
+    "\t.cfi_endproc\n"
+    "\t.popsection\n"
+    ".endr\n");
+
+static void (* volatile thrower)(int);
+
+static void
+do_throw(int i)
+{
+  throw i;
+}
+
+__attribute__((noinline)) static int
+call_1(int i)
+{
+  thrower(i);
+  return 0;
+}
+
+__attribute__((noinline)) static int
+call_2(int i)
+{
+  thrower(i + 1);
+  return 0;
+}
+
+// The object which contains ADDR, and its PT_GNU_EH_FRAME segment.
+
+struct Eh_frame_hdr_info
+{
+  const void* addr;
+  const unsigned char* hdr;
+};
+
+static int
+find_eh_frame_hdr(struct dl_phdr_info* info, size_t, void* data)
+{
+  Eh_frame_hdr_info* p = static_cast<Eh_frame_hdr_info*>(data);
+  uintptr_t addr = reinterpret_cast<uintptr_t>(p->addr);
+  const ElfW(Phdr)* eh_frame = NULL;
+  bool found = false;
+  for (int i = 0; i < info->dlpi_phnum; ++i)
+    {
+      const ElfW(Phdr)* phdr = &info->dlpi_phdr[i];
+      if (phdr->p_type == PT_GNU_EH_FRAME)
+	eh_frame = phdr;
+      else if (phdr->p_type == PT_LOAD
+	       && addr >= info->dlpi_addr + phdr->p_vaddr
+	       && addr < info->dlpi_addr + phdr->p_vaddr + phdr->p_memsz)
+	found = true;
+    }
+  if (!found)
+    return 0;
+  assert(eh_frame != NULL);
+  p->hdr = reinterpret_cast<const unsigned char*>(info->dlpi_addr
+						  + eh_frame->p_vaddr);
+  return 1;
+}
+
+static int32_t
+read_int32(const unsigned char* p)
+{
+  int32_t v;
+  memcpy(&v, p, sizeof v);
+  return v;
+}
+
+// Check the binary search table in the .eh_frame_hdr section.
+
+static void
+check_eh_frame_hdr()
+{
+  Eh_frame_hdr_info info;
+  info.addr = reinterpret_cast<const void*>(call_1);
+  info.hdr = NULL;
+  assert(dl_iterate_phdr(find_eh_frame_hdr, &info) == 1);
+
+  const unsigned char* hdr = info.hdr;
+  assert(hdr[0] == 1);
+  assert(hdr[1] == 0x1b);  // DW_EH_PE_pcrel | DW_EH_PE_sdata4
+  assert(hdr[2] == 0x03);  // DW_EH_PE_udata4
+  assert(hdr[3] == 0x3b);  // DW_EH_PE_datarel | DW_EH_PE_sdata4
+
+  uint32_t fde_count = static_cast<uint32_t>(read_int32(hdr + 8));
+  assert(fde_count >= 140000);
+
+  const unsigned char* table = hdr + 12;
+  int32_t last = read_int32(table);
+  for (uint32_t i = 1; i < fde_count; ++i)
+    {
+      int32_t pc = read_int32(table + i * 8);
+      assert(pc >= last);
+      last = pc;
+    }
+}
+
+int
+main()
+{
+  check_eh_frame_hdr();
+
+  thrower = do_throw;
+  int caught = 0;
+  try
+    {
+      call_1(1);
+    }
+  catch (int i)
+    {
+      caught += i;
+    }
+  try
+    {
+      call_2(2);
+    }
+  catch (int i)
+    {
+      caught += i;
+    }
+  assert(caught == 4);
+  return 0;
+}
@@ -0,0 +1,75 @@
+/* gc_thread_test.c -- test --gc-sections with threads.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled twice, with GC_THREAD_TEST_N defined as 1 and 2,
+   and with -fdata-sections, so that there are 6,000 sections.  Only
+   gc_thread_test_root is exported; everything else is hidden, so it
+   is kept only if it can be reached from the root.  Each chain of
+   references goes from r1 to r2 to s1 to s2, alternating between the
+   objects, so with --threads the closure crosses from one partition
+   to another at every step.  The u1 and u2 variables cannot be
+   reached, although they refer to sections which can.  */
+
+#define X10(f, n) f(n##0) f(n##1) f(n##2) f(n##3) f(n##4) \
+  f(n##5) f(n##6) f(n##7) f(n##8) f(n##9)
+#define X100(f, n) X10(f, n##0) X10(f, n##1) X10(f, n##2) X10(f, n##3) \
+  X10(f, n##4) X10(f, n##5) X10(f, n##6) X10(f, n##7) X10(f, n##8) \
+  X10(f, n##9)
+#define X1000(f) X100(f, v0) X100(f, v1) X100(f, v2) X100(f, v3) \
+  X100(f, v4) X100(f, v5) X100(f, v6) X100(f, v7) X100(f, v8) \
+  X100(f, v9)
+
+#pragma GCC visibility push(hidden)
+
+#define DECL(n) \
+  extern void *gc_thread_test_r1_##n, *gc_thread_test_r2_##n; \
+  extern void *gc_thread_test_s1_##n, *gc_thread_test_s2_##n; \
+  extern void *gc_thread_test_u1_##n, *gc_thread_test_u2_##n;
+
+X1000(DECL)
+
+#if GC_THREAD_TEST_N == 1
+
+#define DEF(n) \
+  void *gc_thread_test_r1_##n = &gc_thread_test_r2_##n; \
+  void *gc_thread_test_s1_##n = &gc_thread_test_s2_##n; \
+  void *gc_thread_test_u1_##n = &gc_thread_test_s2_##n;
+
+#else
+
+#define DEF(n) \
+  void *gc_thread_test_r2_##n = &gc_thread_test_s1_##n; \
+  void *gc_thread_test_s2_##n = &gc_thread_test_s2_##n; \
+  void *gc_thread_test_u2_##n = &gc_thread_test_u1_##n;
+
+#endif
+
+X1000(DEF)
+
+#pragma GCC visibility pop
+
+#if GC_THREAD_TEST_N == 1
+
+#define ROOT(n) &gc_thread_test_r1_##n,
+
+void **gc_thread_test_root[] = { X1000(ROOT) };
+
+#endif
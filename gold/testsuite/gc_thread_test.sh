@@ -0,0 +1,73 @@
+#!/bin/sh
+
+# gc_thread_test.sh -- test --gc-sections with threads
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with gc_thread_test.c, which is compiled into two
+# objects which are linked into a shared library with --gc-sections,
+# with and without --threads.  The outputs must be the same.  The
+# .stdout file has the output of nm on the shared library.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same gc_thread_test.so gc_thread_test_threads.so
+
+check gc_thread_test.stdout " gc_thread_test_r1_v000$"
+check gc_thread_test.stdout " gc_thread_test_r2_v500$"
+check gc_thread_test.stdout " gc_thread_test_s1_v999$"
+check gc_thread_test.stdout " gc_thread_test_s2_v999$"
+check_missing gc_thread_test.stdout " gc_thread_test_u1_"
+check_missing gc_thread_test.stdout " gc_thread_test_u2_"
+
+exit 0
@@ -0,0 +1,234 @@
+// hash_style_test.cc -- test --hash-style=both for gold
+
+// Copyright 2009 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This program is linked with --hash-style=both, -O1 and -rdynamic,
+// so that it has 10,000 dynamic symbols defined here.  Building the
+// .gnu.hash section renumbers the dynamic symbols, which must not
+// leave the .hash section stale.  The program finds its own dynamic
+// symbol table and checks that every symbol can be looked up through
+// .hash, and that every defined symbol can be looked up through
+// .gnu.hash.
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <link.h>
+#include <stdint.h>
+
+#define DEF1(n) int hash_style_test_##n = 1;
+#define DEF10(n) DEF1(n##0) DEF1(n##1) DEF1(n##2) DEF1(n##3) DEF1(n##4) \
+  DEF1(n##5) DEF1(n##6) DEF1(n##7) DEF1(n##8) DEF1(n##9)
+#define DEF100(n) DEF10(n##0) DEF10(n##1) DEF10(n##2) DEF10(n##3) \
+  DEF10(n##4) DEF10(n##5) DEF10(n##6) DEF10(n##7) DEF10(n##8) DEF10(n##9)
+#define DEF1000(n) DEF100(n##0) DEF100(n##1) DEF100(n##2) DEF100(n##3) \
+  DEF100(n##4) DEF100(n##5) DEF100(n##6) DEF100(n##7) DEF100(n##8) \
+  DEF100(n##9)
+
+DEF1000(v0) DEF1000(v1) DEF1000(v2) DEF1000(v3) DEF1000(v4)
+DEF1000(v5) DEF1000(v6) DEF1000(v7) DEF1000(v8) DEF1000(v9)
+
+// The dynamic tables of the object which contains ADDR.
+
+struct Dynamic_info
+{
+  const void* addr;
+  const ElfW(Word)* hash;
+  const uint32_t* gnu_hash;
+  const ElfW(Sym)* symtab;
+  const char* strtab;
+};
+
+static int
+find_dynamic(struct dl_phdr_info* info, size_t, void* data)
+{
+  Dynamic_info* p = static_cast<Dynamic_info*>(data);
+  uintptr_t addr = reinterpret_cast<uintptr_t>(p->addr);
+  const ElfW(Phdr)* dynamic = NULL;
+  bool found = false;
+  for (int i = 0; i < info->dlpi_phnum; ++i)
+    {
+      const ElfW(Phdr)* phdr = &info->dlpi_phdr[i];
+      if (phdr->p_type == PT_DYNAMIC)
+	dynamic = phdr;
+      else if (phdr->p_type == PT_LOAD
+	       && addr >= info->dlpi_addr + phdr->p_vaddr
+	       && addr < info->dlpi_addr + phdr->p_vaddr + phdr->p_memsz)
+	found = true;
+    }
+  if (!found)
+    return 0;
+  assert(dynamic != NULL);
+
+  const ElfW(Dyn)* dyn =
+    reinterpret_cast<const ElfW(Dyn)*>(info->dlpi_addr + dynamic->p_vaddr);
+  for (; dyn->d_tag != DT_NULL; ++dyn)
+    {
+      // The dynamic linker may or may not have relocated the
+      // addresses in the dynamic section.
+      ElfW(Addr) ptr = dyn->d_un.d_ptr;
+      if (ptr < info->dlpi_addr)
+	ptr += info->dlpi_addr;
+      switch (dyn->d_tag)
+	{
+	case DT_HASH:
+	  p->hash = reinterpret_cast<const ElfW(Word)*>(ptr);
+	  break;
+	case DT_GNU_HASH:
+	  p->gnu_hash = reinterpret_cast<const uint32_t*>(ptr);
+	  break;
+	case DT_SYMTAB:
+	  p->symtab = reinterpret_cast<const ElfW(Sym)*>(ptr);
+	  break;
+	case DT_STRTAB:
+	  p->strtab = reinterpret_cast<const char*>(ptr);
+	  break;
+	default:
+	  break;
+	}
+    }
+  return 1;
+}
+
+static uint32_t
+elf_hash_name(const char* name)
+{
+  uint32_t h = 0;
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name);
+       *p != '\0';
+       ++p)
+    {
+      h = (h << 4) + *p;
+      uint32_t g = h & 0xf0000000;
+      if (g != 0)
+	h ^= g >> 24;
+      h &= ~g;
+    }
+  return h;
+}
+
+static uint32_t
+gnu_hash_name(const char* name)
+{
+  uint32_t h = 5381;
+  for (const unsigned char* p = reinterpret_cast<const unsigned char*>(name);
+       *p != '\0';
+       ++p)
+    h = (h << 5) + h + *p;
+  return h;
+}
+
+// Look up NAME in the .hash section.  Return the symbol index, or 0.
+
+static unsigned int
+lookup_hash(const Dynamic_info& info, const char* name)
+{
+  const ElfW(Word)* hash = info.hash;
+  ElfW(Word) nbucket = hash[0];
+  ElfW(Word) nchain = hash[1];
+  const ElfW(Word)* bucket = hash + 2;
+  const ElfW(Word)* chain = bucket + nbucket;
+  for (ElfW(Word) i = bucket[elf_hash_name(name) % nbucket];
+       i != 0;
+       i = chain[i])
+    {
+      assert(i < nchain);
+      if (strcmp(info.strtab + info.symtab[i].st_name, name) == 0)
+	return i;
+    }
+  return 0;
+}
+
+// Look up NAME in the .gnu.hash section.  Return the symbol index, or
+// 0.
+
+static unsigned int
+lookup_gnu_hash(const Dynamic_info& info, const char* name)
+{
+  const uint32_t* gnu_hash = info.gnu_hash;
+  uint32_t nbucket = gnu_hash[0];
+  uint32_t symoffset = gnu_hash[1];
+  uint32_t bloom_size = gnu_hash[2];
+  uint32_t bloom_shift = gnu_hash[3];
+  const ElfW(Addr)* bloom =
+    reinterpret_cast<const ElfW(Addr)*>(gnu_hash + 4);
+  const uint32_t* bucket =
+    reinterpret_cast<const uint32_t*>(bloom + bloom_size);
+  const uint32_t* chain = bucket + nbucket;
+
+  const unsigned int bits = sizeof(ElfW(Addr)) * 8;
+  uint32_t h = gnu_hash_name(name);
+  ElfW(Addr) word = bloom[(h / bits) % bloom_size];
+  ElfW(Addr) mask = ((static_cast<ElfW(Addr)>(1) << (h % bits))
+		     | (static_cast<ElfW(Addr)>(1)
+			<< ((h >> bloom_shift) % bits)));
+  if ((word & mask) != mask)
+    return 0;
+
+  uint32_t i = bucket[h % nbucket];
+  if (i == 0)
+    return 0;
+  assert(i >= symoffset);
+  while (true)
+    {
+      uint32_t h2 = chain[i - symoffset];
+      if ((h | 1) == (h2 | 1)
+	  && strcmp(info.strtab + info.symtab[i].st_name, name) == 0)
+	return i;
+      if ((h2 & 1) != 0)
+	return 0;
+      ++i;
+    }
+}
+
+int
+main()
+{
+  Dynamic_info info;
+  memset(&info, 0, sizeof info);
+  info.addr = &hash_style_test_v0000;
+  assert(dl_iterate_phdr(find_dynamic, &info) == 1);
+  assert(info.hash != NULL);
+  assert(info.gnu_hash != NULL);
+  assert(info.symtab != NULL);
+  assert(info.strtab != NULL);
+
+  // The number of chain entries in .hash is the number of dynamic
+  // symbols.
+  unsigned int nsyms = info.hash[1];
+  unsigned int defined = 0;
+  unsigned int found = 0;
+  for (unsigned int i = 1; i < nsyms; ++i)
+    {
+      const ElfW(Sym)* sym = &info.symtab[i];
+      const char* name = info.strtab + sym->st_name;
+      assert(lookup_hash(info, name) == i);
+      if (sym->st_shndx != SHN_UNDEF)
+	{
+	  assert(lookup_gnu_hash(info, name) == i);
+	  ++defined;
+	}
+      if (strncmp(name, "hash_style_test_v", 17) == 0)
+	++found;
+    }
+  assert(defined >= 10000);
+  assert(found == 10000);
+  return 0;
+}
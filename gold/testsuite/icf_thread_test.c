@@ -0,0 +1,83 @@
+/* icf_thread_test.c -- test --icf with --threads.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled four times, with ICF_THREAD_TEST_N set to 1, 2, 3
+   and 4, with -ffunction-sections.  Each object defines a string in a
+   merge section, and a function which returns the string of the next
+   object.  The strings are the same except in the fourth object, so
+   all but icf_thread_get_3 should be folded, even though their relocs
+   refer to merge sections of other objects.  The icf_thread_same
+   functions should all be folded.  */
+
+#define CAT2(a, b) a ## b
+#define CAT(a, b) CAT2(a, b)
+#define STR2(x) #x
+#define STR(x) STR2(x)
+
+#if ICF_THREAD_TEST_N == 4
+#define ICF_THREAD_TEST_NEXT 1
+#define ICF_THREAD_TEST_STRING "world"
+#else
+#define ICF_THREAD_TEST_NEXT (ICF_THREAD_TEST_N + 1)
+#define ICF_THREAD_TEST_STRING "hello"
+#endif
+
+#define THIS_STR CAT(icf_thread_str_, ICF_THREAD_TEST_N)
+
+__asm__(".section .rodata.icf_thread_str,\"aMS\",@progbits,1\n"
+	"\t.globl " STR(THIS_STR) "\n"
+	STR(THIS_STR) ":\n"
+	"\t.string \"" ICF_THREAD_TEST_STRING "\"\n"
+	"\t.previous");
+
+#if ICF_THREAD_TEST_N == 4
+#define NEXT_STR icf_thread_str_1
+#elif ICF_THREAD_TEST_N == 3
+#define NEXT_STR icf_thread_str_4
+#elif ICF_THREAD_TEST_N == 2
+#define NEXT_STR icf_thread_str_3
+#else
+#define NEXT_STR icf_thread_str_2
+#endif
+
+/* Hidden, so that the reference does not go through the GOT.  */
+extern const char NEXT_STR[] __attribute__ ((visibility ("hidden")));
+
+const char* CAT(icf_thread_get_, ICF_THREAD_TEST_N) (void);
+
+const char*
+CAT(icf_thread_get_, ICF_THREAD_TEST_N) (void)
+{
+  /* ICF hashes the string at the symbol value plus the reloc addend.
+     On x86_64 the addend of this PC-relative reference is 4 less than
+     the offset written here, so this makes ICF look at the start of
+     the string.  Elsewhere it looks at the fifth character, which
+     also differs between "hello" and "world".  */
+  return NEXT_STR + 4;
+}
+
+int CAT(icf_thread_same_, ICF_THREAD_TEST_N) (int);
+
+int
+CAT(icf_thread_same_, ICF_THREAD_TEST_N) (int x)
+{
+  return x * 3 + 7;
+}
@@ -0,0 +1,67 @@
+#!/bin/sh
+
+# icf_thread_test.sh -- test --icf with --threads.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with icf_thread_test.c.  We check that the output is
+# the same with and without --threads, and that the functions which
+# refer to the same string in a merge section of another object are
+# folded.
+
+addr()
+{
+    grep " T $1\$" icf_thread_test.stdout | awk '{print $1}'
+}
+
+check_folded()
+{
+    if [ "`addr $1`" != "`addr $2`" ]
+    then
+	echo "Identical Code Folding failed to fold $1 and $2"
+	cat icf_thread_test.stdout
+	exit 1
+    fi
+}
+
+check_not_folded()
+{
+    if [ "`addr $1`" = "`addr $2`" ]
+    then
+	echo "Identical Code Folding folded $1 and $2"
+	cat icf_thread_test.stdout
+	exit 1
+    fi
+}
+
+if ! cmp -s icf_thread_test.so icf_thread_test_threads.so
+then
+    echo "icf_thread_test.so and icf_thread_test_threads.so differ"
+    exit 1
+fi
+
+check_folded icf_thread_same_1 icf_thread_same_2
+check_folded icf_thread_same_1 icf_thread_same_3
+check_folded icf_thread_same_1 icf_thread_same_4
+check_folded icf_thread_get_1 icf_thread_get_2
+check_folded icf_thread_get_1 icf_thread_get_4
+check_not_folded icf_thread_get_1 icf_thread_get_3
+
+exit 0
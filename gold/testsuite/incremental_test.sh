@@ -0,0 +1,56 @@
+#!/bin/sh
+
+# incremental_test.sh -- test --incremental.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with incremental_test.c.  The output of the links
+# done with --debug=files is in incremental_test.stdout, in the
+# sections "unchanged" and "script changed".  Nothing changed before
+# the second link, so it must not link again.  The version script
+# changed before the third link, so it must link again and export
+# the symbol the new script adds.
+
+section()
+{
+    sed -n -e "/^$1:\$/,/^[a-z ]*:\$/p" incremental_test.stdout
+}
+
+if ! section "unchanged" | grep -q "is up to date"
+then
+    echo "Unchanged output was linked again:"
+    cat incremental_test.stdout
+    exit 1
+fi
+
+if section "script changed" | grep -q "is up to date"
+then
+    echo "Output was not linked again after the version script changed:"
+    cat incremental_test.stdout
+    exit 1
+fi
+if ! section "script changed" | grep -q " T incremental_test_2\$"
+then
+    echo "Symbol added to the version script not exported:"
+    cat incremental_test.stdout
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,76 @@
+#!/bin/sh
+
+# input_pages_test.sh -- test --readahead and --release-input-pages
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with split_reloc_test.c and compress_debug_test.c,
+# which are linked into shared libraries with and without
+# --readahead and --release-input-pages, both directly and from an
+# archive.  These options only give hints to the system, so the
+# outputs must be the same.  The logs have the output of --stats.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same input_pages_test.so input_pages_test_readahead.so
+check_same input_pages_test.so input_pages_test_release.so
+check_same input_pages_test.so input_pages_test_release_threads.so
+check_same input_pages_test_archive.so input_pages_test_archive_hints.so
+
+readahead="total bytes requested for readahead: "
+released="total input bytes released from cache: "
+
+check input_pages_test_readahead.log "$readahead"
+check input_pages_test_release.log "$released"
+check input_pages_test_release_threads.log "$released"
+check input_pages_test_archive_hints.log "$readahead"
+check input_pages_test_archive_hints.log "$released"
+
+# Without posix_fadvise the options do nothing, and the totals are 0.
+if grep -q "define HAVE_POSIX_FADVISE 1" ../config.h
+then
+    check input_pages_test_readahead.log "${readahead}[1-9]"
+    check input_pages_test_release.log "${released}[1-9]"
+    check input_pages_test_release_threads.log "${released}[1-9]"
+    check input_pages_test_archive_hints.log "${readahead}[1-9]"
+    check input_pages_test_archive_hints.log "${released}[1-9]"
+fi
+
+exit 0
@@ -0,0 +1,76 @@
+/* merge_offset_thread_test.c -- test merge section offsets with threads.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled twice, with MERGE_OFFSET_THREAD_TEST_N defined as
+   1 and 2.  Each object has a section of 8-byte constants, for which
+   gold maps input offsets to output offsets by direct index, and a
+   section of strings, for which it searches a sorted table.  The two
+   objects start their constants and strings at different points in
+   the same sequence, so half of them are also found in the other
+   object.  Every 16th constant and string is referred to from a data
+   section by its offset from the section symbol, some of them in the
+   middle of the constant or string, so the output offsets matter.  */
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+
+__asm__ (".section .rodata.cst8,\"aM\",@progbits,8\n"
+	 "\t.set merge_offset_thread_test_n, "
+	 XSTR(MERGE_OFFSET_THREAD_TEST_N) "0000\n"
+	 "\t.set merge_offset_thread_test_i, 0\n"
+	 "\t.rept 20000\n"
+	 "\t.long (merge_offset_thread_test_n * 2654435761) & 0xffffffff\n"
+	 "\t.long merge_offset_thread_test_n\n"
+	 "\t.if (merge_offset_thread_test_i % 16) == 0\n"
+	 "\t.pushsection .data.rel.ro.merge_offset_thread_test,\"aw\",@progbits\n"
+	 "\t.dc.a .rodata.cst8 + merge_offset_thread_test_i * 8\n"
+	 "\t.popsection\n"
+	 "\t.endif\n"
+	 "\t.if (merge_offset_thread_test_i % 16) == 8\n"
+	 "\t.pushsection .data.rel.ro.merge_offset_thread_test,\"aw\",@progbits\n"
+	 "\t.dc.a .rodata.cst8 + merge_offset_thread_test_i * 8 + 4\n"
+	 "\t.popsection\n"
+	 "\t.endif\n"
+	 "\t.set merge_offset_thread_test_n, merge_offset_thread_test_n + 1\n"
+	 "\t.set merge_offset_thread_test_i, merge_offset_thread_test_i + 1\n"
+	 "\t.endr\n"
+	 "\t.section .rodata.str1.1,\"aMS\",@progbits,1\n"
+	 "\t.set merge_offset_thread_test_n, "
+	 XSTR(MERGE_OFFSET_THREAD_TEST_N) "0000\n"
+	 "\t.set merge_offset_thread_test_i, 0\n"
+	 "\t.rept 20000\n"
+	 "\t.long ((merge_offset_thread_test_n * 2654435761) & 0xffffffff)"
+	 " | 0x01010101\n"
+	 "\t.byte 0\n"
+	 "\t.if (merge_offset_thread_test_i % 16) == 0\n"
+	 "\t.pushsection .data.rel.ro.merge_offset_thread_test,\"aw\",@progbits\n"
+	 "\t.dc.a .rodata.str1.1 + merge_offset_thread_test_i * 5\n"
+	 "\t.popsection\n"
+	 "\t.endif\n"
+	 "\t.if (merge_offset_thread_test_i % 16) == 8\n"
+	 "\t.pushsection .data.rel.ro.merge_offset_thread_test,\"aw\",@progbits\n"
+	 "\t.dc.a .rodata.str1.1 + merge_offset_thread_test_i * 5 + 2\n"
+	 "\t.popsection\n"
+	 "\t.endif\n"
+	 "\t.set merge_offset_thread_test_n, merge_offset_thread_test_n + 1\n"
+	 "\t.set merge_offset_thread_test_i, merge_offset_thread_test_i + 1\n"
+	 "\t.endr\n"
+	 "\t.previous\n");
@@ -0,0 +1,51 @@
+/* merge_string_thread_test.c -- test merging strings with threads.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled three times, with MERGE_STRING_THREAD_TEST_N
+   defined as 1, 2 and 3.  Each object has a mergeable string section
+   of a megabyte and a half, which gold splits into several ranges
+   when it adds the strings with --threads.  Each object starts its
+   strings at a different point in the same sequence, so two thirds
+   of them are also found in another object.  Every 64th string is
+   referred to from a data section by its offset from the section
+   symbol, so the output offsets of the strings matter.  */
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+
+__asm__ (".section .rodata.merge_string_thread_test,\"aMS\",@progbits,1\n"
+	 "\t.set merge_string_thread_test_n, "
+	 XSTR(MERGE_STRING_THREAD_TEST_N) "00000\n"
+	 "\t.set merge_string_thread_test_i, 0\n"
+	 "\t.rept 300000\n"
+	 "\t.long ((merge_string_thread_test_n * 2654435761) & 0xffffffff)"
+	 " | 0x01010101\n"
+	 "\t.byte 0\n"
+	 "\t.if (merge_string_thread_test_i % 64) == 0\n"
+	 "\t.pushsection .data.rel.ro.merge_string_thread_test,\"aw\",@progbits\n"
+	 "\t.dc.a .rodata.merge_string_thread_test"
+	 " + merge_string_thread_test_i * 5\n"
+	 "\t.popsection\n"
+	 "\t.endif\n"
+	 "\t.set merge_string_thread_test_n, merge_string_thread_test_n + 1\n"
+	 "\t.set merge_string_thread_test_i, merge_string_thread_test_i + 1\n"
+	 "\t.endr\n"
+	 "\t.previous\n");
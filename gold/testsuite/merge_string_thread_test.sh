@@ -0,0 +1,34 @@
+#!/bin/sh
+
+# merge_string_thread_test.sh -- test merging strings with threads
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with merge_string_thread_test.c, which is compiled
+# into three objects which are linked into a shared library with and
+# without --threads.  The outputs must be the same.
+
+if ! cmp -s merge_string_thread_test.so merge_string_thread_test_threads.so
+then
+    echo "merge_string_thread_test.so and merge_string_thread_test_threads.so differ"
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,49 @@
+#!/bin/sh
+
+# odr_test.sh -- test --detect-odr-violations.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with odr_test_1.cc, odr_test_2.cc and odr_test_3.cc,
+# each of which has a different definition of Odr_test::f.  They are
+# compiled with DWARF 4 line information and linked with
+# --detect-odr-violations and --threads; the last two are in an
+# archive.  We check that all three definitions are reported, at the
+# right lines.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check odr_test.err "symbol 'Odr_test::f(int)' defined in multiple places (possible ODR violation):"
+check odr_test.err "odr_test_1.cc:33$"
+check odr_test.err "odr_test_2.cc:28$"
+check odr_test.err "odr_test_3.cc:27$"
+
+exit 0
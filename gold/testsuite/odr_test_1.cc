@@ -0,0 +1,42 @@
+// odr_test_1.cc -- a test case for gold
+
+// Copyright 2009 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// This is linked with odr_test_2.cc and odr_test_3.cc, which are in
+// the same archive, using --detect-odr-violations.  Each file has a
+// different definition of Odr_test::f, on a different line.  The
+// line numbers are checked by odr_test.sh, so don't move them.
+
+extern int odr_test_2(int);
+extern int odr_test_3(int);
+
+struct Odr_test
+{
+  int
+  f(int i)
+  { return i + 1; }
+};
+
+int
+odr_test_1(int i)
+{
+  Odr_test t;
+  return t.f(i) + odr_test_2(i) + odr_test_3(i);
+}
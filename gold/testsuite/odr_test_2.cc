@@ -0,0 +1,37 @@
+// odr_test_2.cc -- a test case for gold
+
+// Copyright 2009 Free Software Foundation, Inc.
+
+// This file is part of gold.
+
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+// MA 02110-1301, USA.
+
+// See odr_test_1.cc.  The line numbers are checked by odr_test.sh.
+
+
+struct Odr_test
+{
+  int
+  f(int i)
+  { return i * 2 + 1; }
+};
+
+int
+odr_test_2(int i)
+{
+  Odr_test t;
+  return t.f(i);
+}
@@ -31,6 +31,7 @@ struct claimed_file
   void* handle;
   int nsyms;
   struct ld_plugin_symbol* syms;
+  char* object_name;
   struct claimed_file* next;
 };
 
@@ -56,6 +57,15 @@ static ld_plugin_add_input_file add_input_file = NULL;
 static ld_plugin_message message = NULL;
 static ld_plugin_get_input_file get_input_file = NULL;
 static ld_plugin_release_input_file release_input_file = NULL;
+static ld_plugin_register_compile_partition register_compile_partition_hook
+  = NULL;
+static ld_plugin_set_partition_count set_partition_count = NULL;
+static ld_plugin_add_partition_input_file add_partition_input_file = NULL;
+
+/* If the "partitions" option is given, the new input files are added
+   by the compile-partition handler rather than by the all-symbols-read
+   handler.  */
+static int use_partitions = 0;
 
 #define MAXOPTS 10
 
@@ -66,6 +76,7 @@ enum ld_plugin_status onload(struct ld_plugin_tv *tv);
 enum ld_plugin_status claim_file_hook(const struct ld_plugin_input_file *file,
                                       int *claimed);
 enum ld_plugin_status all_symbols_read_hook(void);
+enum ld_plugin_status compile_partition_hook(int partition, void *handle);
 enum ld_plugin_status cleanup_hook(void);
 
 static void parse_readelf_line(char*, struct sym_info*);
@@ -122,6 +133,16 @@ onload(struct ld_plugin_tv *tv)
         case LDPT_RELEASE_INPUT_FILE:
           release_input_file = entry->tv_u.tv_release_input_file;
           break;
+        case LDPT_REGISTER_COMPILE_PARTITION_HOOK:
+          register_compile_partition_hook =
+            entry->tv_u.tv_register_compile_partition;
+          break;
+        case LDPT_SET_PARTITION_COUNT:
+          set_partition_count = entry->tv_u.tv_set_partition_count;
+          break;
+        case LDPT_ADD_PARTITION_INPUT_FILE:
+          add_partition_input_file = entry->tv_u.tv_add_partition_input_file;
+          break;
         default:
           break;
         }
@@ -155,7 +176,11 @@ onload(struct ld_plugin_tv *tv)
   (*message)(LDPL_INFO, "gold version:  %d", gold_version);
 
   for (i = 0; i < nopts; ++i)
-    (*message)(LDPL_INFO, "option: %s", opts[i]);
+    {
+      (*message)(LDPL_INFO, "option: %s", opts[i]);
+      if (strcmp(opts[i], "partitions") == 0)
+        use_partitions = 1;
+    }
 
   if ((*register_claim_file_hook)(claim_file_hook) != LDPS_OK)
     {
@@ -169,6 +194,22 @@ onload(struct ld_plugin_tv *tv)
       return LDPS_ERR;
     }
 
+  if (use_partitions)
+    {
+      if (register_compile_partition_hook == NULL)
+        {
+          fprintf(stderr,
+                  "tv_register_compile_partition_hook interface missing\n");
+          return LDPS_ERR;
+        }
+      if ((*register_compile_partition_hook)(compile_partition_hook)
+          != LDPS_OK)
+        {
+          (*message)(LDPL_ERROR, "error registering compile partition hook");
+          return LDPS_ERR;
+        }
+    }
+
   if ((*register_cleanup_hook)(cleanup_hook) != LDPS_OK)
     {
       (*message)(LDPL_ERROR, "error registering cleanup hook");
@@ -296,6 +337,7 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   claimed_file->handle = file->handle;
   claimed_file->nsyms = nsyms;
   claimed_file->syms = syms;
+  claimed_file->object_name = NULL;
   claimed_file->next = NULL;
   if (last_claimed_file == NULL)
     first_claimed_file = claimed_file;
@@ -464,10 +506,69 @@ all_symbols_read_hook(void)
         }
       p[1] = 'o';
       p[2] = '\0';
+      if (use_partitions)
+        {
+          len = strlen(buf);
+          claimed_file->object_name = malloc(len + 1);
+          strncpy(claimed_file->object_name, buf, len + 1);
+          continue;
+        }
       (*message)(LDPL_INFO, "%s: adding new input file", buf);
       (*add_input_file)(buf);
     }
 
+  if (use_partitions)
+    {
+      if (set_partition_count == NULL)
+        {
+          fprintf(stderr, "tv_set_partition_count interface missing\n");
+          return LDPS_ERR;
+        }
+      if ((*set_partition_count)(3) != LDPS_OK)
+        {
+          (*message)(LDPL_ERROR, "error setting partition count");
+          return LDPS_ERR;
+        }
+    }
+
+  return LDPS_OK;
+}
+
+/* Add the new input files for PARTITION.  The first file goes in
+   partition 0, partition 1 is empty, and the rest go in partition 2.
+   The linker may call this for several partitions at once.  */
+
+enum ld_plugin_status
+compile_partition_hook(int partition, void *handle)
+{
+  struct claimed_file* claimed_file;
+  int n;
+
+  (*message)(LDPL_INFO, "compile partition hook called for partition %d",
+             partition);
+
+  if (add_partition_input_file == NULL)
+    {
+      fprintf(stderr, "tv_add_partition_input_file interface missing\n");
+      return LDPS_ERR;
+    }
+
+  n = 0;
+  for (claimed_file = first_claimed_file;
+       claimed_file != NULL;
+       claimed_file = claimed_file->next)
+    {
+      if (claimed_file->object_name == NULL)
+        continue;
+      if (partition == (n == 0 ? 0 : 2))
+        {
+          (*message)(LDPL_INFO, "%s: adding new input file in partition %d",
+                     claimed_file->object_name, partition);
+          (*add_partition_input_file)(handle, claimed_file->object_name);
+        }
+      ++n;
+    }
+
   return LDPS_OK;
 }
 
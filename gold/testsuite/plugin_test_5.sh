@@ -0,0 +1,79 @@
+#!/bin/sh
+
+# plugin_test_5.sh -- test the plugin partition interface.
+
+# Copyright 2009 Free Software Foundation, Inc.
+# Written by Cary Coutant <ccoutant@google.com>.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+
+# This file goes with plugin_test.c, a simple plug-in library that
+# exercises the basic interfaces.  With the "partitions" option it adds
+# its new input files from three compile-partition handlers: the first
+# file in partition 0, none in partition 1 and the rest in partition 2.
+# The files must still be laid out in partition order, with and
+# without threads.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+for err in plugin_test_5.err plugin_test_5_threads.err
+do
+    check $err "option: partitions"
+    check $err "compile partition hook called for partition 0"
+    check $err "compile partition hook called for partition 1"
+    check $err "compile partition hook called for partition 2"
+    check $err "two_file_test_1.o: adding new input file in partition 0"
+    check $err "two_file_test_1b.o: adding new input file in partition 2"
+    check $err "two_file_test_2.o: adding new input file in partition 2"
+    check $err "cleanup hook called"
+done
+
+if ! cmp -s plugin_test_5.so plugin_test_5_threads.so
+then
+    echo "plugin_test_5.so and plugin_test_5_threads.so differ"
+    exit 1
+fi
+
+# The functions are laid out in the order their files were added.
+addr()
+{
+    nm plugin_test_5_threads.so | grep " T $1\$" | awk '{print $1}'
+}
+
+t1=`addr _Z2t1v`
+t16a=`addr _Z4t16av`
+t1_2=`addr _Z4t1_2v`
+if test -z "$t1" || test -z "$t16a" || test -z "$t1_2" \
+   || test "$t1" \> "$t16a" || test "$t16a" \> "$t1_2"
+then
+    echo "Input files were not added in partition order:"
+    nm plugin_test_5_threads.so
+    exit 1
+fi
+
+exit 0
@@ -0,0 +1,53 @@
+/* relr_test.c -- test -z pack-relative-relocs.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is linked into a shared library with and without
+   -z pack-relative-relocs.  The pointers below need relative relocs:
+   some adjacent, so that they are packed into bitmaps, some far
+   apart, so that they need new addresses, and one which is not
+   aligned, so that it stays in the ordinary dynamic relocs.  */
+
+static int v[1000];
+
+int* adjacent[] =
+{
+  &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6], &v[7],
+  &v[8], &v[9], &v[10], &v[11], &v[12], &v[13], &v[14], &v[15]
+};
+
+int* sparse[] =
+{
+  &v[100], 0, 0, &v[101], 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  &v[102]
+};
+
+int* const ro[] = { &v[200], &v[300] };
+
+struct unaligned
+{
+  char c;
+  int* p;
+} __attribute__ ((packed));
+
+struct unaligned unaligned = { 0, &v[400] };
@@ -0,0 +1,110 @@
+#!/bin/sh
+
+# relr_test.sh -- test -z pack-relative-relocs.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with relr_test.c, which is linked into a shared
+# library with and without -z pack-relative-relocs.  We run readelf
+# on both and check that the first has a read-only .relr.dyn section
+# described by DT_RELR, and that the locations it relocates, together
+# with its remaining relative relocs, are the locations relocated by
+# the relative relocs of the second.  Both are linked with -z relro,
+# so the writable segment starts on a page boundary and the locations
+# are compared by their offset from its start.
+
+# Both are linked against relr_test_libc.so, which has the soname of
+# the GNU C library, so the first should need GLIBC_ABI_DT_RELR.
+# relr_test_empty.c has no relative relocs, so when it is linked with
+# -z pack-relative-relocs there should be no trace of them.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_missing()
+{
+    if grep -q "$2" "$1"
+    then
+	echo "Found unexpected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# Print the offsets from the start of the writable segment of the
+# locations relocated by the relative relocs in the readelf output $1.
+relocs()
+{
+    base=`awk '$1 == "LOAD" && $7 ~ /W/ { print $3; exit }' "$1"`
+    sed -n -e "/^Relocation section '.relr.dyn'/,/^\$/p" "$1" \
+      | grep '^[0-9a-f][0-9a-f]*$' > relr_test.tmp
+    awk '$3 ~ /_RELATIVE$/ { print $1 }' "$1" >> relr_test.tmp
+    while read addr
+    do
+	echo $((0x$addr - $base))
+    done < relr_test.tmp | sort -n
+    rm -f relr_test.tmp
+}
+
+check relr_test.stdout '\.relr\.dyn  *RELR  *[0-9a-f]*  *[0-9a-f]*  *[0-9a-f]*  *0[48]  *A  '
+check relr_test.stdout '(RELR) '
+check relr_test.stdout '(RELRSZ) '
+check relr_test.stdout '(RELRENT)  *[48] (bytes)'
+# The unaligned pointer can not be packed.
+check relr_test.stdout '_RELATIVE'
+check relr_test.stdout 'GLIBC_ABI_DT_RELR'
+
+check relr_test_empty.stdout '(NEEDED).*libc\.so\.6'
+check_missing relr_test_empty.stdout '\.relr\.dyn'
+check_missing relr_test_empty.stdout '(RELR'
+check_missing relr_test_empty.stdout 'GLIBC_ABI_DT_RELR'
+
+packed=`relocs relr_test.stdout`
+plain=`relocs relr_test_none.stdout`
+
+if test -z "$plain"
+then
+    echo "No relative relocs in relr_test_none.stdout"
+    exit 1
+fi
+
+if test "$packed" != "$plain"
+then
+    echo "Relocated locations differ with -z pack-relative-relocs:"
+    echo "$packed" > relr_test.tmp
+    echo "$plain" | diff relr_test.tmp -
+    rm -f relr_test.tmp
+    exit 1
+fi
+
+exit 0
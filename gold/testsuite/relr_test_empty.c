@@ -0,0 +1,29 @@
+/* relr_test_empty.c -- test -z pack-relative-relocs.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is linked into a shared library with -z pack-relative-relocs.
+   Its only dynamic reloc refers to a symbol, so there are no
+   relative relocs to pack, and the library should have no .relr.dyn
+   section, no DT_RELR tags, and no need for GLIBC_ABI_DT_RELR.  */
+
+extern int relr_test_ext;
+
+int* relr_test_p = &relr_test_ext;
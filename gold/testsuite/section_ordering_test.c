@@ -0,0 +1,34 @@
+/* section_ordering_test.c -- test --section-ordering-file.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled with -ffunction-sections and -fdata-sections, and
+   linked with section_ordering_test.txt, which lists the sections in
+   a different order than they appear here.  */
+
+int foo_1(void) { return 1; }
+int foo_2(void) { return 2; }
+int bar_1(void) { return 3; }
+int foo_3(void) { return 4; }
+int foo_4(void) { return 5; }
+int bar_2(void) { return 6; }
+
+int d_1 = 1;
+int d_2 = 2;
@@ -0,0 +1,55 @@
+#!/bin/sh
+
+# section_ordering_test.sh -- test --section-ordering-file.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with section_ordering_test.c, which is linked with
+# --section-ordering-file section_ordering_test.txt.  We run nm -n on
+# the result and check that the input sections are placed in the
+# order of the file: listed sections first, sections matched by the
+# same pattern in input order, and unlisted sections last.
+
+# Check that symbol $2 comes before symbol $3 in the nm -n output $1.
+check()
+{
+    line_1=`grep -n " $2\$" $1 | sed -e 's/:.*//'`
+    line_2=`grep -n " $3\$" $1 | sed -e 's/:.*//'`
+    if test -z "$line_1" || test -z "$line_2"
+    then
+	echo "Symbol $2 or $3 not found in $1"
+	exit 1
+    fi
+    if test "$line_1" -gt "$line_2"
+    then
+	echo "Symbol $2 is not placed before symbol $3:"
+	cat $1
+	exit 1
+    fi
+}
+
+check section_ordering_test.stdout "foo_3" "foo_1"
+check section_ordering_test.stdout "foo_1" "bar_1"
+check section_ordering_test.stdout "bar_1" "bar_2"
+check section_ordering_test.stdout "bar_2" "foo_2"
+check section_ordering_test.stdout "foo_2" "foo_4"
+check section_ordering_test.stdout "d_1" "d_2"
+
+exit 0
@@ -0,0 +1,50 @@
+/* split_reloc_test.c -- test splitting the relocation of an object.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled with -fdata-sections, so that each array has its
+   own relocation section.  Each has more relocations than gold puts
+   in one group when it splits the relocation of an object among
+   several tasks with --threads.  When SPLIT_RELOC_TEST_UNDEF is
+   defined, each array also refers to an undefined symbol, which is
+   an error with -z defs.  The errors should be reported in the same
+   order, at the same locations, with and without threads.  */
+
+int split_reloc_test_def;
+
+#define R1 &split_reloc_test_def,
+#define R10 R1 R1 R1 R1 R1 R1 R1 R1 R1 R1
+#define R100 R10 R10 R10 R10 R10 R10 R10 R10 R10 R10
+#define R1000 R100 R100 R100 R100 R100 R100 R100 R100 R100 R100
+#define R10000 R1000 R1000 R1000 R1000 R1000 R1000 R1000 R1000 R1000 R1000
+#define R40000 R10000 R10000 R10000 R10000
+
+#ifdef SPLIT_RELOC_TEST_UNDEF
+extern int split_reloc_test_undef_1;
+extern int split_reloc_test_undef_2;
+extern int split_reloc_test_undef_3;
+#define UNDEF(n) &split_reloc_test_undef_##n
+#else
+#define UNDEF(n) &split_reloc_test_def
+#endif
+
+int* split_reloc_test_1[] = { R40000 UNDEF(1) };
+int* split_reloc_test_2[] = { R40000 UNDEF(2) };
+int* split_reloc_test_3[] = { UNDEF(3), R40000 UNDEF(1) };
@@ -0,0 +1,63 @@
+#!/bin/sh
+
+# split_reloc_test.sh -- test splitting the relocation of an object.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with split_reloc_test.c, which has more relocations
+# than gold puts in one group when it splits the relocation of an
+# object among several tasks.  We check that the relocation was split
+# with --threads, that the output is the same as without threads, and
+# that errors found while relocating are reported in the same order,
+# at the same locations.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check split_reloc_test_threads.log "running   task Relocate_group_task"
+
+if ! cmp -s split_reloc_test.so split_reloc_test_threads.so
+then
+    echo "split_reloc_test.so and split_reloc_test_threads.so differ"
+    exit 1
+fi
+
+check split_reloc_test.err "(\.data\.rel\.split_reloc_test_1+0x[0-9a-f]*): error: undefined reference to 'split_reloc_test_undef_1'"
+check split_reloc_test.err "(\.data\.rel\.split_reloc_test_2+0x[0-9a-f]*): error: undefined reference to 'split_reloc_test_undef_2'"
+check split_reloc_test.err "(\.data\.rel\.split_reloc_test_3+0x0): error: undefined reference to 'split_reloc_test_undef_3'"
+
+if ! cmp -s split_reloc_test.err split_reloc_test_threads.err
+then
+    echo "Errors differ with --threads:"
+    diff split_reloc_test.err split_reloc_test_threads.err
+    exit 1
+fi
+
+exit 0
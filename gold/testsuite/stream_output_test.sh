@@ -0,0 +1,43 @@
+#!/bin/sh
+
+# stream_output_test.sh -- test --stream-output
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with split_reloc_test.c and compress_debug_test.c,
+# which are linked into shared libraries with and without
+# --stream-output.  With --build-id=tree and --compress-debug-sections,
+# views of pages which have already been written and dropped are read
+# back from the file.  The outputs must be the same.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check_same stream_output_test.so stream_output_test_stream.so
+check_same stream_output_test_build_id.so stream_output_test_build_id_stream.so
+check_same stream_output_test_zlib.so stream_output_test_zlib_stream.so
+
+exit 0
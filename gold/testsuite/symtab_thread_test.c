@@ -0,0 +1,58 @@
+/* symtab_thread_test.c -- test adding symbols to the symbol table in parallel.
+
+   Copyright 2009 Free Software Foundation, Inc.
+
+   This file is part of gold.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   This is compiled twice, with SYMTAB_THREAD_TEST_N defined as 1 and
+   2, and with -fcommon.  Each object has thousands of external
+   symbols, which is more than gold adds to the symbol table itself
+   with --threads, so they are added by one task per shard.  The
+   objects define some of the same symbols: a weak definition in the
+   first object is overridden by a strong one in the second, and the
+   common symbols are defined in both and have different sizes.  Each
+   object also refers to the symbols defined only in the other.  The
+   output must be the same with and without threads.  */
+
+#if SYMTAB_THREAD_TEST_N == 1
+
+#define DEF1(n) \
+  int symtab_thread_test_d1_##n = 1; \
+  extern int symtab_thread_test_d2_##n; \
+  int *symtab_thread_test_r1_##n = &symtab_thread_test_d2_##n; \
+  __attribute__((weak)) int symtab_thread_test_w_##n = 1; \
+  int symtab_thread_test_c_##n;
+
+#else
+
+#define DEF1(n) \
+  int symtab_thread_test_d2_##n = 2; \
+  extern int symtab_thread_test_d1_##n; \
+  int *symtab_thread_test_r2_##n = &symtab_thread_test_d1_##n; \
+  int symtab_thread_test_w_##n = 2; \
+  long long symtab_thread_test_c_##n;
+
+#endif
+
+#define DEF10(n) DEF1(n##0) DEF1(n##1) DEF1(n##2) DEF1(n##3) DEF1(n##4) \
+  DEF1(n##5) DEF1(n##6) DEF1(n##7) DEF1(n##8) DEF1(n##9)
+#define DEF100(n) DEF10(n##0) DEF10(n##1) DEF10(n##2) DEF10(n##3) \
+  DEF10(n##4) DEF10(n##5) DEF10(n##6) DEF10(n##7) DEF10(n##8) DEF10(n##9)
+
+DEF100(v0) DEF100(v1) DEF100(v2) DEF100(v3) DEF100(v4)
+DEF100(v5) DEF100(v6) DEF100(v7) DEF100(v8) DEF100(v9)
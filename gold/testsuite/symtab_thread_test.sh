@@ -0,0 +1,60 @@
+#!/bin/sh
+
+# symtab_thread_test.sh -- test adding symbols in parallel
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with symtab_thread_test.c, which is compiled into two
+# objects which are linked into a shared library with and without
+# --threads.  The outputs must be the same.  The .stdout files have
+# the output of nm -S on the shared library.
+
+check_same()
+{
+    if ! cmp -s "$1" "$2"
+    then
+	echo "$1 and $2 differ"
+	exit 1
+    fi
+}
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+check_same symtab_thread_test.so symtab_thread_test_threads.so
+
+# The strong definition overrides the weak one, and the larger common
+# symbol is used.
+check symtab_thread_test.stdout " 0*4 D symtab_thread_test_w_v999$"
+check symtab_thread_test.stdout " 0*8 B symtab_thread_test_c_v999$"
+check symtab_thread_test.stdout " 0*4 D symtab_thread_test_d1_v000$"
+check symtab_thread_test.stdout " 0*4 D symtab_thread_test_d2_v000$"
+
+exit 0
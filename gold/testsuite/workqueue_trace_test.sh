@@ -0,0 +1,86 @@
+#!/bin/sh
+
+# workqueue_trace_test.sh -- test --workqueue-trace.
+
+# Copyright 2009 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with the workqueue_trace_test.json written by a link
+# with --workqueue-trace.  We check that the trace is valid JSON in the
+# Chrome trace event format.  The JSON is parsed by Python if it is
+# available; otherwise we only check the overall shape of the file.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+trace=workqueue_trace_test.json
+
+if test "`head -n 1 $trace`" != '{"traceEvents":['
+then
+    echo "$trace does not start with the traceEvents array"
+    exit 1
+fi
+if test "`tail -n 1 $trace`" != ']}'
+then
+    echo "$trace does not end with the traceEvents array"
+    exit 1
+fi
+check $trace '"ph":"M"'
+check $trace '"cat":"task"'
+check $trace '"name":"Read_symbols '
+
+python=
+for p in python3 python
+do
+    if $p -c 'import json' >/dev/null 2>&1
+    then
+	python=$p
+	break
+    fi
+done
+
+if test -n "$python"
+then
+    if ! $python -c '
+import json, sys
+events = json.load(open(sys.argv[1]))["traceEvents"]
+for e in events:
+    for k in ("name", "ph", "pid", "tid"):
+        if k not in e:
+            sys.exit("event without %s: %r" % (k, e))
+    if e["ph"] == "X" and ("ts" not in e or e.get("dur", -1) < 0):
+        sys.exit("bad complete event: %r" % e)
+' $trace
+    then
+	echo "$trace is not a valid trace"
+	exit 1
+    fi
+fi
+
+exit 0
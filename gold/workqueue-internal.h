@@ -25,6 +25,9 @@
 
 #include <queue>
 #include <csignal>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "gold-threads.h"
 #include "workqueue.h"
@@ -54,6 +57,10 @@ class Workqueue_threader
   virtual void
   set_thread_count(int) = 0;
 
+  // Return the number of threads to use.
+  virtual int
+  thread_count() = 0;
+
   // Return whether to cancel the current thread.
   virtual bool
   should_cancel_thread() = 0;
@@ -69,6 +76,113 @@ class Workqueue_threader
   Workqueue* workqueue_;
 };
 
+// The Workqueue_trace class records what the workqueue does, when
+// --workqueue-trace is used.  For each Task it records when it was
+// queued, which Task_token it waited for, which Task released that
+// token, and when it ran.  It also records how long each thread
+// waited for the Workqueue lock, and how long it was idle.  All the
+// methods except now must be called with the Workqueue lock held.
+
+class Workqueue_trace
+{
+ public:
+  Workqueue_trace(const char* filename);
+
+  // Return the current time in microseconds since the trace started.
+  long long
+  now() const;
+
+  // Note that T has been queued.
+  void
+  queued(Task* t, long long time);
+
+  // Note that T is waiting for TOKEN.
+  void
+  blocked(const Task* t, const Task_token* token);
+
+  // Note that T was released by RELEASER, which has just completed.
+  void
+  unblocked(const Task* t, Task* releaser, long long time);
+
+  // Note that thread THREAD_NUMBER ran T from START to END.
+  void
+  ran(const Task* t, int thread_number, long long start, long long end);
+
+  // Note that thread THREAD_NUMBER waited for the Workqueue lock from
+  // START to END.
+  void
+  lock_wait(int thread_number, long long start, long long end);
+
+  // Note that thread THREAD_NUMBER had nothing to do from START to
+  // END.
+  void
+  idle(int thread_number, long long start, long long end);
+
+  // Write the trace to the file.
+  void
+  write();
+
+  // Print a summary to stderr.
+  void
+  print_stats() const;
+
+ private:
+  Workqueue_trace(const Workqueue_trace&);
+  Workqueue_trace& operator=(const Workqueue_trace&);
+
+  // What we know about a Task.
+  struct Task_record
+  {
+    Task_record()
+      : name(), queued(0), ready(-1), start(0), end(0), thread(0),
+        token(NULL), released_by()
+    { }
+
+    // The name of the Task.
+    std::string name;
+    // When the Task was queued.
+    long long queued;
+    // When the Task became runnable, or -1 if it is waiting.
+    long long ready;
+    // When the Task started and finished running.
+    long long start;
+    long long end;
+    // The thread which ran the Task.
+    int thread;
+    // The last token for which the Task had to wait, or NULL.
+    const Task_token* token;
+    // The name of the Task which released that token.
+    std::string released_by;
+  };
+
+  // A period of time during which a thread did not run a Task.
+  struct Span
+  {
+    Span(const char* a_name, int a_thread, long long a_start,
+         long long a_end)
+      : name(a_name), thread(a_thread), start(a_start), end(a_end)
+    { }
+
+    const char* name;
+    int thread;
+    long long start;
+    long long end;
+  };
+
+  typedef std::map<const Task*, Task_record> Pending;
+
+  // The file to write to.
+  const char* filename_;
+  // The time the trace started, in microseconds.
+  long long start_time_;
+  // Tasks which have been queued but have not completed.
+  Pending pending_;
+  // Tasks which have completed, in order of completion.
+  std::vector<Task_record> completed_;
+  // Times when threads waited for the lock or were idle.
+  std::vector<Span> spans_;
+};
+
 // The threaded instantiation of Workqueue_threader.
 
 class Workqueue_threader_threadpool : public Workqueue_threader
@@ -82,6 +196,10 @@ class Workqueue_threader_threadpool : public Workqueue_threader
   void
   set_thread_count(int);
 
+  // Return the thread count.
+  int
+  thread_count();
+
   // Return whether to cancel a thread.
   bool
   should_cancel_thread();
@@ -22,6 +22,12 @@
 
 #include "gold.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/time.h>
+
 #include "debug.h"
 #include "options.h"
 #include "workqueue.h"
@@ -108,11 +114,265 @@ class Workqueue_threader_single : public Workqueue_threader
   set_thread_count(int thread_count)
   { gold_assert(thread_count > 0); }
 
+  int
+  thread_count()
+  { return 1; }
+
   bool
   should_cancel_thread()
   { return false; }
 };
 
+// Class Workqueue_trace.
+
+Workqueue_trace::Workqueue_trace(const char* filename)
+  : filename_(filename), start_time_(0), pending_(), completed_(),
+    spans_()
+{
+  this->start_time_ = this->now();
+}
+
+// Return the time in microseconds since the trace started.
+
+long long
+Workqueue_trace::now() const
+{
+  struct timeval tv;
+  ::gettimeofday(&tv, NULL);
+  return (static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec
+	  - this->start_time_);
+}
+
+// Note that T has been queued.  It is runnable unless we are told
+// otherwise.
+
+void
+Workqueue_trace::queued(Task* t, long long time)
+{
+  Task_record& r(this->pending_[t]);
+  r.name = t->name();
+  r.queued = time;
+  r.ready = time;
+}
+
+// Note that T is waiting for TOKEN.
+
+void
+Workqueue_trace::blocked(const Task* t, const Task_token* token)
+{
+  Task_record& r(this->pending_[t]);
+  r.ready = -1;
+  r.token = token;
+  r.released_by.clear();
+}
+
+// Note that RELEASER has released the token for which T was waiting.
+
+void
+Workqueue_trace::unblocked(const Task* t, Task* releaser, long long time)
+{
+  Task_record& r(this->pending_[t]);
+  r.ready = time;
+  r.released_by = releaser->name();
+}
+
+// Note that T has been run.  This is the last we will hear of it.
+
+void
+Workqueue_trace::ran(const Task* t, int thread_number, long long start,
+		     long long end)
+{
+  Pending::iterator p = this->pending_.find(t);
+  gold_assert(p != this->pending_.end());
+  Task_record& r(p->second);
+  if (r.ready < 0)
+    r.ready = start;
+  r.start = start;
+  r.end = end;
+  r.thread = thread_number;
+  this->completed_.push_back(r);
+  this->pending_.erase(p);
+}
+
+// Note that a thread waited for the Workqueue lock.  Acquiring an
+// uncontended lock is not interesting, so we only record waits which
+// we can measure.
+
+void
+Workqueue_trace::lock_wait(int thread_number, long long start,
+			   long long end)
+{
+  if (end > start)
+    this->spans_.push_back(Span("workqueue lock", thread_number, start,
+				end));
+}
+
+// Note that a thread had nothing to do.
+
+void
+Workqueue_trace::idle(int thread_number, long long start, long long end)
+{
+  this->spans_.push_back(Span("idle", thread_number, start, end));
+}
+
+// Write S to F as a JSON string.
+
+static void
+write_json_string(FILE* f, const char* s)
+{
+  putc('"', f);
+  for (; *s != '\0'; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+	fprintf(f, "\\u%04x", c);
+      else
+	putc(c, f);
+    }
+  putc('"', f);
+}
+
+// Write the trace in the Chrome trace event format, which may be
+// viewed with chrome://tracing or similar tools.  Each Task and each
+// period of waiting is a complete event on the timeline of the thread
+// involved.  Times are in microseconds.
+
+void
+Workqueue_trace::write()
+{
+  FILE* f = ::fopen(this->filename_, "w");
+  if (f == NULL)
+    {
+      gold_error(_("cannot open workqueue trace file %s: %s"),
+		 this->filename_, strerror(errno));
+      return;
+    }
+
+  fprintf(f, "{\"traceEvents\":[\n");
+
+  int max_thread = 0;
+  for (std::vector<Task_record>::const_iterator p = this->completed_.begin();
+       p != this->completed_.end();
+       ++p)
+    max_thread = std::max(max_thread, p->thread);
+  for (std::vector<Span>::const_iterator p = this->spans_.begin();
+       p != this->spans_.end();
+       ++p)
+    max_thread = std::max(max_thread, p->thread);
+
+  for (int i = 0; i <= max_thread; ++i)
+    fprintf(f, ("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		"\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}"),
+	    i == 0 ? "" : ",\n", i, i);
+
+  for (std::vector<Task_record>::const_iterator p = this->completed_.begin();
+       p != this->completed_.end();
+       ++p)
+    {
+      fprintf(f, ",\n{\"name\":");
+      write_json_string(f, p->name.c_str());
+      fprintf(f, (",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+		  "\"ts\":%lld,\"dur\":%lld,\"args\":{\"queued\":%lld,"
+		  "\"blocked_us\":%lld,\"runnable_us\":%lld"),
+	      p->thread, p->start, p->end - p->start, p->queued,
+	      p->ready - p->queued, p->start - p->ready);
+      if (p->token != NULL)
+	{
+	  fprintf(f, ",\"blocked_on\":\"%p\",\"released_by\":",
+		  static_cast<const void*>(p->token));
+	  write_json_string(f, p->released_by.c_str());
+	}
+      fprintf(f, "}}");
+    }
+
+  for (std::vector<Span>::const_iterator p = this->spans_.begin();
+       p != this->spans_.end();
+       ++p)
+    fprintf(f, (",\n{\"name\":\"%s\",\"cat\":\"wait\",\"ph\":\"X\","
+		"\"pid\":1,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}"),
+	    p->name, p->thread, p->start, p->end - p->start);
+
+  fprintf(f, "\n]}\n");
+
+  if (fclose(f) != 0)
+    gold_error(_("cannot close workqueue trace file %s: %s"),
+	       this->filename_, strerror(errno));
+}
+
+// Print a time in microseconds as seconds.
+
+static void
+print_time(const char* what, long long time)
+{
+  fprintf(stderr, _("%s: %s: %lld.%06lld seconds\n"),
+	  program_name, what, time / 1000000, time % 1000000);
+}
+
+// Sort the tasks which released others by how long the others were
+// blocked, longest first.
+
+struct Released_time_compare
+{
+  bool
+  operator()(const std::pair<std::string, long long>& a,
+	     const std::pair<std::string, long long>& b) const
+  { return a.second > b.second; }
+};
+
+// Print a summary of the trace.  The tasks which released the tasks
+// which spent the most time blocked are the ones which serialize the
+// link.
+
+void
+Workqueue_trace::print_stats() const
+{
+  long long run = 0;
+  long long blocked = 0;
+  long long runnable = 0;
+  std::map<std::string, long long> released;
+  for (std::vector<Task_record>::const_iterator p = this->completed_.begin();
+       p != this->completed_.end();
+       ++p)
+    {
+      run += p->end - p->start;
+      blocked += p->ready - p->queued;
+      runnable += p->start - p->ready;
+      if (p->token != NULL)
+	released[p->released_by] += p->ready - p->queued;
+    }
+
+  long long lock = 0;
+  long long idle = 0;
+  for (std::vector<Span>::const_iterator p = this->spans_.begin();
+       p != this->spans_.end();
+       ++p)
+    {
+      if (strcmp(p->name, "idle") == 0)
+	idle += p->end - p->start;
+      else
+	lock += p->end - p->start;
+    }
+
+  fprintf(stderr, _("%s: workqueue tasks run: %lu\n"), program_name,
+	  static_cast<unsigned long>(this->completed_.size()));
+  print_time(_("workqueue task run time"), run);
+  print_time(_("workqueue task time blocked"), blocked);
+  print_time(_("workqueue task time waiting for a thread"), runnable);
+  print_time(_("workqueue lock wait time"), lock);
+  print_time(_("workqueue thread idle time"), idle);
+
+  std::vector<std::pair<std::string, long long> > v(released.begin(),
+						     released.end());
+  std::sort(v.begin(), v.end(), Released_time_compare());
+  for (size_t i = 0; i < v.size() && i < 5; ++i)
+    fprintf(stderr,
+	    _("%s: workqueue tasks blocked %lld.%06lld seconds until %s\n"),
+	    program_name, v[i].second / 1000000, v[i].second % 1000000,
+	    v[i].first.c_str());
+}
+
 // Workqueue methods.
 
 Workqueue::Workqueue(const General_options& options)
@@ -122,7 +382,8 @@ Workqueue::Workqueue(const General_options& options)
     running_(0),
     waiting_(0),
     condvar_(this->lock_),
-    threader_(NULL)
+    threader_(NULL),
+    trace_(NULL)
 {
   bool threads = options.threads();
 #ifndef ENABLE_THREADS
@@ -138,10 +399,14 @@ Workqueue::Workqueue(const General_options& options)
       gold_unreachable();
 #endif
     }
+
+  if (options.workqueue_trace() != NULL)
+    this->trace_ = new Workqueue_trace(options.workqueue_trace());
 }
 
 Workqueue::~Workqueue()
 {
+  delete this->trace_;
 }
 
 // Add a task to the end of a specific queue, or put it on the list
@@ -152,6 +417,9 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
 {
   Hold_lock hl(this->lock_);
 
+  if (this->trace_ != NULL)
+    this->trace_->queued(t, this->trace_->now());
+
   Task_token* token = t->is_runnable();
   if (token != NULL)
     {
@@ -160,6 +428,8 @@ Workqueue::add_to_queue(Task_list* queue, Task* t, bool front)
       else
 	token->add_waiting(t);
       ++this->waiting_;
+      if (this->trace_ != NULL)
+	this->trace_->blocked(t, token);
     }
   else
     {
@@ -223,6 +493,8 @@ Workqueue::find_runnable_in_list(Task_list* tasks)
 
       token->add_waiting(t);
       ++this->waiting_;
+      if (this->trace_ != NULL)
+	this->trace_->blocked(t, token);
     }
 
   // We couldn't find any runnable task.
@@ -268,8 +540,15 @@ Workqueue::find_runnable_or_wait(int thread_number)
 
       gold_debug(DEBUG_TASK, "%3d sleeping", thread_number);
 
+      long long idle_start = 0;
+      if (this->trace_ != NULL)
+	idle_start = this->trace_->now();
+
       this->condvar_.wait();
 
+      if (this->trace_ != NULL)
+	this->trace_->idle(thread_number, idle_start, this->trace_->now());
+
       gold_debug(DEBUG_TASK, "%3d awake", thread_number);
 
       t = this->find_runnable();
@@ -290,9 +569,17 @@ Workqueue::find_and_run_task(int thread_number)
   Task* t;
   Task_locker tl;
 
+  long long lock_start = 0;
+  if (this->trace_ != NULL)
+    lock_start = this->trace_->now();
+
   {
     Hold_lock hl(this->lock_);
 
+    if (this->trace_ != NULL)
+      this->trace_->lock_wait(thread_number, lock_start,
+			      this->trace_->now());
+
     // Find a runnable task.
     t = this->find_runnable_or_wait(thread_number);
 
@@ -311,8 +598,16 @@ Workqueue::find_and_run_task(int thread_number)
       gold_debug(DEBUG_TASK, "%3d running   task %s", thread_number,
 		 t->name().c_str());
 
+      long long start = 0;
+      if (this->trace_ != NULL)
+	start = this->trace_->now();
+
       t->run(this);
 
+      long long end = 0;
+      if (this->trace_ != NULL)
+	end = this->trace_->now();
+
       gold_debug(DEBUG_TASK, "%3d completed task %s", thread_number,
 		 t->name().c_str());
 
@@ -320,6 +615,12 @@ Workqueue::find_and_run_task(int thread_number)
       {
 	Hold_lock hl(this->lock_);
 
+	if (this->trace_ != NULL)
+	  {
+	    this->trace_->lock_wait(thread_number, end, this->trace_->now());
+	    this->trace_->ran(t, thread_number, start, end);
+	  }
+
 	--this->running_;
 
 	// Release the locks for the task.  This must be done with the
@@ -387,6 +688,8 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
     {
       token->add_waiting(t);
       ++this->waiting_;
+      if (this->trace_ != NULL)
+	this->trace_->blocked(t, token);
       return false;
     }
 
@@ -431,6 +734,7 @@ Workqueue::return_or_queue(Task* t, bool is_blocker, Task** pret)
 Task*
 Workqueue::release_locks(Task* t, Task_locker* tl)
 {
+  Task* finished = t;
   Task* ret = NULL;
   for (Task_locker::iterator p = tl->begin(); p != tl->end(); ++p)
     {
@@ -445,6 +749,8 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	      while ((t = token->remove_first_waiting()) != NULL)
 		{
 		  --this->waiting_;
+		  if (this->trace_ != NULL)
+		    this->trace_->unblocked(t, finished, this->trace_->now());
 		  this->return_or_queue(t, true, &ret);
 		}
 	    }
@@ -462,6 +768,8 @@ Workqueue::release_locks(Task* t, Task_locker* tl)
 	  while ((t = token->remove_first_waiting()) != NULL)
 	    {
 	      --this->waiting_;
+	      if (this->trace_ != NULL)
+		this->trace_->unblocked(t, finished, this->trace_->now());
 	      if (this->return_or_queue(t, false, &ret))
 		break;
 	    }
@@ -494,6 +802,14 @@ Workqueue::set_thread_count(int threads)
   this->condvar_.broadcast();
 }
 
+// Return the number of threads we want.
+
+int
+Workqueue::thread_count()
+{
+  return this->threader_->thread_count();
+}
+
 // Add a new blocker to an existing Task_token.
 
 void
@@ -503,4 +819,182 @@ Workqueue::add_blocker(Task_token* token)
   token->add_blocker();
 }
 
+// Write out the trace.
+
+void
+Workqueue::write_trace()
+{
+  if (this->trace_ == NULL)
+    return;
+  Hold_lock hl(this->lock_);
+  this->trace_->write();
+}
+
+// Print statistics from the trace.
+
+void
+Workqueue::print_stats()
+{
+  if (this->trace_ == NULL)
+    return;
+  Hold_lock hl(this->lock_);
+  this->trace_->print_stats();
+}
+
+// Class Parallel_work.
+
+// The state shared by a Parallel_work and its helper tasks.  A helper
+// task may not run until after all the work has been done, so this
+// is reference counted, and deleted by whichever of the caller and
+// the helpers finishes last.
+
+class Parallel_work_state
+{
+ public:
+  Parallel_work_state(Parallel_work* work, unsigned int count,
+		      unsigned int range_size, int refs)
+    : lock_(), condvar_(this->lock_), work_(work), count_(count),
+      range_size_(range_size), next_(0), active_(0), refs_(refs)
+  { }
+
+  // Do ranges until there are none left.
+  void
+  work();
+
+  // Wait until every range has been done.
+  void
+  wait();
+
+  // Drop a reference.
+  void
+  release();
+
+ private:
+  // Lock for the remaining members.
+  Lock lock_;
+  // Signalled when the last active range is done.
+  Condvar condvar_;
+  // The work to do.  This is not used once next_ reaches count_.
+  Parallel_work* work_;
+  // The number of indexes.
+  unsigned int count_;
+  // The number of indexes in a range.
+  unsigned int range_size_;
+  // The first index of the next range to hand out.
+  unsigned int next_;
+  // The number of ranges being done.
+  int active_;
+  // The number of references.
+  int refs_;
+};
+
+void
+Parallel_work_state::work()
+{
+  this->lock_.acquire();
+  while (this->next_ < this->count_)
+    {
+      unsigned int first = this->next_;
+      unsigned int last = first + std::min(this->range_size_,
+					   this->count_ - first);
+      this->next_ = last;
+      ++this->active_;
+      this->lock_.release();
+
+      this->work_->do_range(first, last);
+
+      this->lock_.acquire();
+      --this->active_;
+    }
+  if (this->active_ == 0)
+    this->condvar_.broadcast();
+  this->lock_.release();
+}
+
+void
+Parallel_work_state::wait()
+{
+  Hold_lock hl(this->lock_);
+  while (this->next_ < this->count_ || this->active_ > 0)
+    this->condvar_.wait();
+}
+
+void
+Parallel_work_state::release()
+{
+  bool last;
+  {
+    Hold_lock hl(this->lock_);
+    last = --this->refs_ == 0;
+  }
+  if (last)
+    delete this;
+}
+
+// A helper task for a Parallel_work.
+
+class Parallel_work_task : public Task
+{
+ public:
+  Parallel_work_task(Parallel_work_state* state)
+    : state_(state)
+  { }
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker*)
+  { }
+
+  void
+  run(Workqueue*)
+  {
+    this->state_->work();
+    this->state_->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Parallel_work_task"; }
+
+ private:
+  Parallel_work_state* state_;
+};
+
+// Do the work, using as many of the workqueue threads as are free.
+
+void
+Parallel_work::run(Workqueue* workqueue, unsigned int count,
+		   unsigned int range_size)
+{
+  gold_assert(range_size > 0);
+  unsigned int ranges = count / range_size + (count % range_size != 0);
+
+  unsigned int helpers = 0;
+  if (ranges > 1 && workqueue != NULL)
+    {
+      int threads = workqueue->thread_count();
+      if (threads > 1)
+	helpers = std::min(ranges - 1, static_cast<unsigned int>(threads - 1));
+    }
+
+  if (helpers == 0)
+    {
+      for (unsigned int first = 0; first < count; first += range_size)
+	this->do_range(first, first + std::min(range_size, count - first));
+      return;
+    }
+
+  Parallel_work_state* state = new Parallel_work_state(this, count,
+						       range_size,
+						       helpers + 1);
+  for (unsigned int i = 0; i < helpers; ++i)
+    workqueue->queue_soon(new Parallel_work_task(state));
+  state->work();
+  state->wait();
+  state->release();
+}
+
 } // End namespace gold.
@@ -194,6 +194,7 @@ class Task_function : public Task
 // The workqueue itself.
 
 class Workqueue_threader;
+class Workqueue_trace;
 
 class Workqueue
 {
@@ -227,12 +228,25 @@ class Workqueue
   void
   set_thread_count(int);
 
+  // Return the number of threads we want to have running.  This is
+  // 1 when not using threads.
+  int
+  thread_count();
+
   // Add a new blocker to an existing Task_token. This must be done
   // with the workqueue lock held.  This should not be done routinely,
   // only in special circumstances.
   void
   add_blocker(Task_token*);
 
+  // Write out the trace requested by --workqueue-trace, if any.
+  void
+  write_trace();
+
+  // Print statistics gathered by --workqueue-trace, if any.
+  void
+  print_stats();
+
  private:
   // This class can not be copied.
   Workqueue(const Workqueue&);
@@ -288,6 +302,50 @@ class Workqueue
   // The threading implementation.  This is set at construction time
   // and not changed thereafter.
   Workqueue_threader* threader_;
+  // The trace of what we are doing, if --workqueue-trace is used.
+  // This is set at construction time and not changed thereafter; the
+  // trace itself is protected by lock_.
+  Workqueue_trace* trace_;
+};
+
+// Parallel_work lets a running Task share a loop over a range of
+// indexes with threads which would otherwise be idle.  The Task calls
+// run, which queues helper tasks and then works through the ranges
+// itself until none are left; run returns when every range has been
+// done.  Since the calling thread does any range which no helper has
+// taken, this can not deadlock, and when not using threads it is
+// just a loop.  The calling thread is held while it waits, so this
+// should only be used for work which the Task needs before it can
+// continue.
+
+class Parallel_work
+{
+ public:
+  Parallel_work()
+  { }
+
+  virtual
+  ~Parallel_work()
+  { }
+
+  // Call do_range for each range of RANGE_SIZE indexes from 0 up to
+  // COUNT.
+  void
+  run(Workqueue*, unsigned int count, unsigned int range_size);
+
+ protected:
+  // Do the work for the indexes from FIRST up to, but not including,
+  // LAST.  This may be called by several threads at once, for
+  // different ranges.
+  virtual void
+  do_range(unsigned int first, unsigned int last) = 0;
+
+ private:
+  // This class can not be copied.
+  Parallel_work(const Parallel_work&);
+  Parallel_work& operator=(const Parallel_work&);
+
+  friend class Parallel_work_state;
 };
 
 } // End namespace gold.
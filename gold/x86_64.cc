@@ -62,7 +62,7 @@ class Target_x86_64 : public Target_freebsd<64, false>
 
   Target_x86_64()
     : Target_freebsd<64, false>(&x86_64_info),
-      got_(NULL), plt_(NULL), got_plt_(NULL), rela_dyn_(NULL),
+      got_(NULL), plt_(NULL), got_plt_(NULL), rela_dyn_(NULL), relr_dyn_(NULL),
       copy_relocs_(elfcpp::R_X86_64_COPY), dynbss_(NULL),
       got_mod_index_offset_(-1U), tls_base_symbol_defined_(false)
   { }
@@ -105,6 +105,10 @@ class Target_x86_64 : public Target_freebsd<64, false>
   void
   do_finalize_sections(Layout*);
 
+  // Finalize the sections which depend on the section addresses.
+  bool
+  do_finalize_address_dependent_sections();
+
   // Return the value to use for a dynamic which requires special
   // treatment.
   uint64_t
@@ -419,6 +423,8 @@ class Target_x86_64 : public Target_freebsd<64, false>
   Output_data_space* got_plt_;
   // The dynamic reloc section.
   Reloc_section* rela_dyn_;
+  // The packed relative relocs, for -z pack-relative-relocs.
+  Output_data_relr<64, false>* relr_dyn_;
   // Relocs saved to avoid a COPY reloc.
   Copy_relocs<elfcpp::SHT_RELA, 64, false> copy_relocs_;
   // Space for variables copied with a COPY reloc.
@@ -514,6 +520,18 @@ Target_x86_64::rela_dyn_section(Layout* layout)
       this->rela_dyn_ = new Reloc_section(parameters->options().combreloc());
       layout->add_output_section_data(".rela.dyn", elfcpp::SHT_RELA,
 				      elfcpp::SHF_ALLOC, this->rela_dyn_);
+
+      // The packed relocs are encoded when the addresses of the
+      // relocated locations are known, so we don't use them if a
+      // linker script may change where they go.
+      if (parameters->options().pack_relative_relocs()
+	  && !layout->script_options()->saw_sections_clause())
+	{
+	  this->relr_dyn_ = new Output_data_relr<64, false>();
+	  layout->add_output_section_data(".relr.dyn", elfcpp::SHT_RELR,
+					  elfcpp::SHF_ALLOC, this->relr_dyn_);
+	  this->rela_dyn_->set_relr(this->relr_dyn_, elfcpp::R_X86_64_RELATIVE);
+	}
     }
   return this->rela_dyn_;
 }
@@ -1657,6 +1675,16 @@ Target_x86_64::scan_relocs(const General_options& options,
 void
 Target_x86_64::do_finalize_sections(Layout* layout)
 {
+  // If no relative relocs were packed, drop the empty section, so
+  // that there are no tags for it and no need for a C library which
+  // supports them.  Any relative relocs added from now on go in .rela.dyn.
+  if (this->relr_dyn_ != NULL && this->relr_dyn_->empty())
+    {
+      layout->remove_output_section(layout->find_output_section(".relr.dyn"));
+      this->rela_dyn_->set_relr(NULL, 0);
+      this->relr_dyn_ = NULL;
+    }
+
   // Fill in some more dynamic tags.
   Output_data_dynamic* const odyn = layout->dynamic_data();
   if (odyn != NULL)
@@ -1691,6 +1719,13 @@ Target_x86_64::do_finalize_sections(Layout* layout)
 			     elfcpp::Elf_sizes<64>::rela_size);
 	}
 
+      if (this->relr_dyn_ != NULL)
+	{
+	  odyn->add_section_address(elfcpp::DT_RELR, this->relr_dyn_);
+	  odyn->add_section_size(elfcpp::DT_RELRSZ, this->relr_dyn_);
+	  odyn->add_constant(elfcpp::DT_RELRENT, 64 / 8);
+	}
+
       if (!parameters->options().shared())
 	{
 	  // The value of the DT_DEBUG tag is filled in by the dynamic
@@ -2593,6 +2628,16 @@ Target_x86_64::relocate_for_relocatable(
     reloc_view_size);
 }
 
+// Encode the packed relative relocs, now that the addresses of the
+// locations they relocate are known.  Return true if they need more
+// space than they were given.
+
+bool
+Target_x86_64::do_finalize_address_dependent_sections()
+{
+  return this->relr_dyn_ != NULL && !this->relr_dyn_->encode();
+}
+
 // Return the value to use for a dynamic which requires special
 // treatment.  This is how we support equality comparisons of function
 // pointers across shared library boundaries, as described in the
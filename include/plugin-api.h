@@ -134,6 +134,16 @@ typedef
 enum ld_plugin_status
 (*ld_plugin_all_symbols_read_handler) (void);
 
+/* The plugin library's "compile partition" handler.  PARTITION is a
+   number between zero and the count passed to set_partition_count;
+   HANDLE must be passed back to add_partition_input_file.  The linker
+   may call this handler for several partitions at once, from
+   different threads.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_compile_partition_handler) (int partition, void *handle);
+
 /* The plugin library's cleanup handler.  */
 
 typedef
@@ -153,6 +163,14 @@ enum ld_plugin_status
 (*ld_plugin_register_all_symbols_read) (
   ld_plugin_all_symbols_read_handler handler);
 
+/* The linker's interface for registering the "compile partition"
+   handler.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_register_compile_partition) (
+  ld_plugin_compile_partition_handler handler);
+
 /* The linker's interface for registering the cleanup handler.  */
 
 typedef
@@ -193,6 +211,23 @@ typedef
 enum ld_plugin_status
 (*ld_plugin_add_input_file) (char *pathname);
 
+/* The linker's interface for requesting that the "compile partition"
+   handler be called COUNT times.  This may only be called from the
+   "all symbols read" handler.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_set_partition_count) (int count);
+
+/* The linker's interface for adding a compiled input file from the
+   "compile partition" handler.  HANDLE is the handle passed to that
+   handler.  The linker starts reading the file immediately, but adds
+   its symbols in partition order.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_add_partition_input_file) (void *handle, char *pathname);
+
 /* The linker's interface for issuing a warning or error message.  */
 
 typedef
@@ -224,7 +259,12 @@ enum ld_plugin_tag
   LDPT_ADD_INPUT_FILE,
   LDPT_MESSAGE,
   LDPT_GET_INPUT_FILE,
-  LDPT_RELEASE_INPUT_FILE
+  LDPT_RELEASE_INPUT_FILE,
+  /* The partition interface is not part of the upstream API, so its
+     tags are given values well clear of the upstream numbering.  */
+  LDPT_REGISTER_COMPILE_PARTITION_HOOK = 64,
+  LDPT_SET_PARTITION_COUNT = 65,
+  LDPT_ADD_PARTITION_INPUT_FILE = 66
 };
 
 /* The plugin transfer vector.  */
@@ -245,6 +285,9 @@ struct ld_plugin_tv
     ld_plugin_message tv_message;
     ld_plugin_get_input_file tv_get_input_file;
     ld_plugin_release_input_file tv_release_input_file;
+    ld_plugin_register_compile_partition tv_register_compile_partition;
+    ld_plugin_set_partition_count tv_set_partition_count;
+    ld_plugin_add_partition_input_file tv_add_partition_input_file;
   } tv_u;
 };
 
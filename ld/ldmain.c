@@ -541,6 +541,8 @@ main (int argc, char **argv)
       char *lim = sbrk (0);
 #endif
       long run_time = get_run_time () - start_time;
+      unsigned long cache_hits, cache_misses;
+      int cache_max_open;
 
       fprintf (stderr, _("%s: total time in link: %ld.%06ld\n"),
 	       program_name, run_time / 1000000, run_time % 1000000);
@@ -548,6 +550,9 @@ main (int argc, char **argv)
       fprintf (stderr, _("%s: data size %ld\n"), program_name,
 	       (long) (lim - (char *) &environ));
 #endif
+      bfd_cache_get_stats (&cache_hits, &cache_misses, &cache_max_open);
+      fprintf (stderr, _("%s: file cache hits %lu, misses %lu, size %d\n"),
+	       program_name, cache_hits, cache_misses, cache_max_open);
     }
 
   /* Prevent remove_output from doing anything, after a successful link.  */